@@ -4,6 +4,7 @@
 #include "AnimationResource.hpp"
 #include "AnimationComponent.hpp"
 
+#include <Core/Memory/MemoryTracking.hpp>
 #include <Job/Job.hpp>
 #include <Scene/EntityComponentSystem/Components/TransformComponent.hpp>
 #include <Scene/Scene.hpp>
@@ -16,6 +17,8 @@ namespace Darius::Animation
 
 	void Initialize(D_SERIALIZATION::Json const& settings)
 	{
+		D_MEMORY_TAG_SCOPE(Animation);
+
 		D_ASSERT(!_initialized);
 		_initialized = true;
 
@@ -40,6 +43,8 @@ namespace Darius::Animation
 
 	void Update(float dt)
 	{
+		D_MEMORY_TAG_SCOPE(Animation);
+
 		D_CONTAINERS::DVector<std::function<void()>> updateFuncs;
 		updateFuncs.reserve(D_WORLD::CountComponents<AnimationComponent>());
 
@@ -7,6 +7,7 @@
 #include "AudioScene.hpp"
 
 #include <Core/Application.hpp>
+#include <Core/Memory/MemoryTracking.hpp>
 #include <Physics/Components/RigidbodyComponent.hpp>
 #include <Scene/EntityComponentSystem/Components/TransformComponent.hpp>
 #include <Utils/Assert.hpp>
@@ -66,6 +67,8 @@ namespace Darius::Audio
 
 	void Initialize(D_SERIALIZATION::Json const& settings)
 	{
+		D_MEMORY_TAG_SCOPE(Audio);
+
 		D_ASSERT(!_initialize);
 		_initialize = true;
 		ShouldReset = false;
@@ -169,6 +172,8 @@ namespace Darius::Audio
 
 	void Update(float dt)
 	{
+		D_MEMORY_TAG_SCOPE(Audio);
+
 		if(!AudioEngineInst->Update())
 		{
 			if(AudioEngineInst->IsCriticalError())
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#ifndef D_BENCHMARKS
+#define D_BENCHMARKS Darius::Benchmarks
+#endif // !D_BENCHMARKS
+
+namespace Darius::Benchmarks
+{
+	typedef void(*BenchmarkFunction)();
+
+	// Called by D_BENCHMARK before main, benchmarks run in their registration order
+	bool					RegisterBenchmark(char const* suite, char const* name, BenchmarkFunction function);
+
+	// Prints a line of results under the running benchmark
+	void					Report(std::string const& line);
+
+	// Marks the run as failed without stopping the benchmark
+	void					Fail(std::string const& message);
+
+	class Stopwatch
+	{
+	public:
+		Stopwatch() : mStart(std::chrono::steady_clock::now()) { }
+
+		void				Restart() { mStart = std::chrono::steady_clock::now(); }
+
+		double				GetMilliseconds() const { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mStart).count(); }
+		double				GetNanoseconds() const { return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - mStart).count(); }
+
+	private:
+		std::chrono::steady_clock::time_point mStart;
+	};
+}
+
+#define D_BENCHMARK(suite, name) \
+static void suite##_##name##_Benchmark(); \
+static bool const suite##_##name##_Registered = D_BENCHMARKS::RegisterBenchmark(#suite, #name, &suite##_##name##_Benchmark); \
+static void suite##_##name##_Benchmark()
+
+#define D_BENCHMARK_REPORT(message) \
+{ \
+	std::ostringstream _reportStream; \
+	_reportStream << message; \
+	D_BENCHMARKS::Report(_reportStream.str()); \
+}
+
+// Sanity checks on the results, so that a broken benchmark doesn't report meaningless numbers
+#define D_BENCHMARK_CHECK(expr) \
+{ \
+	if(!(expr)) \
+		D_BENCHMARKS::Fail(std::string(__FILE__) + "(" + std::to_string(__LINE__) + "): " #expr); \
+}
@@ -0,0 +1,465 @@
+#include "Benchmark.hpp"
+
+#include <Core/Containers/ConcurrentQueue.hpp>
+#include <Core/Containers/HandleTable.hpp>
+#include <Core/Containers/Map.hpp>
+#include <Core/Memory/Memory.hpp>
+#include <Core/Memory/Allocators/FrameAllocator.hpp>
+#include <Core/Memory/Allocators/MallocAllocator.hpp>
+#include <Core/Memory/Allocators/MemoryPool.hpp>
+#include <Core/MultiThreading/RWLock.hpp>
+#include <Core/MultiThreading/SpinLock.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <queue>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	// Builds the kind of containers a frame of the renderer fills
+	template<typename Vector>
+	uint64_t FillFrameContainers(uint32_t count)
+	{
+		Vector keys;
+		for (uint32_t i = 0u; i < count; i++)
+			keys.push_back((uint64_t)(count - i) * 2654435761u);
+
+		std::sort(keys.begin(), keys.end());
+		return keys.front();
+	}
+
+	// The mutex based queue replaced by the lock-free ones, as the throughput baseline
+	template<typename T>
+	class MutexQueue
+	{
+	public:
+		void Push(T const& item)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mQueue.push(item);
+		}
+
+		bool TryPop(T& out)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mQueue.empty())
+				return false;
+			out = mQueue.front();
+			mQueue.pop();
+			return true;
+		}
+
+	private:
+		std::queue<T> mQueue;
+		std::mutex mMutex;
+	};
+
+	template<typename Queue>
+	void PushUntilAccepted(Queue& queue, uint64_t item)
+	{
+		if constexpr (requires { queue.TryPush(item); })
+		{
+			while (!queue.TryPush(item))
+				std::this_thread::yield();
+		}
+		else
+			queue.Push(item);
+	}
+
+	// Returns the items per second
+	template<typename Queue>
+	double RunProducersAndConsumers(Queue& queue, uint32_t producers, uint32_t consumers, uint32_t itemsPerProducer)
+	{
+		std::atomic_uint64_t popped = 0u;
+		uint64_t total = (uint64_t)producers * itemsPerProducer;
+
+		std::vector<std::thread> threads;
+		D_BENCHMARKS::Stopwatch stopwatch;
+
+		for (uint32_t p = 0u; p < producers; p++)
+		{
+			threads.emplace_back([&, p]()
+				{
+					for (uint32_t i = 0u; i < itemsPerProducer; i++)
+						PushUntilAccepted(queue, ((uint64_t)p << 32) | i);
+				});
+		}
+
+		for (uint32_t c = 0u; c < consumers; c++)
+		{
+			threads.emplace_back([&]()
+				{
+					uint64_t item;
+					while (popped.load(std::memory_order_relaxed) < total)
+					{
+						if (queue.TryPop(item))
+							popped.fetch_add(1u, std::memory_order_relaxed);
+						else
+							std::this_thread::yield();
+					}
+				});
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+
+		D_BENCHMARK_CHECK(popped.load() == total);
+		return total / (stopwatch.GetMilliseconds() / 1000.);
+	}
+
+	// The spin lock replaced by the adaptive one, as the contention baseline
+	class BusySpinLock
+	{
+	public:
+		void lock() { while (mLocked.test_and_set(std::memory_order_acquire)) { } }
+		void unlock() { mLocked.clear(std::memory_order_release); }
+
+	private:
+		std::atomic_flag mLocked = ATOMIC_FLAG_INIT;
+	};
+
+	// Returns the milliseconds taken by the threads to increment a shared counter under the lock
+	template<typename Lock>
+	double RunLockedIncrements(Lock& lock, uint32_t threadCount, uint32_t incrementsPerThread, uint64_t& counter)
+	{
+		std::vector<std::thread> threads;
+		D_BENCHMARKS::Stopwatch stopwatch;
+
+		for (uint32_t t = 0u; t < threadCount; t++)
+		{
+			threads.emplace_back([&]()
+				{
+					for (uint32_t i = 0u; i < incrementsPerThread; i++)
+					{
+						std::scoped_lock guard(lock);
+						counter++;
+					}
+				});
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+
+		return stopwatch.GetMilliseconds();
+	}
+
+	// Returns the milliseconds taken by the threads, writing every writeEvery operations
+	template<typename ReadFunc, typename WriteFunc>
+	double RunReadersAndWriters(uint32_t threadCount, uint32_t operationsPerThread, uint32_t writeEvery, ReadFunc&& read, WriteFunc&& write)
+	{
+		std::vector<std::thread> threads;
+		D_BENCHMARKS::Stopwatch stopwatch;
+
+		for (uint32_t t = 0u; t < threadCount; t++)
+		{
+			threads.emplace_back([&, t]()
+				{
+					for (uint32_t i = 0u; i < operationsPerThread; i++)
+					{
+						if ((i + t) % writeEvery == 0u)
+							write();
+						else
+							read();
+					}
+				});
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+
+		return stopwatch.GetMilliseconds();
+	}
+
+	struct PoolObject
+	{
+		PoolObject(uint64_t value) :
+			Value(value) { }
+
+		uint64_t Value;
+		uint64_t Padding[3];
+	};
+
+	// The pool replaced by the free list one, which mapped objects to indices with a hash map
+	template<typename T>
+	class HashMappedPool
+	{
+	public:
+		explicit HashMappedPool(uint32_t size) :
+			mMemory(static_cast<std::byte*>(std::malloc(sizeof(T) * size)))
+		{
+			for (uint32_t i = size; i-- > 0u;)
+				mFreeIndices.push_back(i);
+		}
+
+		~HashMappedPool() { std::free(mMemory); }
+
+		T* Alloc(uint64_t value)
+		{
+			auto index = mFreeIndices.back();
+			mFreeIndices.pop_back();
+			auto object = new (mMemory + (size_t)index * sizeof(T)) T(value);
+			mIndices[object] = index;
+			return object;
+		}
+
+		void Release(T* object)
+		{
+			auto search = mIndices.find(object);
+			object->~T();
+			mFreeIndices.push_back(search->second);
+			mIndices.erase(search);
+		}
+
+	private:
+		std::byte* mMemory;
+		std::vector<uint32_t> mFreeIndices;
+		std::unordered_map<T const*, uint32_t> mIndices;
+	};
+
+	// Keeps a window of live objects, releasing one and allocating one each step, returns nanoseconds per step
+	template<typename AllocFunc, typename ReleaseFunc>
+	double ChurnObjects(uint32_t live, uint32_t steps, AllocFunc&& alloc, ReleaseFunc&& release)
+	{
+		std::vector<PoolObject*> objects;
+		for (uint32_t i = 0u; i < live; i++)
+			objects.push_back(alloc(i));
+
+		D_BENCHMARKS::Stopwatch stopwatch;
+
+		uint64_t checksum = 0u;
+		for (uint32_t i = 0u; i < steps; i++)
+		{
+			auto slot = (i * 2654435761u) % live;
+			checksum += objects[slot]->Value;
+			release(objects[slot]);
+			objects[slot] = alloc(i);
+		}
+
+		auto nanoseconds = stopwatch.GetNanoseconds() / steps;
+
+		for (auto object : objects)
+			release(object);
+
+		D_BENCHMARK_CHECK(checksum > 0u);
+		return nanoseconds;
+	}
+
+	struct TableObject
+	{
+		uint16_t Type;
+		uint64_t Value;
+	};
+
+	// Resolves every handle in a shuffled order a number of times, returns nanoseconds per resolve
+	template<typename ResolveFunc>
+	double ResolveHandles(std::vector<uint32_t> const& handles, uint32_t rounds, ResolveFunc&& resolve)
+	{
+		D_BENCHMARKS::Stopwatch stopwatch;
+
+		uint64_t checksum = 0u;
+		for (uint32_t round = 0u; round < rounds; round++)
+			for (auto handle : handles)
+				checksum += resolve(handle)->Value;
+
+		auto nanoseconds = stopwatch.GetNanoseconds() / ((double)rounds * handles.size());
+
+		D_BENCHMARK_CHECK(checksum > 0u);
+		return nanoseconds;
+	}
+}
+
+D_BENCHMARK(FrameAllocator, FrameContainersAgainstHeap)
+{
+	constexpr uint32_t frames = 300u;
+	constexpr uint32_t containersPerFrame = 16u;
+	constexpr uint32_t count = 2000u;
+
+	D_FRAME_ALLOCATOR::Initialize(3u, 1024u * 1024u);
+
+	uint64_t checksum = 0u;
+	uint64_t frameAllocations = 0u;
+
+	D_BENCHMARKS::Stopwatch stopwatch;
+	for (uint32_t frame = 0u; frame < frames; frame++)
+		for (uint32_t i = 0u; i < containersPerFrame; i++)
+			checksum += FillFrameContainers<std::vector<uint64_t>>(count);
+	auto heapMs = stopwatch.GetMilliseconds() / frames;
+
+	stopwatch.Restart();
+	for (uint32_t frame = 0u; frame < frames; frame++)
+	{
+		D_FRAME_ALLOCATOR::BeginFrame(frame);
+		for (uint32_t i = 0u; i < containersPerFrame; i++)
+			checksum -= FillFrameContainers<D_FRAME_ALLOCATOR::DFrameVector<uint64_t>>(count);
+		frameAllocations += D_FRAME_ALLOCATOR::GetStats().Allocations;
+	}
+	auto frameMs = stopwatch.GetMilliseconds() / frames;
+
+	D_BENCHMARK_CHECK(checksum == 0u);
+	D_BENCHMARK_REPORT("Per frame, heap vectors: " << heapMs << " ms, frame vectors: " << frameMs << " ms with "
+		<< frameAllocations / frames << " frame allocations, " << D_FRAME_ALLOCATOR::GetStats().ReservedBytes << " bytes reserved");
+
+	D_FRAME_ALLOCATOR::Shutdown();
+}
+
+D_BENCHMARK(MemoryTracking, TrackingOverhead)
+{
+	constexpr uint32_t iterations = 2000000u;
+	constexpr uint32_t batch = 64u;
+
+	void* pointers[batch];
+
+	auto measure = [&](auto alloc, auto free)
+		{
+			D_BENCHMARKS::Stopwatch stopwatch;
+			for (uint32_t i = 0u; i < iterations; i += batch)
+			{
+				for (uint32_t j = 0u; j < batch; j++)
+					pointers[j] = alloc(16u + (j & 7u) * 24u);
+				for (uint32_t j = 0u; j < batch; j++)
+					free(pointers[j]);
+			}
+			return stopwatch.GetNanoseconds() / iterations;
+		};
+
+	// What the memory manager did before the tracking: padded malloc and a global allocation count
+	static std::atomic_uint64_t allocCount;
+	auto plainAlloc = [](size_t size) { allocCount.fetch_add(1u); return std::malloc(size + D_PAD_ALIGN); };
+	auto plainFree = [](void* ptr) { allocCount.fetch_sub(1u); std::free(ptr); };
+	auto trackedAlloc = [](size_t size) { return DMemAlloc(size); };
+	auto trackedFree = [](void* ptr) { DMemFree(ptr); };
+
+	// Best of a few runs to filter out noise
+	double plain = 1e9, tracked = 1e9;
+	for (int run = 0; run < 5; run++)
+	{
+		plain = std::min(plain, measure(plainAlloc, plainFree));
+		tracked = std::min(tracked, measure(trackedAlloc, trackedFree));
+	}
+
+	D_BENCHMARK_REPORT("Allocation and free: plain " << plain << " ns, tracked " << tracked << " ns, overhead " << (tracked - plain) / plain * 100.0 << "%");
+}
+
+D_BENCHMARK(ConcurrentQueue, ThroughputAgainstMutexQueue)
+{
+	constexpr uint32_t items = 200000u;
+
+	for (uint32_t threads : { 1u, 4u, 16u })
+	{
+		MutexQueue<uint64_t> mutexQueue;
+		D_CONTAINERS::BoundedConcurrentQueue<uint64_t> bounded(1024u);
+		D_CONTAINERS::ConcurrentQueue<uint64_t> unbounded;
+
+		auto mutexRate = RunProducersAndConsumers(mutexQueue, threads, threads, items / threads);
+		auto boundedRate = RunProducersAndConsumers(bounded, threads, threads, items / threads);
+		auto unboundedRate = RunProducersAndConsumers(unbounded, threads, threads, items / threads);
+
+		D_BENCHMARK_REPORT(threads << " producers and consumers, items per second: mutex " << mutexRate
+			<< ", bounded " << boundedRate << ", unbounded " << unboundedRate);
+	}
+}
+
+D_BENCHMARK(Locks, ContentionAgainstPreviousLocks)
+{
+	using namespace D_CORE_THREADING;
+
+	constexpr uint32_t operations = 400000u;
+
+	for (uint32_t threadCount : { 1u, 4u, 16u })
+	{
+		uint64_t counter = 0u;
+
+		BusySpinLock busy;
+		std::mutex mutex;
+		SpinLock adaptive;
+
+		auto busyTime = RunLockedIncrements(busy, threadCount, operations / threadCount, counter);
+		auto mutexTime = RunLockedIncrements(mutex, threadCount, operations / threadCount, counter);
+		auto adaptiveTime = RunLockedIncrements(adaptive, threadCount, operations / threadCount, counter);
+
+		D_BENCHMARK_REPORT(threadCount << " threads, lock ms: busy spin " << busyTime
+			<< ", mutex " << mutexTime << ", adaptive spin " << adaptiveTime);
+		D_BENCHMARK_CHECK(counter == 3u * operations);
+
+		// Mostly readers, as with the bounding volume hierarchy queries. Only the locking is measured.
+		std::shared_timed_mutex sharedMutex;
+		RWLock rwLock;
+		uint64_t value = 0u;
+
+		auto sharedTime = RunReadersAndWriters(threadCount, operations / threadCount, 20u,
+			[&]() { std::shared_lock guard(sharedMutex); },
+			[&]() { std::unique_lock guard(sharedMutex); value++; });
+		auto rwTime = RunReadersAndWriters(threadCount, operations / threadCount, 20u,
+			[&]() { RWLockRead guard(rwLock); },
+			[&]() { RWLockWrite guard(rwLock); value++; });
+
+		D_BENCHMARK_REPORT(threadCount << " threads, read/write lock ms: shared_timed_mutex " << sharedTime
+			<< ", RWLock " << rwTime);
+		D_BENCHMARK_CHECK(value == 2u * operations / 20u);
+	}
+}
+
+D_BENCHMARK(ObjectPool, ChurnAgainstHashMappedPoolAndNew)
+{
+	constexpr uint32_t live = 10000u;
+	constexpr uint32_t steps = 1000000u;
+
+	D_MEMORY::MallocAllocator allocator;
+	D_MEMORY::TypedObjectPool<PoolObject> pool;
+	pool.Init(&allocator, 1024u);
+	HashMappedPool<PoolObject> hashMapped(live + 1u);
+
+	auto poolTime = ChurnObjects(live, steps, [&](uint64_t value) { return pool.Alloc(value); }, [&](PoolObject* object) { pool.Release(object); });
+	auto hashMappedTime = ChurnObjects(live, steps, [&](uint64_t value) { return hashMapped.Alloc(value); }, [&](PoolObject* object) { hashMapped.Release(object); });
+	auto newTime = ChurnObjects(live, steps, [](uint64_t value) { return new PoolObject(value); }, [](PoolObject* object) { delete object; });
+
+	D_BENCHMARK_REPORT("Release and allocation: free list pool " << poolTime << " ns, hash mapped pool " << hashMappedTime
+		<< " ns, new/delete " << newTime << " ns");
+
+	D_BENCHMARK_CHECK(pool.GetUsedCount() == 0u);
+	pool.Shutdown();
+}
+
+D_BENCHMARK(HandleTable, ResolveAgainstNestedMaps)
+{
+	using namespace D_CONTAINERS;
+
+	constexpr uint32_t count = 20000u;
+	constexpr uint32_t rounds = 50u;
+	constexpr uint16_t typeCount = 16u;
+
+	std::vector<TableObject> objects(count);
+	HandleTable<TableObject> table;
+	std::vector<uint32_t> handles;
+
+	// Resources were looked up by type and then by id
+	DConcurrentUnorderedMap<uint16_t, DUnorderedMap<uint32_t, TableObject*>> nestedMaps;
+	std::vector<uint32_t> ids;
+
+	for (uint32_t i = 0u; i < count; i++)
+	{
+		objects[i] = { (uint16_t)(i % typeCount + 1u), i + 1u };
+		handles.push_back(table.Add(&objects[i]));
+		nestedMaps[objects[i].Type][i] = &objects[i];
+		ids.push_back(i);
+	}
+
+	// Same shuffled order for both
+	for (uint32_t i = count; i-- > 1u;)
+	{
+		auto other = (i * 2654435761u) % (i + 1u);
+		std::swap(handles[i], handles[other]);
+		std::swap(ids[i], ids[other]);
+	}
+
+	auto tableTime = ResolveHandles(handles, rounds, [&](uint32_t handle) { return table.Resolve(handle); });
+	auto mapTime = ResolveHandles(ids, rounds, [&](uint32_t id) { return nestedMaps[(uint16_t)(id % typeCount + 1u)].at(id); });
+
+	D_BENCHMARK_REPORT("Resolve: handle table " << tableTime << " ns, type and id maps " << mapTime << " ns");
+}
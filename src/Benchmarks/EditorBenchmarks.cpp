@@ -0,0 +1,189 @@
+#include "Benchmark.hpp"
+
+#include <GUI/Utils/ContentIndex.hpp>
+#include <GUI/Utils/ThumbnailAtlas.hpp>
+#include <GUI/Utils/ThumbnailQueue.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace D_CORE;
+using namespace D_GUI_UTILS;
+
+D_BENCHMARK(Thumbnails, AtlasWriteSaveLoad)
+{
+	constexpr uint32_t thumbnails = 4096u;
+	constexpr uint32_t threadCount = 8u;
+
+	auto directory = std::filesystem::temp_directory_path() / "DariusThumbnailBenchmark";
+	std::filesystem::remove_all(directory);
+
+	std::vector<Uuid> uuids;
+	for (uint32_t i = 0u; i < thumbnails; i++)
+		uuids.push_back(GenerateUuid());
+
+	ThumbnailAtlas atlas;
+
+	// The workers allocate and write their slots as the generations finish
+	D_BENCHMARKS::Stopwatch stopwatch;
+	{
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0u; t < threadCount; t++)
+		{
+			threads.emplace_back([&, t]()
+				{
+					std::vector<uint32_t> pixels(atlas.GetSlotSize() * atlas.GetSlotSize(), 0xff000000u | t);
+					for (uint32_t i = t; i < thumbnails; i += threadCount)
+						atlas.WriteSlot(atlas.Allocate(uuids[i]), pixels.data(), atlas.GetSlotSize() * sizeof(uint32_t));
+				});
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+	}
+	auto writeMs = stopwatch.GetMilliseconds();
+
+	// What the upload does for the changed pages
+	stopwatch.Restart();
+	uint64_t checksum = 0u;
+	for (uint32_t page = 0u; page < atlas.GetPageCount(); page++)
+	{
+		if (atlas.ConsumeGpuDirty(page))
+			atlas.ReadPage(page, [&](uint32_t const* pixels) { checksum += pixels[0]; });
+	}
+	auto readMs = stopwatch.GetMilliseconds();
+
+	stopwatch.Restart();
+	D_BENCHMARK_CHECK(atlas.Save(directory));
+	auto saveMs = stopwatch.GetMilliseconds();
+
+	ThumbnailAtlas loaded;
+	stopwatch.Restart();
+	D_BENCHMARK_CHECK(loaded.Load(directory));
+	auto loadMs = stopwatch.GetMilliseconds();
+
+	D_BENCHMARK_CHECK(loaded.GetEntryCount() == thumbnails);
+	D_BENCHMARK_CHECK(checksum > 0u);
+	D_BENCHMARK_REPORT(thumbnails << " thumbnails in " << atlas.GetPageCount() << " pages, write from " << threadCount << " threads: " << writeMs
+		<< " ms, read dirty pages: " << readMs << " ms, save: " << saveMs << " ms, load: " << loadMs << " ms");
+
+	std::filesystem::remove_all(directory);
+}
+
+D_BENCHMARK(Thumbnails, QueueScrolling)
+{
+	constexpr uint32_t requests = 20000u;
+	constexpr uint32_t frames = 500u;
+	constexpr uint32_t visible = 200u;
+	constexpr uint32_t popsPerFrame = 16u;
+
+	std::vector<Uuid> uuids;
+	for (uint32_t i = 0u; i < requests; i++)
+		uuids.push_back(GenerateUuid());
+
+	ThumbnailQueue queue;
+
+	D_BENCHMARKS::Stopwatch stopwatch;
+	for (uint32_t i = 0u; i < requests; i++)
+		queue.Push({ uuids[i], "Thumbnail.png" });
+	auto pushNs = stopwatch.GetNanoseconds() / requests;
+
+	// The visible window scrolls down, its items are drawn and prioritized every frame
+	uint32_t popped = 0u;
+	stopwatch.Restart();
+	for (uint32_t frame = 1u; frame <= frames; frame++)
+	{
+		auto first = (frame * 37u) % (requests - visible);
+		for (uint32_t i = first; i < first + visible; i++)
+			queue.Prioritize(uuids[i], frame);
+
+		for (uint32_t i = 0u; i < popsPerFrame && queue.Pop().has_value(); i++)
+			popped++;
+	}
+	auto frameUs = stopwatch.GetNanoseconds() / 1000. / frames;
+
+	D_BENCHMARK_CHECK(popped == frames * popsPerFrame);
+	D_BENCHMARK_CHECK(queue.GetSize() == requests - popped);
+	D_BENCHMARK_REPORT("Queue of " << requests << ", push: " << pushNs << " ns, per frame with " << visible << " visible items: " << frameUs << " us");
+}
+
+D_BENCHMARK(ContentIndex, Tree100k)
+{
+	constexpr uint32_t directories = 500u;
+	constexpr uint32_t filesPerDirectory = 200u;
+	constexpr uint32_t files = directories * filesPerDirectory;
+
+	char const* extensions[] = { ".png", ".fbx", ".mat", ".tga", ".wav" };
+
+	auto root = std::filesystem::temp_directory_path() / "DariusContentIndexBenchmark";
+	std::filesystem::remove_all(root);
+
+	std::vector<D_FILE::Path> paths;
+	paths.reserve(files);
+	for (uint32_t d = 0u; d < directories; d++)
+	{
+		auto directory = root / ("Folder" + std::to_string(d / 25u)) / ("Assets" + std::to_string(d));
+		for (uint32_t f = 0u; f < filesPerDirectory; f++)
+			paths.push_back(directory / ("Asset_" + std::to_string(d) + "_" + std::to_string(f) + extensions[f % 5u]));
+	}
+
+	// Incremental, as the file watcher feeds it
+	ContentIndex index;
+	index.Reset(root);
+	D_BENCHMARKS::Stopwatch stopwatch;
+	for (auto const& path : paths)
+		index.Add(path, false);
+	auto addMs = stopwatch.GetMilliseconds();
+
+	auto snapshot = index.GetSnapshot();
+	D_BENCHMARK_CHECK(snapshot.GetFileCount() == files);
+
+	// Opening a directory
+	D_CONTAINERS::DVector<ContentIndex::NodeId> result;
+	ContentIndex::Filter filter;
+	filter.Extensions = { ".png" };
+	auto directory = snapshot.Find(paths[files / 2u].parent_path());
+	stopwatch.Restart();
+	for (int i = 0; i < 100; i++)
+		snapshot.GetChildren(directory, filter, result);
+	auto childrenUs = stopwatch.GetNanoseconds() / 1000. / 100.;
+	D_BENCHMARK_CHECK(result.size() == filesPerDirectory / 5u);
+
+	// Typing in the search box
+	stopwatch.Restart();
+	for (auto query : { "as", "ass", "asset_1", "asset_12", "asset_123_4" })
+		snapshot.Search(query, snapshot.GetRoot(), {}, result, 1000u);
+	auto searchUs = stopwatch.GetNanoseconds() / 1000. / 5.;
+	D_BENCHMARK_CHECK(!result.empty());
+
+	// Modifying while a reader holds the snapshot copies the data once
+	stopwatch.Restart();
+	index.Rename(root / "Folder0", root / "Moved");
+	auto copyingRenameMs = stopwatch.GetMilliseconds();
+
+	snapshot = {};
+	stopwatch.Restart();
+	index.Rename(root / "Moved", root / "Folder0");
+	auto renameMs = stopwatch.GetMilliseconds();
+
+	// Full scan of the same tree on disk
+	for (auto const& path : paths)
+	{
+		std::filesystem::create_directories(path.parent_path());
+		std::ofstream(path).put('\0');
+	}
+
+	ContentIndex scanned;
+	stopwatch.Restart();
+	scanned.Build(root);
+	auto buildMs = stopwatch.GetMilliseconds();
+	D_BENCHMARK_CHECK(scanned.GetSnapshot().GetFileCount() == files);
+
+	D_BENCHMARK_REPORT(files << " files, add: " << addMs << " ms, scan from disk: " << buildMs << " ms");
+	D_BENCHMARK_REPORT("Filtered children: " << childrenUs << " us, search: " << searchUs << " us, rename of "
+		<< 25u * filesPerDirectory << " files: " << renameMs << " ms, " << copyingRenameMs << " ms with a snapshot alive");
+
+	std::filesystem::remove_all(root);
+}
@@ -0,0 +1,34 @@
+#include "Benchmark.hpp"
+
+#include <GraphicsUtils/Profiling/EventProfiler.hpp>
+
+using namespace D_CONTAINERS;
+using namespace D_PROFILING;
+
+D_BENCHMARK(Profiling, ScopeOverhead)
+{
+	constexpr uint32_t batches = 100u;
+	constexpr uint32_t batchSize = 10000u;
+
+	auto scope = InternScope(L"Overhead");
+	DVector<CapturedEvent> events;
+	events.reserve(batchSize * 2u);
+
+	double totalNs = 0.;
+	for (uint32_t b = 0u; b < batches; b++)
+	{
+		D_BENCHMARKS::Stopwatch stopwatch;
+		for (uint32_t i = 0u; i < batchSize; i++)
+		{
+			RecordBegin(scope);
+			RecordEnd();
+		}
+		totalNs += stopwatch.GetNanoseconds();
+
+		events.clear();
+		DrainEvents(events);
+		D_BENCHMARK_CHECK(events.size() == batchSize * 2u);
+	}
+
+	D_BENCHMARK_REPORT("Profiling scope overhead: " << totalNs / (batches * batchSize) << " ns");
+}
@@ -0,0 +1,173 @@
+#include "Benchmark.hpp"
+
+#include <Core/Memory/Allocators/PagedAllocator.hpp>
+#include <Core/Memory/Allocators/SlabAllocator.hpp>
+#include <Math/Bounds/DynamicBVH.hpp>
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// Same size as a bvh node of a pointer payload
+	struct AllocatorBenchmarkNode
+	{
+		float							Volume[8];
+		void*							Children[2];
+		void*							Parent;
+		void*							Data;
+	};
+
+	template<typename Allocator>
+	double MeasureAllocator(Allocator& allocator, uint32_t threadCount)
+	{
+		constexpr uint32_t rounds = 2000u;
+		constexpr uint32_t batch = 256u;
+
+		D_BENCHMARKS::Stopwatch stopwatch;
+
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0u; t < threadCount; t++)
+		{
+			threads.emplace_back([&]()
+				{
+					AllocatorBenchmarkNode* nodes[batch];
+					for (uint32_t r = 0u; r < rounds; r++)
+					{
+						for (uint32_t i = 0u; i < batch; i++)
+							nodes[i] = allocator.Alloc();
+						for (uint32_t i = 0u; i < batch; i++)
+							allocator.Free(nodes[i]);
+					}
+				});
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+
+		return stopwatch.GetNanoseconds() / ((double)threadCount * rounds * batch);
+	}
+
+	using BenchmarkBVH = D_MATH_BOUNDS::DynamicBVH<uint32_t>;
+
+	D_MATH_BOUNDS::Aabb GetBoxAt(D_MATH::Vector3 const& center)
+	{
+		return D_MATH_BOUNDS::Aabb(center - D_MATH::Vector3(1.f), center + D_MATH::Vector3(1.f));
+	}
+
+	struct MovingLeaves
+	{
+		std::vector<BenchmarkBVH::ID>	Ids;
+		std::vector<D_MATH::Vector3>	Positions;
+
+		MovingLeaves(BenchmarkBVH& bvh, uint32_t count)
+		{
+			for (uint32_t i = 0u; i < count; i++)
+			{
+				auto position = D_MATH::Vector3((float)(i % 97u), (float)((i / 97u) % 89u), (float)(i / (97u * 89u))) * 4.f;
+				Positions.push_back(position);
+				Ids.push_back(bvh.Insert(GetBoxAt(position), i));
+			}
+		}
+
+		// Moves every step-th leaf
+		void Move(uint32_t step, float offset, std::vector<BenchmarkBVH::LeafUpdate>& updates)
+		{
+			updates.clear();
+			for (uint32_t i = 0u; i < Ids.size(); i += step)
+			{
+				Positions[i] += D_MATH::Vector3(offset, -offset, offset * 0.5f);
+				updates.push_back({ Ids[i], GetBoxAt(Positions[i]) });
+			}
+		}
+	};
+}
+
+// Bvh node allocators
+D_BENCHMARK(NodeAllocator, SlabAgainstPaged)
+{
+	constexpr uint32_t threadCount = 8u;
+
+	D_MEMORY::PagedAllocator<AllocatorBenchmarkNode, true> paged;
+	D_MEMORY::SlabAllocator<AllocatorBenchmarkNode> slab;
+
+	auto pagedTime = MeasureAllocator(paged, threadCount);
+	auto slabTime = MeasureAllocator(slab, threadCount);
+
+	D_BENCHMARK_REPORT("Alloc and free from " << threadCount << " threads, paged: " << pagedTime << " ns, slab: " << slabTime << " ns");
+	D_BENCHMARK_CHECK(slab.GetAliveCount() == 0);
+}
+
+// Updating leaves one by one and in a batch
+D_BENCHMARK(DynamicBVH, BatchAgainstSingleUpdates)
+{
+	constexpr uint32_t leafCount = 100000u;
+	constexpr uint32_t frames = 5u;
+
+	for (uint32_t step : { 100u, 10u, 1u })
+	{
+		BenchmarkBVH single;
+		BenchmarkBVH batched;
+		MovingLeaves singleLeaves(single, leafCount);
+		MovingLeaves batchedLeaves(batched, leafCount);
+		std::vector<BenchmarkBVH::LeafUpdate> updates;
+
+		double singleTime = 0.;
+		double batchedTime = 0.;
+		for (uint32_t frame = 0u; frame < frames; frame++)
+		{
+			singleLeaves.Move(step, 0.5f, updates);
+			D_BENCHMARKS::Stopwatch stopwatch;
+			for (auto const& update : updates)
+				single.Update(update.Id, update.Box);
+			singleTime += stopwatch.GetMilliseconds();
+
+			batchedLeaves.Move(step, 0.5f, updates);
+			stopwatch.Restart();
+			batched.UpdateBatch(updates.data(), (int)updates.size());
+			batchedTime += stopwatch.GetMilliseconds();
+		}
+
+		D_BENCHMARK_REPORT(100u / step << "% of " << leafCount << " leaves moving, single: " << singleTime / frames << " ms, batched: " << batchedTime / frames
+			<< " ms per frame, sah cost single: " << single.GetSahCost() << ", batched: " << batched.GetSahCost());
+		D_BENCHMARK_CHECK(batched.GetLeafCount() == (int)leafCount);
+	}
+}
+
+// Rebuilding one tree on the calling thread and split among threads, and refitting it after every leaf moved
+D_BENCHMARK(DynamicBVH, RebuildAgainstRefit)
+{
+	constexpr uint32_t leafCount = 100000u;
+
+	BenchmarkBVH serial;
+	BenchmarkBVH parallel;
+	MovingLeaves serialLeaves(serial, leafCount);
+	MovingLeaves parallelLeaves(parallel, leafCount);
+	parallel.SetForkJoin([](std::function<void()> const& first, std::function<void()> const& second)
+		{
+			std::thread thread(first);
+			second();
+			thread.join();
+		});
+
+	D_BENCHMARKS::Stopwatch stopwatch;
+	serial.Rebuild();
+	auto serialMs = stopwatch.GetMilliseconds();
+
+	stopwatch.Restart();
+	parallel.Rebuild();
+	auto parallelMs = stopwatch.GetMilliseconds();
+
+	// Same splits either way
+	D_BENCHMARK_CHECK(serial.GetSahCost() == parallel.GetSahCost());
+
+	std::vector<BenchmarkBVH::LeafUpdate> updates;
+	serialLeaves.Move(1u, 0.5f, updates);
+	stopwatch.Restart();
+	serial.UpdateBatch(updates.data(), (int)updates.size());
+	auto refitMs = stopwatch.GetMilliseconds();
+
+	D_BENCHMARK_REPORT(leafCount << " leaves, binned sah rebuild: " << serialMs << " ms, split among threads: " << parallelMs
+		<< " ms, refit after all moved: " << refitMs << " ms, sah cost " << serial.GetSahCost() << " built " << serial.GetBuiltSahCost());
+}
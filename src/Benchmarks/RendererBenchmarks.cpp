@@ -0,0 +1,155 @@
+#include "Benchmark.hpp"
+
+#include <Math/Transform.hpp>
+#include <Math/Camera/Frustum.hpp>
+#include <Renderer/Geometry/TerrainQuadTree.hpp>
+#include <Renderer/Resources/MipResidencyPolicy.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace D_CONTAINERS;
+using namespace D_MATH;
+using namespace D_RENDERER;
+using namespace D_RENDERER_GEOMETRY;
+
+namespace
+{
+	// Square RGBA8 texture with its mips up to the tail always resident
+	MipResidencyPolicy::Entry CreateMipEntry(uint32_t size, uint32_t tailSize = 64u)
+	{
+		MipResidencyPolicy::Entry entry;
+
+		DVector<uint64_t> mipSizes;
+		for (uint32_t s = size; s > 0u; s >>= 1)
+		{
+			mipSizes.push_back((uint64_t)s * s * 4u);
+			if (s > tailSize)
+				entry.TailMip++;
+		}
+
+		entry.SizeFromMip.resize(mipSizes.size());
+		uint64_t total = 0u;
+		for (size_t i = mipSizes.size(); i-- > 0u;)
+		{
+			total += mipSizes[i];
+			entry.SizeFromMip[i] = total;
+		}
+
+		entry.ResidentMip = entry.TargetMip = entry.RequestedMip = entry.TailMip;
+		return entry;
+	}
+}
+
+D_BENCHMARK(TerrainQuadTree, HeightMap16k)
+{
+	constexpr uint32_t samples = 16385u;
+	constexpr uint32_t cameraSteps = 64u;
+
+	// Rolling hills, so that the node height ranges differ
+	std::vector<float> heights((size_t)samples * samples);
+	for (uint32_t y = 0u; y < samples; y++)
+		for (uint32_t x = 0u; x < samples; x++)
+			heights[(size_t)y * samples + x] = 0.5f + 0.25f * std::sin(x * 0.003f) * std::cos(y * 0.002f) + 0.05f * std::sin((x + y) * 0.05f);
+
+	TerrainQuadTree::Config config;
+	config.LodLevelCount = 9u;
+	config.FinestLodDistance = 30.f;
+	config.Width = 16384.f;
+	config.Depth = 16384.f;
+	config.HeightScale = 1000.f;
+
+	TerrainQuadTree tree;
+	D_BENCHMARKS::Stopwatch stopwatch;
+	tree.Build(heights.data(), samples, samples, config);
+	auto buildMs = stopwatch.GetMilliseconds();
+
+	D_BENCHMARK_CHECK(tree.GetLeavesPerSide() == 256u);
+
+	// The camera flies over the terrain looking along -Z
+	auto viewFrustum = D_MATH_CAMERA::Frustum(Matrix4::MakeProjection(DirectX::XM_PIDIV4, 16.f / 9.f, 0.1f, 20000.f));
+
+	D_CONTAINERS::DVector<TerrainQuadTree::SelectedNode> selection;
+	double unculledUs = 0., culledUs = 0.;
+	uint64_t unculledNodes = 0u, culledNodes = 0u;
+	for (uint32_t step = 0u; step < cameraSteps; step++)
+	{
+		auto t = (float)step / (cameraSteps - 1u);
+		TerrainQuadTree::SelectionParams params;
+		params.CameraPosition = Vector3(-8000.f + 16000.f * t, 600.f, 8000.f - 16000.f * t);
+
+		selection.clear();
+		stopwatch.Restart();
+		unculledNodes += tree.Select(params, selection);
+		unculledUs += stopwatch.GetNanoseconds() / 1000.;
+
+		auto frustum = OrthogonalTransform(params.CameraPosition) * viewFrustum;
+		params.Frustum = &frustum;
+
+		selection.clear();
+		stopwatch.Restart();
+		culledNodes += tree.Select(params, selection);
+		culledUs += stopwatch.GetNanoseconds() / 1000.;
+	}
+
+	D_BENCHMARK_CHECK(culledNodes <= unculledNodes);
+	D_BENCHMARK_REPORT(samples << "x" << samples << " height map, " << tree.GetNodeCount() << " nodes built in " << buildMs << " ms");
+	D_BENCHMARK_REPORT("Selection without culling: " << unculledUs / cameraSteps << " us for " << unculledNodes / cameraSteps
+		<< " nodes, with frustum culling: " << culledUs / cameraSteps << " us for " << culledNodes / cameraSteps << " nodes");
+}
+
+// Camera moving over the streamed textures, the loads finishing as soon as they are decided
+D_BENCHMARK(MipResidencyPolicy, Simulation)
+{
+	constexpr uint32_t textureCount = 10000u;
+	constexpr uint32_t visibleCount = 500u;
+	constexpr uint32_t frames = 2000u;
+
+	DVector<MipResidencyPolicy::Entry> entries;
+	uint64_t tails = 0u;
+	for (uint32_t i = 0u; i < textureCount; i++)
+	{
+		entries.push_back(CreateMipEntry(i % 3 == 0 ? 2048u : 1024u));
+		tails += entries.back().GetSize(entries.back().TailMip);
+	}
+
+	// Room for the visible textures at their largest
+	MipResidencyPolicy policy(tails + visibleCount * entries[0].GetSize(0u), 30u, 32u);
+
+	DVector<MipResidencyPolicy::Decision> decisions;
+	uint64_t loads = 0u;
+	bool overBudget = false;
+	double evaluateUs = 0., worstUs = 0.;
+	D_BENCHMARKS::Stopwatch stopwatch;
+	for (uint64_t frame = 1u; frame <= frames; frame++)
+	{
+		// Window of visible textures moves every 50 frames
+		uint32_t first = (uint32_t)(frame / 50u) * 173u % textureCount;
+		for (uint32_t i = 0u; i < visibleCount; i++)
+		{
+			auto& entry = entries[(first + i) % textureCount];
+			entry.RequestedMip = i % 4u;
+			entry.LastUsedFrame = frame;
+		}
+
+		stopwatch.Restart();
+		policy.Evaluate(entries, frame, decisions);
+		auto us = stopwatch.GetNanoseconds() / 1000.;
+		evaluateUs += us;
+		worstUs = std::max(worstUs, us);
+
+		for (auto const& decision : decisions)
+		{
+			if (decision.TargetMip < entries[decision.Entry].ResidentMip)
+				loads++;
+			entries[decision.Entry].ResidentMip = entries[decision.Entry].TargetMip = decision.TargetMip;
+		}
+
+		overBudget |= MipResidencyPolicy::GetCommittedSize(entries) > policy.GetBudget();
+	}
+
+	D_BENCHMARK_CHECK(!overBudget);
+	D_BENCHMARK_REPORT(textureCount << " textures, " << visibleCount << " visible: evaluate " << evaluateUs / frames << " us per frame, worst "
+		<< worstUs << " us, " << loads << " loads in " << frames << " frames");
+}
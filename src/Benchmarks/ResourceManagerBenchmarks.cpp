@@ -0,0 +1,71 @@
+#include "Benchmark.hpp"
+
+#include <ResourceManager/ResidencyTracker.hpp>
+
+#include <deque>
+
+using namespace D_RESOURCE;
+
+namespace
+{
+	// Stands in for a resource, evicted on the first request
+	struct FakeResource
+	{
+		FakeResource(uint16_t type, uint64_t size) :
+			Residency(this),
+			Type(type),
+			Size(size)
+		{ }
+
+		ResidencyTracker::Entry	Residency;
+		uint16_t				Type;
+		uint64_t				Size;
+		bool					Loaded = true;
+	};
+}
+
+D_BENCHMARK(ResidencyTracker, BookkeepingCost)
+{
+	constexpr uint32_t count = 100000u;
+	constexpr uint32_t rounds = 10u;
+
+	uint32_t evictions = 0u;
+	ResidencyTracker tracker([&evictions](ResidencyTracker::Entry& entry)
+		{
+			auto& resource = *static_cast<FakeResource*>(entry.GetOwner());
+			if (!resource.Loaded)
+				return ResidencyTracker::EvictResult::InUse;
+
+			resource.Loaded = false;
+			evictions++;
+			return ResidencyTracker::EvictResult::Evicted;
+		}, [](uint16_t) { return ~0ull; }, 0u);
+
+	std::deque<FakeResource> resources;
+	for (uint32_t i = 0u; i < count; i++)
+		resources.emplace_back((uint16_t)(i % 8u + 1u), 1024u);
+
+	// Releasing and releasing again, which moves within the lists
+	D_BENCHMARKS::Stopwatch stopwatch;
+	for (uint32_t round = 0u; round < rounds; round++)
+		for (auto& resource : resources)
+			tracker.MarkUnused(resource.Residency, resource.Type, resource.Size);
+	auto releaseTime = stopwatch.GetNanoseconds() / ((double)count * rounds);
+
+	// Within budget, the frame update only looks at the type totals
+	stopwatch.Restart();
+	for (uint32_t frame = 1u; frame <= 1000u; frame++)
+		tracker.Update(frame);
+	auto updateTime = stopwatch.GetNanoseconds() / 1000u;
+
+	for (uint16_t type = 1u; type <= 8u; type++)
+		tracker.SetBudget(type, 0u);
+
+	stopwatch.Restart();
+	tracker.Update(1001u);
+	auto evictTime = stopwatch.GetNanoseconds() / count;
+
+	D_BENCHMARK_CHECK(evictions == count);
+	D_BENCHMARK_REPORT("Residency bookkeeping: release " << releaseTime << " ns, frame update within budget " << updateTime
+		<< " ns, eviction " << evictTime << " ns");
+}
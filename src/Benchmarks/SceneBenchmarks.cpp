@@ -0,0 +1,663 @@
+#include "Benchmark.hpp"
+
+#include <Core/Serialization/Json.hpp>
+#include <Core/TimeManager/SystemTime.hpp>
+#include <Job/Job.hpp>
+#include <Scene/EntityComponentSystem/Components/BehaviourComponent.hpp>
+#include <Scene/EntityComponentSystem/Components/TransformComponent.hpp>
+#include <Scene/GameObject.hpp>
+#include <Scene/Scene.hpp>
+#include <Scene/Streaming/SceneStreamer.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+using namespace D_CONTAINERS;
+using namespace D_SCENE;
+
+namespace
+{
+	// The scene is brought up by the first scene benchmark and shared by the others, each
+	// clearing it when done
+	struct SceneBenchmarkScope
+	{
+		SceneBenchmarkScope()
+		{
+			static bool initialized = false;
+			if (initialized)
+				return;
+
+			D_TIME::SystemTime::Initialize();
+			D_JOB::Initialize(D_SERIALIZATION::Json());
+			D_WORLD::Initialize();
+			std::atexit([]()
+				{
+					D_WORLD::Shutdown();
+					D_JOB::Shutdown();
+				});
+			initialized = true;
+		}
+
+		~SceneBenchmarkScope()
+		{
+			D_WORLD::ClearScene();
+		}
+	};
+
+	// Roots with full trees of the given depth under them, at distinct positions
+	DVector<GameObject*> CreateHierarchies(UINT rootCount, UINT depth, UINT childCount, bool addToScene = true)
+	{
+		DVector<GameObject*> roots;
+		DVector<GameObject*> level;
+		UINT index = 0u;
+
+		for (UINT i = 0u; i < rootCount; i++)
+		{
+			auto root = D_WORLD::CreateGameObject(addToScene);
+			root->GetTransform()->SetLocalPosition(D_MATH::Vector3((float)index++, 0.f, 0.f));
+			roots.push_back(root);
+			level.push_back(root);
+		}
+
+		for (UINT d = 0u; d < depth; d++)
+		{
+			DVector<GameObject*> next;
+			for (auto parent : level)
+			{
+				for (UINT c = 0u; c < childCount; c++)
+				{
+					auto child = D_WORLD::CreateGameObject(addToScene);
+					child->SetParent(parent, GameObject::AttachmentType::KeepLocal);
+					child->GetTransform()->SetLocalPosition(D_MATH::Vector3(0.f, (float)index++, (float)d));
+					next.push_back(child);
+				}
+			}
+			level = std::move(next);
+		}
+
+		D_WORLD::FlushTransformChanges();
+		return roots;
+	}
+
+	// Stands in for the spacial proxies, which were notified of each object on its own
+	struct WorldChangeCounter
+	{
+		void OnWorldChanged(D_MATH::TransformComponent*, D_MATH::Transform const&)
+		{
+			Count++;
+		}
+
+		UINT							Count = 0u;
+	};
+
+	// Behaviours advancing a state depending on nothing but themselves
+#define D_BENCHMARK_BEHAVIOUR(type) \
+	class type : public D_ECS_COMP::BehaviourComponent \
+	{ \
+		D_H_BEHAVIOUR_COMP_BODY(type, D_ECS_COMP::BehaviourComponent, "Benchmarks/" #type, false, false); \
+	public: \
+		virtual void Update(float deltaTime) override { State = State * 6364136223846793005ull + (uint64_t)(deltaTime * 1000.f) + 1ull; } \
+		uint64_t					State = 0u; \
+	}; \
+	D_H_BEHAVIOUR_COMP_DEF(type); \
+	D_H_COMP_DEFAULT_CONSTRUCTOR_DEF_PAR(type, D_ECS_COMP::BehaviourComponent);
+
+	D_BENCHMARK_BEHAVIOUR(BenchmarkBehaviour0)
+	D_BENCHMARK_BEHAVIOUR(BenchmarkBehaviour1)
+	D_BENCHMARK_BEHAVIOUR(BenchmarkBehaviour2)
+	D_BENCHMARK_BEHAVIOUR(BenchmarkBehaviour3)
+	D_BENCHMARK_BEHAVIOUR(BenchmarkBehaviour4)
+	D_BENCHMARK_BEHAVIOUR(BenchmarkBehaviour5)
+	D_BENCHMARK_BEHAVIOUR(BenchmarkBehaviour6)
+	D_BENCHMARK_BEHAVIOUR(BenchmarkBehaviour7)
+	D_BENCHMARK_BEHAVIOUR(BenchmarkBehaviour8)
+	D_BENCHMARK_BEHAVIOUR(BenchmarkBehaviour9)
+
+	template<class... COMPS>
+	struct BehaviourTypes
+	{
+		static constexpr UINT		Count = sizeof...(COMPS);
+
+		static void Register()
+		{
+			(COMPS::StaticConstructor(), ...);
+		}
+
+		static void Add(GameObject* go, UINT typeIndex)
+		{
+			UINT i = 0u;
+			((i++ == typeIndex ? (void)go->AddComponent<COMPS>() : (void)0), ...);
+		}
+
+		static void UpdateThroughQueries(float deltaTime)
+		{
+			(D_WORLD::UpdateBehaviours<COMPS>(deltaTime, false), ...);
+		}
+
+		// The way each type was updated before, iterating the world with a new filter every frame
+		static void UpdateThroughEach(float deltaTime)
+		{
+			auto world = D_WORLD::GetRoot().world();
+			(world.each([deltaTime](COMPS& comp)
+				{
+					if (comp.IsStarted() && comp.IsActive())
+						comp.Update(deltaTime);
+				}), ...);
+		}
+	};
+
+	using BenchmarkBehaviours = BehaviourTypes<BenchmarkBehaviour0, BenchmarkBehaviour1, BenchmarkBehaviour2, BenchmarkBehaviour3, BenchmarkBehaviour4,
+		BenchmarkBehaviour5, BenchmarkBehaviour6, BenchmarkBehaviour7, BenchmarkBehaviour8, BenchmarkBehaviour9>;
+
+	// Behaviours loaded on the main thread or on the workers. Having no reflected properties, they measure what
+	// deferring the deserialization costs and saves apart from the properties themselves.
+#define D_BENCHMARK_LOADED_BEHAVIOUR(type, parallel) \
+	class type : public D_ECS_COMP::BehaviourComponent \
+	{ \
+		D_H_BEHAVIOUR_COMP_BODY(type, D_ECS_COMP::BehaviourComponent, "Benchmarks/" #type, false, false); \
+	public: \
+		static constexpr bool		ParallelDeserialization = parallel; \
+	}; \
+	D_H_BEHAVIOUR_COMP_DEF(type); \
+	D_H_COMP_DEFAULT_CONSTRUCTOR_DEF_PAR(type, D_ECS_COMP::BehaviourComponent);
+
+	D_BENCHMARK_LOADED_BEHAVIOUR(SeriallyLoadedBehaviour, false)
+	D_BENCHMARK_LOADED_BEHAVIOUR(ParallelLoadedBehaviour, true)
+
+	// The way descendants were visited before the links, collecting the children of each object from flecs
+	void VisitDescendantsThroughFlecs(GameObject const* go, std::function<void(GameObject*)> const& callback)
+	{
+		DVector<GameObject*> children;
+		go->GetEntity().children([&children](D_ECS::Entity child)
+			{
+				children.push_back(D_WORLD::GetGameObject(child));
+			});
+
+		for (auto child : children)
+		{
+			callback(child);
+			VisitDescendantsThroughFlecs(child, callback);
+		}
+	}
+
+	// Deletes the objects and removes them from the scene right away, without a removal budget
+	double DeleteAndRemove(std::function<void()> const& deleteObjects)
+	{
+		D_WORLD::SetDeletionBudget(1e9);
+
+		D_BENCHMARKS::Stopwatch stopwatch;
+		deleteObjects();
+		D_WORLD::Update(0.f);
+		auto time = stopwatch.GetMilliseconds();
+
+		D_WORLD::SetDeletionBudget(1.);
+		return time;
+	}
+
+	UINT CountGameObjects()
+	{
+		DVector<GameObject*> gos;
+		D_WORLD::GetGameObjects(gos);
+		return (UINT)gos.size();
+	}
+
+	struct DeletionFrames
+	{
+		UINT							Count = 0u;
+		double							Worst = 0.;
+		double							Total = 0.;
+	};
+
+	// Deletes the objects on the first frame and updates the scene until they are all removed
+	DeletionFrames DeleteOverFrames(DVector<GameObject*> const& gos, UINT remaining, double budgetMs)
+	{
+		D_WORLD::SetDeletionBudget(budgetMs);
+
+		DeletionFrames frames;
+		D_BENCHMARKS::Stopwatch stopwatch;
+		D_WORLD::DeleteGameObjects(gos);
+		do
+		{
+			D_WORLD::Update(0.f);
+			auto time = stopwatch.GetMilliseconds();
+
+			frames.Worst = std::max(frames.Worst, time);
+			frames.Total += time;
+			frames.Count++;
+			stopwatch.Restart();
+		} while (CountGameObjects() > remaining && frames.Count < 100000u);
+
+		D_WORLD::SetDeletionBudget(1.);
+		return frames;
+	}
+
+	// Position, rotation and scale in a row, the way movement code sets them
+	void MoveObjects(DVector<GameObject*> const& gos, UINT frame)
+	{
+		for (UINT i = 0u; i < gos.size(); i++)
+		{
+			auto trans = gos[i]->GetTransform();
+			trans->SetLocalPosition(D_MATH::Vector3((float)frame, (float)i, 0.f));
+			trans->SetLocalRotation(D_MATH::Quaternion(D_MATH::Vector3::Up, (float)frame * 0.01f));
+			trans->SetLocalScale(D_MATH::Vector3(1.f + (float)frame * 0.001f));
+		}
+	}
+}
+
+D_BENCHMARK(PrefabTemplate, SpawnAgainstJson)
+{
+	constexpr UINT spawnCount = 10000u;
+
+	SceneBenchmarkScope scope;
+
+	// A prefab out of the scene, a root with 3 children and 9 grandchildren
+	auto prefab = CreateHierarchies(1u, 2u, 3u, false).front();
+
+	// Before the templates, each spawn dumped the prefab and loaded the dump
+	D_BENCHMARKS::Stopwatch stopwatch;
+	for (UINT i = 0u; i < spawnCount; i++)
+	{
+		D_SERIALIZATION::Json json;
+		GameObject* copy = nullptr;
+		D_WORLD::DumpGameObject(prefab, json, true);
+		D_WORLD::LoadGameObject(json, &copy, true);
+	}
+	auto jsonTime = stopwatch.GetMilliseconds();
+
+	// One at a time, compiling the template on the first spawn only
+	stopwatch.Restart();
+	for (UINT i = 0u; i < spawnCount; i++)
+		D_WORLD::InstantiateGameObject(prefab);
+	auto singleTime = stopwatch.GetMilliseconds();
+
+	DVector<GameObject*> copies;
+	stopwatch.Restart();
+	D_WORLD::InstantiateGameObjects(prefab, spawnCount, copies);
+	auto batchTime = stopwatch.GetMilliseconds();
+
+	D_BENCHMARK_REPORT(spawnCount << " spawns of 13 objects: json " << jsonTime << " ms, template one by one " << singleTime
+		<< " ms, template batch " << batchTime << " ms (" << jsonTime / batchTime << "x)");
+
+	D_BENCHMARK_CHECK(copies.size() == spawnCount);
+	D_BENCHMARK_CHECK(copies.back()->GetPrefab() == prefab->GetUuid());
+}
+
+D_BENCHMARK(TransformChanges, QueuedAgainstPerObjectSignals)
+{
+	constexpr UINT objectCount = 100000u;
+	constexpr UINT frameCount = 10u;
+
+	SceneBenchmarkScope scope;
+
+	DVector<GameObject*> gos;
+	D_WORLD::CreateGameObjects(objectCount, gos);
+	D_WORLD::FlushTransformChanges();
+
+	// Each setter used to fire the signal of its transform, each object having its own subscriber.
+	// Fired by hand after each setter here, which also queue the change as they do now.
+	WorldChangeCounter perObject;
+	DVector<D_CORE::SignalConnection> connections;
+	connections.reserve(objectCount);
+	for (auto go : gos)
+		connections.push_back(go->GetTransform()->mWorldChanged.ConnectGenericObject(&perObject, &WorldChangeCounter::OnWorldChanged));
+
+	double perObjectTime = 0.;
+	for (UINT frame = 0u; frame < frameCount; frame++)
+	{
+		D_BENCHMARKS::Stopwatch stopwatch;
+		for (UINT i = 0u; i < gos.size(); i++)
+		{
+			auto trans = gos[i]->GetTransform();
+			trans->SetLocalPosition(D_MATH::Vector3((float)frame, (float)i, 0.f));
+			trans->mWorldChanged(trans, trans->GetTransformData());
+			trans->SetLocalRotation(D_MATH::Quaternion(D_MATH::Vector3::Up, (float)frame * 0.01f));
+			trans->mWorldChanged(trans, trans->GetTransformData());
+			trans->SetLocalScale(D_MATH::Vector3(1.f + (float)frame * 0.001f));
+			trans->mWorldChanged(trans, trans->GetTransformData());
+		}
+		perObjectTime += stopwatch.GetMilliseconds();
+
+		// Left out of the timing, the queued changes would not have been there
+		D_WORLD::FlushTransformChanges();
+	}
+
+	auto perObjectCount = perObject.Count;
+	for (auto& connection : connections)
+		connection.disconnect();
+
+	// Now the changes are queued and handed over once a frame, to a single subscriber
+	UINT delivered = 0u;
+	D_CORE::SignalScopedConnection batchConnection = D_WORLD::OnTransformsChanged.connect([&delivered](std::span<GameObject* const> changed)
+		{
+			delivered += (UINT)changed.size();
+		});
+
+	double queuedTime = 0.;
+	for (UINT frame = 0u; frame < frameCount; frame++)
+	{
+		D_BENCHMARKS::Stopwatch stopwatch;
+		MoveObjects(gos, frame + frameCount);
+		D_WORLD::FlushTransformChanges();
+		queuedTime += stopwatch.GetMilliseconds();
+	}
+
+	D_BENCHMARK_REPORT("Moving " << objectCount << " objects: per object signals " << perObjectTime / frameCount << " ms per frame, queued and flushed "
+		<< queuedTime / frameCount << " ms per frame");
+	D_BENCHMARK_REPORT("Notifications: " << perObjectCount << " per object, " << delivered << " batched");
+
+	D_BENCHMARK_CHECK(perObjectCount >= 3u * objectCount * frameCount);
+	D_BENCHMARK_CHECK(delivered == objectCount * frameCount);
+}
+
+D_BENCHMARK(BehaviourUpdates, CachedQueriesAgainstEach)
+{
+	constexpr UINT componentCount = 100000u;
+	constexpr UINT frameCount = 100u;
+
+	SceneBenchmarkScope scope;
+	BenchmarkBehaviours::Register();
+
+	DVector<GameObject*> gos;
+	D_WORLD::CreateGameObjects(componentCount, gos);
+	for (UINT i = 0u; i < componentCount; i++)
+	{
+		BenchmarkBehaviours::Add(gos[i], i % BenchmarkBehaviours::Count);
+		gos[i]->Start();
+	}
+
+	// Warming up both, the queries are created on their first update
+	BenchmarkBehaviours::UpdateThroughEach(0.01f);
+	BenchmarkBehaviours::UpdateThroughQueries(0.01f);
+
+	D_BENCHMARKS::Stopwatch stopwatch;
+	for (UINT frame = 0u; frame < frameCount; frame++)
+		BenchmarkBehaviours::UpdateThroughEach(0.01f);
+	auto eachTime = stopwatch.GetMilliseconds() / frameCount;
+
+	stopwatch.Restart();
+	for (UINT frame = 0u; frame < frameCount; frame++)
+		BenchmarkBehaviours::UpdateThroughQueries(0.01f);
+	auto queryTime = stopwatch.GetMilliseconds() / frameCount;
+
+	D_BENCHMARK_REPORT(componentCount << " behaviours of " << BenchmarkBehaviours::Count << " types: world each " << eachTime
+		<< " ms per frame, cached queries " << queryTime << " ms per frame");
+
+	// Both paths update every behaviour the same number of times
+	auto first = gos[0]->GetComponent<BenchmarkBehaviour0>();
+	auto last = gos[BenchmarkBehaviours::Count]->GetComponent<BenchmarkBehaviour0>();
+	D_BENCHMARK_CHECK(first->State != 0u);
+	D_BENCHMARK_CHECK(first->State == last->State);
+}
+
+D_BENCHMARK(Hierarchy, LinksAgainstFlecsChildren)
+{
+	constexpr UINT rounds = 20u;
+
+	SceneBenchmarkScope scope;
+
+	// 1000 trees of 85 objects
+	auto roots = CreateHierarchies(1000u, 3u, 4u);
+
+	UINT flecsCount = 0u;
+	D_BENCHMARKS::Stopwatch stopwatch;
+	for (UINT round = 0u; round < rounds; round++)
+		for (auto root : roots)
+			VisitDescendantsThroughFlecs(root, [&flecsCount](GameObject*) { flecsCount++; });
+	auto flecsTime = stopwatch.GetMilliseconds() / rounds;
+
+	UINT visitCount = 0u;
+	stopwatch.Restart();
+	for (UINT round = 0u; round < rounds; round++)
+		for (auto root : roots)
+			root->VisitDescendants([&visitCount](GameObject*) { visitCount++; });
+	auto visitTime = stopwatch.GetMilliseconds() / rounds;
+
+	UINT iteratorCount = 0u;
+	stopwatch.Restart();
+	for (UINT round = 0u; round < rounds; round++)
+		for (auto root : roots)
+			for (auto desc : root->GetDescendants())
+				iteratorCount += desc != nullptr;
+	auto iteratorTime = stopwatch.GetMilliseconds() / rounds;
+
+	D_BENCHMARK_REPORT("Visiting " << flecsCount / rounds << " descendants: flecs children " << flecsTime << " ms, linked VisitDescendants "
+		<< visitTime << " ms, DescendantIterator " << iteratorTime << " ms");
+
+	D_BENCHMARK_CHECK(flecsCount == rounds * 1000u * (4u + 16u + 64u));
+	D_BENCHMARK_CHECK(visitCount == flecsCount);
+	D_BENCHMARK_CHECK(iteratorCount == flecsCount);
+}
+
+D_BENCHMARK(ComponentTypes, DenseIndicesAgainstNameMap)
+{
+	constexpr UINT lookupCount = 1000000u;
+
+	SceneBenchmarkScope scope;
+	BenchmarkBehaviours::Register();
+
+	// Names resolved to their flecs entries through a map before the dense indices
+	DUnorderedMap<D_CORE::StringId, D_ECS::ComponentEntry> nameMap;
+	DVector<D_CORE::StringId> names;
+	for (UINT i = 0u; i < D_WORLD::GetComponentTypeCount(); i++)
+	{
+		auto const& info = D_WORLD::GetComponentTypeInfo(i);
+		nameMap[info.Name] = info.Entry;
+		names.push_back(info.Name);
+	}
+
+	D_ECS::EntityId mapSum = 0u;
+	D_BENCHMARKS::Stopwatch stopwatch;
+	for (UINT i = 0u; i < lookupCount; i++)
+		mapSum += nameMap.at(names[(i * 7u) % names.size()]).id();
+	auto mapTime = stopwatch.GetNanoseconds() / lookupCount;
+
+	D_ECS::EntityId indexSum = 0u;
+	stopwatch.Restart();
+	for (UINT i = 0u; i < lookupCount; i++)
+		indexSum += D_WORLD::GetComponentTypeInfo(D_WORLD::FindComponentTypeIndex(names[(i * 7u) % names.size()])).Entry.id();
+	auto indexTime = stopwatch.GetNanoseconds() / lookupCount;
+
+	// By type, the index is known without any lookup
+	D_ECS::EntityId typeSum = 0u;
+	stopwatch.Restart();
+	for (UINT i = 0u; i < lookupCount; i++)
+		typeSum += D_WORLD::GetComponentTypeInfo<BenchmarkBehaviour3>().Entry.id();
+	auto typeTime = stopwatch.GetNanoseconds() / lookupCount;
+
+	D_BENCHMARK_REPORT(names.size() << " registered types: name map " << mapTime << " ns, FindComponentTypeIndex " << indexTime
+		<< " ns, index by type " << typeTime << " ns");
+
+	D_BENCHMARK_CHECK(indexSum == mapSum);
+	D_BENCHMARK_CHECK(typeSum == (D_ECS::EntityId)lookupCount * nameMap.at(D_CORE::StringId(BenchmarkBehaviour3::ClassName().c_str())).id());
+}
+
+D_BENCHMARK(BulkObjects, CreateAndDeleteAgainstOneByOne)
+{
+	constexpr UINT objectCount = 100000u;
+
+	SceneBenchmarkScope scope;
+	auto countBefore = CountGameObjects();
+
+	DVector<GameObject*> single;
+	single.reserve(objectCount);
+	D_BENCHMARKS::Stopwatch stopwatch;
+	for (UINT i = 0u; i < objectCount; i++)
+		single.push_back(D_WORLD::CreateGameObject());
+	auto singleCreateTime = stopwatch.GetMilliseconds();
+
+	auto singleDeleteTime = DeleteAndRemove([&single]()
+		{
+			for (auto go : single)
+				D_WORLD::DeleteGameObject(go);
+		});
+	D_BENCHMARK_CHECK(CountGameObjects() == countBefore);
+
+	DVector<GameObject*> bulk;
+	stopwatch.Restart();
+	D_WORLD::CreateGameObjects(objectCount, bulk);
+	auto bulkCreateTime = stopwatch.GetMilliseconds();
+
+	auto bulkDeleteTime = DeleteAndRemove([&bulk]()
+		{
+			D_WORLD::DeleteGameObjects(bulk);
+		});
+	D_BENCHMARK_CHECK(CountGameObjects() == countBefore);
+
+	D_BENCHMARK_REPORT(objectCount << " objects, one by one: create " << singleCreateTime << " ms, delete " << singleDeleteTime << " ms");
+	D_BENCHMARK_REPORT(objectCount << " objects, bulk: create " << bulkCreateTime << " ms, delete " << bulkDeleteTime << " ms");
+
+	D_BENCHMARK_CHECK(bulk.size() == objectCount);
+}
+
+D_BENCHMARK(Streaming, FlythroughAgainstBudget)
+{
+	constexpr UINT cellCount = 32u;
+	constexpr UINT rootsPerCell = 20u;
+	constexpr float cellSize = 100.f;
+	constexpr float step = 5.f;
+
+	SceneBenchmarkScope scope;
+
+	// A row of cells along X, each with a few hierarchies of 21 objects
+	for (UINT c = 0u; c < cellCount; c++)
+	{
+		auto roots = CreateHierarchies(rootsPerCell, 2u, 4u);
+		for (UINT i = 0u; i < rootsPerCell; i++)
+			roots[i]->GetTransform()->SetLocalPosition(D_MATH::Vector3(cellSize * c + (float)i, 0.f, cellSize * 0.5f));
+	}
+	D_WORLD::FlushTransformChanges();
+
+	auto directory = std::filesystem::temp_directory_path() / "DariusSceneStreamingBenchmarks";
+	std::filesystem::create_directories(directory);
+	auto manifestPath = directory / "Streamed.json";
+	D_BENCHMARK_CHECK(SceneStreamer::SaveStreamedScene(manifestPath, cellSize));
+	D_WORLD::ClearScene();
+
+	SceneStreamer::Settings settings;
+	settings.LoadRadius = 150.f;
+	settings.UnloadRadius = 250.f;
+
+	UINT frameCount = 0u;
+	UINT framesOverBudget = 0u;
+	double totalTime = 0.;
+	double worstTime = 0.;
+	{
+		SceneStreamer streamer(settings);
+		D_BENCHMARK_CHECK(streamer.Open(manifestPath));
+		D_BENCHMARK_CHECK(streamer.GetCellCount() == cellCount);
+
+		auto source = streamer.AddSource(D_MATH::Vector3(0.f, 0.f, cellSize * 0.5f));
+		auto update = [&]()
+			{
+				D_BENCHMARKS::Stopwatch stopwatch;
+				streamer.Update();
+				auto time = stopwatch.GetMilliseconds();
+
+				totalTime += time;
+				worstTime = std::max(worstTime, time);
+				framesOverBudget += time > settings.IntegrationBudgetMs ? 1u : 0u;
+				frameCount++;
+
+				// Giving the workers time to stage the cells, as a frame would
+				std::this_thread::yield();
+			};
+
+		for (float x = 0.f; x < cellSize * cellCount; x += step)
+		{
+			streamer.SetSourcePosition(source, D_MATH::Vector3(x, 0.f, cellSize * 0.5f));
+			update();
+		}
+
+		// Hovering at the end until the last cell is in
+		for (UINT i = 0u; i < 100000u && !streamer.IsCellLoaded((int)cellCount - 1, 0); i++)
+			update();
+
+		D_BENCHMARK_CHECK(streamer.IsCellLoaded((int)cellCount - 1, 0));
+		D_BENCHMARK_CHECK(!streamer.IsCellLoaded(0, 0));
+
+		streamer.Close();
+	}
+
+	std::filesystem::remove_all(directory);
+
+	D_BENCHMARK_REPORT(cellCount << " cells of " << rootsPerCell * 21u << " objects over " << frameCount << " frames, integration budget " << settings.IntegrationBudgetMs << " ms");
+	D_BENCHMARK_REPORT("Update: average " << totalTime / frameCount << " ms, worst " << worstTime << " ms, " << framesOverBudget << " frames over the budget");
+}
+
+D_BENCHMARK(Deletion, BudgetedAgainstAtOnce)
+{
+	constexpr UINT objectCount = 100000u;
+
+	SceneBenchmarkScope scope;
+	auto countBefore = CountGameObjects();
+
+	DVector<GameObject*> gos;
+	D_WORLD::CreateGameObjects(objectCount, gos);
+	auto atOnce = DeleteOverFrames(gos, countBefore, 1e9);
+	D_BENCHMARK_CHECK(CountGameObjects() == countBefore);
+
+	gos.clear();
+	D_WORLD::CreateGameObjects(objectCount, gos);
+	auto budgeted = DeleteOverFrames(gos, countBefore, 1.);
+	D_BENCHMARK_CHECK(CountGameObjects() == countBefore);
+
+	D_BENCHMARK_REPORT(objectCount << " objects deleted without a budget: worst frame " << atOnce.Worst << " ms, " << atOnce.Count << " frames, " << atOnce.Total << " ms in total");
+	D_BENCHMARK_REPORT(objectCount << " objects deleted with a 1 ms budget: worst frame " << budgeted.Worst << " ms, " << budgeted.Count << " frames, " << budgeted.Total << " ms in total");
+}
+
+D_BENCHMARK(SceneDumps, ParallelAgainstSerial)
+{
+	constexpr UINT rootCount = 10000u;
+	constexpr UINT objectCount = rootCount * 10u;
+
+	SceneBenchmarkScope scope;
+	SeriallyLoadedBehaviour::StaticConstructor();
+	ParallelLoadedBehaviour::StaticConstructor();
+
+	// Dumps the objects both ways, and loads the whole scene back with the behaviour on each object
+	auto dumpAndLoad = [&]<class COMP>(double& serialDumpTime, double& parallelDumpTime, double& loadTime)
+		{
+			D_WORLD::ClearScene();
+			auto countBefore = CountGameObjects();
+
+			auto roots = CreateHierarchies(rootCount, 1u, 9u);
+			for (auto root : roots)
+			{
+				root->AddComponent<COMP>();
+				root->VisitDescendants([](GameObject* go) { go->AddComponent<COMP>(); });
+			}
+
+			D_SERIALIZATION::Json serialDump;
+			D_BENCHMARKS::Stopwatch stopwatch;
+			D_WORLD::DumpGameObjects(roots, serialDump, false);
+			serialDumpTime = stopwatch.GetMilliseconds();
+
+			D_SERIALIZATION::Json parallelDump;
+			stopwatch.Restart();
+			D_WORLD::DumpGameObjects(roots, parallelDump);
+			parallelDumpTime = stopwatch.GetMilliseconds();
+
+			D_BENCHMARK_CHECK(serialDump == parallelDump);
+			D_BENCHMARK_CHECK(parallelDump["Objects"].size() == objectCount);
+
+			D_SERIALIZATION::Json sceneDump;
+			D_WORLD::DumpScene(sceneDump);
+			D_WORLD::ClearScene();
+
+			stopwatch.Restart();
+			D_WORLD::LoadSceneDump(sceneDump);
+			loadTime = stopwatch.GetMilliseconds();
+
+			D_BENCHMARK_CHECK(CountGameObjects() == countBefore + objectCount);
+		};
+
+	double serialDumpTime, parallelDumpTime, serialLoadTime, parallelLoadTime, unused;
+	dumpAndLoad.operator()<SeriallyLoadedBehaviour>(serialDumpTime, parallelDumpTime, serialLoadTime);
+	dumpAndLoad.operator()<ParallelLoadedBehaviour>(unused, unused, parallelLoadTime);
+
+	D_BENCHMARK_REPORT(objectCount << " objects dumped serially in " << serialDumpTime << " ms, in parallel in " << parallelDumpTime << " ms");
+	D_BENCHMARK_REPORT(objectCount << " objects loaded with serially deserialized behaviours in " << serialLoadTime << " ms, with parallel ones in " << parallelLoadTime << " ms");
+}
@@ -0,0 +1,63 @@
+#include "Benchmark.hpp"
+
+#include <Utils/Log.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace D_LOGGER;
+
+namespace
+{
+	class CountingSink : public LogSink
+	{
+	public:
+		virtual void Write(LogEntry const&) override { Count++; }
+
+		std::atomic_uint64_t			Count = 0u;
+	};
+}
+
+D_BENCHMARK(Logger, LogCallCost)
+{
+	constexpr uint32_t threadCount = 16u;
+	constexpr uint32_t count = 20000u;
+
+	ClearSinks();
+	SetLevel(LogLevel::Trace);
+	Initialize();
+
+	auto sink = std::make_shared<CountingSink>();
+	AddSink(sink);
+
+	auto droppedBefore = GetDroppedCount();
+	D_BENCHMARKS::Stopwatch stopwatch;
+	{
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0u; t < threadCount; t++)
+		{
+			threads.emplace_back([]()
+				{
+					for (uint32_t i = 1u; i <= count; i++)
+						D_LOG_CATEGORY(LogLevel::Info, "Test", "Entry " << i);
+				});
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+	}
+	auto elapsedNs = stopwatch.GetNanoseconds();
+	Flush();
+
+	auto dropped = GetDroppedCount() - droppedBefore;
+	D_BENCHMARK_CHECK(sink->Count + dropped == (uint64_t)threadCount * count);
+
+	// Threads beyond the core count run one after another
+	auto cores = std::min(threadCount, std::max(std::thread::hardware_concurrency(), 1u));
+	D_BENCHMARK_REPORT("Log call cost from " << threadCount << " threads: " << elapsedNs * cores / ((double)threadCount * count) << " ns, dropped " << dropped);
+
+	Shutdown();
+	ClearSinks();
+}
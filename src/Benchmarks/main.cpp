@@ -0,0 +1,74 @@
+#include "Benchmark.hpp"
+
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+namespace Darius::Benchmarks
+{
+	struct RegisteredBenchmark
+	{
+		std::string				Name;
+		BenchmarkFunction		Function;
+	};
+
+	// Function local, so that registrations from any translation unit find it constructed
+	static std::vector<RegisteredBenchmark>& GetBenchmarks()
+	{
+		static std::vector<RegisteredBenchmark> benchmarks;
+		return benchmarks;
+	}
+
+	static int FailureCount = 0;
+
+	bool RegisterBenchmark(char const* suite, char const* name, BenchmarkFunction function)
+	{
+		GetBenchmarks().push_back({ std::string(suite) + "." + name, function });
+		return true;
+	}
+
+	void Report(std::string const& line)
+	{
+		std::printf("    %s\n", line.c_str());
+	}
+
+	void Fail(std::string const& message)
+	{
+		std::printf("    FAILED: %s\n", message.c_str());
+		FailureCount++;
+	}
+}
+
+using namespace D_BENCHMARKS;
+
+// Usage: DariusBenchmarks [filter...]
+// Runs the benchmarks whose Suite.Name contains any of the filters, or all of them without filters.
+int main(int argc, char** argv)
+{
+	auto matches = [argc, argv](std::string const& name)
+		{
+			if(argc < 2)
+				return true;
+
+			for(int i = 1; i < argc; i++)
+			{
+				if(name.find(argv[i]) != std::string::npos)
+					return true;
+			}
+			return false;
+		};
+
+	for(auto const& benchmark : GetBenchmarks())
+	{
+		if(!matches(benchmark.Name))
+			continue;
+
+		std::printf("%s\n", benchmark.Name.c_str());
+		Stopwatch stopwatch;
+		benchmark.Function();
+		std::printf("    (%.1f ms)\n", stopwatch.GetMilliseconds());
+		std::fflush(stdout);
+	}
+
+	return FailureCount == 0 ? 0 : 1;
+}
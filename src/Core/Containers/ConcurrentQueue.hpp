@@ -1,73 +1,521 @@
 #pragma once
-#include <queue>
-#include <optional>
-#include <mutex>
+
 #include <Utils/Assert.hpp>
 #include <Utils/Common.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <utility>
+#include <vector>
+
 #ifndef D_CONTAINERS
 #define D_CONTAINERS Darius::Core::Containers
 #endif // !D_CONTAINERS
 
 namespace Darius::Core::Containers
 {
+	namespace Detail
+	{
+		constexpr size_t					QueueCacheLine = 64u;
+
+		// Wakes the blocked consumers. Producers only touch the version when someone waits.
+		class QueueSignal
+		{
+		public:
+			INLINE void Notify()
+			{
+				// Orders the published item before reading the waiters, paired with the consumers
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (mWaiters.load(std::memory_order_relaxed) == 0u)
+					return;
+
+				mVersion.fetch_add(1u, std::memory_order_release);
+				mVersion.notify_one();
+			}
+
+			INLINE void Close()
+			{
+				mClosed.store(true, std::memory_order_release);
+				mVersion.fetch_add(1u, std::memory_order_release);
+				mVersion.notify_all();
+			}
+
+			INLINE bool IsClosed() const { return mClosed.load(std::memory_order_acquire); }
+
+			// Pops until it succeeds or the queue is closed and empty
+			template<typename TryPopFunc>
+			bool Wait(TryPopFunc&& tryPop)
+			{
+				if (tryPop())
+					return true;
+
+				mWaiters.fetch_add(1u, std::memory_order_seq_cst);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+
+				bool result = false;
+				while (true)
+				{
+					auto version = mVersion.load(std::memory_order_acquire);
+
+					if (tryPop())
+					{
+						result = true;
+						break;
+					}
+
+					if (IsClosed())
+						break;
+
+					mVersion.wait(version, std::memory_order_acquire);
+				}
+
+				mWaiters.fetch_sub(1u, std::memory_order_relaxed);
+				return result;
+			}
+
+		private:
+			std::atomic_uint32_t			mVersion = 0u;
+			std::atomic_uint32_t			mWaiters = 0u;
+			std::atomic_bool				mClosed = false;
+		};
+	}
+
+	// Lock-free multi-producer multi-consumer queue of a fixed capacity, rounded up to a power of
+	// two. Each cell has a sequence number telling whether it is ready for the push or the pop of
+	// a given position, so producers and consumers only contend on their own position counter.
 	template<typename T>
-	class ConcurrentQueue {
-		std::queue<T> queue_;
-		mutable std::mutex mutex_;
+	class BoundedConcurrentQueue
+	{
+	public:
+		explicit BoundedConcurrentQueue(size_t capacity) :
+			mCapacity(RoundUpCapacity(capacity)),
+			mMask(mCapacity - 1u),
+			mCells(new Cell[mCapacity])
+		{
+			for (size_t i = 0u; i < mCapacity; i++)
+				mCells[i].Sequence.store(i, std::memory_order_relaxed);
+		}
+
+		~BoundedConcurrentQueue()
+		{
+			// Items pushed but never popped
+			auto end = mEnqueuePos.load(std::memory_order_acquire);
+			for (auto pos = mDequeuePos.load(std::memory_order_acquire); pos != end; pos++)
+				std::launder(reinterpret_cast<T*>(mCells[pos & mMask].Storage))->~T();
+
+			delete[] mCells;
+		}
+
+		BoundedConcurrentQueue(BoundedConcurrentQueue const&) = delete;
+		BoundedConcurrentQueue& operator=(BoundedConcurrentQueue const&) = delete;
+
+		// Returns false if full
+		template<typename... Args>
+		bool TryEmplace(Args&&... args)
+		{
+			auto pos = mEnqueuePos.load(std::memory_order_relaxed);
+			Cell* cell;
+
+			while (true)
+			{
+				cell = &mCells[pos & mMask];
+				auto sequence = cell->Sequence.load(std::memory_order_acquire);
+				auto diff = (intptr_t)sequence - (intptr_t)pos;
+
+				if (diff == 0)
+				{
+					if (mEnqueuePos.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed))
+						break;
+				}
+				// The cell still holds the item of the previous lap
+				else if (diff < 0)
+					return false;
+				else
+					pos = mEnqueuePos.load(std::memory_order_relaxed);
+			}
+
+			new (cell->Storage) T(std::forward<Args>(args)...);
+			cell->Sequence.store(pos + 1u, std::memory_order_release);
+
+			mSignal.Notify();
+			return true;
+		}
+
+		INLINE bool TryPush(T const& item) { return TryEmplace(item); }
+		INLINE bool TryPush(T&& item) { return TryEmplace(std::move(item)); }
+
+		// Returns false if empty. An item whose push is still in progress counts as not pushed yet.
+		bool TryPop(T& out)
+		{
+			auto pos = mDequeuePos.load(std::memory_order_relaxed);
+			Cell* cell;
+
+			while (true)
+			{
+				cell = &mCells[pos & mMask];
+				auto sequence = cell->Sequence.load(std::memory_order_acquire);
+				auto diff = (intptr_t)sequence - (intptr_t)(pos + 1u);
+
+				if (diff == 0)
+				{
+					if (mDequeuePos.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+					return false;
+				else
+					pos = mDequeuePos.load(std::memory_order_relaxed);
+			}
+
+			auto item = std::launder(reinterpret_cast<T*>(cell->Storage));
+			out = std::move(*item);
+			item->~T();
+
+			// Ready for the push of the next lap
+			cell->Sequence.store(pos + mCapacity, std::memory_order_release);
+			return true;
+		}
 
-		// Moved out of public interface to prevent races between this
-		// and pop().
-		bool empty() const {
-			return queue_.empty();
+		INLINE std::optional<T> TryPop()
+		{
+			T item;
+			if (TryPop(item))
+				return std::move(item);
+			return {};
+		}
+
+		// Blocks until an item is popped. Returns false only if the queue is closed and empty.
+		INLINE bool WaitPop(T& out)
+		{
+			return mSignal.Wait([&]() { return TryPop(out); });
+		}
+
+		// Wakes the blocked consumers for shutdown. Pushing is still allowed.
+		INLINE void Close() { mSignal.Close(); }
+		INLINE bool IsClosed() const { return mSignal.IsClosed(); }
+
+		// Approximate while other threads push or pop
+		INLINE size_t Size() const
+		{
+			auto dequeued = mDequeuePos.load(std::memory_order_acquire);
+			auto enqueued = mEnqueuePos.load(std::memory_order_acquire);
+			return enqueued > dequeued ? enqueued - dequeued : 0u;
 		}
 
+		INLINE bool IsEmpty() const { return Size() == 0u; }
+		INLINE size_t GetCapacity() const { return mCapacity; }
+
+	private:
+		struct Cell
+		{
+			std::atomic_size_t				Sequence;
+			alignas(T) std::byte			Storage[sizeof(T)];
+		};
+
+		static size_t RoundUpCapacity(size_t capacity)
+		{
+			D_ASSERT(capacity > 0u);
+			size_t result = 2u;
+			while (result < capacity)
+				result <<= 1u;
+			return result;
+		}
+
+		size_t const						mCapacity;
+		size_t const						mMask;
+		Cell* const							mCells;
+
+		alignas(Detail::QueueCacheLine) std::atomic_size_t mEnqueuePos = 0u;
+		alignas(Detail::QueueCacheLine) std::atomic_size_t mDequeuePos = 0u;
+		alignas(Detail::QueueCacheLine) Detail::QueueSignal mSignal;
+	};
+
+	// Unbounded lock-free multi-producer multi-consumer queue. Items are pushed into a chain of
+	// fixed size segments, and a segment is never pushed to again once full, which keeps the order.
+	// Drained segments are reclaimed by epochs: every push and pop registers in the current epoch,
+	// the epoch advances once the previous one has no running operation left, and a segment is
+	// deleted two epochs after it was unlinked. New operations only join the current epoch, so
+	// the previous one drains and segments are reclaimed even under continuous traffic.
+	template<typename T, size_t SegmentSize = 256u>
+	class ConcurrentQueue
+	{
 	public:
-		ConcurrentQueue() = default;
-		ConcurrentQueue(const ConcurrentQueue<T>&) = delete;
-		ConcurrentQueue& operator=(const ConcurrentQueue<T>&) = delete;
+		ConcurrentQueue() :
+			mHead(new Segment()),
+			mTail(mHead.load(std::memory_order_relaxed))
+		{ }
+
+		~ConcurrentQueue()
+		{
+			auto segment = mHead.load(std::memory_order_acquire);
+			while (segment)
+			{
+				auto next = segment->Next.load(std::memory_order_acquire);
+				delete segment;
+				segment = next;
+			}
 
-		ConcurrentQueue(ConcurrentQueue<T>&& other) {
-			std::lock_guard<std::mutex> lock(mutex_);
-			queue_ = std::move(other.queue_);
+			for (auto const& retired : mRetired)
+				delete retired.Pointer;
 		}
 
-		virtual ~ConcurrentQueue() { }
+		ConcurrentQueue(ConcurrentQueue const&) = delete;
+		ConcurrentQueue& operator=(ConcurrentQueue const&) = delete;
 
-		unsigned long Size() const
+		template<typename... Args>
+		void Emplace(Args&&... args)
 		{
-			std::lock_guard<std::mutex> lock(mutex_);
-			return (unsigned long)queue_.size();
+			{
+				ActiveScope active(*this);
+
+				while (true)
+				{
+					auto tail = mTail.load(std::memory_order_acquire);
+
+					auto pos = tail->EnqueuePos.fetch_add(1u, std::memory_order_acq_rel);
+					if (pos < SegmentSize)
+					{
+						auto& cell = tail->Cells[pos];
+						new (cell.Storage) T(std::forward<Args>(args)...);
+						cell.Ready.store(true, std::memory_order_release);
+						break;
+					}
+
+					// Full, linking the next segment if no other producer did yet
+					auto next = tail->Next.load(std::memory_order_acquire);
+					if (!next)
+					{
+						auto segment = new Segment();
+						if (tail->Next.compare_exchange_strong(next, segment, std::memory_order_acq_rel))
+							next = segment;
+						else
+							delete segment;
+					}
+
+					mTail.compare_exchange_strong(tail, next, std::memory_order_acq_rel);
+				}
+			}
+
+			mSignal.Notify();
 		}
 
-		std::optional<T> Pop() {
-			std::lock_guard<std::mutex> lock(mutex_);
-			if (queue_.empty()) {
-				return {};
+		INLINE void Push(T const& item) { Emplace(item); }
+		INLINE void Push(T&& item) { Emplace(std::move(item)); }
+
+		// Returns false if empty. An item whose push is still in progress counts as not pushed yet.
+		bool TryPop(T& out)
+		{
+			ActiveScope active(*this);
+
+			while (true)
+			{
+				auto head = mHead.load(std::memory_order_acquire);
+
+				auto result = head->TryPop(out);
+				if (result == PopResult::Popped)
+					return true;
+				if (result == PopResult::Empty)
+					return false;
+
+				// Drained, moving to the next segment if there is one
+				auto next = head->Next.load(std::memory_order_acquire);
+				if (!next)
+					return false;
+
+				// The tail must be past the segment before it can be deleted
+				auto tail = head;
+				mTail.compare_exchange_strong(tail, next, std::memory_order_acq_rel);
+
+				if (mHead.compare_exchange_strong(head, next, std::memory_order_acq_rel))
+					Retire(head);
 			}
-			T tmp = queue_.front();
-			queue_.pop();
-			return tmp;
 		}
 
-		void Pop(T& data) {
-			std::lock_guard<std::mutex> lock(mutex_);
-			if (queue_.empty()) {
-				return;
+		INLINE std::optional<T> TryPop()
+		{
+			T item;
+			if (TryPop(item))
+				return std::move(item);
+			return {};
+		}
+
+		// Blocks until an item is popped. Returns false only if the queue is closed and empty.
+		INLINE bool WaitPop(T& out)
+		{
+			return mSignal.Wait([&]() { return TryPop(out); });
+		}
+
+		INLINE std::optional<T> Pop() { return TryPop(); }
+		INLINE bool Pop(T& out) { return TryPop(out); }
+
+		// Wakes the blocked consumers for shutdown. Pushing is still allowed.
+		INLINE void Close() { mSignal.Close(); }
+		INLINE bool IsClosed() const { return mSignal.IsClosed(); }
+
+		// Approximate while other threads push or pop
+		size_t Size() const
+		{
+			ActiveScope active(*this);
+
+			size_t size = 0u;
+			for (auto segment = mHead.load(std::memory_order_acquire); segment; segment = segment->Next.load(std::memory_order_acquire))
+			{
+				auto enqueued = std::min(segment->EnqueuePos.load(std::memory_order_acquire), SegmentSize);
+				auto dequeued = std::min(segment->DequeuePos.load(std::memory_order_acquire), SegmentSize);
+				size += enqueued > dequeued ? enqueued - dequeued : 0u;
 			}
-			data = queue_.front();
-			queue_.pop();
+
+			return size;
 		}
 
-		void Push(const T& item) {
-			std::lock_guard<std::mutex> lock(mutex_);
-			queue_.push(item);
+		INLINE bool IsEmpty() const { return Size() == 0u; }
+
+		// Drained segments waiting for the running operations to finish
+		INLINE size_t GetRetiredCount() const { std::scoped_lock lock(mRetiredMutex); return mRetired.size(); }
+
+	private:
+		enum class PopResult : uint8_t
+		{
+			Popped,
+			Empty,
+			Drained
+		};
+
+		struct Cell
+		{
+			std::atomic_bool				Ready = false;
+			alignas(T) std::byte			Storage[sizeof(T)];
+		};
+
+		struct Segment
+		{
+			~Segment()
+			{
+				// Items pushed but never popped
+				auto end = std::min<size_t>(EnqueuePos.load(std::memory_order_acquire), SegmentSize);
+				for (size_t i = DequeuePos.load(std::memory_order_acquire); i < end; i++)
+					std::launder(reinterpret_cast<T*>(Cells[i].Storage))->~T();
+			}
+
+			PopResult TryPop(T& out)
+			{
+				auto pos = DequeuePos.load(std::memory_order_acquire);
+
+				while (true)
+				{
+					if (pos >= SegmentSize)
+						return PopResult::Drained;
+
+					if (!Cells[pos].Ready.load(std::memory_order_acquire))
+						return PopResult::Empty;
+
+					if (DequeuePos.compare_exchange_weak(pos, pos + 1u, std::memory_order_acq_rel))
+						break;
+				}
+
+				auto item = std::launder(reinterpret_cast<T*>(Cells[pos].Storage));
+				out = std::move(*item);
+				item->~T();
+				return PopResult::Popped;
+			}
+
+			Cell							Cells[SegmentSize];
+
+			// Producers may go past the size when the segment is full
+			alignas(Detail::QueueCacheLine) std::atomic_size_t EnqueuePos = 0u;
+			alignas(Detail::QueueCacheLine) std::atomic_size_t DequeuePos = 0u;
+			std::atomic<Segment*>			Next = nullptr;
+		};
+
+		struct RetiredSegment
+		{
+			Segment*						Pointer;
+			uint64_t						Epoch;
+		};
+
+		// Registers the running push or pop in the current epoch
+		class ActiveScope
+		{
+		public:
+			INLINE explicit ActiveScope(ConcurrentQueue const& queue) :
+				mQueue(queue)
+			{
+				while (true)
+				{
+					mEpoch = mQueue.mEpoch.load(std::memory_order_seq_cst);
+					mQueue.mActive[mEpoch & 1u].fetch_add(1u, std::memory_order_seq_cst);
+
+					// The epoch advanced in between, which may have missed this registration
+					if (mQueue.mEpoch.load(std::memory_order_seq_cst) == mEpoch)
+						break;
+
+					mQueue.mActive[mEpoch & 1u].fetch_sub(1u, std::memory_order_seq_cst);
+				}
+			}
+
+			INLINE ~ActiveScope()
+			{
+				mQueue.mActive[mEpoch & 1u].fetch_sub(1u, std::memory_order_seq_cst);
+				if (mQueue.mHasRetired.load(std::memory_order_relaxed))
+					mQueue.DeleteRetired();
+			}
+
+		private:
+			ConcurrentQueue const&			mQueue;
+			uint64_t						mEpoch;
+		};
+
+		void Retire(Segment* segment)
+		{
+			// Orders the unlinking before reading the epoch
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			std::scoped_lock lock(mRetiredMutex);
+			mRetired.push_back({ segment, mEpoch.load(std::memory_order_seq_cst) });
+			mHasRetired.store(true, std::memory_order_relaxed);
 		}
 
-		bool IsEmpty() const
+		void DeleteRetired() const
 		{
-			std::lock_guard<std::mutex> lock(mutex_);
-			return queue_.empty();
+			std::vector<Segment*> reclaimed;
+			{
+				// Another thread is already at it
+				std::unique_lock lock(mRetiredMutex, std::try_to_lock);
+				if (!lock.owns_lock())
+					return;
+
+				// Operations of the current epoch are still running, advancing only waits for the previous one
+				auto epoch = mEpoch.load(std::memory_order_seq_cst);
+				if (mActive[(epoch + 1u) & 1u].load(std::memory_order_seq_cst) == 0u &&
+					mEpoch.compare_exchange_strong(epoch, epoch + 1u, std::memory_order_seq_cst))
+					epoch++;
+
+				// Nothing that started before the segment was unlinked is running two epochs later
+				auto kept = std::partition(mRetired.begin(), mRetired.end(), [epoch](RetiredSegment const& retired) { return retired.Epoch + 2u > epoch; });
+				for (auto it = kept; it != mRetired.end(); it++)
+					reclaimed.push_back(it->Pointer);
+				mRetired.erase(kept, mRetired.end());
+				mHasRetired.store(!mRetired.empty(), std::memory_order_relaxed);
+			}
+
+			for (auto segment : reclaimed)
+				delete segment;
 		}
+
+		alignas(Detail::QueueCacheLine) std::atomic<Segment*> mHead;
+		alignas(Detail::QueueCacheLine) std::atomic<Segment*> mTail;
+		alignas(Detail::QueueCacheLine) mutable std::atomic_uint64_t mEpoch = 0u;
+
+		// Running operations by the parity of the epoch they registered in
+		alignas(Detail::QueueCacheLine) mutable std::atomic_size_t mActive[2] = { 0u, 0u };
+		alignas(Detail::QueueCacheLine) Detail::QueueSignal mSignal;
+
+		mutable std::mutex					mRetiredMutex;
+		mutable std::vector<RetiredSegment>	mRetired;
+		mutable std::atomic_bool			mHasRetired = false;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "Core/MultiThreading/SpinLock.hpp"
+
+#include <Utils/Assert.hpp>
+#include <Utils/Common.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#ifndef D_CONTAINERS
+#define D_CONTAINERS Darius::Core::Containers
+#endif // !D_CONTAINERS
+
+namespace Darius::Core::Containers
+{
+	// Maps 32 bit handles, an index in the low bits and a generation in the high bits, to objects.
+	// Slots live in chunks which are never moved or freed, so resolving a handle is lock-free: a
+	// stale handle is caught by its generation no longer matching the slot's. A slot whose
+	// generation saturates is retired instead of wrapping, so that no stale handle ever matches
+	// again. Adding and removing take a lock and are expected to be much rarer than resolving.
+	template<typename T, uint32_t IndexBits = 20u, uint32_t ChunkBits = 10u>
+	class HandleTable
+	{
+		static_assert(IndexBits > ChunkBits && IndexBits < 32u);
+
+	public:
+		using Handle = uint32_t;
+
+		static constexpr Handle		InvalidHandle = 0u;
+		static constexpr uint32_t	MaxObjects = 1u << IndexBits;
+		static constexpr uint32_t	ChunkSize = 1u << ChunkBits;
+		static constexpr uint32_t	MaxChunks = MaxObjects / ChunkSize;
+		static constexpr uint32_t	IndexMask = MaxObjects - 1u;
+		static constexpr uint32_t	GenerationMask = (1u << (32u - IndexBits)) - 1u;
+
+		HandleTable() = default;
+
+		~HandleTable()
+		{
+			for (uint32_t i = 0u; i < MaxChunks; i++)
+				delete[] mChunks[i].load(std::memory_order_relaxed);
+		}
+
+		HandleTable(HandleTable const&) = delete;
+		HandleTable& operator=(HandleTable const&) = delete;
+
+		// Returns a handle resolving to nothing until an object is assigned to it
+		Handle Allocate()
+		{
+			std::scoped_lock lock(mLock);
+
+			uint32_t index;
+			if (mFreeHead != kNoFree)
+			{
+				index = mFreeHead;
+				mFreeHead = GetSlot(index).NextFree;
+			}
+			else
+			{
+				index = mCount.load(std::memory_order_relaxed);
+				if (!D_VERIFY(index < MaxObjects))
+					return InvalidHandle;
+
+				auto& chunk = mChunks[index >> ChunkBits];
+				if (!chunk.load(std::memory_order_relaxed))
+					chunk.store(new Slot[ChunkSize], std::memory_order_release);
+
+				mCount.store(index + 1u, std::memory_order_release);
+			}
+
+			mSize.fetch_add(1u, std::memory_order_relaxed);
+			return MakeHandle(index, GetSlot(index).Generation.load(std::memory_order_relaxed));
+		}
+
+		void Assign(Handle handle, T* object)
+		{
+			D_ASSERT(IsValidSlot(handle));
+			GetSlot(GetIndex(handle)).Object.store(object, std::memory_order_release);
+		}
+
+		INLINE Handle Add(T* object)
+		{
+			auto handle = Allocate();
+			if (handle != InvalidHandle)
+				Assign(handle, object);
+			return handle;
+		}
+
+		// Returns false if the handle is stale. The slot is reused by a later add with a new generation.
+		bool Remove(Handle handle)
+		{
+			std::scoped_lock lock(mLock);
+
+			if (!IsValidSlot(handle))
+				return false;
+
+			auto index = GetIndex(handle);
+			auto& slot = GetSlot(index);
+			auto generation = GetGeneration(handle);
+
+			// Generation is changed first, so a reader seeing the slot cleared or reused also sees it.
+			// Zero matches no handle, which retires the slot for good.
+			slot.Generation.store(generation < GenerationMask ? generation + 1u : RetiredGeneration, std::memory_order_release);
+			slot.Object.store(nullptr, std::memory_order_release);
+			mSize.fetch_sub(1u, std::memory_order_relaxed);
+
+			if (generation == GenerationMask)
+			{
+				mRetiredCount.fetch_add(1u, std::memory_order_relaxed);
+				return true;
+			}
+
+			slot.NextFree = mFreeHead;
+			mFreeHead = index;
+			return true;
+		}
+
+		// Null for stale or invalid handles and for handles without an assigned object yet
+		INLINE T* Resolve(Handle handle) const
+		{
+			auto index = GetIndex(handle);
+			if (index >= mCount.load(std::memory_order_acquire))
+				return nullptr;
+
+			auto const& slot = GetSlot(index);
+			auto object = slot.Object.load(std::memory_order_acquire);
+			if (slot.Generation.load(std::memory_order_acquire) != GetGeneration(handle))
+				return nullptr;
+
+			return object;
+		}
+
+		INLINE bool IsValid(Handle handle) const
+		{
+			return IsValidSlot(handle);
+		}
+
+		// Visits the assigned objects by index order without locking. Objects added meanwhile may be missed.
+		template<typename FUNC>
+		void ForEach(FUNC&& func) const
+		{
+			auto count = mCount.load(std::memory_order_acquire);
+			for (uint32_t index = 0u; index < count; index++)
+			{
+				if (auto object = GetSlot(index).Object.load(std::memory_order_acquire))
+					func(object);
+			}
+		}
+
+		INLINE uint32_t GetSize() const { return mSize.load(std::memory_order_relaxed); }
+
+		// Slots whose generations ran out
+		INLINE uint32_t GetRetiredCount() const { return mRetiredCount.load(std::memory_order_relaxed); }
+
+		static INLINE constexpr uint32_t GetIndex(Handle handle) { return handle & IndexMask; }
+		static INLINE constexpr uint32_t GetGeneration(Handle handle) { return handle >> IndexBits; }
+		static INLINE constexpr Handle MakeHandle(uint32_t index, uint32_t generation) { return (generation << IndexBits) | index; }
+
+	private:
+		static constexpr uint32_t	kNoFree = ~0u;
+		static constexpr uint32_t	RetiredGeneration = 0u;
+
+		struct Slot
+		{
+			std::atomic<T*>			Object = nullptr;
+
+			// Zero only once retired, so that no slot matches the invalid handle
+			std::atomic_uint32_t	Generation = 1u;
+
+			// Written and read under the lock only
+			uint32_t				NextFree = kNoFree;
+		};
+
+		INLINE Slot& GetSlot(uint32_t index) const
+		{
+			return mChunks[index >> ChunkBits].load(std::memory_order_acquire)[index & (ChunkSize - 1u)];
+		}
+
+		INLINE bool IsValidSlot(Handle handle) const
+		{
+			auto index = GetIndex(handle);
+			return GetGeneration(handle) != RetiredGeneration && index < mCount.load(std::memory_order_acquire) &&
+				GetSlot(index).Generation.load(std::memory_order_acquire) == GetGeneration(handle);
+		}
+
+		// Fixed in size so that finding a slot needs no lock
+		std::atomic<Slot*>			mChunks[MaxChunks] = {};
+		std::atomic_uint32_t		mCount = 0u;
+
+		uint32_t					mFreeHead = kNoFree;
+		std::atomic_uint32_t		mSize = 0u;
+		std::atomic_uint32_t		mRetiredCount = 0u;
+		D_CORE_THREADING::SpinLock	mLock;
+	};
+}
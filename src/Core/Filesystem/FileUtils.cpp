@@ -81,6 +81,34 @@ namespace Darius::Core::Filesystem
 		return ReadFileHelper(path);
 	}
 
+	ByteArray ReadFileRangeSync(std::wstring const& path, uint64_t offset, uint64_t size)
+	{
+		if (offset + size > GetFileByteSize(path))
+			return NullFile;
+
+		ifstream file(path, ios::in | ios::binary);
+		if (!file)
+			return NullFile;
+
+		ByteArray byteArray = std::make_shared<vector<std::byte> >(size);
+		file.seekg((streamoff)offset);
+		file.read((char*)byteArray->data(), byteArray->size());
+
+		if ((uint64_t)file.gcount() != size)
+			return NullFile;
+
+		return byteArray;
+	}
+
+	uint64_t GetFileByteSize(std::wstring const& path)
+	{
+		struct _stat64 fileStat;
+		if (_wstat64(path.c_str(), &fileStat) == -1)
+			return 0ull;
+
+		return (uint64_t)fileStat.st_size;
+	}
+
 	Concurrency::task<ByteArray> ReadFileAsync(std::wstring const& path)
 	{
 		return Concurrency::create_task([=] { return ReadFileHelper(path); });
@@ -28,6 +28,12 @@ namespace Darius::Core::Filesystem
 
 	ByteArray						ReadFileSync(std::wstring const& path);
 
+	// Reads a part of the file. Returns NullFile if the file does not have the whole range.
+	ByteArray						ReadFileRangeSync(std::wstring const& path, uint64_t offset, uint64_t size);
+
+	// Returns 0 if the file does not exist
+	uint64_t						GetFileByteSize(std::wstring const& path);
+
 	bool							WriteFileHelper(std::wstring const& path, ByteArray data);
 
 	Concurrency::task<ByteArray>	ReadFileAsync(std::wstring const& path);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Core/Memory/MemoryTracking.hpp"
+
 #ifndef D_MEMORY
 #define D_MEMORY Darius::Core::Memory
 #endif // !D_MEMORY_ALLOC
@@ -9,10 +11,18 @@ namespace Darius::Core::Memory
 	class Allocator
 	{
 	public:
-		Allocator() = default;
+		// Allocations are tagged with the tag current on construction unless set
+		Allocator() :
+			mTag(GetCurrentMemoryTag()) { }
 		virtual ~Allocator() = default;
 		virtual void*				Alloc(size_t size, size_t alignment) = 0;
 
 		virtual void				Free(void* ptr) = 0;
+
+		INLINE MemoryTag			GetMemoryTag() const { return mTag; }
+		INLINE void					SetMemoryTag(MemoryTag tag) { mTag = tag; }
+
+	protected:
+		MemoryTag					mTag;
 	};
 }
\ No newline at end of file
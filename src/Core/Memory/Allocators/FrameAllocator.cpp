@@ -0,0 +1,283 @@
+#include "Core/pch.hpp"
+#include "FrameAllocator.hpp"
+
+#include "Core/Memory/Memory.hpp"
+
+#include <Utils/Assert.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+using namespace D_CONTAINERS;
+using namespace D_MEMORY;
+
+namespace
+{
+	constexpr uint32_t						MaxBufferCount = 4u;
+	constexpr size_t						BlockAlignment = 64u;
+
+	struct Block
+	{
+		std::byte*							Memory;
+		size_t								Size;
+	};
+
+	// Only the owner thread allocates from an arena. Others only reset it on frame beginning.
+	struct Arena
+	{
+		DVector<Block>						Blocks;
+		DVector<Block>						Oversized;
+		size_t								Current = 0u;
+		size_t								Offset = 0u;
+
+		std::atomic_uint64_t				Allocations = 0u;
+		std::atomic_uint64_t				AllocatedBytes = 0u;
+		std::atomic_uint64_t				ReservedBytes = 0u;
+	};
+
+	struct ThreadArenas
+	{
+		Arena								Arenas[MaxBufferCount];
+	};
+
+	struct FrameAllocatorState
+	{
+		std::mutex							Mutex;
+		DVector<std::unique_ptr<ThreadArenas>> Threads;
+
+		uint32_t							BufferCount = 1u;
+		size_t								BlockSize = 1024u * 1024u;
+		bool								Initialized = false;
+
+		std::atomic_uint32_t				CurrentBuffer = 0u;
+
+		// Changes when the arenas are released, so that the threads create new ones
+		std::atomic_uint64_t				Generation = 1u;
+	};
+
+	// Never destroyed, so that the threads running at exit can still allocate
+	FrameAllocatorState& GetState()
+	{
+		static auto state = new FrameAllocatorState();
+		return *state;
+	}
+
+	thread_local ThreadArenas*				LocalArenas = nullptr;
+	thread_local uint64_t					LocalGeneration = 0u;
+
+	INLINE void AddCount(std::atomic_uint64_t& counter, uint64_t value)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+
+	ThreadArenas* GetLocalArenas(FrameAllocatorState& state)
+	{
+		auto generation = state.Generation.load(std::memory_order_acquire);
+		if (LocalGeneration == generation)
+			return LocalArenas;
+
+		// Owned by the state so that the memory outlives the thread
+		auto owned = std::make_unique<ThreadArenas>();
+		auto arenas = owned.get();
+
+		{
+			std::scoped_lock lock(state.Mutex);
+			state.Threads.push_back(std::move(owned));
+		}
+
+		LocalArenas = arenas;
+		LocalGeneration = generation;
+		return arenas;
+	}
+
+	Block AllocateBlock(Arena& arena, size_t size, size_t alignment = BlockAlignment)
+	{
+		Block block = { static_cast<std::byte*>(AlignedAlloc(alignment, size)), size };
+		D_ASSERT(block.Memory);
+		AddCount(arena.ReservedBytes, size);
+		TrackAllocation(MemoryTag::Frame, size);
+		return block;
+	}
+
+	void FreeBlock(Block const& block)
+	{
+		AlignedFree(block.Memory);
+		TrackFree(MemoryTag::Frame, block.Size);
+	}
+
+	void ResetArena(Arena& arena)
+	{
+		for (auto const& block : arena.Oversized)
+			FreeBlock(block);
+		arena.Oversized.clear();
+
+		// Keeping only as many blocks as the last frame of the buffer needed
+		size_t used = arena.Blocks.empty() ? 0u : arena.Current + 1u;
+		for (size_t i = used; i < arena.Blocks.size(); i++)
+			FreeBlock(arena.Blocks[i]);
+		arena.Blocks.resize(used);
+
+		arena.Current = 0u;
+		arena.Offset = 0u;
+
+		uint64_t reserved = 0u;
+		for (auto const& block : arena.Blocks)
+			reserved += block.Size;
+
+		arena.Allocations.store(0u, std::memory_order_relaxed);
+		arena.AllocatedBytes.store(0u, std::memory_order_relaxed);
+		arena.ReservedBytes.store(reserved, std::memory_order_relaxed);
+	}
+
+	void ReleaseArena(Arena& arena)
+	{
+		for (auto const& block : arena.Oversized)
+			FreeBlock(block);
+		for (auto const& block : arena.Blocks)
+			FreeBlock(block);
+
+		arena.Oversized.clear();
+		arena.Blocks.clear();
+	}
+
+	// Returns null if the block has no room
+	INLINE std::byte* TryAllocate(Block const& block, size_t& offset, size_t size, size_t alignment)
+	{
+		auto start = AlignUp((size_t)block.Memory + offset, alignment) - (size_t)block.Memory;
+		if (start + size > block.Size)
+			return nullptr;
+
+		offset = start + size;
+		return block.Memory + start;
+	}
+}
+
+namespace Darius::Core::Memory::FrameAllocator
+{
+	void Initialize(uint32_t bufferCount, size_t blockSize)
+	{
+		D_ASSERT(bufferCount > 0u && bufferCount <= MaxBufferCount);
+		D_ASSERT(blockSize > 0u);
+
+		Shutdown();
+
+		auto& state = GetState();
+		std::scoped_lock lock(state.Mutex);
+
+		state.BufferCount = bufferCount;
+		state.BlockSize = blockSize;
+		state.Initialized = true;
+	}
+
+	void Shutdown()
+	{
+		auto& state = GetState();
+		std::scoped_lock lock(state.Mutex);
+
+		for (auto& arenas : state.Threads)
+			for (auto& arena : arenas->Arenas)
+				ReleaseArena(arena);
+		state.Threads.clear();
+
+		state.Initialized = false;
+		state.CurrentBuffer.store(0u, std::memory_order_relaxed);
+		state.Generation.fetch_add(1u, std::memory_order_release);
+	}
+
+	bool IsInitialized()
+	{
+		auto& state = GetState();
+		std::scoped_lock lock(state.Mutex);
+		return state.Initialized;
+	}
+
+	void BeginFrame(uint64_t frameIndex)
+	{
+		auto& state = GetState();
+		std::scoped_lock lock(state.Mutex);
+
+		auto buffer = (uint32_t)(frameIndex % state.BufferCount);
+
+		for (auto& arenas : state.Threads)
+			ResetArena(arenas->Arenas[buffer]);
+
+		state.CurrentBuffer.store(buffer, std::memory_order_release);
+	}
+
+	void* Allocate(size_t size, size_t alignment)
+	{
+		D_ASSERT(alignment > 0u && (alignment & (alignment - 1u)) == 0u);
+
+		auto& state = GetState();
+		auto& arena = GetLocalArenas(state)->Arenas[state.CurrentBuffer.load(std::memory_order_acquire)];
+
+		AddCount(arena.Allocations, 1u);
+		AddCount(arena.AllocatedBytes, size);
+
+		// Allocations not fitting in a block get their own memory, released on reset
+		auto blockSize = state.BlockSize;
+		if (size + alignment > blockSize)
+		{
+			auto block = AllocateBlock(arena, AlignUp(size, BlockAlignment), std::max(alignment, BlockAlignment));
+			arena.Oversized.push_back(block);
+			return block.Memory;
+		}
+
+		if (arena.Blocks.empty())
+			arena.Blocks.push_back(AllocateBlock(arena, blockSize));
+
+		if (auto ptr = TryAllocate(arena.Blocks[arena.Current], arena.Offset, size, alignment))
+			return ptr;
+
+		// Moving to the next block, kept from an earlier frame or newly allocated
+		arena.Current++;
+		arena.Offset = 0u;
+		if (arena.Current == arena.Blocks.size())
+			arena.Blocks.push_back(AllocateBlock(arena, blockSize));
+
+		auto ptr = TryAllocate(arena.Blocks[arena.Current], arena.Offset, size, alignment);
+		D_ASSERT(ptr);
+		return ptr;
+	}
+
+	void Deallocate(void* ptr, size_t size)
+	{
+		if (!ptr)
+			return;
+
+		auto& state = GetState();
+		if (LocalGeneration != state.Generation.load(std::memory_order_acquire))
+			return;
+
+		auto& arena = LocalArenas->Arenas[state.CurrentBuffer.load(std::memory_order_acquire)];
+		if (arena.Blocks.empty())
+			return;
+
+		// Rolling back the latest allocation, so that growing vectors do not waste the arena
+		auto const& block = arena.Blocks[arena.Current];
+		auto bytes = static_cast<std::byte*>(ptr);
+		if (bytes >= block.Memory && bytes + size == block.Memory + arena.Offset)
+			arena.Offset = bytes - block.Memory;
+	}
+
+	FrameAllocatorStats GetStats()
+	{
+		auto& state = GetState();
+		std::scoped_lock lock(state.Mutex);
+
+		auto buffer = state.CurrentBuffer.load(std::memory_order_relaxed);
+
+		FrameAllocatorStats stats;
+		for (auto const& arenas : state.Threads)
+		{
+			auto const& arena = arenas->Arenas[buffer];
+			stats.Allocations += arena.Allocations.load(std::memory_order_relaxed);
+			stats.AllocatedBytes += arena.AllocatedBytes.load(std::memory_order_relaxed);
+			stats.ReservedBytes += arena.ReservedBytes.load(std::memory_order_relaxed);
+		}
+
+		return stats;
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Core/Containers/Vector.hpp"
+
+#include <Utils/Common.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef D_MEMORY
+#define D_MEMORY Darius::Core::Memory
+#endif // !D_MEMORY_ALLOC
+
+#ifndef D_FRAME_ALLOCATOR
+#define D_FRAME_ALLOCATOR Darius::Core::Memory::FrameAllocator
+#endif // !D_FRAME_ALLOCATOR
+
+// Linear allocation of transient data living no longer than a frame. Each thread allocates from
+// its own arena, so allocating does not synchronize. There are as many arenas per thread as
+// buffered frames, and beginning a frame resets the arenas of the frame using the same buffer.
+namespace Darius::Core::Memory::FrameAllocator
+{
+	struct FrameAllocatorStats
+	{
+		uint64_t						Allocations = 0u;
+		uint64_t						AllocatedBytes = 0u;
+		uint64_t						ReservedBytes = 0u;
+	};
+
+	// Buffer count should match the frames in flight
+	void								Initialize(uint32_t bufferCount, size_t blockSize = 1024u * 1024u);
+	void								Shutdown();
+	bool								IsInitialized();
+
+	// Resets the arenas of the buffer of the frame. Must be called while no thread uses frame memory.
+	void								BeginFrame(uint64_t frameIndex);
+
+	void*								Allocate(size_t size, size_t alignment);
+
+	// Memory is only reclaimed if it is the latest allocation of the calling thread
+	void								Deallocate(void* ptr, size_t size);
+
+	// Of the current frame. Exact only when the other threads are not allocating.
+	FrameAllocatorStats					GetStats();
+
+	template<typename T>
+	class FrameStlAllocator
+	{
+	public:
+		using value_type = T;
+
+		FrameStlAllocator() noexcept = default;
+
+		template<typename U>
+		FrameStlAllocator(FrameStlAllocator<U> const&) noexcept { }
+
+		INLINE T* allocate(size_t count)
+		{
+			return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+		}
+
+		INLINE void deallocate(T* ptr, size_t count) noexcept
+		{
+			Deallocate(ptr, count * sizeof(T));
+		}
+
+		template<typename U>
+		INLINE bool operator==(FrameStlAllocator<U> const&) const noexcept { return true; }
+
+		template<typename U>
+		INLINE bool operator!=(FrameStlAllocator<U> const&) const noexcept { return false; }
+	};
+
+	// Must not be kept beyond the frame
+	template<typename T>
+	using DFrameVector = D_CONTAINERS::DVector<T, FrameStlAllocator<T>>;
+}
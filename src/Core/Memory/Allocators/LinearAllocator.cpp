@@ -32,7 +32,7 @@ namespace Darius::Core::Memory
 		if (mMemory != nullptr)
 			Reset();
 
-		mMemory = reinterpret_cast<std::byte*>(DMemAlloc(size));
+		mMemory = reinterpret_cast<std::byte*>(DMemAllocTagged(size, mTag));
 		mTotalSize = size;
 		mAllocatedSize = 0;
 	}
@@ -15,7 +15,7 @@ namespace Darius::Core::Memory
 {
 	void* MallocAllocator::Alloc(size_t size, size_t alignment)
 	{
-		return DMemAlloc(size);
+		return DMemAllocTagged(size, mTag);
 	}
 
 	void MallocAllocator::Free(void* ptr)
@@ -3,88 +3,239 @@
 
 #include "Allocator.hpp"
 
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	// Locks only for the thread safe pools
+	class PoolLock
+	{
+	public:
+		INLINE PoolLock(D_CORE_THREADING::SpinLock const& lock, bool enabled) :
+			mLock(enabled ? &lock : nullptr)
+		{
+			if (mLock)
+				mLock->Lock();
+		}
+
+		INLINE ~PoolLock()
+		{
+			if (mLock)
+				mLock->Unlock();
+		}
+
+	private:
+		D_CORE_THREADING::SpinLock const* mLock;
+	};
+
+	// Free objects hold the index of the next free object
+	INLINE uint32_t& NextFree(std::byte* slot)
+	{
+		return *reinterpret_cast<uint32_t*>(slot);
+	}
+}
+
 namespace Darius::Core::Memory
 {
-	void ObjectPool::Init(Allocator* allocator, uint32_t poolSize, uint32_t objectSize)
+	void ObjectPool::Init(Allocator* allocator, uint32_t chunkSize, uint32_t objectSize, uint32_t objectAlignment, bool threadSafe)
 	{
+		D_ASSERT(allocator);
+		D_ASSERT(chunkSize > 0u && chunkSize <= (1u << 24));
+		D_ASSERT(objectSize > 0u);
+		D_ASSERT(objectAlignment > 0u && (objectAlignment & (objectAlignment - 1u)) == 0u);
+
 		mAllocator = allocator;
-		mPoolSize = poolSize;
-		mObjectsSize = objectSize;
+		mThreadSafe = threadSafe;
 
-		// Group allocate (object size + u32)
-		size_t allocationSize = mPoolSize * (objectSize + sizeof(uint32_t));
-		mMemory = reinterpret_cast<std::byte*>(mAllocator->Alloc(allocationSize, 1));
-		memset(mMemory, 0, allocationSize);
+		mChunkShift = 0u;
+		while ((1u << mChunkShift) < chunkSize)
+			mChunkShift++;
+		mChunkSize = 1u << mChunkShift;
+		mChunkMask = mChunkSize - 1u;
 
-		// Allocate and add free indices
-		mFreeIndices = (uint32_t*)(mMemory + poolSize * mObjectsSize);
-		mFreeIndicesHead = 0;
+		// Room for the free list link in each object
+		mObjectAlignment = std::max(objectAlignment, (uint32_t)alignof(uint32_t));
+		mObjectSize = AlignUp(std::max(objectSize, (uint32_t)sizeof(uint32_t)), mObjectAlignment);
 
-		for (uint32_t i = 0u; i < mPoolSize; i++)
-		{
-			mFreeIndices[i] = i;
-		}
+		mChunks = reinterpret_cast<std::byte**>(mAllocator->Alloc(sizeof(std::byte*) * MaxChunks, alignof(std::byte*)));
+		mChunkCount.store(0u, std::memory_order_relaxed);
+		mFreeHead = kInvalidIndex;
+		mUsedCount = 0u;
 
-		mUsedIndices = 0;
+		AddChunk();
 	}
 
 	void ObjectPool::Shutdown()
 	{
-		if (mFreeIndicesHead != 0)
+		if (mUsedCount != 0u)
 		{
 			D_LOG_ERROR("Object pool has unfreed resources");
 		}
 
-		D_ASSERT(mUsedIndices == 0);
-		mAllocator->Free(mMemory);
+		auto chunkCount = GetChunkCount();
+		for (uint32_t i = 0u; i < chunkCount; i++)
+			mAllocator->Free(mChunks[i]);
+
+		if (mChunks)
+			mAllocator->Free(mChunks);
+
+		mChunks = nullptr;
+		mChunkCount.store(0u, std::memory_order_relaxed);
+		mFreeHead = kInvalidIndex;
+		mUsedCount = 0u;
+	}
+
+	bool ObjectPool::AddChunk()
+	{
+		auto chunkCount = GetChunkCount();
+		if (chunkCount == MaxChunks)
+			return false;
+
+		size_t size = (size_t)mChunkSize * mObjectSize;
+#if D_MEMORY_POOL_GENERATIONS
+		size += mChunkSize * sizeof(uint32_t);
+#endif
+
+		auto chunk = reinterpret_cast<std::byte*>(mAllocator->Alloc(size, mObjectAlignment));
+		D_ASSERT_M(IsAligned(chunk, mObjectAlignment), "Allocator did not align the pool chunk");
+
+#if D_MEMORY_POOL_GENERATIONS
+		std::memset(chunk + (size_t)mChunkSize * mObjectSize, 0, mChunkSize * sizeof(uint32_t));
+#endif
+
+		// Linking the new objects in order in front of the free list
+		uint32_t first = chunkCount << mChunkShift;
+		for (uint32_t i = 0u; i < mChunkSize; i++)
+			NextFree(chunk + (size_t)i * mObjectSize) = i + 1u < mChunkSize ? first + i + 1u : mFreeHead;
+		mFreeHead = first;
+
+		mChunks[chunkCount] = chunk;
+		mChunkCount.store(chunkCount + 1u, std::memory_order_release);
+		return true;
 	}
 
 	uint32_t ObjectPool::ObtainObject()
 	{
-		// TODO: add bits for checking if resource is alive and use bitmasks.
-		if (mFreeIndicesHead < mPoolSize)
+		PoolLock lock(mLock, mThreadSafe);
+
+		if (mFreeHead == kInvalidIndex && !AddChunk())
 		{
-			const uint32_t freeIndex = mFreeIndices[mFreeIndicesHead++];
-			++mUsedIndices;
-			return freeIndex;
+			// Error no more resources left
+			D_ASSERT_NOENTRY();
+			return kInvalidIndex;
 		}
-		// Error no more resources left
-		D_ASSERT_NOENTRY();
 
-		return kInvalidIndex;
+		auto freeIndex = mFreeHead;
+		mFreeHead = NextFree(GetSlot(freeIndex));
+		++mUsedCount;
+
+#if D_MEMORY_POOL_GENERATIONS
+		++GetGenerationSlot(freeIndex);
+#endif
+
+		return freeIndex;
 	}
 
 	void ObjectPool::ReleaseObject(uint32_t index)
 	{
-		// TODO: add bits for checking if resource is alive and use bitmasks.
-		mFreeIndices[--mFreeIndicesHead] = index;
-		--mUsedIndices;
+		D_ASSERT(index < GetCapacity());
+
+		PoolLock lock(mLock, mThreadSafe);
+
+#if D_MEMORY_POOL_GENERATIONS
+		auto& generation = GetGenerationSlot(index);
+		D_ASSERT_M(generation & 1u, "Object pool object released twice");
+		++generation;
+#endif
+
+		NextFree(GetSlot(index)) = mFreeHead;
+		mFreeHead = index;
+		--mUsedCount;
 	}
 
 	void ObjectPool::FreeAllObjects()
 	{
-		mFreeIndices = 0;
-		mUsedIndices = 0;
+		PoolLock lock(mLock, mThreadSafe);
+
+		mFreeHead = kInvalidIndex;
+		mUsedCount = 0u;
 
-		for (uint32_t i = 0; i < mPoolSize; i++)
+		// Linked backwards so that the objects are obtained in order again
+		for (uint32_t index = GetCapacity(); index-- > 0u;)
 		{
-			mFreeIndices[i] = i;
+#if D_MEMORY_POOL_GENERATIONS
+			auto& generation = GetGenerationSlot(index);
+			if (generation & 1u)
+				++generation;
+#endif
+
+			NextFree(GetSlot(index)) = mFreeHead;
+			mFreeHead = index;
 		}
 	}
 
 	void* ObjectPool::AccessObject(uint32_t index)
 	{
-		if (index != kInvalidIndex)
-			return &mMemory[index * mObjectsSize];
-
-		return nullptr;
+		return const_cast<void*>(static_cast<ObjectPool const*>(this)->AccessObject(index));
 	}
 
 	void const* ObjectPool::AccessObject(uint32_t index) const
 	{
-		if (index != kInvalidIndex)
-			return &mMemory[index * mObjectsSize];
+		if (index == kInvalidIndex)
+			return nullptr;
+
+		D_ASSERT(index < GetCapacity());
+
+#if D_MEMORY_POOL_GENERATIONS
+		D_ASSERT_M(GetGenerationSlot(index) & 1u, "Accessing a released object pool object");
+#endif
+
+		return GetSlot(index);
+	}
+
+	uint32_t ObjectPool::GetObjectIndex(void const* object) const
+	{
+		auto address = reinterpret_cast<std::byte const*>(object);
+		auto chunkBytes = (size_t)mChunkSize * mObjectSize;
 
-		return nullptr;
+		// Chunks are few, the newest ones first
+		for (uint32_t chunk = GetChunkCount(); chunk-- > 0u;)
+		{
+			auto begin = mChunks[chunk];
+			if (address < begin || address >= begin + chunkBytes)
+				continue;
+
+			auto offset = (size_t)(address - begin);
+			D_ASSERT_M(offset % mObjectSize == 0u, "Address is not the start of an object pool object");
+
+			return (chunk << mChunkShift) | (uint32_t)(offset / mObjectSize);
+		}
+
+		return kInvalidIndex;
+	}
+
+	uint32_t ObjectPool::GetGeneration(uint32_t index) const
+	{
+#if D_MEMORY_POOL_GENERATIONS
+		D_ASSERT(index < GetCapacity());
+		return GetGenerationSlot(index);
+#else
+		(void)index;
+		return 0u;
+#endif
+	}
+
+	bool ObjectPool::IsAlive(uint32_t index, uint32_t generation) const
+	{
+#if D_MEMORY_POOL_GENERATIONS
+		if (index >= GetCapacity())
+			return false;
+
+		auto current = GetGenerationSlot(index);
+		return current == generation && (current & 1u);
+#else
+		return index < GetCapacity();
+#endif
 	}
 }
@@ -1,58 +1,114 @@
 #pragma once
 
-#include "Core/Containers/Map.hpp"
+#include "Core/MultiThreading/SpinLock.hpp"
 
 #include "Core/Memory/Memory.hpp"
 
 #include <Utils/Log.hpp>
 #include <Utils/Assert.hpp>
 
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
 #ifndef D_MEMORY
 #define D_MEMORY Darius::Core::Memory
 #endif // !D_MEMORY_ALLOC
 
+// Generation counters per object catch double releases and accesses to released objects
+#ifndef D_MEMORY_POOL_GENERATIONS
+#ifdef _DEBUG
+#define D_MEMORY_POOL_GENERATIONS 1
+#else
+#define D_MEMORY_POOL_GENERATIONS 0
+#endif
+#endif // !D_MEMORY_POOL_GENERATIONS
+
 namespace Darius::Core::Memory
 {
 	class Allocator;
 
+	// Pool of objects of a fixed size addressed by index. Objects live in chunks which are never
+	// moved, so growing by a chunk keeps the existing objects in place. Free objects are linked
+	// through their own memory, and an object is mapped back to its index by its address in a chunk.
 	class ObjectPool
 	{
 	public:
-		void					Init(Allocator* allocator, uint32_t poolSize, uint32_t objectSize);
+		// Chunk size is rounded up to a power of two. Thread safe pools lock on obtain and release.
+		void					Init(Allocator* allocator, uint32_t chunkSize, uint32_t objectSize, uint32_t objectAlignment = alignof(std::max_align_t), bool threadSafe = false);
 		void					Shutdown();
 
 		uint32_t				ObtainObject(); // Returns index to the resource
 		void					ReleaseObject(uint32_t index);
+
+		// Releases all the objects without destroying them, keeping the chunks
 		void					FreeAllObjects();
 
 		void*					AccessObject(uint32_t index);
 		void const*				AccessObject(uint32_t index) const;
 
-		INLINE bool				HasAvailableMemory() const { return mFreeIndicesHead < mPoolSize; }
+		// Invalid index if the object is not from the pool
+		uint32_t				GetObjectIndex(void const* object) const;
+
+		// Changes each time the object is obtained or released, always zero without generations
+		uint32_t				GetGeneration(uint32_t index) const;
+		bool					IsAlive(uint32_t index, uint32_t generation) const;
+
+		INLINE bool				HasAvailableMemory() const { return mFreeHead != kInvalidIndex || GetChunkCount() < MaxChunks; }
+		INLINE uint32_t			GetUsedCount() const { return mUsedCount; }
+		INLINE uint32_t			GetCapacity() const { return GetChunkCount() << mChunkShift; }
 
 		static constexpr uint32_t   kInvalidIndex = 0xffffffff;
+		static constexpr uint32_t	MaxChunks = 256u;
 
 	protected:
 
-		std::byte*				mMemory = nullptr;
-		uint32_t*				mFreeIndices = nullptr;
+		// Returns false if there are already as many chunks as possible
+		bool					AddChunk();
+
+		INLINE uint32_t			GetChunkCount() const { return mChunkCount.load(std::memory_order_acquire); }
+
+		INLINE std::byte*		GetSlot(uint32_t index) const
+		{
+			return mChunks[index >> mChunkShift] + (size_t)(index & mChunkMask) * mObjectSize;
+		}
+
+#if D_MEMORY_POOL_GENERATIONS
+		// Stored after the objects of each chunk, odd while the object is alive
+		INLINE uint32_t&		GetGenerationSlot(uint32_t index) const
+		{
+			auto generations = reinterpret_cast<uint32_t*>(mChunks[index >> mChunkShift] + (size_t)mChunkSize * mObjectSize);
+			return generations[index & mChunkMask];
+		}
+#endif
+
+		// Written only when growing, and fixed in size so that reading it needs no lock
+		std::byte**				mChunks = nullptr;
 		Allocator*				mAllocator = nullptr;
 
-		uint32_t				mFreeIndicesHead = 0u;
-		uint32_t				mPoolSize = 16u;
-		uint32_t				mObjectsSize = 4u;
-		uint32_t				mUsedIndices = 0u;
+		std::atomic_uint32_t	mChunkCount = 0u;
+		uint32_t				mChunkSize = 16u;
+		uint32_t				mChunkShift = 4u;
+		uint32_t				mChunkMask = 15u;
+		uint32_t				mObjectSize = 4u;
+		uint32_t				mObjectAlignment = 4u;
+
+		uint32_t				mFreeHead = kInvalidIndex;
+		uint32_t				mUsedCount = 0u;
+
+		bool					mThreadSafe = false;
+		D_CORE_THREADING::SpinLock mLock;
 	};
 
-	template<typename T>
+	template<typename T, bool ThreadSafe = false>
 	class TypedObjectPool : private ObjectPool
 	{
 	public:
-		void					Init(Allocator* allocator, uint32_t poolSize);
+		void					Init(Allocator* allocator, uint32_t chunkSize);
 		void					Shutdown();
 
 		template<typename... Args>
-		T*						Alloc(Args const&&...args);
+		T*						Alloc(Args&&...args);
 		void					Release(T* object);
 
 		T*						Get(uint32_t index);
@@ -61,99 +117,76 @@ namespace Darius::Core::Memory
 		uint32_t				GetIndex(T const* object) const;
 		bool					TryGetIndex(T const* object, uint32_t& result) const;
 
-		INLINE bool				HasAvailableMemory() const { return mFreeIndicesHead < mPoolSize; }
-
-		static constexpr uint32_t   kInvalidIndex = 0xffffffff;
-
-	private:
+		using ObjectPool::GetGeneration;
+		using ObjectPool::IsAlive;
+		using ObjectPool::HasAvailableMemory;
+		using ObjectPool::GetUsedCount;
+		using ObjectPool::GetCapacity;
 
-		D_CONTAINERS::DUnorderedMap<T const*, uint32_t>	mObjectIndexMapping;
+		static constexpr uint32_t   kInvalidIndex = ObjectPool::kInvalidIndex;
 	};
 
-	template<typename T>
-	inline void TypedObjectPool<T>::Init(Allocator* allocator, uint32_t poolSize)
+	template<typename T, bool ThreadSafe>
+	inline void TypedObjectPool<T, ThreadSafe>::Init(Allocator* allocator, uint32_t chunkSize)
 	{
-		ObjectPool::Init(allocator, poolSize, sizeof(T));
+		ObjectPool::Init(allocator, chunkSize, sizeof(T), alignof(T), ThreadSafe);
 	}
 
-	template<typename T>
-	inline void TypedObjectPool<T>::Shutdown()
+	template<typename T, bool ThreadSafe>
+	inline void TypedObjectPool<T, ThreadSafe>::Shutdown()
 	{
-		if (mFreeIndicesHead != 0)
-		{
-			D_LOG_ERROR("Object pool has unfreed resources");
-		}
-
-		mObjectIndexMapping.clear();
-
 		ObjectPool::Shutdown();
 	}
 
-	template<typename T>
+	template<typename T, bool ThreadSafe>
 	template<typename... Args>
-	inline T* TypedObjectPool<T>::Alloc(Args const&&...args)
+	inline T* TypedObjectPool<T, ThreadSafe>::Alloc(Args&&...args)
 	{
 		auto objIndex = ObjectPool::ObtainObject();
-		if (objIndex != kInvalidIndex)
-		{
-			T* obj = Get(objIndex);
-			
-			D_ASSERT(!mObjectIndexMapping.Contains(obj));
-			mObjectIndexMapping[obj] = objIndex;
-			
-			DMemNew_Placement(obj, T(args...));
-			return obj;
-		}
+		if (objIndex == kInvalidIndex)
+			return nullptr;
 
-		return nullptr;
+		return DMemNew_Placement(ObjectPool::AccessObject(objIndex), T(std::forward<Args>(args)...));
 	}
 
-	template<typename T>
-	inline void TypedObjectPool<T>::Release(T* object)
+	template<typename T, bool ThreadSafe>
+	inline void TypedObjectPool<T, ThreadSafe>::Release(T* object)
 	{
-		auto search = mObjectIndexMapping.find(object);
+		auto resIndex = ObjectPool::GetObjectIndex(object);
+		D_ASSERT_M(resIndex != kInvalidIndex, "Object is not from this pool");
 
-		D_ASSERT(search != mObjectIndexMapping.end());
-
-		auto resIndex = search->second;
 		object->~T();
 
 		ObjectPool::ReleaseObject(resIndex);
-
-		mObjectIndexMapping.erase(object);
 	}
 
-	template<typename T>
-	inline T* TypedObjectPool<T>::Get(uint32_t index)
+	template<typename T, bool ThreadSafe>
+	inline T* TypedObjectPool<T, ThreadSafe>::Get(uint32_t index)
 	{
 		return reinterpret_cast<T*>(ObjectPool::AccessObject(index));
 	}
 
-	template<typename T>
-	inline T const* TypedObjectPool<T>::Get(uint32_t index) const
+	template<typename T, bool ThreadSafe>
+	inline T const* TypedObjectPool<T, ThreadSafe>::Get(uint32_t index) const
 	{
 		return reinterpret_cast<T const*>(ObjectPool::AccessObject(index));
 	}
 
-	template<typename T>
-	uint32_t TypedObjectPool<T>::GetIndex(T const* object) const
+	template<typename T, bool ThreadSafe>
+	uint32_t TypedObjectPool<T, ThreadSafe>::GetIndex(T const* object) const
 	{
-		auto search = mObjectIndexMapping.find(object);
-		if (search == mObjectIndexMapping.end())
-			return kInvalidIndex;
-
-		return search->second;
+		return ObjectPool::GetObjectIndex(object);
 	}
 
-	template<typename T>
-	bool TypedObjectPool<T>::TryGetIndex(T const* object, uint32_t& result) const
+	template<typename T, bool ThreadSafe>
+	bool TypedObjectPool<T, ThreadSafe>::TryGetIndex(T const* object, uint32_t& result) const
 	{
-		auto search = mObjectIndexMapping.find(object);
-		if (search == mObjectIndexMapping.end())
+		auto index = ObjectPool::GetObjectIndex(object);
+		if (index == kInvalidIndex)
 			return false;
 
-		result = search->second;
+		result = index;
 		return true;
 	}
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,70 @@
+#include "Core/pch.hpp"
+#include "SlabAllocator.hpp"
+
+#include "Core/Containers/Set.hpp"
+
+#include <mutex>
+
+using namespace D_CONTAINERS;
+
+namespace
+{
+	struct SlabAllocatorRegistry
+	{
+		std::atomic_uint64_t							NextId = 1u;
+
+		std::mutex										Mutex;
+		DSet<uint64_t>									Live;
+	};
+
+	// Constructed on first use, so it outlives the static allocators registered in it
+	SlabAllocatorRegistry& GetRegistry()
+	{
+		static SlabAllocatorRegistry registry;
+		return registry;
+	}
+
+	thread_local DVector<Darius::Core::Memory::Detail::SlabThreadCacheEntry> LocalCaches;
+}
+
+namespace Darius::Core::Memory::Detail
+{
+	uint64_t RegisterSlabAllocator()
+	{
+		auto& registry = GetRegistry();
+		auto id = registry.NextId.fetch_add(1u, std::memory_order_relaxed);
+
+		std::scoped_lock lock(registry.Mutex);
+		registry.Live.insert(id);
+		return id;
+	}
+
+	void UnregisterSlabAllocator(uint64_t allocatorId)
+	{
+		auto& registry = GetRegistry();
+
+		std::scoped_lock lock(registry.Mutex);
+		registry.Live.erase(allocatorId);
+	}
+
+	SlabThreadCache* FindSlabThreadCache(uint64_t allocatorId)
+	{
+		for (auto const& entry : LocalCaches)
+			if (entry.AllocatorId == allocatorId)
+				return entry.Cache;
+
+		return nullptr;
+	}
+
+	void AddSlabThreadCache(uint64_t allocatorId, SlabThreadCache* cache)
+	{
+		auto& registry = GetRegistry();
+
+		std::scoped_lock lock(registry.Mutex);
+
+		// Dropping the caches of the destroyed allocators. Ids are never reused.
+		std::erase_if(LocalCaches, [&](SlabThreadCacheEntry const& entry) { return !registry.Live.contains(entry.AllocatorId); });
+
+		LocalCaches.push_back({ allocatorId, cache });
+	}
+}
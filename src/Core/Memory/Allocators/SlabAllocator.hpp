@@ -0,0 +1,290 @@
+#pragma once
+
+#include "Core/Containers/Vector.hpp"
+#include "Core/MultiThreading/SpinLock.hpp"
+#include "Core/Memory/Memory.hpp"
+
+#include <Utils/Assert.hpp>
+#include <Utils/Log.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+#ifndef D_MEMORY
+#define D_MEMORY Darius::Core::Memory
+#endif // !D_MEMORY_ALLOC
+
+namespace Darius::Core::Memory
+{
+	namespace Detail
+	{
+		struct SlabFreeNode
+		{
+			SlabFreeNode*				Next;
+		};
+
+		// Free objects of an allocator cached by one thread. Only the owner thread changes it.
+		struct SlabThreadCache
+		{
+			SlabFreeNode*				Head = nullptr;
+			uint32_t					Count = 0u;
+
+			// Allocations minus frees of the thread, negative if it frees objects of other threads
+			std::atomic_int64_t			Allocated = 0;
+		};
+
+		struct SlabThreadCacheEntry
+		{
+			uint64_t					AllocatorId = 0u;
+			SlabThreadCache*			Cache = nullptr;
+		};
+
+		// Last used cache of the thread, so that a thread using one allocator finds it without a search
+		inline thread_local SlabThreadCacheEntry LastSlabThreadCache;
+
+		uint64_t						RegisterSlabAllocator();
+		void							UnregisterSlabAllocator(uint64_t allocatorId);
+
+		// Searches the caches of the calling thread, returns null if the thread has none for the allocator
+		SlabThreadCache*				FindSlabThreadCache(uint64_t allocatorId);
+		void							AddSlabThreadCache(uint64_t allocatorId, SlabThreadCache* cache);
+	}
+
+	// Allocates objects from slabs of a fixed number of objects. Each thread keeps a cache of free
+	// objects, so allocating and freeing do not synchronize with the other threads. Caches exchange
+	// batches of free objects with a central depot, and the depot allocates a new slab when empty.
+	// Objects may be freed on any thread. Slabs are released on reset when no object is alive.
+	template<class T, uint32_t BatchSize = 32u>
+	class SlabAllocator
+	{
+		D_STATIC_ASSERT(BatchSize > 0u);
+
+		using FreeNode = Detail::SlabFreeNode;
+		using ThreadCache = Detail::SlabThreadCache;
+
+		static constexpr size_t			ObjectAlignment = std::max(alignof(T), alignof(FreeNode));
+		static constexpr size_t			ObjectSize = AlignUp(std::max(sizeof(T), sizeof(FreeNode)), ObjectAlignment);
+
+		struct Batch
+		{
+			FreeNode*					Head;
+			uint32_t					Count;
+		};
+
+	public:
+		enum
+		{
+			DEFAULT_SLAB_SIZE = 1024
+		};
+
+		SlabAllocator(uint32_t slabSize = DEFAULT_SLAB_SIZE, MemoryTag tag = GetCurrentMemoryTag()) :
+			mSlabSize(std::max(slabSize, BatchSize)),
+			mId(Detail::RegisterSlabAllocator()),
+			mTag(tag)
+		{ }
+
+		~SlabAllocator()
+		{
+			Detail::UnregisterSlabAllocator(mId);
+
+			if (GetAliveCount() > 0)
+			{
+				// Slabs are kept as the alive objects may still be used
+				D_LOG_ERROR_FMT("Objects alive at exit in SlabAllocator:{}", typeid(T).name());
+				return;
+			}
+
+			ReleaseSlabs();
+		}
+
+		SlabAllocator(SlabAllocator const&) = delete;
+		SlabAllocator& operator=(SlabAllocator const&) = delete;
+
+		template<class... Args>
+		T* Alloc(Args&&... args)
+		{
+			auto cache = GetThreadCache();
+
+			if (!cache->Head)
+				Refill(*cache);
+
+			auto node = cache->Head;
+			cache->Head = node->Next;
+			cache->Count--;
+			cache->Allocated.store(cache->Allocated.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+			return new (node) T(std::forward<Args>(args)...);
+		}
+
+		void Free(T* object)
+		{
+			if (!object)
+				return;
+
+			object->~T();
+
+			auto cache = GetThreadCache();
+
+			auto node = reinterpret_cast<FreeNode*>(object);
+			node->Next = cache->Head;
+			cache->Head = node;
+			cache->Count++;
+			cache->Allocated.store(cache->Allocated.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+
+			// Keeping a batch for the next allocations and returning the rest
+			if (cache->Count >= BatchSize * 2u)
+				ReturnBatch(*cache);
+		}
+
+		// Releases the slabs if no object is alive, or trivially destructible objects are allowed
+		// to be left alive. Must not be called while other threads use the allocator.
+		void Reset(bool allowUnfreed = false)
+		{
+			if (!(allowUnfreed && std::is_trivially_destructible_v<T>) && GetAliveCount() > 0)
+				return;
+
+			ReleaseSlabs();
+		}
+
+		// Exact only when the other threads are not allocating or freeing
+		int64_t GetAliveCount() const
+		{
+			mLock.Lock();
+
+			int64_t alive = 0;
+			for (auto const& cache : mCaches)
+				alive += cache->Allocated.load(std::memory_order_relaxed);
+
+			mLock.Unlock();
+			return alive;
+		}
+
+		uint32_t GetSlabCount() const
+		{
+			mLock.Lock();
+			auto count = (uint32_t)mSlabs.size();
+			mLock.Unlock();
+			return count;
+		}
+
+		INLINE uint32_t GetSlabSize() const { return mSlabSize; }
+
+	private:
+		ThreadCache* GetThreadCache()
+		{
+			auto& last = Detail::LastSlabThreadCache;
+			if (last.AllocatorId == mId)
+				return last.Cache;
+
+			auto cache = Detail::FindSlabThreadCache(mId);
+			if (!cache)
+			{
+				// Owned by the allocator so that its objects outlive the thread
+				auto owned = std::make_unique<ThreadCache>();
+				cache = owned.get();
+
+				mLock.Lock();
+				mCaches.push_back(std::move(owned));
+				mLock.Unlock();
+
+				Detail::AddSlabThreadCache(mId, cache);
+			}
+
+			last = { mId, cache };
+			return cache;
+		}
+
+		void Refill(ThreadCache& cache)
+		{
+			mLock.Lock();
+
+			if (mBatches.empty())
+				AllocateSlab();
+
+			auto batch = mBatches.back();
+			mBatches.pop_back();
+
+			mLock.Unlock();
+
+			cache.Head = batch.Head;
+			cache.Count = batch.Count;
+		}
+
+		void ReturnBatch(ThreadCache& cache)
+		{
+			Batch batch = { cache.Head, BatchSize };
+
+			auto last = cache.Head;
+			for (uint32_t i = 1u; i < BatchSize; i++)
+				last = last->Next;
+
+			cache.Head = last->Next;
+			cache.Count -= BatchSize;
+			last->Next = nullptr;
+
+			mLock.Lock();
+			mBatches.push_back(batch);
+			mLock.Unlock();
+		}
+
+		// Called with the lock held
+		void AllocateSlab()
+		{
+			auto slab = static_cast<std::byte*>(AlignedAlloc(ObjectAlignment, ObjectSize * mSlabSize));
+			D_ASSERT(slab);
+			mSlabs.push_back(slab);
+			TrackAllocation(mTag, ObjectSize * mSlabSize);
+
+			// Carving the slab into batches
+			for (uint32_t first = 0u; first < mSlabSize; first += BatchSize)
+			{
+				uint32_t count = std::min(BatchSize, mSlabSize - first);
+
+				for (uint32_t i = 0u; i < count; i++)
+				{
+					auto node = reinterpret_cast<FreeNode*>(slab + (size_t)(first + i) * ObjectSize);
+					node->Next = i + 1u < count ? reinterpret_cast<FreeNode*>(slab + (size_t)(first + i + 1u) * ObjectSize) : nullptr;
+				}
+
+				mBatches.push_back({ reinterpret_cast<FreeNode*>(slab + (size_t)first * ObjectSize), count });
+			}
+		}
+
+		void ReleaseSlabs()
+		{
+			mLock.Lock();
+
+			for (auto slab : mSlabs)
+			{
+				AlignedFree(slab);
+				TrackFree(mTag, ObjectSize * mSlabSize);
+			}
+			mSlabs.clear();
+			mBatches.clear();
+
+			// The caches stay registered for their threads, but point to no memory
+			for (auto& cache : mCaches)
+			{
+				cache->Head = nullptr;
+				cache->Count = 0u;
+				cache->Allocated.store(0, std::memory_order_relaxed);
+			}
+
+			mLock.Unlock();
+		}
+
+		uint32_t const					mSlabSize;
+		uint64_t const					mId;
+		MemoryTag const					mTag;
+
+		// Guards the depot, the slabs and the cache list
+		D_CORE_THREADING::SpinLock		mLock;
+		D_CONTAINERS::DVector<Batch>	mBatches;
+		D_CONTAINERS::DVector<std::byte*> mSlabs;
+		D_CONTAINERS::DVector<std::unique_ptr<ThreadCache>> mCaches;
+	};
+}
@@ -25,7 +25,7 @@ namespace Darius::Core::Memory
 		if (mMemory != nullptr)
 			Reset();
 
-		mMemory = (std::byte*)DMemAlloc(size);
+		mMemory = (std::byte*)DMemAllocTagged(size, mTag);
 		mAllocatedSize = 0;
 		mTotalSize = 0;
 	}
@@ -2,6 +2,8 @@
 
 #include <Utils/Assert.hpp>
 
+#include <algorithm>
+
 using namespace D_CORE_THREADING;
 
 namespace Darius::Core::Memory
@@ -31,43 +33,38 @@ namespace Darius::Core::Memory
     /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
     // A faster version of memcopy that uses SSE instructions.  TODO:  Write an ARM variant if necessary.
 
-#if _DEBUG
-    SafeNumeric<uint64_t> MemoryManager::MemUsage;
-    SafeNumeric<uint64_t> MemoryManager::MaxUsage;
-#endif // _DEBUG
-
-    SafeNumeric<uint64_t> MemoryManager::AllocCount;
+    // Header word: size in the low bits, then whether the allocation is sampled, then the tag
+    constexpr uint64_t SizeMask = (1ull << 55) - 1u;
+    constexpr uint64_t SampledBit = 1ull << 55;
+    constexpr int TagShift = 56;
 
+    INLINE uint64_t MakeHeader(size_t bytes, MemoryTag tag, bool sampled) {
+        D_ASSERT((bytes & ~SizeMask) == 0u);
+        return (uint64_t)bytes | (sampled ? SampledBit : 0u) | ((uint64_t)tag << TagShift);
+    }
 
-    void* MemoryManager::AllocStatic(size_t bytes, bool padAlign) {
-#ifdef _DEBUG
-        bool prepad = true;
-#else
-        bool prepad = padAlign;
-#endif
+    INLINE MemoryTag GetHeaderTag(uint64_t header) {
+        return (MemoryTag)(header >> TagShift);
+    }
 
-        void* mem = malloc(bytes + (prepad ? D_PAD_ALIGN : 0));
+    void* MemoryManager::AllocStatic(size_t bytes, bool padAlign, MemoryTag tag) {
+        void* mem = malloc(bytes + D_PAD_ALIGN);
 
         if (!D_VERIFY(mem))
-            return nullptr; 
+            return nullptr;
 
-        AllocCount.Increment();
+        bool sampled = ShouldSampleAllocation();
 
-        if (prepad) {
-            uint64_t* s = (uint64_t*)mem;
-            *s = bytes;
+        uint64_t* s = (uint64_t*)mem;
+        *s = MakeHeader(bytes, tag, sampled);
 
-            uint8_t* s8 = (uint8_t*)mem;
+        TrackAllocation(tag, bytes);
 
-#ifdef _DEBUG
-            uint64_t new_MemUsage = MemUsage.Add(bytes);
-            MaxUsage.ExchangeIfGreater(new_MemUsage);
-#endif
-            return s8 + D_PAD_ALIGN;
-        }
-        else {
-            return mem;
-        }
+        uint8_t* s8 = (uint8_t*)mem + D_PAD_ALIGN;
+        if (sampled)
+            RecordAllocationSample(s8, bytes, tag);
+
+        return s8;
     }
 
     void* MemoryManager::ReallocStatic(void* memory, size_t bytes, bool padAlign) {
@@ -75,85 +72,48 @@ namespace Darius::Core::Memory
             return AllocStatic(bytes, padAlign);
         }
 
-        uint8_t* mem = (uint8_t*)memory;
-
-#ifdef _DEBUG
-        bool prepad = true;
-#else
-        bool prepad = padAlign;
-#endif
-
-        if (prepad) {
-            mem -= D_PAD_ALIGN;
-            uint64_t* s = (uint64_t*)mem;
-
-#ifdef _DEBUG
-            if (bytes > *s) {
-                uint64_t new_MemUsage = MemUsage.Add(bytes - *s);
-                MaxUsage.ExchangeIfGreater(new_MemUsage);
-            }
-            else
-            {
-                MemUsage.Sub(*s - bytes);
-            }
-#endif
-
-            if (bytes == 0) {
-                free(mem);
-                return nullptr;
-            }
-            else {
-                *s = bytes;
-
-                mem = (uint8_t*)realloc(mem, bytes + D_PAD_ALIGN);
-                if(!D_VERIFY(mem))
-                    return nullptr;
+        if (bytes == 0) {
+            FreeStatic(memory, padAlign);
+            return nullptr;
+        }
 
-                s = (uint64_t*)mem;
+        uint8_t* mem = (uint8_t*)memory - D_PAD_ALIGN;
+        uint64_t header = *(uint64_t*)mem;
+        auto tag = GetHeaderTag(header);
 
-                *s = bytes;
+        if (header & SampledBit)
+            RemoveAllocationSample(memory);
 
-                return mem + D_PAD_ALIGN;
-            }
-        }
-        else {
-            mem = (uint8_t*)realloc(mem, bytes);
+        mem = (uint8_t*)realloc(mem, bytes + D_PAD_ALIGN);
+        if (!D_VERIFY(mem))
+            return nullptr;
 
-            if(mem == nullptr && bytes > 0)
-                return nullptr;
+        // Counted as a new allocation of the tag
+        TrackFree(tag, header & SizeMask);
+        TrackAllocation(tag, bytes);
 
-            return mem;
-        }
+        *(uint64_t*)mem = MakeHeader(bytes, tag, false);
+        return mem + D_PAD_ALIGN;
     }
 
     void MemoryManager::FreeStatic(void* ptr, bool padAlign) {
-        
+
         if (ptr == nullptr)
             return;
 
-        uint8_t* mem = (uint8_t*)ptr;
-
-#ifdef _DEBUG
-        bool prepad = true;
-#else
-        bool prepad = padAlign;
-#endif
+        uint8_t* mem = (uint8_t*)ptr - D_PAD_ALIGN;
+        uint64_t header = *(uint64_t*)mem;
 
-        AllocCount.Decrement();
+        if (header & SampledBit)
+            RemoveAllocationSample(ptr);
 
-        if (prepad) {
-            mem -= D_PAD_ALIGN;
+        TrackFree(GetHeaderTag(header), header & SizeMask);
 
-#ifdef _DEBUG
-            uint64_t* s = (uint64_t*)mem;
-            MemUsage.Sub(*s);
-#endif
+        free(mem);
+    }
 
-            free(mem);
-        }
-        else {
-            free(mem);
-        }
+    MemoryTag MemoryManager::GetTag(void const* ptr) {
+        return GetHeaderTag(*(uint64_t const*)((uint8_t const*)ptr - D_PAD_ALIGN));
     }
 
     uint64_t MemoryManager::GetMemAvailable() {
@@ -161,19 +121,15 @@ namespace Darius::Core::Memory
     }
 
     uint64_t MemoryManager::GetMemUsage() {
-#ifdef _DEBUG
-        return MemUsage.Get();
-#else
-        return 0;
-#endif
+        int64_t usage = 0;
+        for (auto const& stats : GetAllMemoryTagStats())
+            usage += stats.Bytes;
+
+        return (uint64_t)std::max(usage, (int64_t)0);
     }
 
     uint64_t MemoryManager::GetMemMaxUsage() {
-#ifdef _DEBUG
-        return MaxUsage.Get();
-#else
-        return 0;
-#endif
+        return (uint64_t)std::max(GetTotalPeakBytes(), (int64_t)GetMemUsage());
     }
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include "Core/Memory/MemoryTracking.hpp"
 #include "Core/MultiThreading/SafeNumeric.hpp"
 
 #include <Utils/Common.hpp>
@@ -50,20 +51,17 @@ namespace Darius::Core::Memory
 	/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
 	/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 
+	// Every allocation is prefixed with a header of its size and tag, so usage is tracked in
+	// all builds. The header is always there, padAlign is kept for the existing callers.
 	class MemoryManager
 	{
-#if _DEBUG
-		static D_CORE_THREADING::SafeNumeric<uint64_t> MaxUsage;
-		static D_CORE_THREADING::SafeNumeric<uint64_t> MemUsage;
-#endif
-
-		static D_CORE_THREADING::SafeNumeric<uint64_t> AllocCount;
-
 	public:
-		static void* AllocStatic(size_t bytes, bool padAlign = false);
+		static void* AllocStatic(size_t bytes, bool padAlign = false, MemoryTag tag = GetCurrentMemoryTag());
 		static void* ReallocStatic(void* memory, size_t, bool padAlign = false);
 		static void FreeStatic(void* ptr, bool padAlign = false);
 
+		static MemoryTag GetTag(void const* ptr);
+
 		static uint64_t GetMemAvailable();
 		static uint64_t GetMemUsage();
 		static uint64_t GetMemMaxUsage();
@@ -158,7 +156,7 @@ namespace Darius::Core::Memory
 			}
 		}
 
-		MemoryManager::free_static(ptr, true);
+		MemoryManager::FreeStatic(ptr, true);
 	}
 
 	template<typename T, std::size_t Alignment = 64>
@@ -242,6 +240,7 @@ void operator delete(void* mem, void* (*allocfunc)(size_t size));
 void operator delete(void* mem, void* pointer, size_t check, const char* description);
 
 #define DMemAlloc(size) D_MEMORY::MemoryManager::AllocStatic(size)
+#define DMemAllocTagged(size, tag) D_MEMORY::MemoryManager::AllocStatic(size, false, tag)
 #define DMemRealloc(mem, size) D_MEMORY::MemoryManager::ReallocStatic(mem, size)
 #define DMemFree(mem) D_MEMORY::MemoryManager::FreeStatic(mem)
 
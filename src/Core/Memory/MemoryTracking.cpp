@@ -0,0 +1,181 @@
+#include "Core/pch.hpp"
+#include "MemoryTracking.hpp"
+
+#include "Core/Containers/Map.hpp"
+
+#include <Utils/Assert.hpp>
+
+#include <algorithm>
+#include <mutex>
+
+using namespace D_CONTAINERS;
+using namespace Darius::Core::Memory::Detail;
+
+namespace
+{
+	using namespace D_MEMORY;
+
+	struct TrackingState
+	{
+		std::mutex							Mutex;
+
+		// Counters live as long as the program, since frees of other threads are counted in them
+		DVector<ThreadMemoryCounters*>		Threads;
+
+		int64_t								Peaks[(size_t)MemoryTag::Count] = {};
+		int64_t								TotalPeak = 0;
+
+		std::mutex							SamplesMutex;
+		DUnorderedMap<void const*, MemorySample> Samples;
+	};
+
+	// Never destroyed, so that the allocations at exit can still be tracked
+	TrackingState& GetState()
+	{
+		static auto state = new TrackingState();
+		return *state;
+	}
+
+	char const* const						TagNames[] =
+	{
+		"General",
+		"Resource",
+		"Graphics",
+		"Renderer",
+		"Scene",
+		"Physics",
+		"Animation",
+		"Audio",
+		"Editor",
+		"Frame"
+	};
+
+	D_STATIC_ASSERT(sizeof(TagNames) / sizeof(TagNames[0]) == (size_t)MemoryTag::Count);
+
+	// Called with the lock held
+	void SumCounters(TrackingState const& state, std::array<MemoryTagStats, (size_t)MemoryTag::Count>& stats)
+	{
+		for (auto counters : state.Threads)
+		{
+			for (size_t i = 0u; i < (size_t)MemoryTag::Count; i++)
+			{
+				auto const& tag = counters->Tags[i];
+				stats[i].Bytes += tag.Bytes.load(std::memory_order_relaxed);
+				stats[i].Allocations += tag.Allocations.load(std::memory_order_relaxed);
+				stats[i].TotalAllocations += tag.TotalAllocations.load(std::memory_order_relaxed);
+				stats[i].HighWaterBytes += tag.HighWaterBytes.load(std::memory_order_relaxed);
+			}
+		}
+
+		for (size_t i = 0u; i < (size_t)MemoryTag::Count; i++)
+			stats[i].PeakBytes = std::max(state.Peaks[i], stats[i].Bytes);
+	}
+
+	uint32_t CaptureStack(void** frames, uint32_t maxFrames)
+	{
+		// Skipping this function and the recording one
+		return (uint32_t)RtlCaptureStackBackTrace(2u, maxFrames, frames, nullptr);
+	}
+}
+
+namespace Darius::Core::Memory
+{
+	namespace Detail
+	{
+		ThreadMemoryCounters* CreateLocalMemoryCounters()
+		{
+			// Not allocated through the memory manager, which would be tracked by these counters
+			auto counters = new ThreadMemoryCounters();
+
+			auto& state = GetState();
+			{
+				std::scoped_lock lock(state.Mutex);
+				state.Threads.push_back(counters);
+			}
+
+			LocalMemoryCounters = counters;
+			return counters;
+		}
+	}
+
+	char const* GetMemoryTagName(MemoryTag tag)
+	{
+		return tag < MemoryTag::Count ? TagNames[(size_t)tag] : "Unknown";
+	}
+
+	MemoryTagStats GetMemoryTagStats(MemoryTag tag)
+	{
+		D_ASSERT(tag < MemoryTag::Count);
+		return GetAllMemoryTagStats()[(size_t)tag];
+	}
+
+	std::array<MemoryTagStats, (size_t)MemoryTag::Count> GetAllMemoryTagStats()
+	{
+		auto& state = GetState();
+		std::scoped_lock lock(state.Mutex);
+
+		std::array<MemoryTagStats, (size_t)MemoryTag::Count> stats;
+		SumCounters(state, stats);
+		return stats;
+	}
+
+	void UpdateMemoryTagPeaks()
+	{
+		auto& state = GetState();
+		std::scoped_lock lock(state.Mutex);
+
+		std::array<MemoryTagStats, (size_t)MemoryTag::Count> stats;
+		SumCounters(state, stats);
+
+		int64_t total = 0;
+		for (size_t i = 0u; i < (size_t)MemoryTag::Count; i++)
+		{
+			state.Peaks[i] = stats[i].PeakBytes;
+			total += stats[i].Bytes;
+		}
+
+		state.TotalPeak = std::max(state.TotalPeak, total);
+	}
+
+	int64_t GetTotalPeakBytes()
+	{
+		auto& state = GetState();
+		std::scoped_lock lock(state.Mutex);
+		return state.TotalPeak;
+	}
+
+	void SetAllocationSampling(uint32_t interval)
+	{
+		SamplingInterval.store(interval, std::memory_order_relaxed);
+	}
+
+	void RecordAllocationSample(void const* address, size_t size, MemoryTag tag)
+	{
+		MemorySample sample;
+		sample.Address = address;
+		sample.Size = size;
+		sample.Tag = tag;
+		sample.FrameCount = CaptureStack(sample.Frames, MemorySample::MaxFrames);
+
+		auto& state = GetState();
+		std::scoped_lock lock(state.SamplesMutex);
+		state.Samples.insert_or_assign(address, sample);
+	}
+
+	void RemoveAllocationSample(void const* address)
+	{
+		auto& state = GetState();
+		std::scoped_lock lock(state.SamplesMutex);
+		state.Samples.erase(address);
+	}
+
+	void GetAllocationSamples(DVector<MemorySample>& samples)
+	{
+		auto& state = GetState();
+		std::scoped_lock lock(state.SamplesMutex);
+
+		samples.reserve(samples.size() + state.Samples.size());
+		for (auto const& [address, sample] : state.Samples)
+			samples.push_back(sample);
+	}
+}
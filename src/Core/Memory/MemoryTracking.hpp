@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Core/Containers/Vector.hpp"
+
+#include <Utils/Common.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#ifndef D_MEMORY
+#define D_MEMORY Darius::Core::Memory
+#endif // !D_MEMORY
+
+// Memory usage is counted per tag on the allocating thread, without synchronization, so the
+// tracking stays on in release. The counters of all threads are summed when stats are requested.
+namespace Darius::Core::Memory
+{
+	enum class MemoryTag : uint8_t
+	{
+		General,
+		Resource,
+		Graphics,
+		Renderer,
+		Scene,
+		Physics,
+		Animation,
+		Audio,
+		Editor,
+		Frame,
+
+		Count
+	};
+
+	struct MemoryTagStats
+	{
+		int64_t								Bytes = 0;
+		int64_t								Allocations = 0;
+		uint64_t							TotalAllocations = 0u;
+
+		// Highest bytes seen when the peaks are updated
+		int64_t								PeakBytes = 0;
+
+		// Sum of the highest bytes of each thread, never below the real peak
+		int64_t								HighWaterBytes = 0;
+	};
+
+	struct MemorySample
+	{
+		static constexpr uint32_t			MaxFrames = 16u;
+
+		void const*							Address;
+		size_t								Size;
+		MemoryTag							Tag;
+		uint32_t							FrameCount;
+		void*								Frames[MaxFrames];
+	};
+
+	namespace Detail
+	{
+		struct MemoryTagCounters
+		{
+			std::atomic_int64_t				Bytes = 0;
+			std::atomic_int64_t				Allocations = 0;
+			std::atomic_uint64_t			TotalAllocations = 0u;
+			std::atomic_int64_t				HighWaterBytes = 0;
+		};
+
+		// Written only by the owner thread, read by any thread
+		struct ThreadMemoryCounters
+		{
+			MemoryTagCounters				Tags[(size_t)MemoryTag::Count];
+			uint32_t						SampleCountdown = 0u;
+		};
+
+		inline thread_local ThreadMemoryCounters* LocalMemoryCounters = nullptr;
+		inline thread_local MemoryTag		LocalMemoryTag = MemoryTag::General;
+
+		inline std::atomic_uint32_t			SamplingInterval = 0u;
+
+		ThreadMemoryCounters*				CreateLocalMemoryCounters();
+
+		INLINE void Add(std::atomic_int64_t& counter, int64_t value)
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+	}
+
+	INLINE MemoryTag GetCurrentMemoryTag() { return Detail::LocalMemoryTag; }
+
+	char const*								GetMemoryTagName(MemoryTag tag);
+
+	// Sets the tag of the allocations of the thread until destroyed
+	class MemoryTagScope
+	{
+	public:
+		INLINE explicit MemoryTagScope(MemoryTag tag) :
+			mPrevious(Detail::LocalMemoryTag)
+		{
+			Detail::LocalMemoryTag = tag;
+		}
+
+		INLINE ~MemoryTagScope()
+		{
+			Detail::LocalMemoryTag = mPrevious;
+		}
+
+		MemoryTagScope(MemoryTagScope const&) = delete;
+		MemoryTagScope& operator=(MemoryTagScope const&) = delete;
+
+	private:
+		MemoryTag							mPrevious;
+	};
+
+	INLINE void TrackAllocation(MemoryTag tag, size_t bytes)
+	{
+		auto counters = Detail::LocalMemoryCounters;
+		if (!counters)
+			counters = Detail::CreateLocalMemoryCounters();
+
+		auto& tagCounters = counters->Tags[(size_t)tag];
+
+		auto current = tagCounters.Bytes.load(std::memory_order_relaxed) + (int64_t)bytes;
+		tagCounters.Bytes.store(current, std::memory_order_relaxed);
+		Detail::Add(tagCounters.Allocations, 1);
+		tagCounters.TotalAllocations.store(tagCounters.TotalAllocations.load(std::memory_order_relaxed) + 1u, std::memory_order_relaxed);
+
+		if (current > tagCounters.HighWaterBytes.load(std::memory_order_relaxed))
+			tagCounters.HighWaterBytes.store(current, std::memory_order_relaxed);
+	}
+
+	// May be called on another thread than the allocation
+	INLINE void TrackFree(MemoryTag tag, size_t bytes)
+	{
+		auto counters = Detail::LocalMemoryCounters;
+		if (!counters)
+			counters = Detail::CreateLocalMemoryCounters();
+
+		auto& tagCounters = counters->Tags[(size_t)tag];
+		Detail::Add(tagCounters.Bytes, -(int64_t)bytes);
+		Detail::Add(tagCounters.Allocations, -1);
+	}
+
+	MemoryTagStats							GetMemoryTagStats(MemoryTag tag);
+	std::array<MemoryTagStats, (size_t)MemoryTag::Count> GetAllMemoryTagStats();
+
+	// Samples the current usage into the peaks, called once a frame
+	void									UpdateMemoryTagPeaks();
+
+	// Highest total usage seen when the peaks are updated
+	int64_t									GetTotalPeakBytes();
+
+	// Captures the call stack of one in the given number of allocations, zero disables it
+	void									SetAllocationSampling(uint32_t interval);
+
+	INLINE bool ShouldSampleAllocation()
+	{
+		auto interval = Detail::SamplingInterval.load(std::memory_order_relaxed);
+		if (interval == 0u)
+			return false;
+
+		auto counters = Detail::LocalMemoryCounters;
+		if (!counters)
+			counters = Detail::CreateLocalMemoryCounters();
+
+		if (counters->SampleCountdown > 0u && --counters->SampleCountdown > 0u)
+			return false;
+
+		counters->SampleCountdown = interval;
+		return true;
+	}
+
+	void									RecordAllocationSample(void const* address, size_t size, MemoryTag tag);
+	void									RemoveAllocationSample(void const* address);
+
+	// Sampled allocations not freed yet
+	void									GetAllocationSamples(D_CONTAINERS::DVector<MemorySample>& samples);
+}
+
+#define D_MEMORY_TAG_SCOPE(tag) D_MEMORY::MemoryTagScope D_H_UNIQUE_NAME(_memoryTagScope)(D_MEMORY::MemoryTag::tag)
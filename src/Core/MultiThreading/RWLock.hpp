@@ -1,8 +1,11 @@
 #pragma once
 
+#include "SpinLock.hpp"
+
 #include <Utils/Common.hpp>
 
-#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
 
 #ifndef D_CORE_THREADING
 #define D_CORE_THREADING Darius::Core::MultiThreading
@@ -11,6 +14,8 @@
 
 namespace Darius::Core::MultiThreading
 {
+	// Reader/writer lock preferring writers: once a writer waits, new readers wait too so that a
+	// steady stream of readers cannot starve it. Spins for a short while before parking.
 	class RWLock
 	{
 	public:
@@ -18,41 +23,125 @@ namespace Darius::Core::MultiThreading
 		// Locks as reader. Block if locked by writer
 		INLINE void ReadLock() const
 		{
-			mMutex.lock_shared();
+			if (!ReadTryLock())
+				ReadLockContended();
 		}
 
 		// Unlock as reader. Let other threads continue
 		INLINE void ReadUnlock() const
 		{
-			mMutex.unlock_shared();
+			auto previous = mState.fetch_sub(1u, std::memory_order_release);
+
+			// Last reader out lets the waiting writers in
+			if ((previous & ReaderMask) == 1u && (previous & WriterWaiting))
+				WakeParked();
 		}
 
 		// Attempt to lock for reading. True on success, false if can't lock
 		INLINE bool ReadTryLock() const
 		{
-			return mMutex.try_lock_shared();
+			auto state = mState.load(std::memory_order_relaxed);
+			while (!(state & (WriterLocked | WriterWaiting)))
+			{
+				if (mState.compare_exchange_weak(state, state + 1u, std::memory_order_acquire, std::memory_order_relaxed))
+					return true;
+			}
+			return false;
 		}
 
 		// Lock as writer. Block if already locked.
 		INLINE void WriteLock()
 		{
-			mMutex.lock();
+			if (!WriterTryLock())
+				WriteLockContended();
 		}
 
 		// Unlock as writer, let others continue
 		INLINE void WriterUnlock()
 		{
-			mMutex.unlock();
+			mState.fetch_and(~WriterLocked, std::memory_order_release);
+			WakeParked();
 		}
 
 		// Attempt to lock as writer. True on success, false if can't lock
 		INLINE bool WriterTryLock()
 		{
-			return mMutex.try_lock();
+			auto state = mState.load(std::memory_order_relaxed);
+			while (!(state & (WriterLocked | ReaderMask)))
+			{
+				if (mState.compare_exchange_weak(state, state | WriterLocked, std::memory_order_acquire, std::memory_order_relaxed))
+					return true;
+			}
+			return false;
 		}
 
 	private:
-		mutable std::shared_timed_mutex mMutex;
+		static constexpr uint32_t		WriterLocked = 1u << 31;
+		static constexpr uint32_t		WriterWaiting = 1u << 30;
+		static constexpr uint32_t		ReaderMask = WriterWaiting - 1u;
+
+		void ReadLockContended() const
+		{
+			Backoff backoff;
+			while (true)
+			{
+				if (ReadTryLock())
+					return;
+
+				auto state = mState.load(std::memory_order_relaxed);
+				if ((state & (WriterLocked | WriterWaiting)) && !backoff.Spin())
+					Park(state);
+			}
+		}
+
+		void WriteLockContended()
+		{
+			mWaitingWriters.fetch_add(1u, std::memory_order_relaxed);
+
+			Backoff backoff;
+			while (true)
+			{
+				auto state = mState.load(std::memory_order_relaxed);
+
+				// Set again each time, since the last writer to take the lock clears it
+				if (!(state & WriterWaiting))
+					state = mState.fetch_or(WriterWaiting, std::memory_order_relaxed) | WriterWaiting;
+
+				if (!(state & (WriterLocked | ReaderMask)))
+				{
+					if (mState.compare_exchange_weak(state, state | WriterLocked, std::memory_order_acquire, std::memory_order_relaxed))
+						break;
+					continue;
+				}
+
+				if (!backoff.Spin())
+					Park(state);
+			}
+
+			// Readers may come in again once no writer waits
+			if (mWaitingWriters.fetch_sub(1u, std::memory_order_relaxed) == 1u)
+				mState.fetch_and(~WriterWaiting, std::memory_order_relaxed);
+		}
+
+		void Park(uint32_t state) const
+		{
+			// Paired with the wake, either it sees the sleeper or the wait sees the new state
+			mSleepers.fetch_add(1u, std::memory_order_seq_cst);
+			if (mState.load(std::memory_order_seq_cst) == state)
+				mState.wait(state, std::memory_order_relaxed);
+			mSleepers.fetch_sub(1u, std::memory_order_relaxed);
+		}
+
+		INLINE void WakeParked() const
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (mSleepers.load(std::memory_order_seq_cst) > 0u)
+				mState.notify_all();
+		}
+
+		mutable std::atomic_uint32_t	mState = 0u;
+		mutable std::atomic_uint32_t	mSleepers = 0u;
+		std::atomic_uint32_t			mWaitingWriters = 0u;
 	};
 
 	class RWLockRead
@@ -90,4 +179,4 @@ namespace Darius::Core::MultiThreading
 	private:
 		RWLock& mLock;
 	};
-}
\ No newline at end of file
+}
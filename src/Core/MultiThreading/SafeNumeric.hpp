@@ -130,4 +130,51 @@ namespace Darius::Core::MultiThreading
 	private:
 		std::atomic<T>			mValue;
 	};
+
+	// Copying takes the value, so it can be a member of the types their owners copy or move around,
+	// as long as no one sets it meanwhile
+	class SafeFlag
+	{
+	public:
+		INLINE bool IsSet() const
+		{
+			return mFlag.load(std::memory_order_acquire);
+		}
+
+		INLINE void Set()
+		{
+			mFlag.store(true, std::memory_order_release);
+		}
+
+		INLINE void Clear()
+		{
+			mFlag.store(false, std::memory_order_release);
+		}
+
+		INLINE void SetTo(bool value)
+		{
+			mFlag.store(value, std::memory_order_release);
+		}
+
+		// Sets and returns whether it was already set, true for only one of the callers setting it together
+		INLINE bool TestAndSet()
+		{
+			return mFlag.exchange(true, std::memory_order_acq_rel);
+		}
+
+		INLINE explicit SafeFlag(bool value = false) :
+			mFlag(value) { }
+
+		INLINE SafeFlag(SafeFlag const& other) :
+			mFlag(other.IsSet()) { }
+
+		INLINE SafeFlag& operator=(SafeFlag const& other)
+		{
+			SetTo(other.IsSet());
+			return *this;
+		}
+
+	private:
+		std::atomic_bool		mFlag;
+	};
 }
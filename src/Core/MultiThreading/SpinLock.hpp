@@ -2,7 +2,17 @@
 
 #include <Utils/Common.hpp>
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define D_CPU_PAUSE() _mm_pause()
+#else
+#define D_CPU_PAUSE() std::this_thread::yield()
+#endif
 
 #ifndef D_CORE_THREADING
 #define D_CORE_THREADING Darius::Core::MultiThreading
@@ -11,17 +21,78 @@
 
 namespace Darius::Core::MultiThreading
 {
+	// Spins with exponentially more pauses each round, for a bounded number of rounds
+	class Backoff
+	{
+	public:
+		static constexpr uint32_t		MaxPauses = 64u;
+		static constexpr uint32_t		MaxRounds = 10u;
+
+		// Returns false once the spinning budget is spent and the thread should park
+		INLINE bool Spin()
+		{
+			if (mRound >= MaxRounds)
+				return false;
+
+			for (uint32_t i = 0u; i < mPauses; i++)
+				D_CPU_PAUSE();
+
+			mPauses = std::min(mPauses * 2u, MaxPauses);
+			mRound++;
+			return true;
+		}
+
+	private:
+		uint32_t						mPauses = 1u;
+		uint32_t						mRound = 0u;
+	};
+
+	// Spins for a short while when contended, then parks the thread on the lock word so that a
+	// preempted holder does not make the others burn their timeslices.
 	class SpinLock {
-		mutable std::atomic_flag mLocked = ATOMIC_FLAG_INIT;
+		enum : uint32_t
+		{
+			Unlocked = 0u,
+			Locked = 1u,
+
+			// Locked with parked threads to wake on unlock
+			Contended = 2u
+		};
+
+		mutable std::atomic_uint32_t mState = Unlocked;
+
+		void LockContended() const {
+			Backoff backoff;
+			while (backoff.Spin()) {
+				// Reading first so that the spinning does not take the cache line from the holder
+				if (mState.load(std::memory_order_relaxed) == Unlocked && TryLock())
+					return;
+			}
+
+			// Whoever takes the lock from here on may leave parked threads behind, so marks it contended
+			while (mState.exchange(Contended, std::memory_order_acquire) != Unlocked)
+				mState.wait(Contended, std::memory_order_relaxed);
+		}
 
 	public:
+		INLINE bool TryLock() const {
+			uint32_t expected = Unlocked;
+			return mState.compare_exchange_strong(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed);
+		}
+
 		INLINE void Lock() const {
-			while (mLocked.test_and_set(std::memory_order_acquire)) {
-				// Continue.
-			}
+			if (!TryLock())
+				LockContended();
 		}
+
 		INLINE void Unlock() const {
-			mLocked.clear(std::memory_order_release);
+			if (mState.exchange(Unlocked, std::memory_order_release) == Contended)
+				mState.notify_one();
 		}
+
+		// For std::scoped_lock and the like
+		INLINE void lock() const { Lock(); }
+		INLINE bool try_lock() const { return TryLock(); }
+		INLINE void unlock() const { Unlock(); }
 	};
-}
\ No newline at end of file
+}
@@ -11,6 +11,7 @@ using namespace D_CORE;
 
 namespace Darius::Core::Serialization
 {
+	// Only read with contains and at after registration, so objects may be serialized concurrently
 	D_CONTAINERS::DUnorderedMap<rttr::type, std::function<void(rttr::instance const&, Json&)>> typeSerializers = { };
 	D_CONTAINERS::DUnorderedMap<rttr::type, std::function<void(rttr::variant&, Json const&)>> typeDeserializers = { };
 
@@ -185,7 +186,7 @@ namespace Darius::Core::Serialization
 				// Checking existing serializers and deserializers
 				if (typeSerializers.contains(intendedType))
 				{
-					typeSerializers[intendedType](is_wrapper ? wrapped_var.extract_wrapped_value() : wrapped_var, el);
+					typeSerializers.at(intendedType)(is_wrapper ? wrapped_var.extract_wrapped_value() : wrapped_var, el);
 				}
 				else if (intendedType.is_arithmetic() || intendedType == type::get<std::string>() || intendedType.is_enumeration() || intendedType == type::get<UuidWrapper>())
 				{
@@ -243,7 +244,7 @@ namespace Darius::Core::Serialization
 		// Checking existing serializers and deserializers
 		if (typeSerializers.contains(intendedType))
 		{
-			typeSerializers[intendedType](is_wrapper ? var.extract_wrapped_value() : var, json);
+			typeSerializers.at(intendedType)(is_wrapper ? var.extract_wrapped_value() : var, json);
 			return true;
 		}
 
@@ -410,7 +411,7 @@ namespace Darius::Core::Serialization
 				if (typeDeserializers.contains(intendedType))
 				{
 					variant v;
-					typeDeserializers[intendedType](v, json_index_value);
+					typeDeserializers.at(intendedType)(v, json_index_value);
 					v.convert(array_value_type);
 					view.set_value(i, v);
 				}
@@ -482,7 +483,7 @@ namespace Darius::Core::Serialization
 		if (typeDeserializers.contains(t))
 		{
 			rttr::variant& var = *obj.try_convert<rttr::variant>();
-			typeDeserializers[t](var, json_object);
+			typeDeserializers.at(t)(var, json_object);
 			return;
 		}
 
@@ -505,7 +506,7 @@ namespace Darius::Core::Serialization
 			if (typeDeserializers.contains(intendedType))
 			{
 				variant v;
-				typeDeserializers[intendedType](v, json_value);
+				typeDeserializers.at(intendedType)(v, json_value);
 				v.convert(value_t);
 				prop.set_value(obj, v);
 				continue;
@@ -1,9 +1,27 @@
 #define BOOST_TEST_MODULE CoreTests
 #define BOOST_TEST_DYN_LINK
 
+#include <Containers/ConcurrentQueue.hpp>
+#include <Containers/HandleTable.hpp>
 #include <Memory/Memory.hpp>
+#include <Memory/MemoryTracking.hpp>
+#include <Memory/Allocators/MallocAllocator.hpp>
+#include <Memory/Allocators/MemoryPool.hpp>
+#include <Memory/Allocators/FrameAllocator.hpp>
+#include <Memory/Allocators/SlabAllocator.hpp>
+#include <MultiThreading/RWLock.hpp>
+#include <MultiThreading/SpinLock.hpp>
 #include <boost/test/included/unit_test.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace Darius::Core::Containers;
 using namespace Darius::Core::Memory;
 
 inline void test(std::size_t alignment)
@@ -70,4 +88,1211 @@ BOOST_AUTO_TEST_CASE(Alloc128)
     test(128);
 }
 
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+    struct SlabTestObject
+    {
+        SlabTestObject(uint32_t owner, uint32_t value) :
+            Owner(owner),
+            Value(value),
+            Check(~value)
+        { }
+
+        ~SlabTestObject()
+        {
+            Check = 0u;
+        }
+
+        bool IsValid() const { return Check == ~Value; }
+
+        uint32_t Owner;
+        uint32_t Value;
+        uint32_t Check;
+    };
+}
+
+BOOST_AUTO_TEST_SUITE(SlabAllocatorTests)
+
+BOOST_AUTO_TEST_CASE(ReusesFreedObjects)
+{
+    SlabAllocator<SlabTestObject> allocator(64u);
+
+    auto object = allocator.Alloc(0u, 1u);
+    BOOST_TEST(object->IsValid());
+    BOOST_TEST(allocator.GetAliveCount() == 1);
+
+    allocator.Free(object);
+    BOOST_TEST(allocator.GetAliveCount() == 0);
+
+    BOOST_TEST(allocator.Alloc(0u, 2u) == object);
+    allocator.Free(object);
+    BOOST_TEST(allocator.GetSlabCount() == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(GrowsAndReleasesSlabs)
+{
+    SlabAllocator<SlabTestObject> allocator(64u);
+
+    std::vector<SlabTestObject*> objects;
+    std::set<SlabTestObject*> addresses;
+    for (uint32_t i = 0u; i < 1000u; i++)
+    {
+        objects.push_back(allocator.Alloc(0u, i));
+        addresses.insert(objects.back());
+    }
+
+    BOOST_TEST(addresses.size() == 1000u);
+    BOOST_TEST(allocator.GetSlabCount() == 16u);
+
+    for (uint32_t i = 0u; i < 1000u; i++)
+        BOOST_TEST_REQUIRE(objects[i]->Value == i);
+
+    // Not released while objects are alive
+    allocator.Reset();
+    BOOST_TEST(allocator.GetSlabCount() == 16u);
+
+    for (auto object : objects)
+        allocator.Free(object);
+
+    allocator.Reset();
+    BOOST_TEST(allocator.GetSlabCount() == 0u);
+
+    // Usable again after the reset
+    auto object = allocator.Alloc(0u, 7u);
+    BOOST_TEST(object->IsValid());
+    allocator.Free(object);
+}
+
+BOOST_AUTO_TEST_CASE(ManyThreads)
+{
+    constexpr uint32_t threadCount = 8u;
+    constexpr uint32_t iterations = 20000u;
+
+    SlabAllocator<SlabTestObject> allocator(256u);
+
+    // Objects passed to other threads to be freed there
+    std::mutex sharedMutex;
+    std::vector<SlabTestObject*> shared;
+    std::atomic_uint32_t corrupted = 0u;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0u; t < threadCount; t++)
+    {
+        threads.emplace_back([&, t]()
+            {
+                std::vector<SlabTestObject*> local;
+                for (uint32_t i = 0u; i < iterations; i++)
+                {
+                    local.push_back(allocator.Alloc(t, i));
+
+                    if (local.size() < 64u)
+                        continue;
+
+                    for (size_t j = 0u; j < local.size(); j++)
+                    {
+                        auto object = local[j];
+                        if (!object->IsValid() || object->Owner != t)
+                            corrupted++;
+
+                        if (j % 4u == 0u)
+                        {
+                            std::scoped_lock lock(sharedMutex);
+                            shared.push_back(object);
+                        }
+                        else
+                            allocator.Free(object);
+                    }
+                    local.clear();
+
+                    std::vector<SlabTestObject*> others;
+                    {
+                        std::scoped_lock lock(sharedMutex);
+                        std::swap(others, shared);
+                    }
+                    for (auto object : others)
+                    {
+                        if (!object->IsValid())
+                            corrupted++;
+                        allocator.Free(object);
+                    }
+                }
+
+                for (auto object : local)
+                    allocator.Free(object);
+            });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto object : shared)
+        allocator.Free(object);
+
+    BOOST_TEST(corrupted.load() == 0u);
+    BOOST_TEST(allocator.GetAliveCount() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+    struct FrameAllocatorFixture
+    {
+        FrameAllocatorFixture()
+        {
+            D_FRAME_ALLOCATOR::Initialize(3u, 4096u);
+        }
+
+        ~FrameAllocatorFixture()
+        {
+            D_FRAME_ALLOCATOR::Shutdown();
+        }
+    };
+
+    // Builds the kind of containers a frame of the renderer fills
+    template<typename Vector>
+    uint64_t FillFrameContainers(uint32_t count)
+    {
+        Vector keys;
+        for (uint32_t i = 0u; i < count; i++)
+            keys.push_back((uint64_t)(count - i) * 2654435761u);
+
+        std::sort(keys.begin(), keys.end());
+        return keys.front();
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE(FrameAllocatorTests, FrameAllocatorFixture)
+
+BOOST_AUTO_TEST_CASE(ResetsBufferOfFrame)
+{
+    D_FRAME_ALLOCATOR::BeginFrame(0u);
+    auto first = D_FRAME_ALLOCATOR::Allocate(100u, 16u);
+    BOOST_TEST(IsAligned(first, 16u));
+    BOOST_TEST(D_FRAME_ALLOCATOR::Allocate(1u, 1u) != first);
+    BOOST_TEST(D_FRAME_ALLOCATOR::GetStats().Allocations == 2u);
+
+    // Memory of the frames in flight is not reused
+    D_FRAME_ALLOCATOR::BeginFrame(1u);
+    BOOST_TEST(D_FRAME_ALLOCATOR::GetStats().Allocations == 0u);
+    BOOST_TEST(D_FRAME_ALLOCATOR::Allocate(100u, 16u) != first);
+
+    D_FRAME_ALLOCATOR::BeginFrame(2u);
+    BOOST_TEST(D_FRAME_ALLOCATOR::Allocate(100u, 16u) != first);
+
+    D_FRAME_ALLOCATOR::BeginFrame(3u);
+    BOOST_TEST(D_FRAME_ALLOCATOR::Allocate(100u, 16u) == first);
+}
+
+BOOST_AUTO_TEST_CASE(GrowsAndReleasesBlocks)
+{
+    D_FRAME_ALLOCATOR::BeginFrame(0u);
+
+    // More than a block, and more than a block at once
+    for (int i = 0; i < 100; i++)
+        std::memset(D_FRAME_ALLOCATOR::Allocate(200u, 8u), i, 200u);
+    auto large = D_FRAME_ALLOCATOR::Allocate(10000u, 128u);
+    BOOST_TEST(IsAligned(large, 128u));
+    std::memset(large, 0, 10000u);
+
+    auto stats = D_FRAME_ALLOCATOR::GetStats();
+    BOOST_TEST(stats.AllocatedBytes == 30000u);
+    BOOST_TEST(stats.ReservedBytes >= 30000u);
+
+    // A small frame on the same buffer keeps a single block
+    D_FRAME_ALLOCATOR::BeginFrame(3u);
+    D_FRAME_ALLOCATOR::Allocate(16u, 8u);
+    D_FRAME_ALLOCATOR::BeginFrame(6u);
+    BOOST_TEST(D_FRAME_ALLOCATOR::GetStats().ReservedBytes == 4096u);
+}
+
+BOOST_AUTO_TEST_CASE(VectorsInFrameMemory)
+{
+    D_FRAME_ALLOCATOR::BeginFrame(0u);
+
+    void* data;
+    {
+        D_FRAME_ALLOCATOR::DFrameVector<uint64_t> values;
+        values.reserve(64u);
+        for (uint64_t i = 0u; i < 1000u; i++)
+            values.push_back(i);
+
+        for (uint64_t i = 0u; i < 1000u; i++)
+            BOOST_TEST_REQUIRE(values[i] == i);
+
+        D_FRAME_ALLOCATOR::DFrameVector<uint64_t> temp(16u, 7u);
+        data = temp.data();
+    }
+
+    // The latest allocation is given back when freed
+    BOOST_TEST(D_FRAME_ALLOCATOR::Allocate(16u * sizeof(uint64_t), alignof(uint64_t)) == data);
+}
+
+BOOST_AUTO_TEST_CASE(ManyThreads)
+{
+    constexpr uint32_t threadCount = 8u;
+    constexpr uint32_t frames = 12u;
+
+    std::atomic_uint32_t corrupted = 0u;
+
+    for (uint32_t frame = 0u; frame < frames; frame++)
+    {
+        D_FRAME_ALLOCATOR::BeginFrame(frame);
+
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0u; t < threadCount; t++)
+        {
+            threads.emplace_back([&, t]()
+                {
+                    std::vector<uint32_t*> allocations;
+                    for (uint32_t i = 0u; i < 500u; i++)
+                    {
+                        uint32_t count = 1u + (i * 7u + t) % 64u;
+                        auto values = static_cast<uint32_t*>(D_FRAME_ALLOCATOR::Allocate(count * sizeof(uint32_t), alignof(uint32_t)));
+                        std::fill(values, values + count, t);
+                        allocations.push_back(values);
+                    }
+
+                    for (uint32_t i = 0u; i < 500u; i++)
+                    {
+                        uint32_t count = 1u + (i * 7u + t) % 64u;
+                        if (std::any_of(allocations[i], allocations[i] + count, [t](uint32_t value) { return value != t; }))
+                            corrupted++;
+                    }
+                });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        BOOST_TEST(D_FRAME_ALLOCATOR::GetStats().Allocations == threadCount * 500u);
+    }
+
+    BOOST_TEST(corrupted.load() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(FrameContainersMatchHeap)
+{
+    constexpr uint32_t frames = 8u;
+    constexpr uint32_t containersPerFrame = 4u;
+    constexpr uint32_t count = 2000u;
+
+    D_FRAME_ALLOCATOR::Initialize(3u, 1024u * 1024u);
+
+    uint64_t checksum = 0u;
+    for (uint32_t frame = 0u; frame < frames; frame++)
+    {
+        D_FRAME_ALLOCATOR::BeginFrame(frame);
+        for (uint32_t i = 0u; i < containersPerFrame; i++)
+        {
+            checksum += FillFrameContainers<std::vector<uint64_t>>(count);
+            checksum -= FillFrameContainers<D_FRAME_ALLOCATOR::DFrameVector<uint64_t>>(count);
+        }
+    }
+
+    BOOST_TEST(checksum == 0u);
+
+    // The blocks are kept, so nothing is allocated from the heap after the first frames
+    BOOST_TEST(D_FRAME_ALLOCATOR::GetStats().ReservedBytes <= 2u * 1024u * 1024u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(MemoryTrackingTests)
+
+BOOST_AUTO_TEST_CASE(TagsByScopeAndExplicitly)
+{
+    auto audioBefore = GetMemoryTagStats(MemoryTag::Audio);
+    auto physicsBefore = GetMemoryTagStats(MemoryTag::Physics);
+
+    void* scoped;
+    {
+        D_MEMORY_TAG_SCOPE(Audio);
+        scoped = DMemAlloc(100u);
+        BOOST_TEST((GetCurrentMemoryTag() == MemoryTag::Audio));
+    }
+    BOOST_TEST((GetCurrentMemoryTag() == MemoryTag::General));
+
+    auto tagged = DMemAllocTagged(64u, MemoryTag::Physics);
+    BOOST_TEST((MemoryManager::GetTag(scoped) == MemoryTag::Audio));
+    BOOST_TEST((MemoryManager::GetTag(tagged) == MemoryTag::Physics));
+
+    auto audio = GetMemoryTagStats(MemoryTag::Audio);
+    BOOST_TEST(audio.Bytes - audioBefore.Bytes == 100);
+    BOOST_TEST(audio.Allocations - audioBefore.Allocations == 1);
+    BOOST_TEST(GetMemoryTagStats(MemoryTag::Physics).Bytes - physicsBefore.Bytes == 64);
+
+    // Reallocation keeps the tag
+    scoped = DMemRealloc(scoped, 300u);
+    BOOST_TEST((MemoryManager::GetTag(scoped) == MemoryTag::Audio));
+    BOOST_TEST(GetMemoryTagStats(MemoryTag::Audio).Bytes - audioBefore.Bytes == 300);
+
+    DMemFree(scoped);
+    DMemFree(tagged);
+
+    BOOST_TEST(GetMemoryTagStats(MemoryTag::Audio).Bytes == audioBefore.Bytes);
+    BOOST_TEST(GetMemoryTagStats(MemoryTag::Physics).Bytes == physicsBefore.Bytes);
+    BOOST_TEST(GetMemoryTagStats(MemoryTag::Audio).TotalAllocations - audioBefore.TotalAllocations == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(AllocatorTag)
+{
+    auto before = GetMemoryTagStats(MemoryTag::Animation);
+
+    MallocAllocator allocator;
+    allocator.SetMemoryTag(MemoryTag::Animation);
+
+    auto ptr = allocator.Alloc(256u, 16u);
+    BOOST_TEST(GetMemoryTagStats(MemoryTag::Animation).Bytes - before.Bytes == 256);
+
+    allocator.Free(ptr);
+    BOOST_TEST(GetMemoryTagStats(MemoryTag::Animation).Bytes == before.Bytes);
+}
+
+BOOST_AUTO_TEST_CASE(FreedOnOtherThreadsAndPeaks)
+{
+    constexpr uint32_t threadCount = 4u;
+    constexpr uint32_t count = 1000u;
+
+    auto before = GetMemoryTagStats(MemoryTag::Resource);
+
+    std::mutex mutex;
+    std::vector<void*> allocations;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0u; t < threadCount; t++)
+    {
+        threads.emplace_back([&]()
+            {
+                D_MEMORY_TAG_SCOPE(Resource);
+                for (uint32_t i = 0u; i < count; i++)
+                {
+                    auto ptr = DMemAlloc(32u);
+                    std::scoped_lock lock(mutex);
+                    allocations.push_back(ptr);
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    auto allocated = GetMemoryTagStats(MemoryTag::Resource);
+    BOOST_TEST(allocated.Bytes - before.Bytes == (int64_t)threadCount * count * 32);
+    UpdateMemoryTagPeaks();
+
+    // Freed on another thread than allocated
+    for (auto ptr : allocations)
+        DMemFree(ptr);
+
+    auto freed = GetMemoryTagStats(MemoryTag::Resource);
+    BOOST_TEST(freed.Bytes == before.Bytes);
+    BOOST_TEST(freed.Allocations == before.Allocations);
+    BOOST_TEST(freed.PeakBytes >= allocated.Bytes);
+    BOOST_TEST(freed.HighWaterBytes >= allocated.Bytes);
+}
+
+BOOST_AUTO_TEST_CASE(SamplesCallStacks)
+{
+    SetAllocationSampling(1u);
+    auto ptr = DMemAllocTagged(48u, MemoryTag::Scene);
+    SetAllocationSampling(0u);
+
+    auto hasSample = [ptr]()
+        {
+            std::vector<MemorySample> samples;
+            GetAllocationSamples(samples);
+            return std::any_of(samples.begin(), samples.end(), [ptr](MemorySample const& sample) { return sample.Address == ptr; });
+        };
+
+    BOOST_TEST(hasSample());
+
+    DMemFree(ptr);
+    BOOST_TEST(!hasSample());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+    template<typename Queue>
+    void PushUntilAccepted(Queue& queue, uint64_t item)
+    {
+        if constexpr (requires { queue.TryPush(item); })
+        {
+            while (!queue.TryPush(item))
+                std::this_thread::yield();
+        }
+        else
+            queue.Push(item);
+    }
+
+    // Items carry the producer and a per producer sequence, which must be popped in order and once
+    template<typename Queue>
+    void RunProducersAndConsumers(Queue& queue, uint32_t producers, uint32_t consumers, uint32_t itemsPerProducer)
+    {
+        std::vector<std::atomic_uint8_t> received((size_t)producers * itemsPerProducer);
+        std::atomic_uint64_t popped = 0u;
+        std::atomic_bool ordered = true;
+        uint64_t total = (uint64_t)producers * itemsPerProducer;
+
+        std::vector<std::thread> threads;
+        for (uint32_t p = 0u; p < producers; p++)
+        {
+            threads.emplace_back([&, p]()
+                {
+                    for (uint32_t i = 0u; i < itemsPerProducer; i++)
+                        PushUntilAccepted(queue, ((uint64_t)p << 32) | i);
+                });
+        }
+
+        for (uint32_t c = 0u; c < consumers; c++)
+        {
+            threads.emplace_back([&]()
+                {
+                    std::vector<int64_t> last(producers, -1);
+                    uint64_t item;
+                    while (popped.load(std::memory_order_relaxed) < total)
+                    {
+                        if (!queue.TryPop(item))
+                        {
+                            std::this_thread::yield();
+                            continue;
+                        }
+
+                        popped.fetch_add(1u, std::memory_order_relaxed);
+
+                        auto producer = (uint32_t)(item >> 32);
+                        auto sequence = (int64_t)(item & 0xffffffffu);
+                        if (sequence <= last[producer])
+                            ordered = false;
+                        last[producer] = sequence;
+                        received[(size_t)producer * itemsPerProducer + sequence].fetch_add(1u, std::memory_order_relaxed);
+                    }
+                });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        BOOST_TEST(popped.load() == total);
+        BOOST_TEST(ordered.load());
+        BOOST_TEST(std::all_of(received.begin(), received.end(), [](auto const& count) { return count.load() == 1u; }));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(ConcurrentQueueTests)
+
+using namespace Darius::Core::Containers;
+
+BOOST_AUTO_TEST_CASE(BoundedFifoAndCapacity)
+{
+    BoundedConcurrentQueue<int> queue(5u);
+    BOOST_TEST(queue.GetCapacity() == 8u);
+
+    // Several laps around the ring
+    for (int lap = 0; lap < 3; lap++)
+    {
+        for (int i = 0; i < 8; i++)
+            BOOST_TEST(queue.TryPush(lap * 8 + i));
+        BOOST_TEST(!queue.TryPush(-1));
+        BOOST_TEST(queue.Size() == 8u);
+
+        for (int i = 0; i < 8; i++)
+            BOOST_TEST(queue.TryPop().value() == lap * 8 + i);
+        BOOST_TEST(!queue.TryPop().has_value());
+        BOOST_TEST(queue.IsEmpty());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(UnboundedFifoAcrossSegments)
+{
+    ConcurrentQueue<int, 4u> queue;
+
+    for (int i = 0; i < 100; i++)
+        queue.Push(i);
+    BOOST_TEST(queue.Size() == 100u);
+
+    for (int i = 0; i < 50; i++)
+        BOOST_TEST(queue.Pop().value() == i);
+
+    for (int i = 100; i < 120; i++)
+        queue.Push(i);
+
+    int item;
+    for (int i = 50; i < 120; i++)
+    {
+        BOOST_TEST(queue.Pop(item));
+        BOOST_TEST(item == i);
+    }
+
+    BOOST_TEST(!queue.Pop(item));
+    BOOST_TEST(queue.IsEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(DestroysRemainingItems)
+{
+    auto item = std::make_shared<int>(0);
+    {
+        BoundedConcurrentQueue<std::shared_ptr<int>> bounded(4u);
+        ConcurrentQueue<std::shared_ptr<int>, 4u> unbounded;
+
+        for (int i = 0; i < 3; i++)
+            bounded.TryPush(item);
+        for (int i = 0; i < 10; i++)
+            unbounded.Push(item);
+
+        bounded.TryPop();
+        unbounded.TryPop();
+        BOOST_TEST(item.use_count() == 12);
+    }
+    BOOST_TEST(item.use_count() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(ManyProducersAndConsumers)
+{
+    for (uint32_t producers : { 1u, 4u, 16u })
+    {
+        for (uint32_t consumers : { 1u, 4u, 16u })
+        {
+            BoundedConcurrentQueue<uint64_t> bounded(64u);
+            RunProducersAndConsumers(bounded, producers, consumers, 5000u);
+
+            // Small segments so that they are linked and deleted all along
+            ConcurrentQueue<uint64_t, 16u> unbounded;
+            RunProducersAndConsumers(unbounded, producers, consumers, 5000u);
+            BOOST_TEST(unbounded.IsEmpty());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ReclaimsSegmentsUnderContention)
+{
+    constexpr uint32_t threadCount = 4u;
+    constexpr uint32_t items = 200000u;
+    constexpr uint64_t total = (uint64_t)threadCount * items;
+
+    // Small segments so that they are retired all along, while pushes and pops never stop
+    ConcurrentQueue<uint64_t, 16u> queue;
+    std::atomic_uint64_t popped = 0u;
+    std::atomic_bool done = false;
+    size_t maxRetired = 0u;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0u; t < threadCount; t++)
+    {
+        threads.emplace_back([&]()
+            {
+                for (uint32_t i = 0u; i < items; i++)
+                    queue.Push(i);
+            });
+        threads.emplace_back([&]()
+            {
+                uint64_t item;
+                while (popped.load(std::memory_order_relaxed) < total)
+                {
+                    if (queue.TryPop(item))
+                        popped.fetch_add(1u, std::memory_order_relaxed);
+                    else
+                        std::this_thread::yield();
+                }
+            });
+    }
+
+    std::thread monitor([&]()
+        {
+            while (!done.load())
+            {
+                maxRetired = std::max(maxRetired, queue.GetRetiredCount());
+                std::this_thread::yield();
+            }
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+    done = true;
+    monitor.join();
+
+    BOOST_TEST_MESSAGE("Most retired segments at once: " << maxRetired << " of " << total / 16u);
+    BOOST_TEST(maxRetired < total / 16u / 4u);
+
+    // Once idle, a couple of operations advance the epochs past everything retired
+    uint64_t item;
+    for (int i = 0; i < 3; i++)
+        BOOST_TEST(!queue.TryPop(item));
+    BOOST_TEST(queue.GetRetiredCount() == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(WaitPopUntilClosed)
+{
+    constexpr uint32_t consumers = 4u;
+    constexpr uint32_t items = 20000u;
+
+    ConcurrentQueue<uint32_t> queue;
+    std::atomic_uint64_t sum = 0u;
+    std::atomic_uint32_t popped = 0u;
+
+    std::vector<std::thread> threads;
+    for (uint32_t c = 0u; c < consumers; c++)
+    {
+        threads.emplace_back([&]()
+            {
+                uint32_t item;
+                while (queue.WaitPop(item))
+                {
+                    sum.fetch_add(item);
+                    popped.fetch_add(1u);
+                }
+            });
+    }
+
+    // Letting the consumers block before anything is pushed
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    for (uint32_t i = 1u; i <= items; i++)
+    {
+        queue.Push(i);
+        if (i % 1000u == 0u)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    while (popped.load() < items)
+        std::this_thread::yield();
+
+    queue.Close();
+    for (auto& thread : threads)
+        thread.join();
+
+    BOOST_TEST(sum.load() == (uint64_t)items * (items + 1u) / 2u);
+    BOOST_TEST(queue.IsClosed());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+    // The threads increment a shared counter under the lock
+    template<typename Lock>
+    void RunLockedIncrements(Lock& lock, uint32_t threadCount, uint32_t incrementsPerThread, uint64_t& counter)
+    {
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0u; t < threadCount; t++)
+        {
+            threads.emplace_back([&]()
+                {
+                    for (uint32_t i = 0u; i < incrementsPerThread; i++)
+                    {
+                        std::scoped_lock guard(lock);
+                        counter++;
+                    }
+                });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    // Readers check that the writers never leave the two values apart
+    template<typename ReadFunc, typename WriteFunc>
+    void RunReadersAndWriters(uint32_t threadCount, uint32_t operationsPerThread, uint32_t writeEvery, ReadFunc&& read, WriteFunc&& write)
+    {
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0u; t < threadCount; t++)
+        {
+            threads.emplace_back([&, t]()
+                {
+                    for (uint32_t i = 0u; i < operationsPerThread; i++)
+                    {
+                        if ((i + t) % writeEvery == 0u)
+                            write();
+                        else
+                            read();
+                    }
+                });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(LockTests)
+
+using namespace Darius::Core::MultiThreading;
+
+BOOST_AUTO_TEST_CASE(SpinLockExcludes)
+{
+    SpinLock lock;
+    BOOST_TEST(lock.TryLock());
+    BOOST_TEST(!lock.TryLock());
+    lock.Unlock();
+
+    // More threads than cores, so that some park
+    uint64_t counter = 0u;
+    auto threadCount = std::max(8u, std::thread::hardware_concurrency() * 4u);
+    RunLockedIncrements(lock, threadCount, 20000u, counter);
+    BOOST_TEST(counter == (uint64_t)threadCount * 20000u);
+}
+
+BOOST_AUTO_TEST_CASE(SpinLockParksBehindSlowHolder)
+{
+    SpinLock lock;
+    std::atomic_uint32_t done = 0u;
+
+    lock.Lock();
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0u; t < 4u; t++)
+    {
+        threads.emplace_back([&]()
+            {
+                lock.Lock();
+                done.fetch_add(1u);
+                lock.Unlock();
+            });
+    }
+
+    // Long enough for the waiting threads to spend their spinning and park
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_TEST(done.load() == 0u);
+    lock.Unlock();
+
+    for (auto& thread : threads)
+        thread.join();
+    BOOST_TEST(done.load() == 4u);
+}
+
+BOOST_AUTO_TEST_CASE(RWLockExcludesWriters)
+{
+    RWLock lock;
+    uint64_t first = 0u, second = 0u;
+    std::atomic_uint32_t readers = 0u;
+    std::atomic_uint32_t maxReaders = 0u;
+    std::atomic_bool consistent = true;
+
+    RunReadersAndWriters(16u, 20000u, 10u,
+        [&]()
+        {
+            RWLockRead guard(lock);
+            auto current = readers.fetch_add(1u) + 1u;
+            if (current > maxReaders.load())
+                maxReaders.store(current);
+            if (first != second)
+                consistent = false;
+            readers.fetch_sub(1u);
+        },
+        [&]()
+        {
+            RWLockWrite guard(lock);
+            if (readers.load() != 0u)
+                consistent = false;
+            first++;
+            second++;
+        });
+
+    BOOST_TEST(consistent.load());
+    BOOST_TEST(first == 16u * 20000u / 10u);
+    BOOST_TEST(first == second);
+}
+
+BOOST_AUTO_TEST_CASE(RWLockPrefersWaitingWriter)
+{
+    RWLock lock;
+    std::atomic_bool written = false;
+
+    lock.ReadLock();
+
+    std::thread writer([&]()
+        {
+            RWLockWrite guard(lock);
+            written = true;
+        });
+
+    // Once the writer waits, new readers are held back
+    bool readerHeldBack = false;
+    for (int i = 0; i < 1000 && !readerHeldBack; i++)
+    {
+        if (lock.ReadTryLock())
+        {
+            lock.ReadUnlock();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        else
+            readerHeldBack = true;
+    }
+
+    BOOST_TEST(readerHeldBack);
+    BOOST_TEST(!written.load());
+
+    lock.ReadUnlock();
+    writer.join();
+    BOOST_TEST(written.load());
+
+    BOOST_TEST(lock.ReadTryLock());
+    lock.ReadUnlock();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+    struct PoolObject
+    {
+        PoolObject(uint64_t value) :
+            Value(value) { }
+
+        uint64_t Value;
+        uint64_t Padding[3];
+    };
+
+    // Keeps a window of live objects, releasing one and allocating one each step
+    template<typename AllocFunc, typename ReleaseFunc>
+    uint64_t ChurnObjects(uint32_t live, uint32_t steps, AllocFunc&& alloc, ReleaseFunc&& release)
+    {
+        std::vector<PoolObject*> objects;
+        for (uint32_t i = 0u; i < live; i++)
+            objects.push_back(alloc(i));
+
+        uint64_t checksum = 0u;
+        for (uint32_t i = 0u; i < steps; i++)
+        {
+            auto slot = (i * 2654435761u) % live;
+            checksum += objects[slot]->Value;
+            release(objects[slot]);
+            objects[slot] = alloc(i);
+        }
+
+        for (auto object : objects)
+            release(object);
+
+        return checksum;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(ObjectPoolTests)
+
+BOOST_AUTO_TEST_CASE(GrowsWithoutMovingObjects)
+{
+    MallocAllocator allocator;
+    TypedObjectPool<PoolObject> pool;
+    pool.Init(&allocator, 3u);
+    BOOST_TEST(pool.GetCapacity() == 4u);
+
+    std::vector<PoolObject*> objects;
+    for (uint64_t i = 0u; i < 20u; i++)
+        objects.push_back(pool.Alloc(i));
+
+    BOOST_TEST(pool.GetCapacity() == 20u);
+    BOOST_TEST(pool.GetUsedCount() == 20u);
+
+    for (uint32_t i = 0u; i < 20u; i++)
+    {
+        BOOST_TEST(objects[i]->Value == i);
+        BOOST_TEST(IsAligned(objects[i], alignof(PoolObject)));
+
+        auto index = pool.GetIndex(objects[i]);
+        BOOST_TEST(index != TypedObjectPool<PoolObject>::kInvalidIndex);
+        BOOST_TEST(pool.Get(index) == objects[i]);
+    }
+
+    PoolObject outside(0u);
+    uint32_t index;
+    BOOST_TEST(!pool.TryGetIndex(&outside, index));
+
+    for (auto object : objects)
+        pool.Release(object);
+
+    BOOST_TEST(pool.GetUsedCount() == 0u);
+    pool.Shutdown();
+}
+
+BOOST_AUTO_TEST_CASE(ReusesReleasedObjects)
+{
+    MallocAllocator allocator;
+    TypedObjectPool<PoolObject> pool;
+    pool.Init(&allocator, 8u);
+
+    auto first = pool.Alloc(1u);
+    auto second = pool.Alloc(2u);
+    pool.Release(first);
+
+    // Most recently released first
+    auto third = pool.Alloc(3u);
+    BOOST_TEST(third == first);
+    BOOST_TEST(third->Value == 3u);
+    BOOST_TEST(pool.GetCapacity() == 8u);
+
+    pool.Release(second);
+    pool.Release(third);
+
+    std::vector<PoolObject*> objects;
+    for (uint64_t i = 0u; i < 8u; i++)
+        objects.push_back(pool.Alloc(i));
+    BOOST_TEST(pool.GetCapacity() == 8u);
+
+    for (auto object : objects)
+        pool.Release(object);
+    pool.Shutdown();
+
+    // Released all at once, the objects are obtained in order again
+
+    ObjectPool untyped;
+    untyped.Init(&allocator, 4u, 12u);
+    for (uint32_t i = 0u; i < 4u; i++)
+        BOOST_TEST(untyped.ObtainObject() == i);
+    untyped.FreeAllObjects();
+    BOOST_TEST(untyped.ObtainObject() == 0u);
+    BOOST_TEST(untyped.GetCapacity() == 4u);
+    untyped.ReleaseObject(0u);
+    untyped.Shutdown();
+}
+
+BOOST_AUTO_TEST_CASE(GenerationsOfReleasedObjects)
+{
+    MallocAllocator allocator;
+    ObjectPool pool;
+    pool.Init(&allocator, 4u, sizeof(uint64_t));
+
+    auto index = pool.ObtainObject();
+    auto generation = pool.GetGeneration(index);
+    BOOST_TEST(pool.IsAlive(index, generation));
+
+    pool.ReleaseObject(index);
+    BOOST_TEST(pool.ObtainObject() == index);
+
+#if D_MEMORY_POOL_GENERATIONS
+    // Reused, so the old generation no longer refers to a live object
+    BOOST_TEST(!pool.IsAlive(index, generation));
+    BOOST_TEST(pool.IsAlive(index, pool.GetGeneration(index)));
+#endif
+
+    pool.ReleaseObject(index);
+    pool.Shutdown();
+}
+
+BOOST_AUTO_TEST_CASE(ThreadSafePool)
+{
+    constexpr uint32_t threadCount = 8u;
+    constexpr uint32_t steps = 20000u;
+
+    MallocAllocator allocator;
+    TypedObjectPool<PoolObject, true> pool;
+    pool.Init(&allocator, 64u);
+
+    std::atomic_bool intact = true;
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0u; t < threadCount; t++)
+    {
+        threads.emplace_back([&, t]()
+            {
+                std::vector<PoolObject*> objects;
+                for (uint32_t i = 0u; i < steps; i++)
+                {
+                    if (objects.size() < 100u && (i * 7u + t) % 3u != 0u)
+                        objects.push_back(pool.Alloc(((uint64_t)t << 32) | i));
+                    else if (!objects.empty())
+                    {
+                        auto object = objects.back();
+                        if ((object->Value >> 32) != t || pool.Get(pool.GetIndex(object)) != object)
+                            intact = false;
+                        objects.pop_back();
+                        pool.Release(object);
+                    }
+                }
+
+                for (auto object : objects)
+                    pool.Release(object);
+            });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    BOOST_TEST(intact.load());
+    BOOST_TEST(pool.GetUsedCount() == 0u);
+    pool.Shutdown();
+}
+
+BOOST_AUTO_TEST_CASE(ChurnMatchesNew)
+{
+    constexpr uint32_t live = 1000u;
+    constexpr uint32_t steps = 20000u;
+
+    MallocAllocator allocator;
+    TypedObjectPool<PoolObject> pool;
+    pool.Init(&allocator, 64u);
+
+    auto poolChecksum = ChurnObjects(live, steps, [&](uint64_t value) { return pool.Alloc(value); }, [&](PoolObject* object) { pool.Release(object); });
+    auto newChecksum = ChurnObjects(live, steps, [](uint64_t value) { return new PoolObject(value); }, [](PoolObject* object) { delete object; });
+
+    BOOST_TEST(poolChecksum == newChecksum);
+    BOOST_TEST(pool.GetUsedCount() == 0u);
+    pool.Shutdown();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+    struct TableObject
+    {
+        uint16_t Type;
+        uint64_t Value;
+    };
+}
+
+BOOST_AUTO_TEST_SUITE(HandleTableTests)
+
+BOOST_AUTO_TEST_CASE(ReusedSlotsInvalidateStaleHandles)
+{
+    HandleTable<TableObject> table;
+    TableObject first { 1u, 1u };
+    TableObject second { 1u, 2u };
+
+    BOOST_TEST(!table.Resolve(HandleTable<TableObject>::InvalidHandle));
+
+    auto firstHandle = table.Add(&first);
+    BOOST_TEST(firstHandle != HandleTable<TableObject>::InvalidHandle);
+    BOOST_TEST(table.Resolve(firstHandle) == &first);
+
+    BOOST_TEST(table.Remove(firstHandle));
+    BOOST_TEST(!table.Remove(firstHandle));
+    BOOST_TEST(!table.Resolve(firstHandle));
+    BOOST_TEST(!table.IsValid(firstHandle));
+
+    // Same slot, new generation
+    auto secondHandle = table.Add(&second);
+    BOOST_TEST(HandleTable<TableObject>::GetIndex(secondHandle) == HandleTable<TableObject>::GetIndex(firstHandle));
+    BOOST_TEST(secondHandle != firstHandle);
+    BOOST_TEST(!table.Resolve(firstHandle));
+    BOOST_TEST(table.Resolve(secondHandle) == &second);
+    BOOST_TEST(table.GetSize() == 1u);
+
+    // Allocated handles resolve to nothing until assigned
+    auto allocated = table.Allocate();
+    BOOST_TEST(table.IsValid(allocated));
+    BOOST_TEST(!table.Resolve(allocated));
+    table.Assign(allocated, &first);
+    BOOST_TEST(table.Resolve(allocated) == &first);
+}
+
+BOOST_AUTO_TEST_CASE(RetiresSlotWhenGenerationSaturates)
+{
+    // 8 bits of generation
+    using SmallTable = HandleTable<TableObject, 24u, 16u>;
+    SmallTable table;
+    TableObject object { 1u, 1u };
+
+    std::vector<SmallTable::Handle> handles;
+    auto handle = table.Add(&object);
+    while (SmallTable::GetIndex(handle) == 0u)
+    {
+        handles.push_back(handle);
+        BOOST_TEST(table.Remove(handle));
+        handle = table.Add(&object);
+    }
+
+    // Every generation but zero used once, then a fresh slot
+    BOOST_TEST(handles.size() == SmallTable::GenerationMask);
+    BOOST_TEST(SmallTable::GetIndex(handle) == 1u);
+    BOOST_TEST(table.GetRetiredCount() == 1u);
+    BOOST_TEST(table.GetSize() == 1u);
+
+    // No stale handle matches the retired slot, nor one with the retired generation
+    for (auto stale : handles)
+    {
+        BOOST_TEST(!table.Resolve(stale));
+        BOOST_TEST(!table.IsValid(stale));
+        BOOST_TEST(!table.Remove(stale));
+    }
+    BOOST_TEST(!table.IsValid(SmallTable::MakeHandle(0u, 0u)));
+    BOOST_TEST(table.Resolve(handle) == &object);
+}
+
+BOOST_AUTO_TEST_CASE(GrowsAcrossChunks)
+{
+    HandleTable<TableObject, 16u, 4u> table;
+    std::vector<TableObject> objects(1000u);
+    std::vector<uint32_t> handles;
+
+    for (uint32_t i = 0u; i < objects.size(); i++)
+    {
+        objects[i].Value = i;
+        handles.push_back(table.Add(&objects[i]));
+    }
+
+    for (uint32_t i = 0u; i < objects.size(); i++)
+        BOOST_TEST(table.Resolve(handles[i]) == &objects[i]);
+
+    uint32_t visited = 0u;
+    table.ForEach([&](TableObject* object) { BOOST_TEST(object == &objects[object->Value]); visited++; });
+    BOOST_TEST(visited == objects.size());
+}
+
+BOOST_AUTO_TEST_CASE(ResolvesWhileOthersAddAndRemove)
+{
+    constexpr uint32_t writerCount = 4u;
+    constexpr uint32_t steps = 20000u;
+
+    HandleTable<TableObject> table;
+    std::vector<TableObject> stable(256u);
+    std::vector<uint32_t> stableHandles;
+    for (uint32_t i = 0u; i < stable.size(); i++)
+    {
+        stable[i] = { 1u, i };
+        stableHandles.push_back(table.Add(&stable[i]));
+    }
+
+    std::atomic_bool done = false;
+    std::atomic_bool intact = true;
+
+    std::vector<std::thread> writers;
+    for (uint32_t t = 0u; t < writerCount; t++)
+    {
+        writers.emplace_back([&, t]()
+            {
+                std::vector<TableObject> own(64u);
+                std::vector<uint32_t> handles(own.size(), HandleTable<TableObject>::InvalidHandle);
+                for (uint32_t i = 0u; i < steps; i++)
+                {
+                    auto slot = i % own.size();
+                    if (handles[slot] != HandleTable<TableObject>::InvalidHandle)
+                    {
+                        auto stale = handles[slot];
+                        table.Remove(stale);
+                        if (table.Resolve(stale))
+                            intact = false;
+                    }
+
+                    own[slot] = { 2u, t };
+                    handles[slot] = table.Add(&own[slot]);
+                    if (table.Resolve(handles[slot]) != &own[slot])
+                        intact = false;
+                }
+
+                for (auto handle : handles)
+                    table.Remove(handle);
+            });
+    }
+
+    std::thread reader([&]()
+        {
+            while (!done.load())
+                for (uint32_t i = 0u; i < stable.size(); i++)
+                    if (table.Resolve(stableHandles[i]) != &stable[i])
+                        intact = false;
+        });
+
+    for (auto& writer : writers)
+        writer.join();
+    done = true;
+    reader.join();
+
+    BOOST_TEST(intact.load());
+    BOOST_TEST(table.GetSize() == stable.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
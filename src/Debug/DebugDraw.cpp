@@ -1,6 +1,7 @@
 #include "pch.hpp"
 #include "DebugDraw.hpp"
 
+#include <Core/Memory/Allocators/FrameAllocator.hpp>
 #include <Core/TimeManager/TimeManager.hpp>
 #include <Graphics/GraphicsDeviceManager.hpp>
 #include <Renderer/RendererManager.hpp>
@@ -233,7 +234,7 @@ namespace Darius::Debug
 
 		using namespace DirectX;
 
-		D_CONTAINERS::DVector<Vector3> verticesLocations;
+		D_FRAME_ALLOCATOR::DFrameVector<Vector3> verticesLocations;
 		verticesLocations.reserve((horizontalSegments + 1) * (tessellation / 2) + 1);
 
 		auto baseRotation = Quaternion::GetShortestArcBetweenTwoVector(Vector3::Up, centerToTopDirection.Normal());
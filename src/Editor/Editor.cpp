@@ -10,9 +10,12 @@
 #include "GUI/GuiRenderer.hpp"
 
 #include <Core/Containers/Vector.hpp>
+#include <Core/Memory/Allocators/FrameAllocator.hpp>
+#include <Core/Memory/MemoryTracking.hpp>
 #include <Core/TimeManager/TimeManager.hpp>
 #include <Engine/EngineContext.hpp>
 #include <Graphics/CommandContext.hpp>
+#include <Graphics/GraphicsCore.hpp>
 #include <Graphics/GraphicsUtils/Profiling/Profiling.hpp>
 #include <Renderer/Rasterization/Renderer.hpp>
 #include <Renderer/Camera/CameraManager.hpp>
@@ -78,6 +81,8 @@ namespace Darius::Editor
 		mTimer.Tick([&]()
 			{
 				D_PROFILING::Update();
+				D_FRAME_ALLOCATOR::BeginFrame(D_GRAPHICS::GetFrameCount());
+				D_MEMORY::UpdateMemoryTagPeaks();
 				Update(mTimer);
 				Render();
 				D_PROFILING::FinishFrame();
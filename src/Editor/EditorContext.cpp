@@ -8,6 +8,7 @@
 #include "Simulation.hpp"
 
 #include <Core/Serialization/Copyable.hpp>
+#include <Core/Memory/MemoryTracking.hpp>
 #include <Core/MultiThreading/SpinLock.hpp>
 #include <Engine/EngineContext.hpp>
 #include <Graphics/GraphicsUtils/Profiling/Profiling.hpp>
@@ -31,6 +32,8 @@ namespace Darius::Editor::Context
 
 	void Initialize(HWND wind)
 	{
+		D_MEMORY_TAG_SCOPE(Editor);
+
 		D_ASSERT(!_initialized);
 		_initialized = true;
 		SelectedGameObject = nullptr;
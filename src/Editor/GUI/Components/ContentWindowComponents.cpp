@@ -1,6 +1,7 @@
 #include "Editor/pch.hpp"
 
 #include "ContentWindowComponents.hpp"
+#include "Editor/GUI/ThumbnailManager.hpp"
 
 #include <ResourceManager/ResourceManager.hpp>
 #include <ResourceManager/Resource.hpp>
@@ -76,7 +77,13 @@ namespace Darius::Editor::Gui::Components
 
 		ImGui::SetCursorPos(ImVec2((availWidth - size.x) / 2 + startCurPos.x, startCurPos.y + 5));
 
-		ImGui::Image((ImTextureID)data.IconId, size);
+		if(!data.IsDirectory && data.MainHandle.IsValid())
+		{
+			auto thumbnail = D_THUMBNAIL::GetResourceThumbnail(data.MainHandle);
+			ImGui::Image((ImTextureID)thumbnail.TextureId, size, ImVec2(thumbnail.Uv0[0], thumbnail.Uv0[1]), ImVec2(thumbnail.Uv1[0], thumbnail.Uv1[1]));
+		}
+		else
+			ImGui::Image((ImTextureID)data.IconId, size);
 
 		auto nameStr = data.Name.c_str();
 
@@ -1,9 +1,11 @@
 #include "Editor/pch.hpp"
 
 #include "GuiManager.hpp"
+#include "ThumbnailManager.hpp"
 #include "Windows/ContentWindow.hpp"
 #include "Windows/DetailsWindow.hpp"
 #include "Windows/GameWindow.hpp"
+#include "Windows/LogWindow.hpp"
 #include "Windows/ProfilerWindow.hpp"
 #include "Windows/SceneWindow.hpp"
 #include "Windows/SceneGraphWindow.hpp"
@@ -99,6 +101,7 @@ namespace Darius::Editor::Gui::GuiManager
 		RegisterWindow(SettingsWindow);
 		RegisterWindow(GameWindow);
 		RegisterWindow(SequencerWindow);
+		RegisterWindow(LogWindow);
 
 		ImGuiIO& io = ImGui::GetIO();
 		// Setup docking
@@ -148,6 +151,8 @@ namespace Darius::Editor::Gui::GuiManager
 	{
 		D_PROFILING::ScopedTimer guiProfiling(L"Update Gui");
 
+		D_THUMBNAIL::Update();
+
 		{
 			D_PROFILING::ScopedTimer windowProfiling(L"Update Windows");
 			for(auto& kv : Windows)
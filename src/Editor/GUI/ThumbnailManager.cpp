@@ -3,12 +3,19 @@
 
 #include "Editor/EditorContext.hpp"
 #include "GuiRenderer.hpp"
+#include "Utils/ThumbnailAtlas.hpp"
+#include "Utils/ThumbnailQueue.hpp"
 
 #include <Core/Containers/Map.hpp>
+#include <Graphics/CommandContext.hpp>
+#include <Graphics/GraphicsCore.hpp>
+#include <Job/Job.hpp>
 #include <Renderer/Resources/MaterialResource.hpp>
 #include <Scene/EntityComponentSystem/Components/TransformComponent.hpp>
 #include <Utils/Assert.hpp>
 
+#include <Libs/DirectXTex/DirectXTex/DirectXTex.h>
+
 #define REGISTER_RESOURCE_TYPE_TEXTURE(resType, fileName) \
 { \
 auto resPath = D_FILE::Path("EditorResources") / "icons" / fileName; \
@@ -34,27 +41,54 @@ using namespace D_CORE;
 
 namespace Darius::Editor::Gui::ThumbnailManager
 {
+	// Generates up to its set size thumbnails from the queue
+	class ThumbnailGenerationTask : public D_JOB::ITaskSet
+	{
+	public:
+		virtual void ExecuteRange(D_JOB::TaskPartition range, D_JOB::ThreadNumber threadNumber) override;
+	};
+
+	class ThumbnailSaveTask : public D_JOB::IPinnedTask
+	{
+	public:
+		virtual void Execute() override;
+	};
+
+	struct AtlasPageTexture
+	{
+		D_GRAPHICS_BUFFERS::Texture		Texture;
+		uint64_t						TextureId;
+	};
+
 	bool								_initialized = false;
 	DUnorderedMap<ResourceType, D_GRAPHICS_BUFFERS::Texture>	ResourceTypeTextures;
-	DUnorderedMap<Uuid, D_GRAPHICS_BUFFERS::Texture, UuidHasher> ResourceTextures;
 	DUnorderedMap<CommonIcon, D_GRAPHICS_BUFFERS::Texture>		CommonIconTextures;
 
 	DUnorderedMap<ResourceType, uint64_t>						ResourceTypeTextureIdMap;
-	DUnorderedMap<Uuid, uint64_t, UuidHasher>					ResourceTextureIdMap;
 	DUnorderedMap<CommonIcon, uint64_t>							CommonIconTextureIdMap;
 
 	////////////////////////////////////////////////////////////////
 	////// Options
 	std::string													ThumbnailCacheDirectory = "CacheData/Thumbnails";
+	uint32_t const												ThumbnailSize = 64u;
+	uint32_t const												ThumbnailAtlasPageSize = 1024u;
+	uint32_t const												MaxThumbnailsPerBatch = 16u;
+	uint32_t const												PageUploadIntervalFrames = 8u;
+
+	D_GUI_UTILS::ThumbnailAtlas									Atlas(ThumbnailAtlasPageSize, ThumbnailSize);
+	D_GUI_UTILS::ThumbnailQueue									Queue;
+	DVector<std::unique_ptr<AtlasPageTexture>>					PageTextures;
+
+	ThumbnailGenerationTask										GenerationTask;
+	std::atomic_bool											SaveInProgress = false;
+	uint32_t													LastPageUploadFrame = 0u;
 
 	void RegisterResourceTypeTextures();
 	void RegisterCommonIconTextures();
-	void AddExistingResourceThumbnail(Uuid const& uuid); // Add thumbnail of previously generated thumbnail to registry by uuid
-	void GenerateThumbnailForResource(Resource const* resource, bool force = false);
+	void UploadAtlasPages(bool force);
+	bool GenerateThumbnailImage(D_FILE::Path const& path, DirectX::ScratchImage& result);
 	D_FILE::Path GetThumbnailsDirectory();
 
-	void GenerateThumbnailFromDDSTexture(Uuid const& resourceUuid, D_FILE::Path const& path);
-
 	void Initialize()
 	{
 		D_ASSERT(!_initialized);
@@ -63,13 +97,8 @@ namespace Darius::Editor::Gui::ThumbnailManager
 		RegisterResourceTypeTextures();
 
 		// Adding existing thumbnails
-		auto thumbnailDir = GetThumbnailsDirectory();
-		if (D_H_ENSURE_DIR(thumbnailDir))
-			D_FILE::VisitFilesInDirectory(thumbnailDir, true, [&](auto const& path)
-				{
-					auto uuid = FromWString(D_FILE::GetFileName(path));
-					AddExistingResourceThumbnail(uuid);
-				});
+		Atlas.Load(GetThumbnailsDirectory());
+		UploadAtlasPages(true);
 
 		_initialized = true;
 	}
@@ -78,23 +107,88 @@ namespace Darius::Editor::Gui::ThumbnailManager
 	{
 		D_ASSERT(_initialized);
 
+		// Letting the running batch finish and keeping what is generated
+		Queue.Clear();
+		D_JOB::WaitForTask(&GenerationTask);
+		while (SaveInProgress.load())
+			std::this_thread::yield();
+
+		if (Atlas.IsDiskDirty())
+			Atlas.Save(GetThumbnailsDirectory());
+
 		ResourceTypeTextures.clear();
-		ResourceTextures.clear();
 		CommonIconTextures.clear();
+		PageTextures.clear();
 
 		ResourceTypeTextureIdMap.clear();
-		ResourceTextureIdMap.clear();
 		CommonIconTextureIdMap.clear();
 	}
 
-	D_FILE::Path GetThumbnailsDirectory()
+	void Update()
 	{
-		return D_EDITOR_CONTEXT::GetProjectPath() / ThumbnailCacheDirectory;
+		UploadAtlasPages(false);
+
+		if (!GenerationTask.GetIsComplete())
+			return;
+
+		if (!Queue.IsEmpty())
+		{
+			GenerationTask.m_SetSize = std::min(Queue.GetSize(), MaxThumbnailsPerBatch);
+			D_JOB::AddTaskSet(&GenerationTask);
+		}
+		else if (!SaveInProgress.load() && Atlas.IsDiskDirty())
+		{
+			// Saving in background once the queue is drained
+			SaveInProgress.store(true);
+			D_JOB::AddPinnedTask(new ThumbnailSaveTask(), D_JOB::ThreadType::FileIO);
+		}
+	}
+
+	void UploadAtlasPages(bool force)
+	{
+		auto frame = D_GRAPHICS::GetFrameCount();
+		if (!force && frame - LastPageUploadFrame < PageUploadIntervalFrames)
+			return;
+
+		LastPageUploadFrame = frame;
+
+		auto pageCount = Atlas.GetPageCount();
+		auto rowPitch = ThumbnailAtlasPageSize * sizeof(uint32_t);
+
+		for (uint32_t page = 0u; page < pageCount; page++)
+		{
+			if (!Atlas.ConsumeGpuDirty(page))
+				continue;
+
+			// New page, one descriptor per page
+			if (page >= PageTextures.size())
+			{
+				auto& pageTexture = PageTextures.emplace_back(std::make_unique<AtlasPageTexture>());
+				Atlas.ReadPage(page, [&](uint32_t const* pixels)
+					{
+						pageTexture->Texture.Create2D(rowPitch, ThumbnailAtlasPageSize, ThumbnailAtlasPageSize, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, pixels);
+					});
+
+				auto gpuHandle = D_GUI_RENDERER::AllocateUiTexture(1);
+				D_GRAPHICS_DEVICE::GetDevice()->CopyDescriptorsSimple(1, gpuHandle, pageTexture->Texture.GetSRV(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+				pageTexture->TextureId = gpuHandle.GetGpuPtr();
+				continue;
+			}
+
+			Atlas.ReadPage(page, [&](uint32_t const* pixels)
+				{
+					D3D12_SUBRESOURCE_DATA data;
+					data.pData = pixels;
+					data.RowPitch = rowPitch;
+					data.SlicePitch = rowPitch * ThumbnailAtlasPageSize;
+					D_GRAPHICS::CommandContext::UpdateTexture(PageTextures[page]->Texture, 1, &data);
+				});
+		}
 	}
 
-	D_FILE::Path GetResourceThumbnailPath(Uuid uuid)
+	D_FILE::Path GetThumbnailsDirectory()
 	{
-		return GetThumbnailsDirectory() / (D_CORE::ToString(uuid) + ".dds");
+		return D_EDITOR_CONTEXT::GetProjectPath() / ThumbnailCacheDirectory;
 	}
 
 	void RegisterResourceTypeTextures()
@@ -115,8 +209,12 @@ namespace Darius::Editor::Gui::ThumbnailManager
 			{
 				auto resource = D_RESOURCE::GetRawResourceSync(resourcePrev.Handle, false);
 				auto resourcePath = resource->GetPath();
-				if (!resource->IsDefault() && resourcePath.has_parent_path() && std::filesystem::equivalent(resourcePath.parent_path(), path))
-					GenerateThumbnailForResource(resource);
+				if (resource->IsDefault() || !resourcePath.has_parent_path() || !std::filesystem::equivalent(resourcePath.parent_path(), path))
+					continue;
+
+				D_GUI_UTILS::ThumbnailAtlas::Slot slot;
+				if (!Atlas.Find(resource->GetUuid(), slot))
+					Queue.Push({ resource->GetUuid(), resourcePath });
 			}
 		}
 	}
@@ -151,83 +249,117 @@ namespace Darius::Editor::Gui::ThumbnailManager
 		return CommonIconTextureIdMap[iconId];
 	}
 
-	uint64_t GetResourceTextureId(D_RESOURCE::ResourceHandle const& handle)
+	Thumbnail GetResourceThumbnail(D_RESOURCE::ResourceHandle const& handle)
 	{
+		Thumbnail result;
+
 		auto resource = D_RESOURCE::GetRawResourceSync(handle, false);
 		auto uuid = resource->GetUuid();
-		if (ResourceTextureIdMap.contains(uuid))
-			return ResourceTextureIdMap[uuid];
+
+		D_GUI_UTILS::ThumbnailAtlas::Slot slot;
+		if (Atlas.Find(uuid, slot) && slot.Page < PageTextures.size())
+		{
+			auto uv = Atlas.GetSlotUV(slot);
+			result.TextureId = PageTextures[slot.Page]->TextureId;
+			result.Uv0[0] = uv.U0;
+			result.Uv0[1] = uv.V0;
+			result.Uv1[0] = uv.U1;
+			result.Uv1[1] = uv.V1;
+			return result;
+		}
+
+		// Items drawn in later frames come first
+		Queue.Prioritize(uuid, (uint64_t)D_GRAPHICS::GetFrameCount() + 1);
 
 		auto type = resource->GetType();
 		if (ResourceTypeTextureIdMap.contains(type))
-			return ResourceTypeTextureIdMap[type];
+			result.TextureId = ResourceTypeTextureIdMap[type];
+		else
+			result.TextureId = CommonIconTextureIdMap[CommonIcon::File];
 
-		return CommonIconTextureIdMap[CommonIcon::File];
+		return result;
 	}
 
-	void AddExistingResourceThumbnail(Uuid const& uuid)
+	bool GenerateThumbnailImage(D_FILE::Path const& path, DirectX::ScratchImage& result)
 	{
+		using namespace DirectX;
+
+		auto extension = path.extension().string();
+		boost::algorithm::to_lower(extension);
+
+		ScratchImage image;
+		TexMetadata meta;
+		HRESULT hr;
+		if (extension == ".dds")
+			hr = LoadFromDDSFile(path.c_str(), DDS_FLAGS_NONE, &meta, image);
+		else if (extension == ".tga")
+			hr = LoadFromTGAFile(path.c_str(), &meta, image);
+		else if (extension == ".hdr")
+			hr = LoadFromHDRFile(path.c_str(), &meta, image);
+		else
+			hr = LoadFromWICFile(path.c_str(), WIC_FLAGS_NONE, &meta, image);
 
-		// Return if texture already 
-		if (ResourceTextures.contains(uuid))
-			return;
-
-		auto& tex = ResourceTextures[uuid];
+		if (FAILED(hr) || meta.dimension != TEX_DIMENSION_TEXTURE2D)
+			return false;
 
-		auto fileData = D_FILE::ReadFileSync(GetResourceThumbnailPath(uuid));
+		// Smallest mip which still covers the thumbnail
+		size_t mip = 0;
+		while (mip + 1 < meta.mipLevels && std::max(meta.width >> (mip + 1), meta.height >> (mip + 1)) >= ThumbnailSize)
+			mip++;
 
-		tex.CreateDDSFromMemory(fileData->data(), fileData->size(), true);
+		Image const* source = image.GetImage(mip, 0, 0);
 
-		// Don't create texture if not
-		if (!tex.Is2D() || tex.ArraySize() > 1)
+		ScratchImage decompressed;
+		if (IsCompressed(source->format))
 		{
-			ResourceTextures.erase(uuid);
-			return;
+			if (FAILED(Decompress(*source, DXGI_FORMAT_UNKNOWN, decompressed)))
+				return false;
+			source = decompressed.GetImage(0, 0, 0);
 		}
 
-		auto gpuHandle = D_GUI_RENDERER::AllocateUiTexture(1);
-
-		D_GRAPHICS_DEVICE::GetDevice()->CopyDescriptorsSimple(1, gpuHandle, tex.GetSRV(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-		ResourceTextureIdMap[uuid] = gpuHandle.GetGpuPtr();
-	}
-
-	void GenerateThumbnailForResource(Resource const* resource, bool force)
-	{
-		auto resourceType = resource->GetType();
-		auto uuid = resource->GetUuid();
-
-		// Return if texture already 
-		if (!force && ResourceTextures.contains(uuid))
-			return;
-
-		if (resourceType == D_RENDERER::TextureResource::GetResourceType())
+		// Keeping sRGB encoded texels as they are, pages are sampled as sRGB
+		ScratchImage converted;
+		auto targetFormat = IsSRGB(source->format) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+		if (source->format != targetFormat)
 		{
-			GenerateThumbnailFromDDSTexture(uuid, resource->GetPath());
+			if (FAILED(Convert(*source, targetFormat, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, converted)))
+				return false;
+			source = converted.GetImage(0, 0, 0);
 		}
-		else
-			return;
 
-		AddExistingResourceThumbnail(uuid);
+		return SUCCEEDED(Resize(*source, ThumbnailSize, ThumbnailSize, TEX_FILTER_LINEAR, result));
 	}
 
-	void GenerateThumbnailFromDDSTexture(Uuid const& resourceUuid, D_FILE::Path const& path)
+	void ThumbnailGenerationTask::ExecuteRange(D_JOB::TaskPartition range, D_JOB::ThreadNumber threadNumber)
 	{
+		// WIC requires COM on this thread
+		auto coInit = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
 
-		auto destinationFolder = GetThumbnailsDirectory();
-		auto finalDestinationFile = (destinationFolder / (D_CORE::ToString(resourceUuid) + ".dds")).lexically_normal();
-
-		if (!D_H_ENSURE_DIR(destinationFolder))
-			std::filesystem::create_directories(destinationFolder);
+		for (auto i = range.start; i < range.end; i++)
+		{
+			auto request = Queue.Pop();
+			if (!request.has_value())
+				break;
 
-		auto normalPath = path.lexically_normal();
+			DirectX::ScratchImage thumbnail;
+			if (!GenerateThumbnailImage(request->SourcePath, thumbnail))
+			{
+				D_LOG_WARN("Could not generate thumbnail for " + request->SourcePath.string());
+				continue;
+			}
 
-		std::string outputExt = normalPath.extension().string();
-		outputExt = outputExt.substr(1, outputExt.size() - 1);
-		boost::algorithm::to_lower(outputExt);
-		auto thumbnaildCommand = std::string("Utils\\texconv.exe -m 1 -w 64 -h 64 -o \"" + destinationFolder.string() + "\" \"" + normalPath.string() + "\"");
+			auto image = thumbnail.GetImage(0, 0, 0);
+			auto slot = Atlas.Allocate(request->ResourceUuid);
+			Atlas.WriteSlot(slot, image->pixels, image->rowPitch);
+		}
 
-		system(thumbnaildCommand.c_str());
+		if (SUCCEEDED(coInit))
+			CoUninitialize();
+	}
 
-		std::filesystem::rename(destinationFolder / normalPath.filename().replace_extension(".dds"), finalDestinationFile);
+	void ThumbnailSaveTask::Execute()
+	{
+		Atlas.Save(GetThumbnailsDirectory());
+		SaveInProgress.store(false);
 	}
 }
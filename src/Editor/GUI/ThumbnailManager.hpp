@@ -17,11 +17,26 @@ namespace Darius::Editor::Gui::ThumbnailManager
 		NumIcons
 	};
 
+	struct Thumbnail
+	{
+		uint64_t			TextureId = 0u;
+		float				Uv0[2] = { 0.f, 0.f };
+		float				Uv1[2] = { 1.f, 1.f };
+	};
+
 	void					Initialize();
 	void					Shutdown();
 
+	// Uploads the generated thumbnails and schedules the next generation batch
+	void					Update();
+
 
 	uint64_t GetIconTextureId(CommonIcon iconId);
-	uint64_t GetResourceTextureId(D_RESOURCE::ResourceHandle const& resource);
+
+	// Returns the type icon until the thumbnail of the resource is generated.
+	// Pending generation of the resource is prioritized as it is being drawn.
+	Thumbnail GetResourceThumbnail(D_RESOURCE::ResourceHandle const& resource);
+
+	// Queues thumbnail generation for the resources in the directory
 	void RegisterExistingResources(D_FILE::Path const& path);
 }
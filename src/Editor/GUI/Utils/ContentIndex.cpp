@@ -0,0 +1,555 @@
+#include "Editor/pch.hpp"
+#include "ContentIndex.hpp"
+
+#include <Utils/Assert.hpp>
+
+using namespace D_CONTAINERS;
+using namespace D_FILE;
+
+namespace
+{
+	std::string ToLower(std::string_view str)
+	{
+		std::string result(str);
+		for (auto& c : result)
+			c = (char)std::tolower((unsigned char)c);
+		return result;
+	}
+
+	// Sorted and unique trigrams of the string
+	void CollectTrigrams(std::string_view str, DVector<uint32_t>& result)
+	{
+		result.clear();
+		if (str.size() < 3)
+			return;
+
+		result.reserve(str.size() - 2);
+		for (size_t i = 0; i + 2 < str.size(); i++)
+			result.push_back(((uint32_t)(uint8_t)str[i] << 16) | ((uint32_t)(uint8_t)str[i + 1] << 8) | (uint32_t)(uint8_t)str[i + 2]);
+
+		std::sort(result.begin(), result.end());
+		result.erase(std::unique(result.begin(), result.end()), result.end());
+	}
+}
+
+namespace Darius::Editor::Gui::Utils
+{
+	// Display order, directories first, then by name
+	static bool NodeLess(ContentIndex::Node const& a, ContentIndex::Node const& b)
+	{
+		if (a.IsDirectory != b.IsDirectory)
+			return a.IsDirectory;
+
+		int cmp = a.LowerName.compare(b.LowerName);
+		if (cmp != 0)
+			return cmp < 0;
+
+		return a.Name < b.Name;
+	}
+
+	bool ContentIndex::Filter::Accepts(Node const& node) const
+	{
+		if (node.IsDirectory)
+			return Directories;
+
+		if (!Files)
+			return false;
+
+		return Extensions.empty() || Extensions.contains(node.Extension);
+	}
+
+#pragma region Snapshot
+
+	ContentIndex::NodeId ContentIndex::Snapshot::Find(Path const& path) const
+	{
+		if (!mData)
+			return InvalidNode;
+
+		auto search = mData->PathMap.find(NormalizePath(path));
+		if (search == mData->PathMap.end())
+			return InvalidNode;
+
+		return search->second;
+	}
+
+	void ContentIndex::Snapshot::GetChildren(NodeId directory, Filter const& filter, DVector<NodeId>& result) const
+	{
+		result.clear();
+		if (!mData || directory >= mData->Nodes.size())
+			return;
+
+		auto const& node = mData->Nodes[directory];
+		result.reserve(node.Children.size());
+		for (auto child : node.Children)
+			if (filter.Accepts(mData->Nodes[child]))
+				result.push_back(child);
+	}
+
+	void ContentIndex::Snapshot::Search(std::string_view query, NodeId scope, Filter const& filter, DVector<NodeId>& result, size_t maxResults) const
+	{
+		result.clear();
+		if (!mData || query.empty())
+			return;
+
+		auto lowerQuery = ToLower(query);
+		auto const& nodes = mData->Nodes;
+		bool checkScope = scope != InvalidNode && scope != mData->Root;
+
+		auto accept = [&](NodeId id)
+			{
+				auto const& node = nodes[id];
+				if (!node.Alive || id == mData->Root)
+					return;
+
+				if (node.LowerName.find(lowerQuery) == std::string::npos || !filter.Accepts(node))
+					return;
+
+				if (checkScope && !IsDescendant(id, scope))
+					return;
+
+				result.push_back(id);
+			};
+
+		if (lowerQuery.size() < 3)
+		{
+			// Too short for trigrams
+			for (NodeId id = 0; id < (NodeId)nodes.size(); id++)
+				accept(id);
+		}
+		else
+		{
+			DVector<uint32_t> trigrams;
+			CollectTrigrams(lowerQuery, trigrams);
+
+			DVector<DVector<NodeId> const*> lists;
+			lists.reserve(trigrams.size());
+			for (auto trigram : trigrams)
+			{
+				auto search = mData->Trigrams.find(trigram);
+				if (search == mData->Trigrams.end())
+					return;
+				lists.push_back(&search->second);
+			}
+
+			// Intersecting from the shortest list
+			std::sort(lists.begin(), lists.end(), [](auto a, auto b) { return a->size() < b->size(); });
+
+			DVector<NodeId> candidates = *lists[0];
+			DVector<NodeId> temp;
+			for (size_t i = 1; i < lists.size() && !candidates.empty(); i++)
+			{
+				temp.clear();
+				std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(temp));
+				std::swap(candidates, temp);
+			}
+
+			// Trigrams match out of order too, so the names are verified
+			for (auto id : candidates)
+				accept(id);
+		}
+
+		std::sort(result.begin(), result.end(), [&nodes](NodeId a, NodeId b) { return NodeLess(nodes[a], nodes[b]); });
+
+		if (result.size() > maxResults)
+			result.resize(maxResults);
+	}
+
+	bool ContentIndex::Snapshot::IsDescendant(NodeId node, NodeId ancestor) const
+	{
+		if (!mData || node >= mData->Nodes.size())
+			return false;
+
+		for (NodeId current = mData->Nodes[node].Parent; current != InvalidNode; current = mData->Nodes[current].Parent)
+			if (current == ancestor)
+				return true;
+
+		return false;
+	}
+
+#pragma endregion
+
+	ContentIndex::ContentIndex() :
+		mData(std::make_shared<Data>())
+	{ }
+
+	Path ContentIndex::NormalizePath(Path const& path)
+	{
+		auto result = path.lexically_normal();
+
+		// Trailing separator
+		if (!result.has_filename() && result.has_relative_path())
+			result = result.parent_path();
+
+		return result;
+	}
+
+	ContentIndex::Snapshot ContentIndex::GetSnapshot() const
+	{
+		std::scoped_lock lock(mMutex);
+		return Snapshot(mData);
+	}
+
+	ContentIndex::Data& ContentIndex::MutateLocked()
+	{
+		// Copying only if a reader holds the data
+		if (mData.use_count() > 1)
+			mData = std::make_shared<Data>(*mData);
+
+		mData->Version++;
+		return *mData;
+	}
+
+	void ContentIndex::Reset(Path const& root)
+	{
+		std::scoped_lock lock(mMutex);
+		ResetLocked(root);
+	}
+
+	void ContentIndex::Build(Path const& root)
+	{
+		std::scoped_lock lock(mMutex);
+		ResetLocked(root);
+
+		// Fresh data is not shared with any reader yet
+		auto& data = *mData;
+		ScanLocked(data, data.Nodes[data.Root].Path, false);
+		SortChildren(data);
+	}
+
+	void ContentIndex::ResetLocked(Path const& root)
+	{
+		auto version = mData->Version;
+
+		// Readers keep the old data
+		mData = std::make_shared<Data>();
+		mData->Version = version + 1;
+
+		auto normalRoot = NormalizePath(root);
+		auto& node = mData->Nodes.emplace_back();
+		node.IsDirectory = true;
+		node.Alive = true;
+		SetName(node, normalRoot);
+
+		mData->Root = 0u;
+		mData->PathMap[normalRoot] = 0u;
+	}
+
+	bool ContentIndex::Add(Path const& path, bool isDirectory)
+	{
+		std::scoped_lock lock(mMutex);
+
+		auto normalPath = NormalizePath(path);
+		if (mData->Root == InvalidNode || mData->PathMap.contains(normalPath) || IsIgnoredLocked(normalPath))
+			return false;
+
+		return AddLocked(MutateLocked(), normalPath, isDirectory, true) != InvalidNode;
+	}
+
+	bool ContentIndex::AddFromDisk(Path const& path)
+	{
+		std::scoped_lock lock(mMutex);
+
+		auto normalPath = NormalizePath(path);
+		if (mData->Root == InvalidNode || mData->PathMap.contains(normalPath) || IsIgnoredLocked(normalPath))
+			return false;
+
+		std::error_code ec;
+		auto status = std::filesystem::status(normalPath, ec);
+		if (ec || !std::filesystem::exists(status))
+			return false;
+
+		bool isDirectory = std::filesystem::is_directory(status);
+
+		auto& data = MutateLocked();
+		if (AddLocked(data, normalPath, isDirectory, true) == InvalidNode)
+			return false;
+
+		// A directory moved in from outside is reported without its contents
+		if (isDirectory)
+			ScanLocked(data, normalPath, true);
+
+		return true;
+	}
+
+	bool ContentIndex::Remove(Path const& path)
+	{
+		std::scoped_lock lock(mMutex);
+
+		auto search = mData->PathMap.find(NormalizePath(path));
+		if (search == mData->PathMap.end() || search->second == mData->Root)
+			return false;
+
+		auto id = search->second;
+		RemoveLocked(MutateLocked(), id);
+		return true;
+	}
+
+	bool ContentIndex::Rename(Path const& oldPath, Path const& newPath)
+	{
+		std::scoped_lock lock(mMutex);
+
+		auto normalOld = NormalizePath(oldPath);
+		auto normalNew = NormalizePath(newPath);
+
+		auto search = mData->PathMap.find(normalOld);
+		if (search == mData->PathMap.end() || search->second == mData->Root || normalOld == normalNew)
+			return false;
+
+		NodeId id = search->second;
+		auto& data = MutateLocked();
+
+		// Renamed to something which is not tracked
+		if (IsIgnoredLocked(normalNew))
+		{
+			RemoveLocked(data, id);
+			return true;
+		}
+
+		auto existing = data.PathMap.find(normalNew);
+		if (existing != data.PathMap.end())
+		{
+			if (existing->second == data.Root)
+				return false;
+			RemoveLocked(data, existing->second);
+		}
+
+		NodeId newParent = EnsureDirectoryLocked(data, normalNew.parent_path());
+		if (newParent == InvalidNode || newParent == id)
+			return false;
+
+		// Can't be moved under itself
+		for (NodeId current = newParent; current != InvalidNode; current = data.Nodes[current].Parent)
+			if (current == id)
+				return false;
+
+		// Collecting the subtree before the paths change
+		DVector<NodeId> subtree = { id };
+		for (size_t i = 0; i < subtree.size(); i++)
+			for (auto child : data.Nodes[subtree[i]].Children)
+				subtree.push_back(child);
+
+		for (auto nodeId : subtree)
+			data.PathMap.erase(data.Nodes[nodeId].Path);
+
+		EraseChild(data, data.Nodes[id].Parent, id);
+		RemoveTrigrams(data, id);
+		CountFile(data, data.Nodes[id], false);
+
+		auto& node = data.Nodes[id];
+		node.Parent = newParent;
+		SetName(node, normalNew);
+
+		CountFile(data, node, true);
+		AddTrigrams(data, id);
+		InsertChild(data, newParent, id);
+
+		// Parents come before their children in the subtree
+		data.PathMap[normalNew] = id;
+		for (size_t i = 1; i < subtree.size(); i++)
+		{
+			auto& child = data.Nodes[subtree[i]];
+			child.Path = data.Nodes[child.Parent].Path / child.Path.filename();
+			data.PathMap[child.Path] = subtree[i];
+		}
+
+		return true;
+	}
+
+	ContentIndex::NodeId ContentIndex::AddLocked(Data& data, Path const& path, bool isDirectory, bool sorted)
+	{
+		if (data.PathMap.contains(path))
+			return InvalidNode;
+
+		// Has to be done before taking a reference to the node
+		NodeId parent = EnsureDirectoryLocked(data, path.parent_path());
+		if (parent == InvalidNode)
+			return InvalidNode;
+
+		NodeId id;
+		if (!data.FreeIds.empty())
+		{
+			id = data.FreeIds.back();
+			data.FreeIds.pop_back();
+		}
+		else
+		{
+			id = (NodeId)data.Nodes.size();
+			data.Nodes.emplace_back();
+		}
+
+		auto& node = data.Nodes[id];
+		node = Node();
+		node.IsDirectory = isDirectory;
+		node.Alive = true;
+		node.Parent = parent;
+		SetName(node, path);
+
+		data.PathMap[path] = id;
+
+		if (sorted)
+			InsertChild(data, parent, id);
+		else
+			data.Nodes[parent].Children.push_back(id);
+
+		AddTrigrams(data, id);
+		CountFile(data, node, true);
+
+		return id;
+	}
+
+	ContentIndex::NodeId ContentIndex::EnsureDirectoryLocked(Data& data, Path const& path)
+	{
+		auto search = data.PathMap.find(path);
+		if (search != data.PathMap.end())
+			return data.Nodes[search->second].IsDirectory ? search->second : InvalidNode;
+
+		// Reached the top without passing the root
+		if (!path.has_relative_path() || path == path.parent_path() || IsIgnoredLocked(path))
+			return InvalidNode;
+
+		// Nothing is created unless the parent chain reaches the root
+		return AddLocked(data, path, true, true);
+	}
+
+	void ContentIndex::RemoveLocked(Data& data, NodeId id)
+	{
+		EraseChild(data, data.Nodes[id].Parent, id);
+
+		DVector<NodeId> subtree = { id };
+		for (size_t i = 0; i < subtree.size(); i++)
+			for (auto child : data.Nodes[subtree[i]].Children)
+				subtree.push_back(child);
+
+		for (auto nodeId : subtree)
+		{
+			auto& node = data.Nodes[nodeId];
+			RemoveTrigrams(data, nodeId);
+			CountFile(data, node, false);
+			data.PathMap.erase(node.Path);
+
+			node = Node();
+			data.FreeIds.push_back(nodeId);
+		}
+	}
+
+	void ContentIndex::ScanLocked(Data& data, Path const& directory, bool sorted)
+	{
+		std::error_code ec;
+		std::filesystem::recursive_directory_iterator it(directory, std::filesystem::directory_options::skip_permission_denied, ec);
+
+		// Parents are visited before their children
+		for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+		{
+			auto path = NormalizePath(it->path());
+			bool isDirectory = it->is_directory(ec);
+
+			if (IsIgnoredLocked(path))
+			{
+				if (isDirectory)
+					it.disable_recursion_pending();
+				continue;
+			}
+
+			AddLocked(data, path, isDirectory, sorted);
+		}
+	}
+
+	bool ContentIndex::IsIgnoredLocked(Path const& path) const
+	{
+		return mIgnore && mIgnore(path);
+	}
+
+	void ContentIndex::SetName(Node& node, Path const& path)
+	{
+		node.Path = path;
+		node.Name = WSTR2STR(path.filename().wstring());
+		node.LowerName = ToLower(node.Name);
+		node.Extension = node.IsDirectory ? std::string() : ToLower(WSTR2STR(path.extension().wstring()));
+	}
+
+	void ContentIndex::CountFile(Data& data, Node const& node, bool add)
+	{
+		if (node.IsDirectory || !node.Alive)
+			return;
+
+		if (add)
+		{
+			data.FileCount++;
+			data.ExtensionCounts[node.Extension]++;
+			return;
+		}
+
+		data.FileCount--;
+		auto search = data.ExtensionCounts.find(node.Extension);
+		D_ASSERT(search != data.ExtensionCounts.end());
+		if (--search->second == 0u)
+			data.ExtensionCounts.erase(search);
+	}
+
+	void ContentIndex::InsertChild(Data& data, NodeId parent, NodeId child)
+	{
+		auto& children = data.Nodes[parent].Children;
+		auto const& nodes = data.Nodes;
+		auto it = std::lower_bound(children.begin(), children.end(), child, [&nodes](NodeId a, NodeId b) { return NodeLess(nodes[a], nodes[b]); });
+		children.insert(it, child);
+	}
+
+	void ContentIndex::EraseChild(Data& data, NodeId parent, NodeId child)
+	{
+		if (parent == InvalidNode)
+			return;
+
+		auto& children = data.Nodes[parent].Children;
+		auto it = std::find(children.begin(), children.end(), child);
+		if (it != children.end())
+			children.erase(it);
+	}
+
+	void ContentIndex::AddTrigrams(Data& data, NodeId id)
+	{
+		DVector<uint32_t> trigrams;
+		CollectTrigrams(data.Nodes[id].LowerName, trigrams);
+
+		for (auto trigram : trigrams)
+		{
+			// Ids are mostly increasing, so this is usually an append
+			auto& list = data.Trigrams[trigram];
+			auto it = std::lower_bound(list.begin(), list.end(), id);
+			if (it == list.end() || *it != id)
+				list.insert(it, id);
+		}
+	}
+
+	void ContentIndex::RemoveTrigrams(Data& data, NodeId id)
+	{
+		DVector<uint32_t> trigrams;
+		CollectTrigrams(data.Nodes[id].LowerName, trigrams);
+
+		for (auto trigram : trigrams)
+		{
+			auto search = data.Trigrams.find(trigram);
+			if (search == data.Trigrams.end())
+				continue;
+
+			auto& list = search->second;
+			auto it = std::lower_bound(list.begin(), list.end(), id);
+			if (it != list.end() && *it == id)
+				list.erase(it);
+
+			if (list.empty())
+				data.Trigrams.erase(search);
+		}
+	}
+
+	void ContentIndex::SortChildren(Data& data)
+	{
+		auto const& nodes = data.Nodes;
+		for (auto& node : data.Nodes)
+		{
+			if (!node.Alive || node.Children.size() < 2)
+				continue;
+
+			std::sort(node.Children.begin(), node.Children.end(), [&nodes](NodeId a, NodeId b) { return NodeLess(nodes[a], nodes[b]); });
+		}
+	}
+}
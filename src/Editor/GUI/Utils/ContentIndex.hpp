@@ -0,0 +1,152 @@
+#pragma once
+
+#include <Core/Containers/Map.hpp>
+#include <Core/Containers/Set.hpp>
+#include <Core/Containers/Vector.hpp>
+#include <Core/Filesystem/Path.hpp>
+#include <Utils/Common.hpp>
+
+#include <functional>
+#include <mutex>
+#include <string_view>
+
+#ifndef D_GUI_UTILS
+#define D_GUI_UTILS Darius::Editor::Gui::Utils
+#endif // !D_GUI_UTILS
+
+namespace Darius::Editor::Gui::Utils
+{
+	// In-memory tree of the files and directories under a root, with the children of each
+	// directory kept sorted and a trigram index over the names for substring search.
+	// It is built once and then updated incrementally. Readers take a snapshot which stays
+	// unchanged while the index is being modified; the data is only copied when a snapshot
+	// is alive during a modification. Modifications and taking snapshots are thread safe.
+	class ContentIndex
+	{
+	public:
+		typedef uint32_t						NodeId;
+		static constexpr NodeId					InvalidNode = UINT32_MAX;
+
+		struct Node
+		{
+			D_FILE::Path						Path;
+			std::string							Name;
+			std::string							LowerName;
+			std::string							Extension; // Lower case, including the dot
+			NodeId								Parent = InvalidNode;
+			bool								IsDirectory = false;
+			bool								Alive = false;
+
+			// Directories first, then by name
+			D_CONTAINERS::DVector<NodeId>		Children;
+		};
+
+		struct Filter
+		{
+			// Empty accepts all extensions
+			D_CONTAINERS::DSet<std::string>		Extensions;
+			bool								Directories = true;
+			bool								Files = true;
+
+			bool								Accepts(Node const& node) const;
+		};
+
+	private:
+		struct Data
+		{
+			D_CONTAINERS::DVector<Node>			Nodes;
+			D_CONTAINERS::DVector<NodeId>		FreeIds;
+			D_CONTAINERS::DUnorderedMap<D_FILE::Path, NodeId> PathMap;
+			D_CONTAINERS::DUnorderedMap<uint32_t, D_CONTAINERS::DVector<NodeId>> Trigrams;
+			D_CONTAINERS::DMap<std::string, uint32_t> ExtensionCounts;
+			NodeId								Root = InvalidNode;
+			uint32_t							FileCount = 0u;
+			uint64_t							Version = 0u;
+		};
+
+	public:
+		class Snapshot
+		{
+		public:
+			Snapshot() = default;
+
+			NodeId								Find(D_FILE::Path const& path) const;
+			INLINE Node const&					Get(NodeId id) const { return mData->Nodes[id]; }
+			INLINE NodeId						GetRoot() const { return mData ? mData->Root : InvalidNode; }
+			INLINE bool							IsValid() const { return mData && mData->Root != InvalidNode; }
+			INLINE uint32_t						GetNodeCount() const { return mData ? (uint32_t)mData->PathMap.size() : 0u; }
+			INLINE uint32_t						GetFileCount() const { return mData ? mData->FileCount : 0u; }
+			INLINE uint64_t						GetVersion() const { return mData ? mData->Version : 0u; }
+
+			// File extensions in the index and the number of files having them
+			INLINE D_CONTAINERS::DMap<std::string, uint32_t> const& GetExtensions() const { return mData->ExtensionCounts; }
+
+			// Children of the directory in display order
+			void								GetChildren(NodeId directory, Filter const& filter, D_CONTAINERS::DVector<NodeId>& result) const;
+
+			// Case insensitive substring search over the names of the nodes under the scope.
+			// Results are in display order and capped at maxResults.
+			void								Search(std::string_view query, NodeId scope, Filter const& filter, D_CONTAINERS::DVector<NodeId>& result, size_t maxResults = SIZE_MAX) const;
+
+			bool								IsDescendant(NodeId node, NodeId ancestor) const;
+
+		private:
+			friend class ContentIndex;
+
+			Snapshot(std::shared_ptr<Data const> data) : mData(std::move(data)) {}
+
+			std::shared_ptr<Data const>			mData;
+		};
+
+	public:
+		ContentIndex();
+
+		// Returns whether the path should be left out of the index
+		INLINE void							SetIgnoreFunction(std::function<bool(D_FILE::Path const&)> const& func) { std::scoped_lock lock(mMutex); mIgnore = func; }
+
+		// Clears the index and sets the root without touching the disk
+		void								Reset(D_FILE::Path const& root);
+
+		// Clears the index and scans the root recursively
+		void								Build(D_FILE::Path const& root);
+
+		// Adds the path and its missing parent directories. Returns false if the path is
+		// not under the root, is ignored or already exists.
+		bool								Add(D_FILE::Path const& path, bool isDirectory);
+
+		// Adds the path from the disk, including the contents if it is a directory
+		bool								AddFromDisk(D_FILE::Path const& path);
+
+		// Removes the path and everything under it
+		bool								Remove(D_FILE::Path const& path);
+
+		// Moves the path and everything under it. The destination is replaced if it exists.
+		bool								Rename(D_FILE::Path const& oldPath, D_FILE::Path const& newPath);
+
+		Snapshot							GetSnapshot() const;
+
+		static D_FILE::Path					NormalizePath(D_FILE::Path const& path);
+
+	private:
+		// Mutex has to be held
+		Data&								MutateLocked();
+		void								ResetLocked(D_FILE::Path const& root);
+		NodeId								AddLocked(Data& data, D_FILE::Path const& path, bool isDirectory, bool sorted);
+		NodeId								EnsureDirectoryLocked(Data& data, D_FILE::Path const& path);
+		void								RemoveLocked(Data& data, NodeId id);
+		void								ScanLocked(Data& data, D_FILE::Path const& directory, bool sorted);
+		bool								IsIgnoredLocked(D_FILE::Path const& path) const;
+
+		static void							SetName(Node& node, D_FILE::Path const& path);
+		static void							CountFile(Data& data, Node const& node, bool add);
+		static void							InsertChild(Data& data, NodeId parent, NodeId child);
+		static void							EraseChild(Data& data, NodeId parent, NodeId child);
+		static void							AddTrigrams(Data& data, NodeId id);
+		static void							RemoveTrigrams(Data& data, NodeId id);
+		static void							SortChildren(Data& data);
+
+		mutable std::mutex					mMutex;
+		std::shared_ptr<Data>				mData;
+		std::function<bool(D_FILE::Path const&)> mIgnore;
+	};
+}
@@ -0,0 +1,123 @@
+#include "Editor/pch.hpp"
+#include "DirectoryWatcher.hpp"
+
+#include <Utils/Log.hpp>
+
+using namespace D_CONTAINERS;
+using namespace D_FILE;
+
+namespace Darius::Editor::Gui::Utils
+{
+	DirectoryWatcher::~DirectoryWatcher()
+	{
+		Stop();
+	}
+
+	bool DirectoryWatcher::Start(Path const& directory)
+	{
+		Stop();
+
+		HANDLE handle = CreateFileW(directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+		{
+			D_LOG_WARN_FMT("Could not watch directory {}", directory.string());
+			return false;
+		}
+
+		mDirectory = directory;
+		mHandle = handle;
+		mRunning = true;
+		mThread = std::thread(&DirectoryWatcher::Run, this);
+		return true;
+	}
+
+	void DirectoryWatcher::Stop()
+	{
+		if (!mHandle)
+			return;
+
+		// Wakes the thread up from the blocking read
+		mRunning = false;
+		CancelIoEx((HANDLE)mHandle, nullptr);
+
+		if (mThread.joinable())
+			mThread.join();
+
+		CloseHandle((HANDLE)mHandle);
+		mHandle = nullptr;
+	}
+
+	void DirectoryWatcher::Poll(DVector<Change>& changes)
+	{
+		changes.clear();
+
+		std::scoped_lock lock(mChangesMutex);
+		std::swap(changes, mChanges);
+	}
+
+	void DirectoryWatcher::Run()
+	{
+		constexpr DWORD bufferSize = 64 * 1024;
+		constexpr DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+		// Notification records are DWORD aligned
+		DVector<DWORD> buffer(bufferSize / sizeof(DWORD));
+		DVector<Change> changes;
+		Path renamedFrom;
+
+		while (mRunning.load())
+		{
+			DWORD bytes = 0;
+			if (!ReadDirectoryChangesW((HANDLE)mHandle, buffer.data(), bufferSize, TRUE, filter, &bytes, nullptr, nullptr))
+			{
+				if (mRunning.load())
+				{
+					D_LOG_WARN_FMT("Watching directory {} stopped", mDirectory.string());
+					mRunning = false;
+				}
+				break;
+			}
+
+			changes.clear();
+
+			// The buffer was not large enough to hold the changes
+			if (bytes == 0)
+				changes.push_back({ ChangeType::Overflow, mDirectory });
+
+			auto data = reinterpret_cast<uint8_t const*>(buffer.data());
+			while (bytes > 0)
+			{
+				auto info = reinterpret_cast<FILE_NOTIFY_INFORMATION const*>(data);
+				auto path = mDirectory / std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR));
+
+				switch (info->Action)
+				{
+				case FILE_ACTION_ADDED:
+					changes.push_back({ ChangeType::Added, path });
+					break;
+				case FILE_ACTION_REMOVED:
+					changes.push_back({ ChangeType::Removed, path });
+					break;
+				case FILE_ACTION_MODIFIED:
+					changes.push_back({ ChangeType::Modified, path });
+					break;
+				case FILE_ACTION_RENAMED_OLD_NAME:
+					renamedFrom = path;
+					break;
+				case FILE_ACTION_RENAMED_NEW_NAME:
+					changes.push_back({ ChangeType::Renamed, path, renamedFrom });
+					break;
+				default:
+					break;
+				}
+
+				if (info->NextEntryOffset == 0)
+					break;
+				data += info->NextEntryOffset;
+			}
+
+			std::scoped_lock lock(mChangesMutex);
+			mChanges.insert(mChanges.end(), changes.begin(), changes.end());
+		}
+	}
+}
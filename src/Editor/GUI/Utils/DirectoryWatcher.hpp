@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Core/Containers/Vector.hpp>
+#include <Core/Filesystem/Path.hpp>
+#include <Utils/Common.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#ifndef D_GUI_UTILS
+#define D_GUI_UTILS Darius::Editor::Gui::Utils
+#endif // !D_GUI_UTILS
+
+namespace Darius::Editor::Gui::Utils
+{
+	// Watches a directory recursively on a background thread and collects the changes
+	// to be polled from the main thread
+	class DirectoryWatcher
+	{
+	public:
+		enum class ChangeType
+		{
+			Added,
+			Removed,
+			Modified,
+			Renamed,
+
+			// Changes are lost and the directory has to be scanned again
+			Overflow
+		};
+
+		struct Change
+		{
+			ChangeType						Type;
+			D_FILE::Path					Path;
+			D_FILE::Path					OldPath; // Only for renames
+		};
+
+	public:
+		DirectoryWatcher() = default;
+		~DirectoryWatcher();
+
+		DirectoryWatcher(DirectoryWatcher const&) = delete;
+
+		bool								Start(D_FILE::Path const& directory);
+		void								Stop();
+
+		// Moves the changes since the last call to the vector
+		void								Poll(D_CONTAINERS::DVector<Change>& changes);
+
+		INLINE bool							IsRunning() const { return mRunning.load(); }
+		INLINE D_FILE::Path const&			GetDirectory() const { return mDirectory; }
+
+	private:
+		void								Run();
+
+		D_FILE::Path						mDirectory;
+		void*								mHandle = nullptr;
+		std::thread							mThread;
+		std::atomic_bool					mRunning = false;
+
+		std::mutex							mChangesMutex;
+		D_CONTAINERS::DVector<Change>		mChanges;
+	};
+}
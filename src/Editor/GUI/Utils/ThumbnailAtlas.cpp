@@ -0,0 +1,296 @@
+#include "Editor/pch.hpp"
+#include "ThumbnailAtlas.hpp"
+
+#include <Utils/Assert.hpp>
+
+#include <fstream>
+
+using namespace D_CONTAINERS;
+using namespace D_CORE;
+using namespace D_FILE;
+
+namespace
+{
+	constexpr uint32_t	IndexMagic = 0x41485444; // DTHA
+	constexpr uint32_t	IndexVersion = 1u;
+
+	struct IndexHeader
+	{
+		uint32_t		Magic;
+		uint32_t		Version;
+		uint32_t		PageSize;
+		uint32_t		SlotSize;
+		uint32_t		PageCount;
+		uint32_t		EntryCount;
+	};
+
+	struct IndexEntry
+	{
+		uint8_t			Uuid[16];
+		uint16_t		Page;
+		uint16_t		Index;
+	};
+
+	D_STATIC_ASSERT(sizeof(IndexEntry) == 20);
+
+	Path GetIndexPath(Path const& directory)
+	{
+		return directory / "Atlas.index";
+	}
+
+	Path GetPagePath(Path const& directory, uint32_t page)
+	{
+		return directory / ("Atlas" + std::to_string(page) + ".page");
+	}
+}
+
+namespace Darius::Editor::Gui::Utils
+{
+	ThumbnailAtlas::ThumbnailAtlas(uint32_t pageSize, uint32_t slotSize) :
+		mPageSize(pageSize),
+		mSlotSize(slotSize),
+		mSlotsPerRow(pageSize / slotSize)
+	{
+		D_ASSERT(slotSize > 0 && pageSize >= slotSize);
+		D_ASSERT(GetSlotsPerPage() <= UINT16_MAX);
+	}
+
+	ThumbnailAtlas::Slot ThumbnailAtlas::Allocate(Uuid const& uuid)
+	{
+		std::scoped_lock lock(mMutex);
+
+		auto search = mIndex.find(uuid);
+		if (search != mIndex.end())
+			return search->second;
+
+		if (mFreeSlots.empty())
+			AddPageLocked();
+
+		auto slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+
+		mIndex[uuid] = slot;
+		mIndexDiskDirty = true;
+		return slot;
+	}
+
+	void ThumbnailAtlas::AddPageLocked()
+	{
+		D_ASSERT(mPages.size() < UINT16_MAX);
+
+		uint16_t pageIndex = (uint16_t)mPages.size();
+		auto& page = mPages.emplace_back();
+		page.Pixels.resize((size_t)mPageSize * mPageSize, 0u);
+
+		// Reversed so that the slots are handed out in order
+		for (uint32_t i = GetSlotsPerPage(); i > 0; i--)
+			mFreeSlots.push_back({ pageIndex, (uint16_t)(i - 1) });
+	}
+
+	bool ThumbnailAtlas::Find(Uuid const& uuid, Slot& slot) const
+	{
+		std::scoped_lock lock(mMutex);
+
+		auto search = mIndex.find(uuid);
+		if (search == mIndex.end())
+			return false;
+
+		slot = search->second;
+		return true;
+	}
+
+	bool ThumbnailAtlas::Free(Uuid const& uuid)
+	{
+		std::scoped_lock lock(mMutex);
+
+		auto search = mIndex.find(uuid);
+		if (search == mIndex.end())
+			return false;
+
+		mFreeSlots.push_back(search->second);
+		mIndex.erase(search);
+		mIndexDiskDirty = true;
+		return true;
+	}
+
+	void ThumbnailAtlas::Clear()
+	{
+		std::scoped_lock lock(mMutex);
+
+		mIndex.clear();
+		mFreeSlots.clear();
+		mPages.clear();
+		mIndexDiskDirty = true;
+	}
+
+	void ThumbnailAtlas::WriteSlot(Slot slot, void const* pixels, size_t rowPitch)
+	{
+		std::scoped_lock lock(mMutex);
+
+		D_ASSERT(slot.Page < mPages.size() && slot.Index < GetSlotsPerPage());
+
+		auto& page = mPages[slot.Page];
+		uint32_t originX = (slot.Index % mSlotsPerRow) * mSlotSize;
+		uint32_t originY = (slot.Index / mSlotsPerRow) * mSlotSize;
+
+		auto src = reinterpret_cast<uint8_t const*>(pixels);
+		for (uint32_t row = 0; row < mSlotSize; row++)
+		{
+			auto dest = page.Pixels.data() + (size_t)(originY + row) * mPageSize + originX;
+			std::memcpy(dest, src + row * rowPitch, mSlotSize * sizeof(uint32_t));
+		}
+
+		page.GpuDirty = true;
+		page.DiskDirty = true;
+	}
+
+	void ThumbnailAtlas::ReadPage(uint32_t page, std::function<void(uint32_t const* pixels)> const& func) const
+	{
+		std::scoped_lock lock(mMutex);
+
+		D_ASSERT(page < mPages.size());
+		func(mPages[page].Pixels.data());
+	}
+
+	bool ThumbnailAtlas::ConsumeGpuDirty(uint32_t page)
+	{
+		std::scoped_lock lock(mMutex);
+
+		if (page >= mPages.size() || !mPages[page].GpuDirty)
+			return false;
+
+		mPages[page].GpuDirty = false;
+		return true;
+	}
+
+	bool ThumbnailAtlas::IsDiskDirty() const
+	{
+		std::scoped_lock lock(mMutex);
+
+		if (mIndexDiskDirty)
+			return true;
+
+		for (auto const& page : mPages)
+			if (page.DiskDirty)
+				return true;
+
+		return false;
+	}
+
+	ThumbnailAtlas::UVRect ThumbnailAtlas::GetSlotUV(Slot slot) const
+	{
+		float invPageSize = 1.f / mPageSize;
+		float u0 = (slot.Index % mSlotsPerRow) * mSlotSize * invPageSize;
+		float v0 = (slot.Index / mSlotsPerRow) * mSlotSize * invPageSize;
+		float size = mSlotSize * invPageSize;
+		return { u0, v0, u0 + size, v0 + size };
+	}
+
+	bool ThumbnailAtlas::Save(Path const& directory)
+	{
+		// Taking a snapshot so that the slots can be written while saving
+		DVector<IndexEntry> entries;
+		DVector<std::pair<uint32_t, DVector<uint32_t>>> dirtyPages;
+		IndexHeader header;
+		{
+			std::scoped_lock lock(mMutex);
+
+			header = { IndexMagic, IndexVersion, mPageSize, mSlotSize, (uint32_t)mPages.size(), (uint32_t)mIndex.size() };
+
+			entries.reserve(mIndex.size());
+			for (auto const& [uuid, slot] : mIndex)
+			{
+				IndexEntry& entry = entries.emplace_back();
+				std::memcpy(entry.Uuid, uuid.data, sizeof(entry.Uuid));
+				entry.Page = slot.Page;
+				entry.Index = slot.Index;
+			}
+
+			for (uint32_t i = 0; i < (uint32_t)mPages.size(); i++)
+			{
+				if (!mPages[i].DiskDirty)
+					continue;
+
+				dirtyPages.push_back({ i, mPages[i].Pixels });
+				mPages[i].DiskDirty = false;
+			}
+
+			mIndexDiskDirty = false;
+		}
+
+		std::error_code ec;
+		std::filesystem::create_directories(directory, ec);
+
+		bool result = true;
+		for (auto const& [pageIndex, pixels] : dirtyPages)
+		{
+			std::ofstream file(GetPagePath(directory, pageIndex), std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<char const*>(pixels.data()), pixels.size() * sizeof(uint32_t));
+			result &= (bool)file;
+		}
+
+		// Index is written last so that it never refers to missing pages
+		std::ofstream file(GetIndexPath(directory), std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		file.write(reinterpret_cast<char const*>(entries.data()), entries.size() * sizeof(IndexEntry));
+		result &= (bool)file;
+
+		return result;
+	}
+
+	bool ThumbnailAtlas::Load(Path const& directory)
+	{
+		std::ifstream file(GetIndexPath(directory), std::ios::binary);
+		if (!file.good())
+			return false;
+
+		IndexHeader header;
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+			return false;
+
+		if (header.Magic != IndexMagic || header.Version != IndexVersion || header.PageSize != mPageSize || header.SlotSize != mSlotSize)
+			return false;
+
+		DVector<IndexEntry> entries(header.EntryCount);
+		if (!file.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(IndexEntry)))
+			return false;
+
+		DVector<Page> pages(header.PageCount);
+		size_t pageBytes = (size_t)mPageSize * mPageSize * sizeof(uint32_t);
+		for (uint32_t i = 0; i < header.PageCount; i++)
+		{
+			std::ifstream pageFile(GetPagePath(directory, i), std::ios::binary);
+			pages[i].Pixels.resize((size_t)mPageSize * mPageSize);
+			if (!pageFile.read(reinterpret_cast<char*>(pages[i].Pixels.data()), pageBytes))
+				return false;
+
+			pages[i].DiskDirty = false;
+		}
+
+		std::scoped_lock lock(mMutex);
+
+		mPages = std::move(pages);
+		mIndex.clear();
+		mFreeSlots.clear();
+
+		DVector<bool> used(mPages.size() * GetSlotsPerPage(), false);
+		for (auto const& entry : entries)
+		{
+			if (entry.Page >= mPages.size() || entry.Index >= GetSlotsPerPage())
+				continue;
+
+			Uuid uuid;
+			std::memcpy(uuid.data, entry.Uuid, sizeof(entry.Uuid));
+			mIndex[uuid] = { entry.Page, entry.Index };
+			used[(size_t)entry.Page * GetSlotsPerPage() + entry.Index] = true;
+		}
+
+		for (uint32_t page = (uint32_t)mPages.size(); page > 0; page--)
+			for (uint32_t index = GetSlotsPerPage(); index > 0; index--)
+				if (!used[(size_t)(page - 1) * GetSlotsPerPage() + index - 1])
+					mFreeSlots.push_back({ (uint16_t)(page - 1), (uint16_t)(index - 1) });
+
+		mIndexDiskDirty = false;
+		return true;
+	}
+}
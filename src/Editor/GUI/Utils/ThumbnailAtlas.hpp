@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Core/Containers/Map.hpp>
+#include <Core/Containers/Vector.hpp>
+#include <Core/Filesystem/Path.hpp>
+#include <Core/Uuid.hpp>
+#include <Utils/Common.hpp>
+
+#include <functional>
+#include <mutex>
+
+#ifndef D_GUI_UTILS
+#define D_GUI_UTILS Darius::Editor::Gui::Utils
+#endif // !D_GUI_UTILS
+
+namespace Darius::Editor::Gui::Utils
+{
+	// Packs fixed size RGBA8 thumbnails into square atlas pages and keeps the pixels of the
+	// pages on CPU. The uuid to slot index and the pages are persisted in a directory so that
+	// thumbnails survive between sessions. All methods are thread safe.
+	class ThumbnailAtlas
+	{
+	public:
+		struct Slot
+		{
+			uint16_t						Page;
+			uint16_t						Index;
+		};
+
+		struct UVRect
+		{
+			float							U0;
+			float							V0;
+			float							U1;
+			float							V1;
+		};
+
+	public:
+		ThumbnailAtlas(uint32_t pageSize = 1024u, uint32_t slotSize = 64u);
+
+		// Returns the existing slot if the uuid already has one
+		Slot								Allocate(D_CORE::Uuid const& uuid);
+		bool								Find(D_CORE::Uuid const& uuid, Slot& slot) const;
+		bool								Free(D_CORE::Uuid const& uuid);
+		void								Clear();
+
+		// Copies SlotSize x SlotSize RGBA8 pixels into the slot
+		void								WriteSlot(Slot slot, void const* pixels, size_t rowPitch);
+
+		// Calls the function with the pixels of the page while no slot is being written
+		void								ReadPage(uint32_t page, std::function<void(uint32_t const* pixels)> const& func) const;
+
+		// Returns whether the page is changed since the last call
+		bool								ConsumeGpuDirty(uint32_t page);
+
+		// Whether there are changes which are not saved yet
+		bool								IsDiskDirty() const;
+
+		// Writes the index and the pages changed since the last save
+		bool								Save(D_FILE::Path const& directory);
+
+		// Returns false and stays empty if there is no compatible atlas in the directory
+		bool								Load(D_FILE::Path const& directory);
+
+		UVRect								GetSlotUV(Slot slot) const;
+
+		INLINE uint32_t						GetPageSize() const { return mPageSize; }
+		INLINE uint32_t						GetSlotSize() const { return mSlotSize; }
+		INLINE uint32_t						GetSlotsPerPage() const { return mSlotsPerRow * mSlotsPerRow; }
+		INLINE uint32_t						GetPageCount() const { std::scoped_lock lock(mMutex); return (uint32_t)mPages.size(); }
+		INLINE uint32_t						GetEntryCount() const { std::scoped_lock lock(mMutex); return (uint32_t)mIndex.size(); }
+
+	private:
+		struct Page
+		{
+			D_CONTAINERS::DVector<uint32_t>	Pixels;
+			bool							GpuDirty = true;
+			bool							DiskDirty = true;
+		};
+
+		// Mutex has to be held
+		void								AddPageLocked();
+
+		uint32_t const						mPageSize;
+		uint32_t const						mSlotSize;
+		uint32_t const						mSlotsPerRow;
+
+		mutable std::mutex					mMutex;
+		D_CONTAINERS::DUnorderedMap<D_CORE::Uuid, Slot, D_CORE::UuidHasher> mIndex;
+		D_CONTAINERS::DVector<Slot>			mFreeSlots;
+		D_CONTAINERS::DVector<Page>			mPages;
+		bool								mIndexDiskDirty = false;
+	};
+}
@@ -0,0 +1,88 @@
+#include "Editor/pch.hpp"
+#include "ThumbnailQueue.hpp"
+
+using namespace D_CORE;
+
+namespace Darius::Editor::Gui::Utils
+{
+	bool ThumbnailQueue::Push(Request const& request, uint64_t priority)
+	{
+		std::scoped_lock lock(mMutex);
+
+		auto search = mEntries.find(request.ResourceUuid);
+		if (search != mEntries.end())
+		{
+			PrioritizeLocked(search->second, priority);
+			return false;
+		}
+
+		OrderKey order = { priority, mSequence++ };
+		mEntries.emplace(request.ResourceUuid, Entry { request, order });
+		mOrder.emplace(order, request.ResourceUuid);
+		return true;
+	}
+
+	bool ThumbnailQueue::Prioritize(Uuid const& uuid, uint64_t priority)
+	{
+		std::scoped_lock lock(mMutex);
+
+		auto search = mEntries.find(uuid);
+		if (search == mEntries.end())
+			return false;
+
+		PrioritizeLocked(search->second, priority);
+		return true;
+	}
+
+	void ThumbnailQueue::PrioritizeLocked(Entry& entry, uint64_t priority)
+	{
+		if (priority <= entry.Order.Priority)
+			return;
+
+		mOrder.erase(entry.Order);
+		entry.Order = { priority, mSequence++ };
+		mOrder.emplace(entry.Order, entry.Req.ResourceUuid);
+	}
+
+	std::optional<ThumbnailQueue::Request> ThumbnailQueue::Pop()
+	{
+		std::scoped_lock lock(mMutex);
+
+		if (mOrder.empty())
+			return std::nullopt;
+
+		auto first = mOrder.begin();
+		auto search = mEntries.find(first->second);
+		mOrder.erase(first);
+
+		auto request = std::move(search->second.Req);
+		mEntries.erase(search);
+		return request;
+	}
+
+	bool ThumbnailQueue::Remove(Uuid const& uuid)
+	{
+		std::scoped_lock lock(mMutex);
+
+		auto search = mEntries.find(uuid);
+		if (search == mEntries.end())
+			return false;
+
+		mOrder.erase(search->second.Order);
+		mEntries.erase(search);
+		return true;
+	}
+
+	void ThumbnailQueue::Clear()
+	{
+		std::scoped_lock lock(mMutex);
+		mEntries.clear();
+		mOrder.clear();
+	}
+
+	bool ThumbnailQueue::Contains(Uuid const& uuid) const
+	{
+		std::scoped_lock lock(mMutex);
+		return mEntries.contains(uuid);
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Core/Containers/Map.hpp>
+#include <Core/Filesystem/Path.hpp>
+#include <Core/Uuid.hpp>
+#include <Utils/Common.hpp>
+
+#include <mutex>
+#include <optional>
+
+#ifndef D_GUI_UTILS
+#define D_GUI_UTILS Darius::Editor::Gui::Utils
+#endif // !D_GUI_UTILS
+
+namespace Darius::Editor::Gui::Utils
+{
+	// Thread safe queue of pending thumbnail generations. Requests with higher priority are
+	// popped first and requests of the same priority are popped in the order they were pushed.
+	// The frame number an item was last visible in is a good priority, so that items which
+	// scroll out of view fall behind the ones currently on screen.
+	class ThumbnailQueue
+	{
+	public:
+		struct Request
+		{
+			D_CORE::Uuid					ResourceUuid;
+			D_FILE::Path					SourcePath;
+		};
+
+	public:
+		// Returns false and raises the priority if already queued
+		bool								Push(Request const& request, uint64_t priority = 0u);
+
+		// Raises the priority of a queued request, returns false if not queued
+		bool								Prioritize(D_CORE::Uuid const& uuid, uint64_t priority);
+
+		std::optional<Request>				Pop();
+		bool								Remove(D_CORE::Uuid const& uuid);
+		void								Clear();
+
+		bool								Contains(D_CORE::Uuid const& uuid) const;
+		INLINE uint32_t						GetSize() const { std::scoped_lock lock(mMutex); return (uint32_t)mEntries.size(); }
+		INLINE bool							IsEmpty() const { return GetSize() == 0u; }
+
+	private:
+		struct OrderKey
+		{
+			uint64_t						Priority;
+			uint64_t						Sequence;
+
+			INLINE bool operator <(OrderKey const& other) const
+			{
+				if (Priority != other.Priority)
+					return Priority > other.Priority;
+				return Sequence < other.Sequence;
+			}
+		};
+
+		struct Entry
+		{
+			Request							Req;
+			OrderKey						Order;
+		};
+
+		// Mutex has to be held
+		void								PrioritizeLocked(Entry& entry, uint64_t priority);
+
+		mutable std::mutex					mMutex;
+		D_CONTAINERS::DUnorderedMap<D_CORE::Uuid, Entry, D_CORE::UuidHasher> mEntries;
+		D_CONTAINERS::DMap<OrderKey, D_CORE::Uuid> mOrder;
+		uint64_t							mSequence = 0u;
+	};
+}
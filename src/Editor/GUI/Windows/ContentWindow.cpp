@@ -22,16 +22,29 @@ using namespace D_FILE;
 
 namespace Darius::Editor::Gui::Windows
 {
+	// Search results are capped to keep the grid responsive
+	constexpr size_t MaxSearchResults = 2000u;
+
 	ContentWindow::ContentWindow(D_SERIALIZATION::Json& config) :
 		Window(config),
+		mSearchBuffer(""),
+		mItemsDirty(true),
 		mTreeViewWidth(-1.f),
 		mRightPanelWidth(-1.f),
 		mFocusScrollDone(false)
 	{
 		auto assetsPath = D_ENGINE_CONTEXT::GetAssetsPath();
-		TrySetCurrentPath(assetsPath);
 
-		mTreeViewFolderMap[assetsPath] = { assetsPath, false, assetsPath.parent_path().filename().string() };
+		// Built once, then kept up to date with the file system changes
+		mIndex.SetIgnoreFunction([](Path const& path)
+			{
+				return path.extension() == ".tos";
+			});
+		mIndex.Build(assetsPath);
+		mSnapshot = mIndex.GetSnapshot();
+		mWatcher.Start(mSnapshot.Get(mSnapshot.GetRoot()).Path);
+
+		TrySetCurrentPath(assetsPath);
 
 		// Setup listeners
 		mComponentChangePathConnection = D_ECS_COMP::ComponentBase::RequestPathChange.connect([&](D_FILE::Path const& path, D_RESOURCE::ResourceHandle const& handle, bool select)
@@ -60,6 +73,51 @@ namespace Darius::Editor::Gui::Windows
 	{
 		mComponentChangePathConnection.disconnect();
 		mResourceChangePathConnection.disconnect();
+		mWatcher.Stop();
+	}
+
+	void ContentWindow::Update(float)
+	{
+		DVector<D_GUI_UTILS::DirectoryWatcher::Change> changes;
+		mWatcher.Poll(changes);
+
+		for (auto const& change : changes)
+		{
+			using ChangeType = D_GUI_UTILS::DirectoryWatcher::ChangeType;
+
+			switch (change.Type)
+			{
+			case ChangeType::Added:
+				mIndex.AddFromDisk(change.Path);
+				break;
+			case ChangeType::Removed:
+				mIndex.Remove(change.Path);
+				ForgetResolvedFile(change.Path);
+				break;
+			case ChangeType::Renamed:
+				// The old name may not have been tracked
+				if (!mIndex.Rename(change.OldPath, change.Path))
+					mIndex.AddFromDisk(change.Path);
+				ForgetResolvedFile(change.OldPath);
+				break;
+			case ChangeType::Overflow:
+				mIndex.Build(D_ENGINE_CONTEXT::GetAssetsPath());
+				break;
+			default:
+				break;
+			}
+		}
+
+		auto snapshot = mIndex.GetSnapshot();
+		if (snapshot.GetVersion() == mSnapshot.GetVersion())
+			return;
+
+		mSnapshot = std::move(snapshot);
+
+		if (mSnapshot.Find(mCurrentDirectory) == D_GUI_UTILS::ContentIndex::InvalidNode)
+			TrySetCurrentPath(D_ENGINE_CONTEXT::GetAssetsPath());
+		else
+			mItemsDirty = true;
 	}
 
 	void ContentWindow::DrawGUI()
@@ -76,7 +134,8 @@ namespace Darius::Editor::Gui::Windows
 
 		ImGui::BeginChild("##FileTreeView", ImVec2(mTreeViewWidth, availableHeigh));
 		{
-			DrawFolderTreeItem(mTreeViewFolderMap[D_ENGINE_CONTEXT::GetAssetsPath()]);
+			if (mSnapshot.IsValid())
+				DrawFolderTreeItem(mSnapshot.GetRoot());
 		}
 		ImGui::EndChild();
 
@@ -84,9 +143,10 @@ namespace Darius::Editor::Gui::Windows
 
 		ImGui::BeginChild("##MainPane", ImVec2(mRightPanelWidth, availableHeigh));
 		{
-			ImGui::BeginChild("##ToolbarPane", ImVec2(mRightPanelWidth, 40));
+			ImGui::BeginChild("##ToolbarPane", ImVec2(mRightPanelWidth, 70));
 			{
 				DrawBreadcrumb();
+				DrawSearchBar();
 			}
 			ImGui::EndChild();
 
@@ -99,50 +159,33 @@ namespace Darius::Editor::Gui::Windows
 		ImGui::EndChild();
 	}
 
-	void ContentWindow::DrawFolderTreeItem(TreeFoldeEntry& entry)
+	void ContentWindow::DrawFolderTreeItem(D_GUI_UTILS::ContentIndex::NodeId id)
 	{
+		auto const& node = mSnapshot.Get(id);
+
 		ImGuiTreeNodeFlags baseFlag = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_FramePadding;
 
-		if (entry.Openned && entry.Children.size() == 0)
+		// Directories come first among the children
+		if (node.Children.empty() || !mSnapshot.Get(node.Children[0]).IsDirectory)
 			baseFlag |= ImGuiTreeNodeFlags_Leaf;
 
-		if (&entry == mSelectedTreeNode)
+		if (node.Path == mCurrentDirectory)
 			baseFlag |= ImGuiTreeNodeFlags_Selected;
 
-		auto nodeOpen = ImGui::TreeNodeEx((void*)(&entry), baseFlag, entry.Name.c_str());
+		auto nodeOpen = ImGui::TreeNodeEx(node.Name.c_str(), baseFlag, "%s", node.Name.c_str());
 
 		if (ImGui::IsItemClicked())
-		{
-			mSelectedTreeNode = &entry;
-			TrySetCurrentPath(entry.Path);
-		}
+			TrySetCurrentPath(node.Path);
 
 		if (nodeOpen)
 		{
-			// Creating records for children
-			if (!entry.Openned)
-			{
-				entry.Openned = true;
-				D_FILE::VisitEntriesInDirectory(entry.Path, false, [&](Path const& _path, bool isDir)
-					{
-						if (!isDir)
-							return;
-
-						mTreeViewFolderMap[_path] = { _path, false, _path.filename().string(), D_CONTAINERS::DVector<TreeFoldeEntry*>() };
-
-						entry.Children.push_back(&mTreeViewFolderMap[_path]);
-					});
-
-				std::sort(entry.Children.begin(), entry.Children.end(), [](auto const& a, auto const& b)
-					{
-						return b->Name > a->Name;
-					});
-			}
-
 			// Drawing children
-			for (auto child : entry.Children)
+			for (auto child : node.Children)
 			{
-				DrawFolderTreeItem(*child);
+				if (!mSnapshot.Get(child).IsDirectory)
+					break;
+
+				DrawFolderTreeItem(child);
 			}
 
 			ImGui::TreePop();
@@ -174,14 +217,48 @@ namespace Darius::Editor::Gui::Windows
 			TrySetCurrentPath(newCurrentDir);
 	}
 
-	void ContentWindow::DrawMainItems()
+	void ContentWindow::DrawSearchBar()
 	{
-		// Are items are being loaded
-		if (mNumberOfItemsToBeLoaded.load() > 0)
+		ImGui::SetNextItemWidth(200.f);
+		if (ImGui::InputTextWithHint("##ContentSearch", ICON_FA_MAGNIFYING_GLASS " Search", mSearchBuffer, sizeof(mSearchBuffer)))
+			mItemsDirty = true;
+
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(120.f);
+		if (ImGui::BeginCombo("##ContentTypeFilter", mTypeFilter.empty() ? "All Types" : mTypeFilter.c_str()))
 		{
-			ImGui::Text("Items are being loaded");
-			return;
+			if (ImGui::Selectable("All Types", mTypeFilter.empty()))
+			{
+				mTypeFilter.clear();
+				mFilter.Extensions.clear();
+				mItemsDirty = true;
+			}
+
+			// Only the extensions which can be loaded as resources
+			for (auto const& [ext, count] : mSnapshot.GetExtensions())
+			{
+				if (!D_RESOURCE::Resource::GetResourceTypeByExtension(ext).has_value())
+					continue;
+
+				if (ImGui::Selectable(ext.c_str(), mTypeFilter == ext))
+				{
+					mTypeFilter = ext;
+					mFilter.Extensions = { ext };
+					mItemsDirty = true;
+				}
+			}
+
+			ImGui::EndCombo();
 		}
+	}
+
+	void ContentWindow::DrawMainItems()
+	{
+		if (mItemsDirty.exchange(false))
+			RebuildItems();
+
+		if (mNumberOfItemsToBeLoaded.load() > 0)
+			ImGui::Text("Loading %u items", mNumberOfItemsToBeLoaded.load());
 
 		ImGuiStyle& style = ImGui::GetStyle();
 		float window_visible_x2 = ImGui::GetWindowPos().x + ImGui::GetWindowContentRegionMax().x;
@@ -234,84 +311,118 @@ namespace Darius::Editor::Gui::Windows
 
 		// Switching to new director
 		if (!newContext.empty())
+		{
+			mSearchBuffer[0] = '\0';
 			TrySetCurrentPath(newContext);
+		}
 
 	}
 
 	void ContentWindow::UpdateDirectoryItems()
 	{
+		mItemsDirty = true;
+	}
 
+	void ContentWindow::RebuildItems()
+	{
 		mCurrentDirectoryItems.clear();
+		mSelectedItem = nullptr;
+
+		auto directory = mSnapshot.Find(mCurrentDirectory);
+		if (directory == D_GUI_UTILS::ContentIndex::InvalidNode)
+			return;
+
+		// Searching under the current directory instead of listing it
+		DVector<D_GUI_UTILS::ContentIndex::NodeId> nodes;
+		if (mSearchBuffer[0] != '\0')
+			mSnapshot.Search(mSearchBuffer, directory, mFilter, nodes, MaxSearchResults);
+		else
+			mSnapshot.GetChildren(directory, mFilter, nodes);
+
+		auto folderIcon = D_THUMBNAIL::GetIconTextureId(D_THUMBNAIL::CommonIcon::Folder);
+		auto fileIcon = D_THUMBNAIL::GetIconTextureId(D_THUMBNAIL::CommonIcon::File);
+
+		DVector<Path> toResolve;
+		{
+			std::scoped_lock lock(mItemsLoadMutex);
 
-		D_FILE::VisitEntriesInDirectory(mCurrentDirectory, false, [&](auto const& _path, bool isDir)
+			mCurrentDirectoryItems.reserve(nodes.size());
+			for (auto id : nodes)
 			{
-				if (isDir)
+				auto const& node = mSnapshot.Get(id);
+
+				if (node.IsDirectory)
 				{
-					mCurrentDirectoryItems.push_back({ _path.filename().string(), _path, true, D_THUMBNAIL::GetIconTextureId(D_THUMBNAIL::CommonIcon::Folder) });
+					mCurrentDirectoryItems.push_back({ node.Name, node.Path, true, folderIcon });
+					continue;
 				}
-			});
 
-		DVector<Path> resVec;
-		D_RESOURCE::GetAllResourcePathsInDirectory(mCurrentDirectory, resVec);
+				if (!D_RESOURCE::Resource::GetResourceTypeByExtension(node.Extension).has_value())
+					continue;
 
-		mNumberOfItemsToBeLoaded.store(0);
+				// Resolving the contained resources of each file only once
+				auto search = mResolvedFiles.find(node.Path);
+				if (search == mResolvedFiles.end())
+				{
+					mResolvedFiles.emplace(node.Path, ResolvedFile());
+					toResolve.push_back(node.Path);
+					continue;
+				}
 
-		D_THUMBNAIL::RegisterExistingResources(mCurrentDirectory);
+				if (!search->second.Loaded)
+					continue;
 
-		for (auto const& path : resVec)
-		{
+				// Resource thumbnails are fetched when drawn
+				auto name = WSTR2STR(D_FILE::GetFileName(node.Path.filename()));
+				auto& item = mCurrentDirectoryItems.emplace_back(D_GUI_COMPONENT::EditorContentWindowItem { name, node.Path, false, fileIcon, search->second.MainHandle });
+				item.ChildResources = search->second.ChildResources;
+			}
+		}
+
+		for (auto const& item : mCurrentDirectoryItems)
+			if (item.Path == mSelectedItemPath)
+				mSelectedItem = &item;
+
+		if (!toResolve.empty())
+			D_THUMBNAIL::RegisterExistingResources(mCurrentDirectory);
 
+		// Out of the lock as the callback may be called right away
+		for (auto const& path : toResolve)
+		{
 			mNumberOfItemsToBeLoaded++;
-			D_RESOURCE::ResourceLoader::LoadResourceAsync(path, [mutex = &mItemsLoadMutex, _currentDirectoryItems = &mCurrentDirectoryItems, path = path, itemsLoading = &mNumberOfItemsToBeLoaded](auto containedResources)
+			D_RESOURCE::ResourceLoader::LoadResourceAsync(path, [this, path](auto containedResources)
 				{
-					std::lock_guard lock(*mutex);
-					auto& currentDirectoryItems = *_currentDirectoryItems;
-					auto name = D_FILE::GetFileName(path.filename());
-					auto nameStr = WSTR2STR(name);
-					(*itemsLoading)--;
-
-					uint64_t icon = D_THUMBNAIL::GetIconTextureId(D_THUMBNAIL::CommonIcon::File);
+					ResolvedFile resolved;
+					resolved.Loaded = true;
 
-					D_RESOURCE::ResourceHandle resourceHandle = D_RESOURCE::EmptyResourceHandle;
 					if (containedResources.size() == 1)
-					{
-						icon = D_THUMBNAIL::GetResourceTextureId(containedResources[0]);
-						resourceHandle = containedResources[0];
-					}
-
-					currentDirectoryItems.push_back({ nameStr, path, false, icon, resourceHandle });
-					auto& lastItem = currentDirectoryItems[currentDirectoryItems.size() - 1];
+						resolved.MainHandle = containedResources[0];
 
 					for (auto const& handle : containedResources)
 					{
 						if (handle.Type == D_FBX::FBXPrefabResource::GetResourceType())
-						{
-							lastItem.MainHandle = handle;
-							lastItem.IconId = D_THUMBNAIL::GetResourceTextureId(handle);
-						}
+							resolved.MainHandle = handle;
 						else
-						{
-							lastItem.ChildResources.push_back(handle);
-						}
+							resolved.ChildResources.push_back(handle);
 					}
 
-					if (itemsLoading->load() != 0)
-						return;
-
-					std::sort(currentDirectoryItems.begin(), currentDirectoryItems.end(), [](auto first, auto second)
-						{
-							if (first.IsDirectory && !second.IsDirectory)
-								return true;
-							else if (second.IsDirectory && !first.IsDirectory)
-								return false;
-							else
-								return first.Name.compare(second.Name.c_str()) < 0;
-						});
-				}, true);
+					{
+						std::scoped_lock lock(mItemsLoadMutex);
+						mResolvedFiles[path] = std::move(resolved);
+					}
 
+					mNumberOfItemsToBeLoaded--;
+					mItemsDirty = true;
+				}, true);
 		}
 	}
 
+	void ContentWindow::ForgetResolvedFile(D_FILE::Path const& path)
+	{
+		std::scoped_lock lock(mItemsLoadMutex);
+		mResolvedFiles.erase(D_GUI_UTILS::ContentIndex::NormalizePath(path));
+	}
+
 	bool ContentWindow::TrySetCurrentPath(D_FILE::Path const& path)
 	{
 
@@ -347,7 +458,7 @@ namespace Darius::Editor::Gui::Windows
 		}
 		mBreadcrumbItems.push_back(assetsPath.parent_path());
 
-		mCurrentDirectory = newPath.lexically_normal();
+		mCurrentDirectory = D_GUI_UTILS::ContentIndex::NormalizePath(newPath);
 		UpdateDirectoryItems();
 		return true;
 	}
@@ -355,6 +466,7 @@ namespace Darius::Editor::Gui::Windows
 	void ContentWindow::SelectEditorContentItem(D_GUI_COMPONENT::EditorContentWindowItem const* item, D_RESOURCE::ResourceHandle const& selectedHandle)
 	{
 		mSelectedItem = item;
+		mSelectedItemPath = item->Path;
 
 		if (item->IsDirectory)
 			return;
@@ -2,6 +2,8 @@
 
 #include "Window.hpp"
 #include "Editor/GUI/Components/ContentWindowComponents.hpp"
+#include "Editor/GUI/Utils/ContentIndex.hpp"
+#include "Editor/GUI/Utils/DirectoryWatcher.hpp"
 
 #include <Core/Containers/Vector.hpp>
 #include <Core/Filesystem/Path.hpp>
@@ -27,7 +29,8 @@ namespace Darius::Editor::Gui::Windows
 	public:
 		// Inherited via Window
 
-		INLINE virtual void			Update(float) override {}
+		// Applies the file system changes to the content index
+		virtual void				Update(float) override;
 
 		virtual void				DrawGUI() override;
 
@@ -36,24 +39,36 @@ namespace Darius::Editor::Gui::Windows
 
 	private:
 
-		struct TreeFoldeEntry
+		// Resources contained in a file, resolved once per file
+		struct ResolvedFile
 		{
-			D_FILE::Path	Path;
-			bool			Openned = false;
-			std::string		Name;
-			D_CONTAINERS::DVector<TreeFoldeEntry*> Children;
+			bool						Loaded = false;
+			D_RESOURCE::ResourceHandle	MainHandle = D_RESOURCE::EmptyResourceHandle;
+			D_CONTAINERS::DVector<D_RESOURCE::ResourceHandle> ChildResources;
 		};
 
 		void						DrawMainItems();
 		void						DrawBreadcrumb();
-		void						DrawFolderTreeItem(TreeFoldeEntry& entry);
+		void						DrawSearchBar();
+		void						DrawFolderTreeItem(D_GUI_UTILS::ContentIndex::NodeId id);
 		void						SelectEditorContentItem(D_GUI_COMPONENT::EditorContentWindowItem const* item, D_RESOURCE::ResourceHandle const& selectedHandle);
+		void						RebuildItems();
+		void						ForgetResolvedFile(D_FILE::Path const& path);
 
 		D_CONTAINERS::DVector<D_GUI_COMPONENT::EditorContentWindowItem>	mCurrentDirectoryItems;
 		D_CONTAINERS::DVector<D_FILE::Path> mBreadcrumbItems; // it's from child to parent
-		D_CONTAINERS::DUnorderedMap<D_FILE::Path, TreeFoldeEntry> mTreeViewFolderMap;
-		TreeFoldeEntry*				mSelectedTreeNode = nullptr;
 		D_GUI_COMPONENT::EditorContentWindowItem const* mSelectedItem = nullptr;
+		D_FILE::Path				mSelectedItemPath;
+
+		D_GUI_UTILS::ContentIndex	mIndex;
+		D_GUI_UTILS::DirectoryWatcher mWatcher;
+
+		// The index as seen by the UI, only replaced in Update
+		D_GUI_UTILS::ContentIndex::Snapshot mSnapshot;
+		D_GUI_UTILS::ContentIndex::Filter mFilter;
+		std::string					mTypeFilter;
+		char						mSearchBuffer[128];
+		std::atomic_bool			mItemsDirty;
 
 		DField(Get[const, &, inline])
 		D_FILE::Path				mCurrentDirectory;
@@ -62,6 +77,7 @@ namespace Darius::Editor::Gui::Windows
 
 		std::atomic_uint			mNumberOfItemsToBeLoaded;
 		std::mutex					mItemsLoadMutex;
+		D_CONTAINERS::DUnorderedMap<D_FILE::Path, ResolvedFile> mResolvedFiles;
 
 		D_CORE::SignalConnection	mComponentChangePathConnection;
 		D_CORE::SignalConnection	mResourceChangePathConnection;
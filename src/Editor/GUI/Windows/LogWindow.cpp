@@ -0,0 +1,105 @@
+#include "Editor/pch.hpp"
+#include "LogWindow.hpp"
+
+#include <imgui.h>
+
+#include <Libs/FontIcon/IconsFontAwesome6.h>
+
+using namespace D_LOGGER;
+
+namespace Darius::Editor::Gui::Windows
+{
+	LogWindow::LogWindow(D_SERIALIZATION::Json& config) :
+		Window(config),
+		mSink(std::make_shared<MemoryLogSink>(4096u))
+	{
+		D_LOGGER::AddSink(mSink);
+	}
+
+	LogWindow::~LogWindow()
+	{
+		D_LOGGER::RemoveSink(mSink);
+	}
+
+	void LogWindow::Update(float)
+	{
+		auto version = mSink->GetVersion();
+		if (version == mEntriesVersion)
+			return;
+
+		mSink->GetEntries(mEntries);
+		mEntriesVersion = version;
+	}
+
+	void LogWindow::DrawGUI()
+	{
+		D_PROFILING::ScopedTimer profiling(L"Log Window Draw GUI");
+
+		if (ImGui::Button(ICON_FA_TRASH_CAN))
+			mSink->Clear();
+
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(100.f);
+		if (ImGui::BeginCombo("##MinLevel", GetLevelName(mMinLevel)))
+		{
+			for (auto level = (int)LogLevel::Trace; level <= (int)LogLevel::Fatal; level++)
+				if (ImGui::Selectable(GetLevelName((LogLevel)level), mMinLevel == (LogLevel)level))
+					mMinLevel = (LogLevel)level;
+			ImGui::EndCombo();
+		}
+
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(200.f);
+		ImGui::InputTextWithHint("##Filter", "Filter", mFilter, sizeof(mFilter));
+
+		ImGui::SameLine();
+		ImGui::Checkbox("Auto Scroll", &mAutoScroll);
+
+		ImGui::Separator();
+
+		if (ImGui::BeginChild("Log Entries", ImVec2(0.f, 0.f), false, ImGuiWindowFlags_HorizontalScrollbar))
+		{
+			std::string_view filter = mFilter;
+
+			// Only the visible lines are formatted
+			std::vector<uint32_t> visible;
+			visible.reserve(mEntries.size());
+			for (uint32_t i = 0u; i < (uint32_t)mEntries.size(); i++)
+			{
+				auto const& entry = mEntries[i];
+				if (entry.Level < mMinLevel)
+					continue;
+				if (!filter.empty() && entry.Message.find(filter) == std::string::npos && entry.Category.find(filter) == std::string::npos)
+					continue;
+				visible.push_back(i);
+			}
+
+			ImGuiListClipper clipper;
+			clipper.Begin((int)visible.size());
+			std::string line;
+			while (clipper.Step())
+			{
+				for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+				{
+					auto const& entry = mEntries[visible[row]];
+
+					line.clear();
+					FormatEntry({ entry.Time, entry.Level, entry.Thread, entry.Category.empty() ? nullptr : entry.Category.c_str(), entry.Message }, line);
+
+					bool colored = entry.Level >= LogLevel::Warn;
+					if (colored)
+						ImGui::PushStyleColor(ImGuiCol_Text, entry.Level == LogLevel::Warn ? ImVec4(1.f, 0.8f, 0.3f, 1.f) : ImVec4(1.f, 0.35f, 0.35f, 1.f));
+
+					ImGui::TextUnformatted(line.data(), line.data() + line.size());
+
+					if (colored)
+						ImGui::PopStyleColor();
+				}
+			}
+
+			if (mAutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY())
+				ImGui::SetScrollHereY(1.f);
+		}
+		ImGui::EndChild();
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Window.hpp"
+
+#include <Utils/Logger.hpp>
+
+namespace Darius::Editor::Gui::Windows
+{
+	class LogWindow : public Window
+	{
+		D_CH_EDITOR_WINDOW_BODY(LogWindow, "Log");
+	public:
+
+		// Inherited via Window
+
+		virtual void Update(float) override;
+
+		virtual void DrawGUI() override;
+
+	private:
+
+		std::shared_ptr<D_LOGGER::MemoryLogSink> mSink;
+
+		// Copy of the sink's entries, refreshed when the sink changes
+		std::vector<D_LOGGER::MemoryLogSink::Entry> mEntries;
+		uint64_t						mEntriesVersion = UINT64_MAX;
+
+		D_LOGGER::LogLevel				mMinLevel = D_LOGGER::LogLevel::Trace;
+		char							mFilter[128] = "";
+		bool							mAutoScroll = true;
+	};
+}
@@ -1,8 +1,10 @@
 #include "Editor/pch.hpp"
 #include "ProfilerWindow.hpp"
 
+#include "Editor/EditorContext.hpp"
 #include "Editor/Simulation.hpp"
 
+#include <Core/Memory/MemoryTracking.hpp>
 #include <Core/TimeManager/TimeManager.hpp>
 #include <Graphics/GraphicsUtils/Profiling/Profiling.hpp>
 
@@ -63,7 +65,17 @@ namespace Darius::Editor::Gui::Windows
 
 		auto windowWidth = ImGui::GetWindowWidth();
 
-		ImGui::SetCursorPos({ windowWidth - 50, 25 });
+		ImGui::SetCursorPos({ windowWidth - 85, 25 });
+		if (D_PROFILING::IsCapturing())
+		{
+			// Trace of all threads to be opened in chrome://tracing or Perfetto
+			if (ImGui::Button(ICON_FA_STOP))
+				D_PROFILING::EndCapture((D_EDITOR_CONTEXT::GetEditorConfigPath() / L"ProfilerCapture.json").wstring());
+		}
+		else if (ImGui::Button(ICON_FA_CIRCLE))
+			D_PROFILING::BeginCapture();
+
+		ImGui::SameLine();
 		if (ImGui::Button(ICON_FA_CAMERA))
 		{
 			mSnapshot.clear();
@@ -208,6 +220,59 @@ namespace Darius::Editor::Gui::Windows
 			ImGui::EndTabItem();
 		}
 
+		// Memory usage per tag
+		if (ImGui::BeginTabItem("Memory"))
+		{
+			static bool sampling = false;
+			if (ImGui::Checkbox("Sample Allocation Call Stacks", &sampling))
+				D_MEMORY::SetAllocationSampling(sampling ? 1024u : 0u);
+
+			if (sampling)
+			{
+				D_CONTAINERS::DVector<D_MEMORY::MemorySample> samples;
+				D_MEMORY::GetAllocationSamples(samples);
+				ImGui::SameLine();
+				ImGui::Text("%zu sampled allocations alive", samples.size());
+			}
+
+			auto toMB = [](int64_t bytes) { return (double)bytes / (1024.0 * 1024.0); };
+
+			if (ImGui::BeginTable("MemoryTagTable", 6, ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg))
+			{
+				ImGui::TableSetupColumn("Tag");
+				ImGui::TableSetupColumn("Usage (MB)");
+				ImGui::TableSetupColumn("Peak (MB)");
+				ImGui::TableSetupColumn("High Water (MB)");
+				ImGui::TableSetupColumn("Allocations");
+				ImGui::TableSetupColumn("Total Allocations");
+				ImGui::TableHeadersRow();
+
+				auto stats = D_MEMORY::GetAllMemoryTagStats();
+				for (size_t i = 0u; i < stats.size(); i++)
+				{
+					auto const& tagStats = stats[i];
+
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(D_MEMORY::GetMemoryTagName((D_MEMORY::MemoryTag)i));
+					ImGui::TableNextColumn();
+					ImGui::Text("%.2f", toMB(tagStats.Bytes));
+					ImGui::TableNextColumn();
+					ImGui::Text("%.2f", toMB(tagStats.PeakBytes));
+					ImGui::TableNextColumn();
+					ImGui::Text("%.2f", toMB(tagStats.HighWaterBytes));
+					ImGui::TableNextColumn();
+					ImGui::Text("%lld", (long long)tagStats.Allocations);
+					ImGui::TableNextColumn();
+					ImGui::Text("%llu", (unsigned long long)tagStats.TotalAllocations);
+				}
+
+				ImGui::EndTable();
+			}
+
+			ImGui::EndTabItem();
+		}
+
 		ImGui::EndTabBar();
 	}
 
@@ -81,6 +81,8 @@ namespace Darius::Editor::Simulate
 						externalContextUpdate();
 				}
 
+				D_WORLD::FlushTransformChanges();
+
 				// Physics
 				{
 					D_PROFILING::ScopedTimer simPhysProf(L"Update Physics");
@@ -104,6 +106,8 @@ namespace Darius::Editor::Simulate
 								externalContextUpdate();
 						}
 
+						D_WORLD::FlushTransformChanges();
+
 						// Physics
 						{
 							D_PROFILING::ScopedTimer simPhysProf(L"Update Physics");
@@ -136,6 +140,12 @@ namespace Darius::Editor::Simulate
 
 		}
 
+		// Transform changes of this frame reach their subscribers before audio and rendering
+		{
+			D_PROFILING::ScopedTimer _prof(L"Flush Transform Changes");
+			D_WORLD::FlushTransformChanges();
+		}
+
 		{
 			D_PROFILING::ScopedTimer _prof(L"Update Audio");
 			D_AUDIO::Update(Timer->IsPaused() ? 0.f : (float)Timer->GetElapsedSeconds());
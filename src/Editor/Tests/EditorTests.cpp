@@ -0,0 +1,259 @@
+#define BOOST_TEST_MODULE EditorTests
+#define BOOST_TEST_DYN_LINK
+
+#include <GUI/Utils/ContentIndex.hpp>
+#include <GUI/Utils/ThumbnailAtlas.hpp>
+#include <GUI/Utils/ThumbnailQueue.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <fstream>
+
+using namespace D_CORE;
+using namespace D_GUI_UTILS;
+
+BOOST_AUTO_TEST_SUITE(ThumbnailQueueTests)
+
+BOOST_AUTO_TEST_CASE(PriorityOrder)
+{
+	ThumbnailQueue queue;
+	auto a = GenerateUuid();
+	auto b = GenerateUuid();
+	auto c = GenerateUuid();
+
+	BOOST_TEST(queue.Push({ a, "a.png" }));
+	BOOST_TEST(queue.Push({ b, "b.png" }));
+	BOOST_TEST(queue.Push({ c, "c.png" }));
+	BOOST_TEST(!queue.Push({ a, "a.png" }));
+	BOOST_TEST(queue.GetSize() == 3u);
+
+	// Visible items jump ahead, most recently visible first
+	BOOST_TEST(queue.Prioritize(c, 10u));
+	BOOST_TEST(queue.Prioritize(b, 11u));
+	BOOST_TEST(!queue.Prioritize(GenerateUuid(), 12u));
+
+	BOOST_TEST((queue.Pop()->ResourceUuid == b));
+	BOOST_TEST((queue.Pop()->ResourceUuid == c));
+	BOOST_TEST((queue.Pop()->ResourceUuid == a));
+	BOOST_TEST(!queue.Pop().has_value());
+}
+
+BOOST_AUTO_TEST_CASE(Remove)
+{
+	ThumbnailQueue queue;
+	auto a = GenerateUuid();
+	auto b = GenerateUuid();
+	queue.Push({ a, "a.png" });
+	queue.Push({ b, "b.png" }, 5u);
+
+	BOOST_TEST(queue.Remove(b));
+	BOOST_TEST(!queue.Contains(b));
+	BOOST_TEST((queue.Pop()->ResourceUuid == a));
+	BOOST_TEST(queue.IsEmpty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(ThumbnailAtlasTests)
+
+BOOST_AUTO_TEST_CASE(SlotPacking)
+{
+	// Four slots per page
+	ThumbnailAtlas atlas(8u, 4u);
+	BOOST_TEST(atlas.GetSlotsPerPage() == 4u);
+
+	D_CONTAINERS::DVector<Uuid> uuids;
+	for (int i = 0; i < 5; i++)
+	{
+		uuids.push_back(GenerateUuid());
+		auto slot = atlas.Allocate(uuids.back());
+		BOOST_TEST(slot.Page == i / 4);
+		BOOST_TEST(slot.Index == i % 4);
+	}
+	BOOST_TEST(atlas.GetPageCount() == 2u);
+
+	// Existing slot is returned again
+	auto slot = atlas.Allocate(uuids[1]);
+	BOOST_TEST(slot.Page == 0u);
+	BOOST_TEST(slot.Index == 1u);
+
+	// Freed slots are reused before growing
+	BOOST_TEST(atlas.Free(uuids[2]));
+	auto reused = atlas.Allocate(GenerateUuid());
+	BOOST_TEST(reused.Page == 0u);
+	BOOST_TEST(reused.Index == 2u);
+	BOOST_TEST(atlas.GetPageCount() == 2u);
+
+	auto uv = atlas.GetSlotUV({ 0u, 3u });
+	BOOST_TEST(uv.U0 == 0.5f);
+	BOOST_TEST(uv.V0 == 0.5f);
+	BOOST_TEST(uv.U1 == 1.f);
+	BOOST_TEST(uv.V1 == 1.f);
+}
+
+BOOST_AUTO_TEST_CASE(WriteAndPersist)
+{
+	auto directory = std::filesystem::temp_directory_path() / "DariusThumbnailAtlasTests";
+	std::filesystem::remove_all(directory);
+
+	auto uuid = GenerateUuid();
+	uint32_t pixels[4] = { 1u, 2u, 3u, 4u };
+
+	{
+		ThumbnailAtlas atlas(4u, 2u);
+		auto slot = atlas.Allocate(uuid);
+		atlas.Allocate(GenerateUuid());
+		slot = atlas.Allocate(GenerateUuid());
+		atlas.Free(uuid);
+		uuid = GenerateUuid();
+		slot = atlas.Allocate(uuid);
+		BOOST_TEST(slot.Index == 0u);
+
+		// Slot 0 is the top left 2x2 block of the 4x4 page
+		atlas.WriteSlot(slot, pixels, 2 * sizeof(uint32_t));
+		BOOST_TEST(atlas.ConsumeGpuDirty(0u));
+		BOOST_TEST(!atlas.ConsumeGpuDirty(0u));
+
+		BOOST_TEST(atlas.IsDiskDirty());
+		BOOST_TEST(atlas.Save(directory));
+		BOOST_TEST(!atlas.IsDiskDirty());
+	}
+
+	ThumbnailAtlas atlas(4u, 2u);
+	BOOST_TEST(atlas.Load(directory));
+	BOOST_TEST(atlas.GetEntryCount() == 3u);
+
+	ThumbnailAtlas::Slot slot;
+	BOOST_TEST(atlas.Find(uuid, slot));
+	BOOST_TEST(slot.Index == 0u);
+
+	atlas.ReadPage(0u, [&](uint32_t const* page)
+		{
+			BOOST_TEST(page[0] == 1u);
+			BOOST_TEST(page[1] == 2u);
+			BOOST_TEST(page[4] == 3u);
+			BOOST_TEST(page[5] == 4u);
+		});
+
+	// Only the remaining slot is free
+	auto next = atlas.Allocate(GenerateUuid());
+	BOOST_TEST(next.Index == 3u);
+
+	// Incompatible layout is ignored
+	ThumbnailAtlas other(8u, 2u);
+	BOOST_TEST(!other.Load(directory));
+
+	std::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(ContentIndexTests)
+
+BOOST_AUTO_TEST_CASE(IncrementalTree)
+{
+	auto root = std::filesystem::temp_directory_path() / "DariusContentIndexTests";
+
+	ContentIndex index;
+	index.Reset(root);
+	BOOST_TEST(index.Add(root / "b.png", false));
+	BOOST_TEST(index.Add(root / "A.fbx", false));
+	BOOST_TEST(index.Add(root / "Textures" / "Wall.png", false));
+	BOOST_TEST(!index.Add(root / "b.png", false));
+	BOOST_TEST(!index.Add(root.parent_path() / "Outside.png", false));
+
+	auto before = index.GetSnapshot();
+	BOOST_TEST(before.GetNodeCount() == 5u);
+	BOOST_TEST(before.GetFileCount() == 3u);
+	BOOST_TEST(before.GetExtensions().at(".png") == 2u);
+
+	// Directories first, then case insensitive by name
+	D_CONTAINERS::DVector<ContentIndex::NodeId> children;
+	before.GetChildren(before.GetRoot(), {}, children);
+	BOOST_TEST(children.size() == 3u);
+	BOOST_TEST(before.Get(children[0]).Name == "Textures");
+	BOOST_TEST(before.Get(children[1]).Name == "A.fbx");
+	BOOST_TEST(before.Get(children[2]).Name == "b.png");
+
+	ContentIndex::Filter filter;
+	filter.Directories = false;
+	filter.Extensions = { ".png" };
+	before.GetChildren(before.GetRoot(), filter, children);
+	BOOST_TEST(children.size() == 1u);
+
+	// Moving a directory carries its contents
+	BOOST_TEST(index.Rename(root / "Textures", root / "Art" / "Tex"));
+	BOOST_TEST(index.Remove(root / "b.png"));
+
+	auto after = index.GetSnapshot();
+	BOOST_TEST(after.GetVersion() > before.GetVersion());
+	BOOST_TEST(after.Find(root / "Art" / "Tex" / "Wall.png") != ContentIndex::InvalidNode);
+	BOOST_TEST(after.Find(root / "Textures" / "Wall.png") == ContentIndex::InvalidNode);
+	BOOST_TEST(after.Find(root / "b.png") == ContentIndex::InvalidNode);
+	BOOST_TEST(after.GetFileCount() == 2u);
+
+	// Taken snapshot is not affected
+	BOOST_TEST(before.Find(root / "Textures" / "Wall.png") != ContentIndex::InvalidNode);
+	BOOST_TEST(before.Find(root / "b.png") != ContentIndex::InvalidNode);
+}
+
+BOOST_AUTO_TEST_CASE(SubstringSearch)
+{
+	auto root = std::filesystem::temp_directory_path() / "DariusContentIndexTests";
+
+	ContentIndex index;
+	index.Reset(root);
+	for (int i = 0; i < 1000; i++)
+		index.Add(root / ("Dir" + std::to_string(i % 10)) / ("Mesh" + std::to_string(i) + ".fbx"), false);
+	index.Add(root / "Dir3" / "BrickWall.png", false);
+	index.Add(root / "Dir7" / "wallpaper.png", false);
+
+	auto snapshot = index.GetSnapshot();
+	D_CONTAINERS::DVector<ContentIndex::NodeId> result;
+
+	snapshot.Search("WALL", snapshot.GetRoot(), {}, result);
+	BOOST_TEST(result.size() == 2u);
+	BOOST_TEST(snapshot.Get(result[0]).Name == "BrickWall.png");
+
+	// Scoped to a directory
+	snapshot.Search("wall", snapshot.Find(root / "Dir7"), {}, result);
+	BOOST_TEST(result.size() == 1u);
+	BOOST_TEST(snapshot.Get(result[0]).Name == "wallpaper.png");
+
+	// Longer queries are verified against the names
+	snapshot.Search("mesh99.fbx", snapshot.GetRoot(), {}, result);
+	BOOST_TEST(result.size() == 1u);
+
+	// Short queries fall back to scanning
+	snapshot.Search("r3", snapshot.GetRoot(), {}, result);
+	BOOST_TEST(result.size() == 1u);
+	BOOST_TEST(snapshot.Get(result[0]).IsDirectory);
+
+	snapshot.Search("mesh", snapshot.GetRoot(), {}, result, 10u);
+	BOOST_TEST(result.size() == 10u);
+}
+
+BOOST_AUTO_TEST_CASE(BuildFromDisk)
+{
+	auto root = std::filesystem::temp_directory_path() / "DariusContentIndexBuildTests";
+	std::filesystem::remove_all(root);
+	std::filesystem::create_directories(root / "Sub");
+	std::ofstream(root / "Sub" / "a.png") << "a";
+	std::ofstream(root / "Sub" / "a.png.tos") << "a";
+
+	ContentIndex index;
+	index.SetIgnoreFunction([](D_FILE::Path const& path) { return path.extension() == ".tos"; });
+	index.Build(root);
+	BOOST_TEST(index.GetSnapshot().GetFileCount() == 1u);
+
+	std::filesystem::create_directories(root / "New" / "Deep");
+	std::ofstream(root / "New" / "Deep" / "b.png") << "b";
+	BOOST_TEST(index.AddFromDisk(root / "New"));
+
+	auto snapshot = index.GetSnapshot();
+	BOOST_TEST(snapshot.Find(root / "New" / "Deep" / "b.png") != ContentIndex::InvalidNode);
+	BOOST_TEST(snapshot.GetFileCount() == 2u);
+
+	std::filesystem::remove_all(root);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 #include "SubsystemRegistry.hpp"
 
 #include <Utils/Assert.hpp>
+#include <Utils/Logger.hpp>
 
 namespace Darius::Engine::Context
 {
@@ -17,6 +18,10 @@ namespace Darius::Engine::Context
 
 		ProjectPath = projectPath;
 
+		// Logging to a file from here on, in release builds too
+		D_LOGGER::Initialize();
+		D_LOGGER::AddSink(std::make_shared<D_LOGGER::RotatingFileLogSink>(GetLogsPath().append("Darius.log"), 8u * 1024u * 1024u, 3u));
+
 		D_ASSERT_M(D_H_ENSURE_DIR(projectPath), "Project directory is not a valid directory");
 
 		if (!D_H_ENSURE_PATH(GetAssetsPath()))
@@ -43,6 +48,8 @@ namespace Darius::Engine::Context
 
 		// Shuting down engine subsystems
 		D_SUBSYSTEMS::ShutdownSubsystems();
+
+		D_LOGGER::Shutdown();
 	}
 
 	D_FILE::Path GetProjectPath()
@@ -60,6 +67,11 @@ namespace Darius::Engine::Context
 		return D_FILE::Path(ProjectPath).append("Config/Engine/");
 	}
 
+	D_FILE::Path GetLogsPath()
+	{
+		return D_FILE::Path(ProjectPath).append("Logs/");
+	}
+
 	D_FILE::Path GetEngineSettingsPath()
 	{
 		return GetEngineConfigPath().append("Settings.json");
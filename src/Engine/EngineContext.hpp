@@ -17,4 +17,5 @@ namespace Darius::Engine::Context
 	D_FILE::Path GetAssetsPath();
 	D_FILE::Path GetEngineConfigPath();
 	D_FILE::Path GetEngineSettingsPath();
+	D_FILE::Path GetLogsPath();
 }
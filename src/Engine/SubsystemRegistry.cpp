@@ -7,10 +7,12 @@
 #include <Core/Containers/List.hpp>
 #include <Core/Containers/Map.hpp>
 #include <Core/Input.hpp>
+#include <Core/Memory/Allocators/FrameAllocator.hpp>
 #include <Core/Serialization/TypeSerializer.hpp>
 #include <Core/TimeManager/TimeManager.hpp>
 #include <Debug/DebugDraw.hpp>
 #include <Graphics/GraphicsCore.hpp>
+#include <Graphics/GraphicsDeviceManager.hpp>
 #include <FBX/FBXSystem.hpp>
 #include <Scene/Scene.hpp>
 #include <Job/Job.hpp>
@@ -86,6 +88,12 @@ namespace Darius::Subsystems
 
 		D_SERIALIZATION::Initialize();
 
+		// Transient frame memory is buffered as many times as the frames in flight
+		D_FRAME_ALLOCATOR::Initialize(D_GRAPHICS_DEVICE::gNumFrameResources);
+
+		// Job system is up first so that graphics can compile shaders in parallel
+		D_JOB::Initialize(settings["Job"]);
+
 		// Initializing the resource manager
 		D_RESOURCE::Initialize(settings["Resource Manager"]);
 
@@ -99,8 +107,6 @@ namespace Darius::Subsystems
 
 		D_WORLD::Initialize();
 
-		D_JOB::Initialize(settings["Job"]);
-
 		// Initialing the tiem manager
 		D_TIME::Initialize(settings["Time"]);
 
@@ -142,11 +148,12 @@ namespace Darius::Subsystems
 #endif // _D_EDITOR
 		D_INPUT::Shutdown();
 		D_TIME::Shutdown();
-		D_JOB::Shutdown();
 		D_WORLD::Shutdown();
 		D_RENDERER::Shutdown();
 		D_GRAPHICS::Shutdown();
 		D_RESOURCE::Shutdown();
+		D_JOB::Shutdown();
+		D_FRAME_ALLOCATOR::Shutdown();
 		D_SERIALIZATION::Shutdown();
 	}
 
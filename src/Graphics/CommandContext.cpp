@@ -503,6 +503,22 @@ namespace Darius::Graphics
         InitContext.Finish(true);
     }
 
+    void CommandContext::UpdateTexture(GpuResource& Dest, UINT NumSubresources, D3D12_SUBRESOURCE_DATA SubData[])
+    {
+        UINT64 uploadBufferSize = GetRequiredIntermediateSize(Dest.GetResource(), 0, NumSubresources);
+
+        CommandContext& UpdateContext = CommandContext::Begin();
+
+        UpdateContext.TransitionResource(Dest, D3D12_RESOURCE_STATE_COPY_DEST, true);
+
+        // Upload memory is retired with the fence of this context, no need to wait
+        DynAlloc mem = UpdateContext.m_CpuLinearAllocator.Allocate(uploadBufferSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+        UpdateSubresources(UpdateContext.m_CommandList, Dest.GetResource(), mem.Buffer.GetResource(), mem.Offset, 0, NumSubresources, SubData);
+        UpdateContext.TransitionResource(Dest, D3D12_RESOURCE_STATE_GENERIC_READ);
+
+        UpdateContext.Finish(false);
+    }
+
     void CommandContext::CopySubresource(GpuResource& Dest, UINT DestSubIndex, GpuResource& Src, UINT SrcSubIndex)
     {
         FlushResourceBarriers();
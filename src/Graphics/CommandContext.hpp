@@ -138,6 +138,8 @@ namespace Darius::Graphics
 		}
 
 		static void InitializeTexture(D_GRAPHICS_UTILS::GpuResource& Dest, UINT NumSubresources, D3D12_SUBRESOURCE_DATA SubData[]);
+		// Uploads to a texture which may already be in use, does not wait for the copy to finish
+		static void UpdateTexture(D_GRAPHICS_UTILS::GpuResource& Dest, UINT NumSubresources, D3D12_SUBRESOURCE_DATA SubData[]);
 		static void InitializeBuffer(D_GRAPHICS_BUFFERS::GpuBuffer& Dest, const void* Data, size_t NumBytes, size_t DestOffset = 0);
 		static void InitializeBuffer(D_GRAPHICS_BUFFERS::GpuBuffer& Dest, const D_GRAPHICS_BUFFERS::UploadBuffer& Src, size_t SrcOffset, size_t NumBytes = -1, size_t DestOffset = 0);
 		static void InitializeTextureArraySlice(D_GRAPHICS_UTILS::GpuResource& Dest, UINT SliceIndex, D_GRAPHICS_UTILS::GpuResource& Src);
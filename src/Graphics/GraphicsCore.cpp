@@ -7,6 +7,7 @@
 #include "CommandContext.hpp"
 #include "GraphicsDeviceManager.hpp"
 #include "GraphicsUtils/Buffers/Texture.hpp"
+#include "GraphicsUtils/Shader/ShaderCache.hpp"
 #include "GraphicsUtils/Shader/ShaderCompiler.hpp"
 #include "GraphicsUtils/Shader/ShaderFactory.hpp"
 #include "GraphicsUtils/Memory/DescriptorHeap.hpp"
@@ -14,8 +15,10 @@
 #include "PostProcessing/MotionBlur.hpp"
 #include "PostProcessing/PostProcessing.hpp"
 
+#include <Core/Memory/MemoryTracking.hpp>
 #include <Core/Serialization/TypeSerializer.hpp>
 #include <Core/TimeManager/TimeManager.hpp>
+#include <Job/Job.hpp>
 #include <ResourceManager/ResourceManager.hpp>
 #include <Utils/Assert.hpp>
 #include <Utils/Common.hpp>
@@ -149,12 +152,16 @@ namespace Darius::Graphics
 	bool											CustomDepthEnabled;
 	bool											CurrentlyStencilEnabled;
 	bool											CurrentlyCustomDepthDenabled;
+	bool											ShaderCacheEnabled;
+	uint32_t										ShaderCacheSizeMB;
 
 
 	namespace Device
 	{
 		void Initialize(HWND window, int width, int height, D_SERIALIZATION::Json const& settings)
 		{
+			D_MEMORY_TAG_SCOPE(Graphics);
+
 			// Initialize Device
 
 			// TODO: Provide parameters for swapchain format, depth/stencil format, and backbuffer count.
@@ -296,6 +303,8 @@ namespace Darius::Graphics
 		// Settings
 		D_H_OPTIONS_LOAD_BASIC_DEFAULT("Graphics.StencilEnabled", StencilEnabled, false);
 		D_H_OPTIONS_LOAD_BASIC_DEFAULT("Graphics.CustomDepthEnabled", CustomDepthEnabled, false);
+		D_H_OPTIONS_LOAD_BASIC_DEFAULT("Graphics.ShaderCacheEnabled", ShaderCacheEnabled, true);
+		D_H_OPTIONS_LOAD_BASIC_DEFAULT("Graphics.ShaderCacheSizeMB", ShaderCacheSizeMB, 256u);
 		CurrentlyStencilEnabled = StencilEnabled;
 		CurrentlyCustomDepthDenabled = CustomDepthEnabled;
 		if (StencilEnabled)
@@ -329,6 +338,7 @@ namespace Darius::Graphics
 
 		ShaderFactory = std::make_unique<D_GRAPHICS_SHADERS::ShaderFactory>();
 
+		D_GRAPHICS_UTILS::InitializeShaderCompiler(ShaderCacheEnabled, "CacheData/Shaders", (uint64_t)ShaderCacheSizeMB << 20);
 		BuildShaders();
 		InitializeCommonStates();
 
@@ -353,6 +363,7 @@ namespace Darius::Graphics
 		Shaders.clear();
 		ShaderNameMap.clear();
 		ShaderFactory.reset();
+		D_GRAPHICS_UTILS::ShutdownShaderCompiler();
 
 		D_PROFILING_GPU::Shutdown();
 
@@ -429,6 +440,11 @@ namespace Darius::Graphics
 		return DescriptorAllocators[type].Allocate(count);
 	}
 
+	bool IsInitialized()
+	{
+		return _initialized;
+	}
+
 	CommandListManager* GetCommandManager()
 	{
 		D_ASSERT(_initialized);
@@ -662,95 +678,68 @@ namespace Darius::Graphics
 
 		D3D_SHADER_MODEL highestAvailable = Resources->GetFeatureSupport().HighestShaderModel();
 
+		Device::ShaderCompatibilityCheck(D3D_SHADER_MODEL_6_2);
+
+		DVector<Path> shaderPaths;
 		D_FILE::VisitFilesInDirectory(std::filesystem::current_path() / "Shaders", true, [&](Path const& path)
 			{
-				if (path.extension() != L".hlsl")
-					return;
-
-				auto shaderNameW = D_FILE::GetFileName(path);
-				auto shaderName = WSTR2STR(shaderNameW);
-
-				Device::ShaderCompatibilityCheck(D3D_SHADER_MODEL_6_2);
-
-				std::shared_ptr<CompiledShader> shader;
-				Shaders::ShaderCompileConfig compileConfig;
-				compileConfig.EntryPoint = "main"_SId;
-				compileConfig.Path = path;
-
-				if (shaderName.ends_with("VS"))
-				{
-					auto typedShader = ShaderFactory->CompileVertexShader(compileConfig, false, nullptr);
-					shader = std::static_pointer_cast<CompiledShader>(typedShader);
-				}
-				else if (shaderName.ends_with("PS"))
-				{
-					auto typedShader = ShaderFactory->CompilePixelShader(compileConfig, false, nullptr);
-					shader = std::static_pointer_cast<CompiledShader>(typedShader);
-				}
-				else if (shaderName.ends_with("CS"))
-				{
-					auto typedShader = ShaderFactory->CompileComputeShader(compileConfig, false, nullptr);
-					shader = std::static_pointer_cast<CompiledShader>(typedShader);
-				}
-				else if (shaderName.ends_with("GS"))
-				{
-					auto typedShader = ShaderFactory->CompileGeometryShader(compileConfig, false, nullptr);
-					shader = std::static_pointer_cast<CompiledShader>(typedShader);
-				}
-				else if (shaderName.ends_with("DS"))
-				{
-					auto typedShader = ShaderFactory->CompileDomainShader(compileConfig, false, nullptr);
-					shader = std::static_pointer_cast<CompiledShader>(typedShader);
-				}
-				else if (shaderName.ends_with("HS"))
-				{
-					auto typedShader = ShaderFactory->CompileHullShader(compileConfig, false, nullptr);
-					shader = std::static_pointer_cast<CompiledShader>(typedShader);
-				}
-				else if (shaderName.ends_with("Lib"))
-				{
-					auto typedShader = ShaderFactory->CompileShaderLibrary(compileConfig, false, nullptr);
-					shader = std::static_pointer_cast<CompiledShader>(typedShader);
-				}
-				else
-					return;
-
-				D_VERIFY(shader);
-				Shaders.push_back(shader);
+				if (path.extension() == L".hlsl")
+					shaderPaths.push_back(path);
+			});
 
-				/*D3D12_SHADER_DESC desc;
-				auto reflection = shader->GetReflectionData();
-				reflection->GetDesc(&desc);
+		// Compiling in parallel, results are registered in the visit order afterwards
+		DVector<std::shared_ptr<CompiledShader>> compiledShaders(shaderPaths.size());
 
-				auto buffer = reflection->GetConstantBufferByIndex(0);
-				D3D12_SHADER_BUFFER_DESC bufferDesc;
-				buffer->GetDesc(&bufferDesc);*/
-				/*for (int i = 0; i < bufferDesc.Variables; i++)
+		D_JOB::AddTaskSetAndWait((uint32_t)shaderPaths.size(), [&](D_JOB::TaskPartition range, D_JOB::ThreadNumber threadNumber)
+			{
+				for (uint32_t i = range.start; i < range.end; i++)
 				{
-					auto variable = buffer->GetVariableByIndex(i);
-
-					D3D12_SHADER_VARIABLE_DESC variableDesc;
-					variable->GetDesc(&variableDesc);
-
-					auto type = variable->GetType();
-
-					D3D12_SHADER_TYPE_DESC typeDesc;
-					type->GetDesc(&typeDesc);
-
-					D_ASSERT(&variableDesc);
-					D_ASSERT(&typeDesc);
+					auto const& path = shaderPaths[i];
+					auto shaderName = WSTR2STR(D_FILE::GetFileName(path));
+
+					std::shared_ptr<CompiledShader> shader;
+					Shaders::ShaderCompileConfig compileConfig;
+					compileConfig.EntryPoint = "main"_SId;
+					compileConfig.Path = path;
+
+					if (shaderName.ends_with("VS"))
+						shader = ShaderFactory->CompileVertexShader(compileConfig, false, nullptr);
+					else if (shaderName.ends_with("PS"))
+						shader = ShaderFactory->CompilePixelShader(compileConfig, false, nullptr);
+					else if (shaderName.ends_with("CS"))
+						shader = ShaderFactory->CompileComputeShader(compileConfig, false, nullptr);
+					else if (shaderName.ends_with("GS"))
+						shader = ShaderFactory->CompileGeometryShader(compileConfig, false, nullptr);
+					else if (shaderName.ends_with("DS"))
+						shader = ShaderFactory->CompileDomainShader(compileConfig, false, nullptr);
+					else if (shaderName.ends_with("HS"))
+						shader = ShaderFactory->CompileHullShader(compileConfig, false, nullptr);
+					else if (shaderName.ends_with("Lib"))
+						shader = ShaderFactory->CompileShaderLibrary(compileConfig, false, nullptr);
+					else
+						continue;
+
+					D_VERIFY(shader);
+					compiledShaders[i] = shader;
 				}
+			});
 
-				for (int i = 0; i < desc.BoundResources; i++)
-				{
-					D3D12_SHADER_INPUT_BIND_DESC resourceDesc;
-					reflection->GetResourceBindingDesc(i, &resourceDesc);
-					D_ASSERT(&resourceDesc);
-				}*/
+		for (UINT32 i = 0; i < (UINT32)shaderPaths.size(); i++)
+		{
+			auto const& shader = compiledShaders[i];
+			if (!shader)
+				continue;
 
-				ShaderNameMap[shaderName] = (UINT32)Shaders.size() - 1;
-			});
+			auto shaderName = WSTR2STR(D_FILE::GetFileName(shaderPaths[i]));
+			Shaders.push_back(shader);
+			ShaderNameMap[shaderName] = (UINT32)Shaders.size() - 1;
+		}
 
+		if (auto cache = GetShaderCache())
+		{
+			auto stats = cache->GetStats();
+			D_LOG_INFO_FMT("Shader cache: {} hits, {} misses, {} entries", stats.Hits, stats.Misses, cache->GetEntryCount());
+		}
 	}
 
 #ifdef _D_EDITOR
@@ -27,6 +27,8 @@ namespace Darius::Graphics
 
 	void									Initialize(HWND window, int width, int height, D_SERIALIZATION::Json const& settings);
 	void									Shutdown();
+	// False in tools and tests running without a device
+	bool									IsInitialized();
 
 	void									Present();
 
@@ -0,0 +1,366 @@
+#include "Graphics/pch.hpp"
+#include "DDSMipLayout.hpp"
+
+#include <Utils/Assert.hpp>
+
+#include <cstring>
+
+namespace
+{
+	constexpr uint32_t DDSMagic = 0x20534444; // "DDS "
+
+	constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+	constexpr uint32_t DDSD_DEPTH = 0x800000;
+	constexpr uint32_t DDPF_ALPHAPIXELS = 0x1;
+	constexpr uint32_t DDPF_FOURCC = 0x4;
+	constexpr uint32_t DDPF_RGB = 0x40;
+	constexpr uint32_t DDPF_LUMINANCE = 0x20000;
+	constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+	constexpr uint32_t DDSCAPS2_VOLUME = 0x200000;
+	constexpr uint32_t DX10_RESOURCE_MISC_TEXTURECUBE = 0x4;
+	constexpr uint32_t DX10_DIMENSION_TEXTURE3D = 4;
+
+	constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+	{
+		return (uint32_t)(uint8_t)a | ((uint32_t)(uint8_t)b << 8) | ((uint32_t)(uint8_t)c << 16) | ((uint32_t)(uint8_t)d << 24);
+	}
+
+	struct DDSPixelFormat
+	{
+		uint32_t	Size;
+		uint32_t	Flags;
+		uint32_t	FourCC;
+		uint32_t	RGBBitCount;
+		uint32_t	RBitMask;
+		uint32_t	GBitMask;
+		uint32_t	BBitMask;
+		uint32_t	ABitMask;
+	};
+
+	struct DDSHeader
+	{
+		uint32_t		Size;
+		uint32_t		Flags;
+		uint32_t		Height;
+		uint32_t		Width;
+		uint32_t		PitchOrLinearSize;
+		uint32_t		Depth;
+		uint32_t		MipMapCount;
+		uint32_t		Reserved1[11];
+		DDSPixelFormat	PixelFormat;
+		uint32_t		Caps;
+		uint32_t		Caps2;
+		uint32_t		Caps3;
+		uint32_t		Caps4;
+		uint32_t		Reserved2;
+	};
+
+	struct DDSHeaderDX10
+	{
+		uint32_t	Format;
+		uint32_t	Dimension;
+		uint32_t	MiscFlag;
+		uint32_t	ArraySize;
+		uint32_t	MiscFlags2;
+	};
+
+	D_STATIC_ASSERT(sizeof(DDSHeader) == 124);
+	D_STATIC_ASSERT(sizeof(DDSHeaderDX10) == 20);
+
+	bool IsMask(DDSPixelFormat const& pf, uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+	{
+		return pf.RBitMask == r && pf.GBitMask == g && pf.BBitMask == b && pf.ABitMask == a;
+	}
+
+	// Formats of the legacy header, the common ones only
+	DXGI_FORMAT GetLegacyFormat(DDSPixelFormat const& pf)
+	{
+		if (pf.Flags & DDPF_FOURCC)
+		{
+			switch (pf.FourCC)
+			{
+			case MakeFourCC('D', 'X', 'T', '1'): return DXGI_FORMAT_BC1_UNORM;
+			case MakeFourCC('D', 'X', 'T', '2'):
+			case MakeFourCC('D', 'X', 'T', '3'): return DXGI_FORMAT_BC2_UNORM;
+			case MakeFourCC('D', 'X', 'T', '4'):
+			case MakeFourCC('D', 'X', 'T', '5'): return DXGI_FORMAT_BC3_UNORM;
+			case MakeFourCC('A', 'T', 'I', '1'):
+			case MakeFourCC('B', 'C', '4', 'U'): return DXGI_FORMAT_BC4_UNORM;
+			case MakeFourCC('B', 'C', '4', 'S'): return DXGI_FORMAT_BC4_SNORM;
+			case MakeFourCC('A', 'T', 'I', '2'):
+			case MakeFourCC('B', 'C', '5', 'U'): return DXGI_FORMAT_BC5_UNORM;
+			case MakeFourCC('B', 'C', '5', 'S'): return DXGI_FORMAT_BC5_SNORM;
+			// D3DFMT values stored as the four cc
+			case 36: return DXGI_FORMAT_R16G16B16A16_UNORM;
+			case 110: return DXGI_FORMAT_R16G16B16A16_SNORM;
+			case 111: return DXGI_FORMAT_R16_FLOAT;
+			case 112: return DXGI_FORMAT_R16G16_FLOAT;
+			case 113: return DXGI_FORMAT_R16G16B16A16_FLOAT;
+			case 114: return DXGI_FORMAT_R32_FLOAT;
+			case 115: return DXGI_FORMAT_R32G32_FLOAT;
+			case 116: return DXGI_FORMAT_R32G32B32A32_FLOAT;
+			default: return DXGI_FORMAT_UNKNOWN;
+			}
+		}
+
+		if (pf.Flags & DDPF_RGB)
+		{
+			switch (pf.RGBBitCount)
+			{
+			case 32:
+				if (IsMask(pf, 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000))
+					return DXGI_FORMAT_R8G8B8A8_UNORM;
+				if (IsMask(pf, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000))
+					return DXGI_FORMAT_B8G8R8A8_UNORM;
+				if (IsMask(pf, 0x00ff0000, 0x0000ff00, 0x000000ff, 0))
+					return DXGI_FORMAT_B8G8R8X8_UNORM;
+				if (IsMask(pf, 0x0000ffff, 0xffff0000, 0, 0))
+					return DXGI_FORMAT_R16G16_UNORM;
+				if (IsMask(pf, 0xffffffff, 0, 0, 0))
+					return DXGI_FORMAT_R32_FLOAT;
+				return DXGI_FORMAT_UNKNOWN;
+			case 16:
+				if (IsMask(pf, 0xf800, 0x07e0, 0x001f, 0))
+					return DXGI_FORMAT_B5G6R5_UNORM;
+				if (IsMask(pf, 0x7c00, 0x03e0, 0x001f, 0x8000))
+					return DXGI_FORMAT_B5G5R5A1_UNORM;
+				return DXGI_FORMAT_UNKNOWN;
+			default:
+				return DXGI_FORMAT_UNKNOWN;
+			}
+		}
+
+		if (pf.Flags & DDPF_LUMINANCE)
+		{
+			if (pf.RGBBitCount == 8 && IsMask(pf, 0xff, 0, 0, 0))
+				return DXGI_FORMAT_R8_UNORM;
+			if (pf.RGBBitCount == 16 && IsMask(pf, 0xffff, 0, 0, 0))
+				return DXGI_FORMAT_R16_UNORM;
+			if (pf.RGBBitCount == 16 && IsMask(pf, 0xff, 0, 0, 0xff00))
+				return DXGI_FORMAT_R8G8_UNORM;
+		}
+
+		if ((pf.Flags & DDPF_ALPHAPIXELS) && pf.RGBBitCount == 8)
+			return DXGI_FORMAT_A8_UNORM;
+
+		return DXGI_FORMAT_UNKNOWN;
+	}
+
+	// Bytes of a 4x4 block for block compressed formats, otherwise zero
+	uint32_t GetBlockBytes(DXGI_FORMAT format)
+	{
+		switch (format)
+		{
+		case DXGI_FORMAT_BC1_TYPELESS:
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_TYPELESS:
+		case DXGI_FORMAT_BC4_UNORM:
+		case DXGI_FORMAT_BC4_SNORM:
+			return 8u;
+		case DXGI_FORMAT_BC2_TYPELESS:
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB:
+		case DXGI_FORMAT_BC3_TYPELESS:
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+		case DXGI_FORMAT_BC5_TYPELESS:
+		case DXGI_FORMAT_BC5_UNORM:
+		case DXGI_FORMAT_BC5_SNORM:
+		case DXGI_FORMAT_BC6H_TYPELESS:
+		case DXGI_FORMAT_BC6H_UF16:
+		case DXGI_FORMAT_BC6H_SF16:
+		case DXGI_FORMAT_BC7_TYPELESS:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			return 16u;
+		default:
+			return 0u;
+		}
+	}
+
+	// Zero for the formats which are not supported
+	uint32_t GetBitsPerPixel(DXGI_FORMAT format)
+	{
+		switch (format)
+		{
+		case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		case DXGI_FORMAT_R32G32B32A32_UINT:
+		case DXGI_FORMAT_R32G32B32A32_SINT:
+			return 128u;
+		case DXGI_FORMAT_R32G32B32_TYPELESS:
+		case DXGI_FORMAT_R32G32B32_FLOAT:
+		case DXGI_FORMAT_R32G32B32_UINT:
+		case DXGI_FORMAT_R32G32B32_SINT:
+			return 96u;
+		case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+		case DXGI_FORMAT_R16G16B16A16_UNORM:
+		case DXGI_FORMAT_R16G16B16A16_UINT:
+		case DXGI_FORMAT_R16G16B16A16_SNORM:
+		case DXGI_FORMAT_R16G16B16A16_SINT:
+		case DXGI_FORMAT_R32G32_TYPELESS:
+		case DXGI_FORMAT_R32G32_FLOAT:
+		case DXGI_FORMAT_R32G32_UINT:
+		case DXGI_FORMAT_R32G32_SINT:
+			return 64u;
+		case DXGI_FORMAT_R10G10B10A2_TYPELESS:
+		case DXGI_FORMAT_R10G10B10A2_UNORM:
+		case DXGI_FORMAT_R10G10B10A2_UINT:
+		case DXGI_FORMAT_R11G11B10_FLOAT:
+		case DXGI_FORMAT_R8G8B8A8_TYPELESS:
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+		case DXGI_FORMAT_R8G8B8A8_UINT:
+		case DXGI_FORMAT_R8G8B8A8_SNORM:
+		case DXGI_FORMAT_R8G8B8A8_SINT:
+		case DXGI_FORMAT_R16G16_TYPELESS:
+		case DXGI_FORMAT_R16G16_FLOAT:
+		case DXGI_FORMAT_R16G16_UNORM:
+		case DXGI_FORMAT_R16G16_UINT:
+		case DXGI_FORMAT_R16G16_SNORM:
+		case DXGI_FORMAT_R16G16_SINT:
+		case DXGI_FORMAT_R32_TYPELESS:
+		case DXGI_FORMAT_R32_FLOAT:
+		case DXGI_FORMAT_R32_UINT:
+		case DXGI_FORMAT_R32_SINT:
+		case DXGI_FORMAT_R9G9B9E5_SHAREDEXP:
+		case DXGI_FORMAT_B8G8R8A8_UNORM:
+		case DXGI_FORMAT_B8G8R8X8_UNORM:
+		case DXGI_FORMAT_B8G8R8A8_TYPELESS:
+		case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+		case DXGI_FORMAT_B8G8R8X8_TYPELESS:
+		case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+			return 32u;
+		case DXGI_FORMAT_R8G8_TYPELESS:
+		case DXGI_FORMAT_R8G8_UNORM:
+		case DXGI_FORMAT_R8G8_UINT:
+		case DXGI_FORMAT_R8G8_SNORM:
+		case DXGI_FORMAT_R8G8_SINT:
+		case DXGI_FORMAT_R16_TYPELESS:
+		case DXGI_FORMAT_R16_FLOAT:
+		case DXGI_FORMAT_R16_UNORM:
+		case DXGI_FORMAT_R16_UINT:
+		case DXGI_FORMAT_R16_SNORM:
+		case DXGI_FORMAT_R16_SINT:
+		case DXGI_FORMAT_B5G6R5_UNORM:
+		case DXGI_FORMAT_B5G5R5A1_UNORM:
+		case DXGI_FORMAT_B4G4R4A4_UNORM:
+			return 16u;
+		case DXGI_FORMAT_R8_TYPELESS:
+		case DXGI_FORMAT_R8_UNORM:
+		case DXGI_FORMAT_R8_UINT:
+		case DXGI_FORMAT_R8_SNORM:
+		case DXGI_FORMAT_R8_SINT:
+		case DXGI_FORMAT_A8_UNORM:
+			return 8u;
+		default:
+			return 0u;
+		}
+	}
+}
+
+namespace Darius::Graphics::Utils::Buffers
+{
+	uint32_t DDSMipLayout::GetFirstMipWithin(uint32_t maxSize) const
+	{
+		for (uint32_t i = 0u; i < (uint32_t)Mips.size(); i++)
+			if (Mips[i].Width <= maxSize && Mips[i].Height <= maxSize)
+				return i;
+
+		return (uint32_t)Mips.size() - 1u;
+	}
+
+	bool ParseDDSMipLayout(void const* data, size_t dataSize, uint64_t fileSize, DDSMipLayout& layout)
+	{
+		auto bytes = reinterpret_cast<uint8_t const*>(data);
+		if (dataSize < 4 + sizeof(DDSHeader))
+			return false;
+
+		uint32_t magic;
+		std::memcpy(&magic, bytes, sizeof(magic));
+		if (magic != DDSMagic)
+			return false;
+
+		DDSHeader header;
+		std::memcpy(&header, bytes + 4, sizeof(header));
+		if (header.Size != sizeof(DDSHeader) || header.PixelFormat.Size != sizeof(DDSPixelFormat))
+			return false;
+
+		uint64_t dataOffset = 4 + sizeof(DDSHeader);
+
+		layout = DDSMipLayout();
+		layout.Width = header.Width;
+		layout.Height = header.Height;
+		layout.Depth = (header.Flags & DDSD_DEPTH) ? std::max(header.Depth, 1u) : 1u;
+
+		if ((header.PixelFormat.Flags & DDPF_FOURCC) && header.PixelFormat.FourCC == MakeFourCC('D', 'X', '1', '0'))
+		{
+			if (dataSize < dataOffset + sizeof(DDSHeaderDX10))
+				return false;
+
+			DDSHeaderDX10 dx10;
+			std::memcpy(&dx10, bytes + dataOffset, sizeof(dx10));
+			dataOffset += sizeof(DDSHeaderDX10);
+
+			layout.Format = (DXGI_FORMAT)dx10.Format;
+			layout.ArraySize = dx10.ArraySize;
+			layout.CubeMap = (dx10.MiscFlag & DX10_RESOURCE_MISC_TEXTURECUBE) != 0;
+			if (dx10.Dimension != DX10_DIMENSION_TEXTURE3D)
+				layout.Depth = 1u;
+		}
+		else
+		{
+			layout.Format = GetLegacyFormat(header.PixelFormat);
+			layout.CubeMap = (header.Caps2 & DDSCAPS2_CUBEMAP) != 0;
+			if (!(header.Caps2 & DDSCAPS2_VOLUME))
+				layout.Depth = 1u;
+		}
+
+		if (layout.Format == DXGI_FORMAT_UNKNOWN || layout.Width == 0u || layout.Height == 0u || layout.ArraySize == 0u)
+			return false;
+
+		uint32_t blockBytes = GetBlockBytes(layout.Format);
+		uint32_t bitsPerPixel = GetBitsPerPixel(layout.Format);
+		if (blockBytes == 0u && bitsPerPixel == 0u)
+			return false;
+
+		uint32_t mipCount = (header.Flags & DDSD_MIPMAPCOUNT) ? std::max(header.MipMapCount, 1u) : 1u;
+		if (mipCount > 32u)
+			return false;
+
+		layout.Mips.resize(mipCount);
+
+		uint64_t offset = dataOffset;
+		uint64_t sliceSize = 0u;
+		for (uint32_t i = 0u; i < mipCount; i++)
+		{
+			auto& mip = layout.Mips[i];
+			mip.Width = std::max(layout.Width >> i, 1u);
+			mip.Height = std::max(layout.Height >> i, 1u);
+
+			if (blockBytes > 0u)
+			{
+				mip.RowPitch = std::max((mip.Width + 3u) / 4u, 1u) * blockBytes;
+				mip.RowCount = std::max((mip.Height + 3u) / 4u, 1u);
+			}
+			else
+			{
+				mip.RowPitch = (mip.Width * bitsPerPixel + 7u) / 8u;
+				mip.RowCount = mip.Height;
+			}
+
+			uint32_t depth = std::max(layout.Depth >> i, 1u);
+			mip.Offset = offset;
+			mip.Size = (uint64_t)mip.RowPitch * mip.RowCount * depth;
+
+			offset += mip.Size;
+			sliceSize += mip.Size;
+		}
+
+		// Array slices and cube faces follow the first one
+		uint64_t sliceCount = (uint64_t)layout.ArraySize * (layout.CubeMap ? 6u : 1u);
+		return dataOffset + sliceSize * sliceCount <= fileSize;
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Core/Containers/Vector.hpp>
+#include <Utils/Common.hpp>
+
+#include <dxgiformat.h>
+
+#ifndef D_GRAPHICS_BUFFERS
+#define D_GRAPHICS_BUFFERS Darius::Graphics::Utils::Buffers
+#endif
+
+namespace Darius::Graphics::Utils::Buffers
+{
+	// Location of each mip of a DDS file, read from the header only so that a range
+	// of mips can be loaded without reading the whole file
+	struct DDSMipLayout
+	{
+		struct Mip
+		{
+			uint64_t						Offset;		// From the start of the file
+			uint64_t						Size;
+			uint32_t						Width;
+			uint32_t						Height;
+			uint32_t						RowPitch;
+			uint32_t						RowCount;
+		};
+
+		// Header and the DX10 extension if present
+		static constexpr size_t				MaxHeaderSize = 4 + 124 + 20;
+
+		uint32_t							Width = 0u;
+		uint32_t							Height = 0u;
+		uint32_t							Depth = 1u;
+		uint32_t							ArraySize = 1u;
+		DXGI_FORMAT							Format = DXGI_FORMAT_UNKNOWN;
+		bool								CubeMap = false;
+
+		// Mips of the first array slice, most detailed first
+		D_CONTAINERS::DVector<Mip>			Mips;
+
+		INLINE uint32_t						GetMipCount() const { return (uint32_t)Mips.size(); }
+
+		// Only single 2D textures can have a part of their mips loaded
+		INLINE bool							IsStreamable() const { return ArraySize == 1u && Depth == 1u && !CubeMap && Mips.size() > 1; }
+
+		// Mips are stored from the most detailed one, so a mip and the ones after it are contiguous
+		INLINE uint64_t						GetRangeOffset(uint32_t firstMip) const { return Mips[firstMip].Offset; }
+		INLINE uint64_t						GetRangeSize(uint32_t firstMip) const { return Mips.back().Offset + Mips.back().Size - Mips[firstMip].Offset; }
+
+		// First mip which is not larger than the size in any dimension
+		uint32_t							GetFirstMipWithin(uint32_t maxSize) const;
+	};
+
+	// Parses the header of a DDS file. The data has to hold at least the header and the
+	// file size is used to validate that all the mips are present.
+	// Returns false for invalid files and pixel formats which can't be described by a DXGI format.
+	bool									ParseDDSMipLayout(void const* data, size_t dataSize, uint64_t fileSize, DDSMipLayout& layout);
+}
@@ -3,6 +3,7 @@
 
 #include "Graphics/CommandContext.hpp"
 #include "Graphics/GraphicsDeviceManager.hpp"
+#include "DDSMipLayout.hpp"
 #include "PixelBuffer.hpp"
 
 #include <Utils/Common.hpp>
@@ -416,6 +417,82 @@ namespace Darius::Graphics::Utils::Buffers
 #endif
 }
 
+	void Texture::CreateDDSMipRange(DDSMipLayout const& layout, uint32_t firstMip, const void* rangeData, bool sRGB)
+	{
+		D_ASSERT(layout.IsStreamable());
+		D_ASSERT(firstMip < layout.GetMipCount());
+
+		Destroy();
+
+		mUsageState = D3D12_RESOURCE_STATE_COPY_DEST;
+
+		auto const& top = layout.Mips[firstMip];
+		DXGI_FORMAT format = sRGB ? PixelBuffer::MakeSRGB(layout.Format) : layout.Format;
+		UINT mipLevels = layout.GetMipCount() - firstMip;
+
+		mMetaData.Width = top.Width;
+		mMetaData.Height = top.Height;
+		mMetaData.Depth = 1;
+		mMetaData.ArraySize = 1;
+		mMetaData.MipLevels = mipLevels;
+		mMetaData.MiscFlags = 0;
+		mMetaData.MiscFlags2 = 0;
+		mMetaData.Format = format;
+		mMetaData.Dimension = TextureMeta::TEX_DIMENSION_TEXTURE2D;
+		mMetaData.Initialized = true;
+
+		D3D12ResourceDesc texDesc = {};
+		texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+		texDesc.Width = (UINT64)top.Width;
+		texDesc.Height = top.Height;
+		texDesc.DepthOrArraySize = 1u;
+		texDesc.MipLevels = (UINT16)mipLevels;
+		texDesc.Format = format;
+		texDesc.SampleDesc.Count = 1u;
+		texDesc.SampleDesc.Quality = 0u;
+		texDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+		texDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+		texDesc.Alignment = 0ull;
+		texDesc.ReservedResource = false;
+
+		D3D12_HEAP_PROPERTIES HeapProps;
+		HeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+		HeapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+		HeapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+		HeapProps.CreationNodeMask = 1;
+		HeapProps.VisibleNodeMask = 1;
+
+		D_HR_CHECK(CreateCommittedResource(D_GRAPHICS_DEVICE::GetDevice(), texDesc, HeapProps, D3D12_HEAP_FLAG_NONE, mUsageState, nullptr));
+
+		GetResource()->SetName(L"Streamed Texture");
+
+		// Offsets in the range are relative to the first mip
+		auto base = reinterpret_cast<uint8_t const*>(rangeData);
+		D_CONTAINERS::DVector<D3D12_SUBRESOURCE_DATA> subData(mipLevels);
+		for (UINT i = 0; i < mipLevels; i++)
+		{
+			auto const& mip = layout.Mips[firstMip + i];
+			subData[i].pData = base + (mip.Offset - top.Offset);
+			subData[i].RowPitch = mip.RowPitch;
+			subData[i].SlicePitch = mip.Size;
+		}
+
+		CommandContext::UpdateTexture(*this, mipLevels, subData.data());
+
+		if(mCpuDescriptorHandle.ptr == D3D12_GPU_VIRTUAL_ADDRESS_UNKNOWN)
+			mCpuDescriptorHandle = AllocateDescriptor(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+		D3D12_SHADER_RESOURCE_VIEW_DESC srv;
+		srv.Format = format;
+		srv.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+		srv.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+		srv.Texture2D.MipLevels = mipLevels;
+		srv.Texture2D.MostDetailedMip = 0;
+		srv.Texture2D.PlaneSlice = 0;
+		srv.Texture2D.ResourceMinLODClamp = 0.f;
+		GetParentDevice()->CreateShaderResourceView(GetResource(), &srv, mCpuDescriptorHandle);
+	}
+
 	bool Texture::CreateWICFromMemory(const void* memBuffer, size_t fileSize, bool sRGB)
 	{
 		DirectX::WIC_FLAGS flags = DirectX::WIC_FLAGS::WIC_FLAGS_NONE;
@@ -14,6 +14,8 @@ namespace DirectX
 
 namespace Darius::Graphics::Utils::Buffers
 {
+	struct DDSMipLayout;
+
 	class Texture : public GpuResource
 	{
 		friend class CommandContext;
@@ -35,6 +37,10 @@ namespace Darius::Graphics::Utils::Buffers
 		bool CreateWICFromMemory(const void* memBuffer, size_t fileSize, bool sRGB);
 		void CreatePIXImageFromMemory(const void* memBuffer, size_t fileSize);
 
+		// Creates a 2D texture with the mips of a DDS file from the first mip to the smallest one.
+		// The data is the part of the file holding these mips. The upload is not waited for.
+		void CreateDDSMipRange(DDSMipLayout const& layout, uint32_t firstMip, const void* rangeData, bool sRGB);
+
 		virtual void Destroy() override
 		{
 			GpuResource::Destroy();
@@ -0,0 +1,321 @@
+#include "Graphics/pch.hpp"
+#include "EventProfiler.hpp"
+
+#include <Core/Containers/Map.hpp>
+#include <Core/Containers/Set.hpp>
+#include <Utils/Assert.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+
+using namespace D_CONTAINERS;
+
+namespace
+{
+	using namespace D_PROFILING;
+
+	// Single producer, single consumer ring of the events of a thread
+	struct ThreadEventBuffer
+	{
+		static constexpr uint64_t			Capacity = 1ull << 15;
+
+		alignas(64) std::atomic_uint64_t	Head = 0u;	// Written by the owner thread
+		alignas(64) std::atomic_uint64_t	Tail = 0u;	// Written by the draining thread
+
+		uint32_t							Thread = 0u;
+		ThreadEventBuffer*					Next = nullptr;
+
+		ProfileEvent						Events[Capacity];
+	};
+
+	// Buffers live as long as the program since the threads may outlive any owner
+	struct ThreadEventBufferList
+	{
+		~ThreadEventBufferList()
+		{
+			auto buffer = Head.load();
+			while (buffer)
+			{
+				auto next = buffer->Next;
+				delete buffer;
+				buffer = next;
+			}
+		}
+
+		std::atomic<ThreadEventBuffer*>		Head = nullptr;
+	};
+
+	// Whether each open scope of the thread has its begin recorded, so that the end is recorded accordingly
+	struct ThreadScopeStack
+	{
+		static constexpr uint32_t			MaxDepth = 64u;
+
+		uint64_t							Recorded = 0u;
+		uint32_t							Depth = 0u;
+
+		// Buffer slots kept for the ends of the recorded scopes
+		uint32_t							PendingEnds = 0u;
+	};
+
+	std::atomic_bool						Recording = false;
+	std::atomic_uint64_t					DroppedEvents = 0u;
+	std::atomic_uint32_t					NextThread = 0u;
+	ThreadEventBufferList					Buffers;
+
+	std::mutex								ScopesMutex;
+	DVector<std::wstring>					ScopeNames;
+	DUnorderedMap<std::wstring, ScopeId>	ScopeIds;
+
+	thread_local ThreadEventBuffer*			LocalBuffer = nullptr;
+	thread_local ThreadScopeStack			LocalStack;
+	thread_local DUnorderedMap<wchar_t const*, ScopeId> LocalLiteralIds;
+	thread_local DUnorderedMap<std::wstring, ScopeId> LocalNameIds;
+
+	INLINE int64_t Now()
+	{
+		return std::chrono::steady_clock::now().time_since_epoch().count();
+	}
+
+	ThreadEventBuffer* CreateLocalBuffer()
+	{
+		auto buffer = new ThreadEventBuffer();
+		buffer->Thread = NextThread.fetch_add(1u, std::memory_order_relaxed);
+
+		buffer->Next = Buffers.Head.load(std::memory_order_relaxed);
+		while (!Buffers.Head.compare_exchange_weak(buffer->Next, buffer, std::memory_order_release, std::memory_order_relaxed));
+
+		LocalBuffer = buffer;
+		return buffer;
+	}
+
+	INLINE bool Record(ScopeId scope, ProfileEventType type, uint32_t reserved)
+	{
+		auto buffer = LocalBuffer ? LocalBuffer : CreateLocalBuffer();
+
+		uint64_t head = buffer->Head.load(std::memory_order_relaxed);
+		if (head - buffer->Tail.load(std::memory_order_acquire) + reserved >= ThreadEventBuffer::Capacity)
+		{
+			DroppedEvents.fetch_add(1u, std::memory_order_relaxed);
+			return false;
+		}
+
+		buffer->Events[head & (ThreadEventBuffer::Capacity - 1u)] = { Now(), scope, type };
+		buffer->Head.store(head + 1u, std::memory_order_release);
+		return true;
+	}
+
+	void WriteJsonString(std::ostream& out, std::wstring const& value)
+	{
+		out << '"';
+		for (char c : WSTR2STR(value))
+		{
+			switch (c)
+			{
+			case '"': out << "\\\""; break;
+			case '\\': out << "\\\\"; break;
+			case '\n': out << "\\n"; break;
+			case '\t': out << "\\t"; break;
+			default:
+				if ((unsigned char)c < 0x20)
+					out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec << std::setfill(' ');
+				else
+					out << c;
+			}
+		}
+		out << '"';
+	}
+}
+
+namespace Darius::Graphics::Utils::Profiling
+{
+	ScopeId InternScope(std::wstring const& name)
+	{
+		auto local = LocalNameIds.find(name);
+		if (local != LocalNameIds.end())
+			return local->second;
+
+		ScopeId id;
+		{
+			std::scoped_lock lock(ScopesMutex);
+
+			auto it = ScopeIds.find(name);
+			if (it == ScopeIds.end())
+			{
+				id = (ScopeId)ScopeNames.size();
+				ScopeNames.push_back(name);
+				ScopeIds.emplace(name, id);
+			}
+			else
+				id = it->second;
+		}
+
+		LocalNameIds.emplace(name, id);
+		return id;
+	}
+
+	ScopeId InternScope(wchar_t const* name)
+	{
+		auto local = LocalLiteralIds.find(name);
+		if (local != LocalLiteralIds.end())
+			return local->second;
+
+		auto id = InternScope(std::wstring(name));
+		LocalLiteralIds.emplace(name, id);
+		return id;
+	}
+
+	std::wstring GetScopeName(ScopeId id)
+	{
+		std::scoped_lock lock(ScopesMutex);
+		return id < ScopeNames.size() ? ScopeNames[id] : std::wstring();
+	}
+
+	void SetEventRecording(bool enabled)
+	{
+		Recording.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool IsEventRecording()
+	{
+		return Recording.load(std::memory_order_relaxed);
+	}
+
+	void RecordBegin(ScopeId scope)
+	{
+		auto& stack = LocalStack;
+
+		// Scopes deeper than the mask are not recorded
+		if (stack.Depth < ThreadScopeStack::MaxDepth)
+		{
+			// Room is kept for the end of this scope and the open ones, so ends are never dropped
+			bool recorded = Recording.load(std::memory_order_relaxed) && Record(scope, ProfileEventType::Begin, stack.PendingEnds + 1u);
+
+			if (recorded)
+			{
+				stack.Recorded |= 1ull << stack.Depth;
+				stack.PendingEnds++;
+			}
+			else
+				stack.Recorded &= ~(1ull << stack.Depth);
+		}
+		stack.Depth++;
+	}
+
+	void RecordEnd()
+	{
+		auto& stack = LocalStack;
+		if (stack.Depth == 0u)
+			return;
+
+		stack.Depth--;
+
+		// Without the begin, the end would close the wrong scope
+		if (stack.Depth < ThreadScopeStack::MaxDepth && (stack.Recorded & (1ull << stack.Depth)))
+		{
+			stack.PendingEnds--;
+			Record(0u, ProfileEventType::End, 0u);
+		}
+	}
+
+	void RecordFrame(uint32_t frameIndex)
+	{
+		if (Recording.load(std::memory_order_relaxed))
+			Record(frameIndex, ProfileEventType::Frame, LocalStack.PendingEnds);
+	}
+
+	void DrainEvents(DVector<CapturedEvent>& events)
+	{
+		for (auto buffer = Buffers.Head.load(std::memory_order_acquire); buffer; buffer = buffer->Next)
+		{
+			uint64_t tail = buffer->Tail.load(std::memory_order_relaxed);
+			uint64_t head = buffer->Head.load(std::memory_order_acquire);
+
+			for (; tail < head; tail++)
+				events.push_back({ buffer->Events[tail & (ThreadEventBuffer::Capacity - 1u)], buffer->Thread });
+
+			buffer->Tail.store(head, std::memory_order_release);
+		}
+	}
+
+	uint64_t GetDroppedEventCount()
+	{
+		return DroppedEvents.load(std::memory_order_relaxed);
+	}
+
+	double GetTimestampMicroseconds(int64_t timestamp)
+	{
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::duration(timestamp)).count();
+	}
+
+	void WriteChromeTrace(DVector<CapturedEvent> const& events, std::ostream& out)
+	{
+		int64_t origin = INT64_MAX;
+		for (auto const& captured : events)
+			origin = std::min(origin, captured.Event.Timestamp);
+
+		DUnorderedMap<uint32_t, DVector<ProfileEvent>> openScopes;
+		DUnorderedMap<ScopeId, std::wstring> names;
+		DSet<uint32_t> namedThreads;
+
+		out << std::fixed << std::setprecision(3);
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		bool first = true;
+		auto beginEvent = [&]()
+			{
+				if (!first)
+					out << ",";
+				out << "\n";
+				first = false;
+			};
+
+		for (auto const& captured : events)
+		{
+			auto const& event = captured.Event;
+			double ts = GetTimestampMicroseconds(event.Timestamp - origin);
+
+			if (namedThreads.insert(captured.Thread).second)
+			{
+				beginEvent();
+				out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << captured.Thread << ",\"args\":{\"name\":\"Thread " << captured.Thread << "\"}}";
+			}
+
+			switch (event.Type)
+			{
+			case ProfileEventType::Begin:
+				openScopes[captured.Thread].push_back(event);
+				break;
+			case ProfileEventType::End:
+			{
+				auto& stack = openScopes[captured.Thread];
+				if (stack.empty())
+					break;
+
+				auto begin = stack.back();
+				stack.pop_back();
+
+				auto name = names.find(begin.Scope);
+				if (name == names.end())
+					name = names.emplace(begin.Scope, GetScopeName(begin.Scope)).first;
+
+				beginEvent();
+				out << "{\"name\":";
+				WriteJsonString(out, name->second);
+				out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << captured.Thread
+					<< ",\"ts\":" << GetTimestampMicroseconds(begin.Timestamp - origin)
+					<< ",\"dur\":" << GetTimestampMicroseconds(event.Timestamp - begin.Timestamp) << "}";
+				break;
+			}
+			case ProfileEventType::Frame:
+				beginEvent();
+				out << "{\"name\":\"Frame " << event.Scope << "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":" << captured.Thread << ",\"ts\":" << ts << "}";
+				break;
+			default:
+				break;
+			}
+		}
+
+		out << "\n]}\n";
+	}
+}
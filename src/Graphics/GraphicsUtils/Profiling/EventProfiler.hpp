@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Core/Containers/Vector.hpp>
+#include <Utils/Common.hpp>
+
+#include <atomic>
+#include <ostream>
+#include <string>
+
+#ifndef D_PROFILING
+#define D_PROFILING Darius::Graphics::Utils::Profiling
+#endif
+
+// Records begin and end events of the profiling scopes of every thread into per thread ring buffers.
+// Each thread only writes to its own buffer and the buffers are drained from a single thread, so
+// neither recording nor draining takes a lock.
+namespace Darius::Graphics::Utils::Profiling
+{
+	typedef uint32_t ScopeId;
+
+	enum class ProfileEventType : uint32_t
+	{
+		Begin,
+		End,
+
+		// Scope of a frame event is the frame index
+		Frame
+	};
+
+	struct ProfileEvent
+	{
+		int64_t							Timestamp;
+		ScopeId							Scope;
+		ProfileEventType				Type;
+	};
+
+	struct CapturedEvent
+	{
+		ProfileEvent					Event;
+		uint32_t						Thread;
+	};
+
+	// Scope names are interned once, so events carry an id only
+	ScopeId								InternScope(std::wstring const& name);
+
+	// Cached per call site string address, for names that are string literals
+	ScopeId								InternScope(wchar_t const* name);
+
+	std::wstring						GetScopeName(ScopeId id);
+
+	// Events are only recorded while enabled
+	void								SetEventRecording(bool enabled);
+	bool								IsEventRecording();
+
+	void								RecordBegin(ScopeId scope);
+	void								RecordEnd();
+	void								RecordFrame(uint32_t frameIndex);
+
+	// Moves the recorded events of all threads to the vector. Only one thread may drain at a time.
+	void								DrainEvents(D_CONTAINERS::DVector<CapturedEvent>& events);
+
+	// Events lost because a thread's buffer was full
+	uint64_t							GetDroppedEventCount();
+
+	// Timestamps of the events in microseconds
+	double								GetTimestampMicroseconds(int64_t timestamp);
+
+	// Writes the events in the Chrome trace event format, viewable in chrome://tracing and Perfetto.
+	// Scopes are matched per thread and the ones not closed within the events are left out.
+	void								WriteChromeTrace(D_CONTAINERS::DVector<CapturedEvent> const& events, std::ostream& out);
+}
@@ -9,6 +9,8 @@
 #include <Utils/Log.hpp>
 
 #include <chrono>
+#include <fstream>
+#include <thread>
 
 using namespace D_GRAPHICS;
 using namespace D_MATH;
@@ -24,6 +26,12 @@ namespace Darius::Graphics::Utils::Profiling
 	bool Paused = false;
 	bool AwaitingUpdate = true;
 
+	// The nested timing tree is only touched from the main thread
+	std::thread::id MainThreadId;
+
+	bool Capturing = false;
+	D_CONTAINERS::DVector<CapturedEvent> CapturedEvents;
+
 	class StatPlot
 	{
 	public:
@@ -126,16 +134,16 @@ namespace Darius::Graphics::Utils::Profiling
 		NestedTimingTree(const std::wstring& name, NestedTimingTree* parent = nullptr)
 			: m_Name(name), m_Parent(parent), m_IsExpanded(false) {}
 
-		NestedTimingTree* GetChild(const std::wstring& name)
+		NestedTimingTree* GetChild(ScopeId scope)
 		{
-			auto iter = m_LUT.find(name);
+			auto iter = m_LUT.find(scope);
 			if (iter != m_LUT.end())
 				return iter->second;
 
-			NestedTimingTree* node = new NestedTimingTree(name, this);
+			NestedTimingTree* node = new NestedTimingTree(GetScopeName(scope), this);
 			node->m_Level = m_Level + 1;
 			m_Children.push_back(node);
-			m_LUT[name] = node;
+			m_LUT[scope] = node;
 			return node;
 		}
 
@@ -280,7 +288,7 @@ namespace Darius::Graphics::Utils::Profiling
 			}
 		}
 
-		static void PushProfilingMarker(const std::wstring& name, D_GRAPHICS::CommandContext* Context);
+		static void PushProfilingMarker(ScopeId scope, D_GRAPHICS::CommandContext* Context);
 		static void PopProfilingMarker(D_GRAPHICS::CommandContext* Context);
 		static void Update(void);
 		static void UpdateTimes(void)
@@ -339,7 +347,7 @@ namespace Darius::Graphics::Utils::Profiling
 		std::wstring m_Name;
 		NestedTimingTree* m_Parent;
 		D_CONTAINERS::DVector<NestedTimingTree*> m_Children;
-		D_CONTAINERS::DUnorderedMap<std::wstring, NestedTimingTree*> m_LUT;
+		D_CONTAINERS::DUnorderedMap<ScopeId, NestedTimingTree*> m_LUT;
 		std::chrono::high_resolution_clock::time_point m_StartTime;
 		std::chrono::high_resolution_clock::time_point m_EndTime;
 		std::chrono::high_resolution_clock::time_point m_LastStartTime;
@@ -386,8 +394,16 @@ namespace Darius::Graphics::Utils::Profiling
 
 	void Update(void)
 	{
+		MainThreadId = std::this_thread::get_id();
 		AwaitingUpdate = false;
 		NestedTimingTree::UpdateTimes();
+
+		// Draining every frame so that the thread buffers do not fill up
+		if (Capturing)
+		{
+			DrainEvents(CapturedEvents);
+			RecordFrame(D_GRAPHICS::GetFrameCount());
+		}
 	}
 
 	void FinishFrame()
@@ -428,16 +444,69 @@ namespace Darius::Graphics::Utils::Profiling
 
 	void BeginBlock(const std::wstring& name, Darius::Graphics::CommandContext* Context)
 	{
-		if (!AwaitingUpdate)
-			NestedTimingTree::PushProfilingMarker(name, Context);
+		BeginBlock(InternScope(name), Context);
+	}
+
+	void BeginBlock(ScopeId scope, Darius::Graphics::CommandContext* Context)
+	{
+		RecordBegin(scope);
+
+		if (!AwaitingUpdate && std::this_thread::get_id() == MainThreadId)
+			NestedTimingTree::PushProfilingMarker(scope, Context);
 	}
 
 	void EndBlock(Darius::Graphics::CommandContext* Context)
 	{
-		if (!AwaitingUpdate)
+		RecordEnd();
+
+		if (!AwaitingUpdate && std::this_thread::get_id() == MainThreadId)
 			NestedTimingTree::PopProfilingMarker(Context);
 	}
 
+	void BeginCapture()
+	{
+		if (Capturing)
+			return;
+
+		// Leftovers of a previous capture
+		CapturedEvents.clear();
+		DrainEvents(CapturedEvents);
+		CapturedEvents.clear();
+
+		Capturing = true;
+		SetEventRecording(true);
+	}
+
+	bool EndCapture(std::wstring const& tracePath)
+	{
+		if (!Capturing)
+			return false;
+
+		Capturing = false;
+		SetEventRecording(false);
+		DrainEvents(CapturedEvents);
+
+		std::ofstream file(tracePath, std::ios::out | std::ios::trunc);
+		if (!file)
+		{
+			D_LOG_WARN_FMT("Could not write profiler capture to {}", WSTR2STR(tracePath));
+			return false;
+		}
+
+		WriteChromeTrace(CapturedEvents, file);
+		CapturedEvents.clear();
+
+		if (auto dropped = GetDroppedEventCount())
+			D_LOG_WARN_FMT("Profiler dropped {} events so far because of full thread buffers", dropped);
+
+		return true;
+	}
+
+	bool IsCapturing()
+	{
+		return Capturing;
+	}
+
 	void Pause()
 	{
 		if (Paused)
@@ -458,9 +527,9 @@ namespace Darius::Graphics::Utils::Profiling
 		return Paused;
 	}
 
-	void NestedTimingTree::PushProfilingMarker(const std::wstring& name, D_GRAPHICS::CommandContext* Context)
+	void NestedTimingTree::PushProfilingMarker(ScopeId scope, D_GRAPHICS::CommandContext* Context)
 	{
-		sm_CurrentNode = sm_CurrentNode->GetChild(name);
+		sm_CurrentNode = sm_CurrentNode->GetChild(scope);
 		sm_CurrentNode->StartTiming(Context);
 	}
 
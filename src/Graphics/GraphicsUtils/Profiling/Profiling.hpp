@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Graphics/CommandContext.hpp"
+#include "EventProfiler.hpp"
 
 #include <Core/Containers/Vector.hpp>
 #include <Utils/Common.hpp>
@@ -26,9 +27,17 @@ namespace Darius::Graphics::Utils::Profiling
 	void Update();
 	void FinishFrame();
 
+	// Blocks are recorded as events on every thread, and also timed in the nested
+	// timing tree when on the main thread
 	void BeginBlock(const std::wstring& name, D_GRAPHICS::CommandContext* Context = nullptr);
+	void BeginBlock(ScopeId scope, D_GRAPHICS::CommandContext* Context = nullptr);
 	void EndBlock(D_GRAPHICS::CommandContext* Context = nullptr);
 
+	// Captures the events of all threads until the capture is ended and written as a Chrome trace
+	void BeginCapture();
+	bool EndCapture(std::wstring const& tracePath);
+	bool IsCapturing();
+
 	void Pause();
 	void Resume();
 	bool IsPaused();
@@ -62,6 +71,15 @@ namespace Darius::Graphics::Utils::Profiling
 	class ScopedTimer
 	{
 	public:
+		// Only for string literals, as the scope is cached by the address of the name
+		ScopedTimer(const wchar_t* name) : m_Context(nullptr)
+		{
+			D_PROFILING::BeginBlock(D_PROFILING::InternScope(name));
+		}
+		ScopedTimer(const wchar_t* name, D_GRAPHICS::CommandContext& Context) : m_Context(&Context)
+		{
+			D_PROFILING::BeginBlock(D_PROFILING::InternScope(name), m_Context);
+		}
 		ScopedTimer(const std::wstring& name) : m_Context(nullptr)
 		{
 			D_PROFILING::BeginBlock(name);
@@ -0,0 +1,455 @@
+#include "Graphics/pch.hpp"
+#include "ShaderCache.hpp"
+
+#include <Core/Containers/Set.hpp>
+#include <Utils/Assert.hpp>
+#include <Utils/Log.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace D_CONTAINERS;
+using namespace D_FILE;
+
+namespace
+{
+	constexpr uint32_t	EntryMagic = 0x43485344; // DSHC
+	constexpr uint32_t	EntryVersion = 1u;
+	constexpr wchar_t	EntryExtension[] = L".dsc";
+
+	struct EntryHeader
+	{
+		uint32_t		Magic;
+		uint32_t		Version;
+		uint64_t		Key;
+		uint64_t		BytecodeSize;
+		uint64_t		PdbSize;
+		uint64_t		ReflectionSize;
+		uint64_t		LogSize;
+	};
+
+	// 64 bit FNV-1a
+	class KeyHasher
+	{
+	public:
+		INLINE void Add(void const* data, size_t size)
+		{
+			auto bytes = reinterpret_cast<uint8_t const*>(data);
+			for (size_t i = 0; i < size; i++)
+			{
+				mHash ^= bytes[i];
+				mHash *= 1099511628211ull;
+			}
+		}
+
+		// Length is hashed too so that concatenations of different strings don't collide
+		template<typename CHAR>
+		INLINE void Add(std::basic_string<CHAR> const& str)
+		{
+			uint64_t length = str.size();
+			Add(&length, sizeof(length));
+			Add(str.data(), str.size() * sizeof(CHAR));
+		}
+
+		INLINE uint64_t Get() const { return mHash; }
+
+	private:
+		uint64_t mHash = 14695981039346656037ull;
+	};
+
+	// Finds the names in #include "name" and #include <name> directives
+	void CollectIncludes(std::string const& source, DVector<std::string>& includes)
+	{
+		std::istringstream stream(source);
+		std::string line;
+		while (std::getline(stream, line))
+		{
+			size_t pos = line.find_first_not_of(" \t");
+			if (pos == std::string::npos || line[pos] != '#')
+				continue;
+
+			pos = line.find_first_not_of(" \t", pos + 1);
+			if (pos == std::string::npos || line.compare(pos, 7, "include") != 0)
+				continue;
+
+			pos = line.find_first_of("\"<", pos + 7);
+			if (pos == std::string::npos)
+				continue;
+
+			char closing = line[pos] == '"' ? '"' : '>';
+			size_t end = line.find(closing, pos + 1);
+			if (end == std::string::npos)
+				continue;
+
+			includes.push_back(line.substr(pos + 1, end - pos - 1));
+		}
+	}
+}
+
+namespace Darius::Graphics::Utils::Shaders
+{
+	ShaderCache::ShaderCache(Config const& config, std::shared_ptr<IShaderCompilerBackend> backend) :
+		mConfig(config),
+		mBackend(backend)
+	{
+		D_ASSERT(mBackend);
+		LoadIndex();
+	}
+
+	void ShaderCache::LoadIndex()
+	{
+		std::error_code ec;
+		std::filesystem::create_directories(mConfig.Directory, ec);
+
+		struct FoundEntry
+		{
+			Key								EntryKey;
+			uint64_t						Size;
+			std::filesystem::file_time_type	WriteTime;
+		};
+
+		DVector<FoundEntry> found;
+		for (auto const& dirEntry : std::filesystem::directory_iterator(mConfig.Directory, ec))
+		{
+			if (!dirEntry.is_regular_file())
+				continue;
+
+			auto const& path = dirEntry.path();
+
+			// Leftovers of interrupted writes
+			if (path.extension() == L".tmp")
+			{
+				std::filesystem::remove(path, ec);
+				continue;
+			}
+
+			if (path.extension() != EntryExtension)
+				continue;
+
+			wchar_t* end = nullptr;
+			auto stem = path.stem().wstring();
+			Key key = std::wcstoull(stem.c_str(), &end, 16);
+			if (stem.empty() || *end != L'\0')
+				continue;
+
+			found.push_back({ key, dirEntry.file_size(ec), dirEntry.last_write_time(ec) });
+		}
+
+		// Most recently written entries are considered most recently used
+		std::sort(found.begin(), found.end(), [](FoundEntry const& a, FoundEntry const& b) { return a.WriteTime < b.WriteTime; });
+
+		std::scoped_lock lock(mMutex);
+		for (auto const& entry : found)
+		{
+			mIndex[entry.EntryKey] = { entry.Size, ++mUseCounter };
+			mTotalSize += entry.Size;
+		}
+
+		EvictLocked();
+	}
+
+	bool ShaderCache::ReadFile(Path const& path, std::string& content) const
+	{
+		if (mConfig.ReadFile)
+			return mConfig.ReadFile(path, content);
+
+		std::ifstream file(path, std::ios::binary);
+		if (!file.good())
+			return false;
+
+		std::stringstream ss;
+		ss << file.rdbuf();
+		content = ss.str();
+		return true;
+	}
+
+	bool ShaderCache::ComputeKey(ShaderCacheRequest const& request, Key& key, DVector<Path>* dependencies) const
+	{
+		return ComputeKeyInternal(request, key, nullptr, dependencies);
+	}
+
+	bool ShaderCache::ComputeKeyInternal(ShaderCacheRequest const& request, Key& key, std::string* source, DVector<Path>* dependencies) const
+	{
+		std::string mainSource;
+		if (request.SourceCode)
+			mainSource.assign(reinterpret_cast<char const*>(request.SourceCode), request.SourceCodeSize);
+		else if (!ReadFile(request.Path, mainSource))
+			return false;
+
+		KeyHasher hasher;
+		hasher.Add(mBackend->GetVersion());
+		hasher.Add(request.EntryPoint);
+		hasher.Add(request.Target);
+		hasher.Add(&request.DisableOptimization, sizeof(request.DisableOptimization));
+
+		uint64_t defineCount = request.Defines.size();
+		hasher.Add(&defineCount, sizeof(defineCount));
+		for (auto const& define : request.Defines)
+			hasher.Add(define);
+
+		hasher.Add(mainSource);
+
+		if (source)
+			*source = mainSource;
+
+		// Walking the include graph depth first, hashing name and content of every included
+		// file once. Names which can't be resolved are hashed alone so that the key still
+		// changes when they appear or disappear.
+		DSet<std::wstring> visited;
+		visited.insert(request.Path.lexically_normal().wstring());
+
+		struct PendingFile
+		{
+			Path							Directory;
+			std::string						Content;
+		};
+
+		DVector<PendingFile> stack;
+		stack.push_back({ request.Path.parent_path(), std::move(mainSource) });
+
+		while (!stack.empty())
+		{
+			auto current = std::move(stack.back());
+			stack.pop_back();
+
+			DVector<std::string> includes;
+			CollectIncludes(current.Content, includes);
+
+			for (auto const& include : includes)
+			{
+				hasher.Add(include);
+
+				Path includePath = include;
+				std::string content;
+				bool resolved = false;
+				Path resolvedPath;
+
+				auto tryResolve = [&](Path const& candidate)
+					{
+						auto normal = candidate.lexically_normal();
+						if (visited.contains(normal.wstring()))
+						{
+							// Already hashed
+							resolved = true;
+							resolvedPath.clear();
+							return true;
+						}
+
+						if (!ReadFile(normal, content))
+							return false;
+
+						resolved = true;
+						resolvedPath = normal;
+						return true;
+					};
+
+				if (!tryResolve(current.Directory / includePath))
+					for (auto const& includeDir : request.IncludeDirectories)
+						if (tryResolve(Path(includeDir) / includePath))
+							break;
+
+				if (!resolved || resolvedPath.empty())
+					continue;
+
+				visited.insert(resolvedPath.wstring());
+				if (dependencies)
+					dependencies->push_back(resolvedPath);
+
+				hasher.Add(content);
+				stack.push_back({ resolvedPath.parent_path(), std::move(content) });
+			}
+		}
+
+		key = hasher.Get();
+		return true;
+	}
+
+	bool ShaderCache::GetOrCompile(ShaderCacheRequest const& request, ShaderCacheBlobs& result, bool* cacheHit)
+	{
+		if (cacheHit)
+			*cacheHit = false;
+
+		Key key;
+		std::string source;
+		if (!ComputeKeyInternal(request, key, &source, nullptr))
+		{
+			result.CompileLog = "Could not read shader source " + request.Path.string();
+			return false;
+		}
+
+		bool found = false;
+		{
+			std::scoped_lock lock(mMutex);
+			auto search = mIndex.find(key);
+			if (search != mIndex.end())
+			{
+				search->second.LastUse = ++mUseCounter;
+				found = true;
+			}
+		}
+
+		if (found)
+		{
+			if (ReadEntry(key, result))
+			{
+				std::scoped_lock lock(mMutex);
+				mStats.Hits++;
+
+				if (cacheHit)
+					*cacheHit = true;
+				return true;
+			}
+
+			// Entry is corrupt or deleted from outside
+			D_LOG_WARN("Dropping unreadable shader cache entry " + GetEntryPath(key).string());
+			Remove(key);
+		}
+
+		result = ShaderCacheBlobs();
+		bool compiled = mBackend->Compile(request, source, result);
+
+		uint64_t size = 0u;
+		bool stored = compiled && WriteEntry(key, result, size);
+
+		std::scoped_lock lock(mMutex);
+		mStats.Misses++;
+
+		if (stored)
+		{
+			// Another thread may have compiled the same shader meanwhile
+			auto search = mIndex.find(key);
+			if (search != mIndex.end())
+				mTotalSize -= search->second.Size;
+
+			mIndex[key] = { size, ++mUseCounter };
+			mTotalSize += size;
+
+			EvictLocked();
+		}
+
+		return compiled;
+	}
+
+	bool ShaderCache::Contains(Key key) const
+	{
+		std::scoped_lock lock(mMutex);
+		return mIndex.contains(key);
+	}
+
+	void ShaderCache::Remove(Key key)
+	{
+		std::scoped_lock lock(mMutex);
+		RemoveLocked(key);
+	}
+
+	void ShaderCache::Clear()
+	{
+		std::scoped_lock lock(mMutex);
+		while (!mIndex.empty())
+			RemoveLocked(mIndex.begin()->first);
+	}
+
+	void ShaderCache::RemoveLocked(Key key)
+	{
+		auto search = mIndex.find(key);
+		if (search == mIndex.end())
+			return;
+
+		mTotalSize -= search->second.Size;
+		mIndex.erase(search);
+
+		std::error_code ec;
+		std::filesystem::remove(GetEntryPath(key), ec);
+	}
+
+	void ShaderCache::EvictLocked()
+	{
+		// The most recent entry is always kept
+		while (mTotalSize > mConfig.MaxSizeBytes && mIndex.size() > 1)
+		{
+			auto oldest = std::min_element(mIndex.begin(), mIndex.end(), [](auto const& a, auto const& b) { return a.second.LastUse < b.second.LastUse; });
+			RemoveLocked(oldest->first);
+			mStats.Evictions++;
+		}
+	}
+
+	Path ShaderCache::GetEntryPath(Key key) const
+	{
+		wchar_t name[17];
+		swprintf_s(name, L"%016llx", (unsigned long long)key);
+		return mConfig.Directory / (std::wstring(name) + EntryExtension);
+	}
+
+	bool ShaderCache::ReadEntry(Key key, ShaderCacheBlobs& result) const
+	{
+		std::ifstream file(GetEntryPath(key), std::ios::binary);
+		if (!file.good())
+			return false;
+
+		EntryHeader header;
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+			return false;
+
+		if (header.Magic != EntryMagic || header.Version != EntryVersion || header.Key != key)
+			return false;
+
+		result.Bytecode.resize(header.BytecodeSize);
+		result.Pdb.resize(header.PdbSize);
+		result.Reflection.resize(header.ReflectionSize);
+		result.CompileLog.resize(header.LogSize);
+
+		file.read(reinterpret_cast<char*>(result.Bytecode.data()), header.BytecodeSize);
+		file.read(reinterpret_cast<char*>(result.Pdb.data()), header.PdbSize);
+		file.read(reinterpret_cast<char*>(result.Reflection.data()), header.ReflectionSize);
+		file.read(result.CompileLog.data(), header.LogSize);
+
+		return (bool)file && !result.Bytecode.empty();
+	}
+
+	bool ShaderCache::WriteEntry(Key key, ShaderCacheBlobs const& blobs, uint64_t& size) const
+	{
+		if (blobs.Bytecode.empty())
+			return false;
+
+		EntryHeader header;
+		header.Magic = EntryMagic;
+		header.Version = EntryVersion;
+		header.Key = key;
+		header.BytecodeSize = blobs.Bytecode.size();
+		header.PdbSize = blobs.Pdb.size();
+		header.ReflectionSize = blobs.Reflection.size();
+		header.LogSize = blobs.CompileLog.size();
+
+		// Writing to a temporary file first so that readers never see partial entries
+		auto entryPath = GetEntryPath(key);
+		auto tempPath = entryPath;
+		tempPath += L"." + std::to_wstring(std::hash<std::thread::id>()(std::this_thread::get_id())) + L".tmp";
+
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.good())
+				return false;
+
+			file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+			file.write(reinterpret_cast<char const*>(blobs.Bytecode.data()), header.BytecodeSize);
+			file.write(reinterpret_cast<char const*>(blobs.Pdb.data()), header.PdbSize);
+			file.write(reinterpret_cast<char const*>(blobs.Reflection.data()), header.ReflectionSize);
+			file.write(blobs.CompileLog.data(), header.LogSize);
+
+			if (!file)
+				return false;
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, entryPath, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+
+		size = sizeof(header) + header.BytecodeSize + header.PdbSize + header.ReflectionSize + header.LogSize;
+		return true;
+	}
+}
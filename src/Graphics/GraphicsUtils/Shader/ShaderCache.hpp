@@ -0,0 +1,131 @@
+#pragma once
+
+#include <Core/Containers/Map.hpp>
+#include <Core/Containers/Vector.hpp>
+#include <Core/Filesystem/Path.hpp>
+#include <Utils/Common.hpp>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#ifndef D_GRAPHICS_SHADERS
+#define D_GRAPHICS_SHADERS Darius::Graphics::Utils::Shaders
+#endif // !D_GRAPHICS_SHADERS
+
+namespace Darius::Graphics::Utils::Shaders
+{
+	struct ShaderCacheRequest
+	{
+		D_FILE::Path						Path;
+		std::wstring						EntryPoint;
+		std::wstring						Target;
+		D_CONTAINERS::DVector<std::wstring>	Defines;
+		D_CONTAINERS::DVector<std::wstring>	IncludeDirectories;
+
+		// Source is read from Path if not provided
+		void const*							SourceCode = nullptr;
+		size_t								SourceCodeSize = 0u;
+
+		bool								DisableOptimization = false;
+	};
+
+	struct ShaderCacheBlobs
+	{
+		D_CONTAINERS::DVector<std::byte>	Bytecode;
+		D_CONTAINERS::DVector<std::byte>	Pdb;
+		D_CONTAINERS::DVector<std::byte>	Reflection;
+		std::string							CompileLog;
+	};
+
+	// The actual compiler behind the cache
+	class IShaderCompilerBackend
+	{
+	public:
+		virtual ~IShaderCompilerBackend() = default;
+
+		// Any string which changes whenever the compiler output may change
+		virtual std::string					GetVersion() const = 0;
+
+		// Source is the already loaded content of the request source
+		virtual bool						Compile(ShaderCacheRequest const& request, std::string const& source, ShaderCacheBlobs& result) = 0;
+	};
+
+	// Content addressed shader compilation cache. Entries are keyed by the source, the
+	// contents of all the files it includes, the defines, the entry point, the target
+	// profile and the compiler version. Compiled blobs are kept in the cache directory,
+	// one file per entry, and an in-memory index of them is used for lookup and eviction.
+	// Lookups and compilations are thread safe.
+	class ShaderCache
+	{
+	public:
+		typedef uint64_t					Key;
+		typedef std::function<bool(D_FILE::Path const& path, std::string& content)> FileReader;
+
+		struct Config
+		{
+			D_FILE::Path					Directory = "CacheData/Shaders";
+
+			// Least recently used entries are evicted when the cache grows larger than this
+			uint64_t						MaxSizeBytes = 256ull << 20;
+
+			// Used to load sources and includes, reads from disk if null
+			FileReader						ReadFile = nullptr;
+		};
+
+		struct Stats
+		{
+			uint32_t						Hits = 0u;
+			uint32_t						Misses = 0u;
+			uint32_t						Evictions = 0u;
+		};
+
+	public:
+		ShaderCache(Config const& config, std::shared_ptr<IShaderCompilerBackend> backend);
+
+		// Fills the blobs from the cache or compiles and stores them. Failed compilations
+		// are not cached. Returns false if the source could not be loaded or compiled.
+		bool								GetOrCompile(ShaderCacheRequest const& request, ShaderCacheBlobs& result, bool* cacheHit = nullptr);
+
+		// Computes the key of the request, optionally returning the resolved include files
+		bool								ComputeKey(ShaderCacheRequest const& request, Key& key, D_CONTAINERS::DVector<D_FILE::Path>* dependencies = nullptr) const;
+
+		bool								Contains(Key key) const;
+		void								Remove(Key key);
+		void								Clear();
+
+		INLINE uint64_t						GetTotalSize() const { std::scoped_lock lock(mMutex); return mTotalSize; }
+		INLINE uint32_t						GetEntryCount() const { std::scoped_lock lock(mMutex); return (uint32_t)mIndex.size(); }
+		INLINE Stats						GetStats() const { std::scoped_lock lock(mMutex); return mStats; }
+		INLINE Config const&				GetConfig() const { return mConfig; }
+		INLINE IShaderCompilerBackend*		GetBackend() const { return mBackend.get(); }
+
+	private:
+		struct IndexEntry
+		{
+			uint64_t						Size;
+			uint64_t						LastUse;
+		};
+
+		void								LoadIndex();
+		bool								ComputeKeyInternal(ShaderCacheRequest const& request, Key& key, std::string* source, D_CONTAINERS::DVector<D_FILE::Path>* dependencies) const;
+		bool								ReadFile(D_FILE::Path const& path, std::string& content) const;
+		D_FILE::Path						GetEntryPath(Key key) const;
+		bool								ReadEntry(Key key, ShaderCacheBlobs& result) const;
+		bool								WriteEntry(Key key, ShaderCacheBlobs const& blobs, uint64_t& size) const;
+
+		// Mutex has to be held
+		void								EvictLocked();
+		void								RemoveLocked(Key key);
+
+		Config								mConfig;
+		std::shared_ptr<IShaderCompilerBackend> mBackend;
+
+		mutable std::mutex					mMutex;
+		D_CONTAINERS::DUnorderedMap<Key, IndexEntry> mIndex;
+		uint64_t							mTotalSize = 0u;
+		uint64_t							mUseCounter = 0u;
+		Stats								mStats;
+	};
+}
@@ -1,6 +1,7 @@
 #include "Graphics/pch.hpp"
 #include "ShaderCompiler.hpp"
 
+#include "ShaderCache.hpp"
 #include "Shaders.hpp"
 
 #include <Core/Filesystem/Path.hpp>
@@ -10,6 +11,7 @@
 #include <d3d12shader.h>    // Shader reflection.
 
 #include <fstream>
+#include <sstream>
 
 using namespace Microsoft::WRL;
 
@@ -125,216 +127,343 @@ namespace Darius::Graphics::Utils
 	static DxcDllSupport gDxcDllHelper;
 	static bool loadedDXIL = false;
 
-	ComPtr<ID3DBlob> CompileShader(
-		std::wstring const& filename,
-		std::wstring const& entrypoint,
-		std::wstring const& target,
-		void const* shaderCode,
-		size_t shaderCodeSize,
-		D_CONTAINERS::DVector<std::wstring> const& defines,
-		D_CONTAINERS::DVector<std::wstring> const& includes,
-		ID3D12ShaderReflection** reflectionData,
-		ID3D12LibraryReflection** libraryReflectionData,
-		std::string& compileLog,
-		bool forceDisableOptimization)
+	namespace
 	{
-		// 
-		// Create compiler and utils.
-		//
-		ComPtr<IDxcUtils> pUtils;
-		ComPtr<IDxcCompiler3> pCompiler;
-		DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&pUtils));
-		DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&pCompiler));
-
+		// DXC objects are not thread safe, each thread keeps its own instances
+		struct DxcThreadContext
+		{
+			ComPtr<IDxcUtils>			Utils;
+			ComPtr<IDxcCompiler3>		Compiler;
+			ComPtr<IDxcIncludeHandler>	IncludeHandler;
+		};
 
-		bool isShaderLibrary = target.starts_with(L"lib");
+		DxcThreadContext& GetDxcThreadContext()
+		{
+			thread_local DxcThreadContext context;
 
-		//
-		// Create default include handler. (You can create your own...)
-		//
-		ComPtr<IDxcIncludeHandler> pIncludeHandler;
-		pUtils->CreateDefaultIncludeHandler(&pIncludeHandler);
+			if (!context.Utils)
+			{
+				D_HR_CHECK(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&context.Utils)));
+				D_HR_CHECK(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&context.Compiler)));
+				D_HR_CHECK(context.Utils->CreateDefaultIncludeHandler(&context.IncludeHandler));
+			}
 
-		auto pdbName = filename + L".pdb";
+			return context;
+		}
 
-		std::vector<LPCWSTR> pszArgs =
+		template<class BlobType>
+		void CopyBlob(BlobType* blob, D_CONTAINERS::DVector<std::byte>& dest)
 		{
-			filename.c_str(),           // Optional shader source file name for error reporting and for PIX shader source view. 
-			L"-T", target.c_str(),      // Target.
-			L"-Fd", pdbName.c_str(),    // The file name of the pdb. This must either be supplied
-			// or the autogenerated file name must be used.
-			L"-enable-16bit-types",		// Enable 16bit data types
-		};
+			if (!blob)
+			{
+				dest.clear();
+				return;
+			}
 
+			dest.resize(blob->GetBufferSize());
+			std::memcpy(dest.data(), blob->GetBufferPointer(), dest.size());
+		}
 
-		if (isShaderLibrary)
+		void WritePdb(std::wstring const& pdbName, D_CONTAINERS::DVector<std::byte> const& pdb)
 		{
-			//pszArgs.push_back(L"-Vd");
-			pszArgs.push_back(L"-Zpc");						// Enable debug information
+			if (pdb.empty())
+				return;
+
+			// Use this file name to save the pdb so that PIX can find it quickly.
+			FILE* fp = NULL;
+			if (_wfopen_s(&fp, pdbName.c_str(), L"wb") != 0 || !fp)
+				return;
+
+			fwrite(pdb.data(), pdb.size(), 1, fp);
+			fclose(fp);
 		}
-		else
+	}
+
+	class DxcCompilerBackend : public Shaders::IShaderCompilerBackend
+	{
+	public:
+		DxcCompilerBackend()
 		{
-			pszArgs.push_back(L"-E");
-			pszArgs.push_back(entrypoint.c_str());			// Marking entrypoint
-			pszArgs.push_back(L"-Zpc");						// Pack matrices in column-major order
+			std::stringstream ss;
+
+			auto& context = GetDxcThreadContext();
+
+			ComPtr<IDxcVersionInfo> versionInfo;
+			if (D_HR_SUCCEEDED(context.Compiler.As(&versionInfo)))
+			{
+				UINT32 major = 0, minor = 0;
+				versionInfo->GetVersion(&major, &minor);
+				ss << "dxc " << major << "." << minor;
+			}
+
+			ComPtr<IDxcVersionInfo2> versionInfo2;
+			if (D_HR_SUCCEEDED(context.Compiler.As(&versionInfo2)))
+			{
+				UINT32 commitCount = 0;
+				char* commitHash = nullptr;
+				if (D_HR_SUCCEEDED(versionInfo2->GetCommitInfo(&commitCount, &commitHash)) && commitHash)
+				{
+					ss << " " << commitCount << " " << commitHash;
+					CoTaskMemFree(commitHash);
+				}
+			}
+
+			// Debug builds pass extra arguments
+#ifdef _DEBUG
+			ss << " debug";
+#endif
+			mVersion = ss.str();
 		}
 
+		virtual std::string GetVersion() const override { return mVersion; }
+
+		virtual bool Compile(Shaders::ShaderCacheRequest const& request, std::string const& source, Shaders::ShaderCacheBlobs& result) override
+		{
+			auto& context = GetDxcThreadContext();
+
+			auto filename = request.Path.wstring();
+			auto pdbName = filename + L".pdb";
+			bool isShaderLibrary = request.Target.starts_with(L"lib");
+			bool disableOptimization = request.DisableOptimization;
+
+			std::vector<LPCWSTR> pszArgs =
+			{
+				filename.c_str(),					// Optional shader source file name for error reporting and for PIX shader source view. 
+				L"-T", request.Target.c_str(),		// Target.
+				L"-Fd", pdbName.c_str(),			// The file name of the pdb. This must either be supplied
+				// or the autogenerated file name must be used.
+				L"-enable-16bit-types",				// Enable 16bit data types
+			};
+
+
+			if (isShaderLibrary)
+			{
+				//pszArgs.push_back(L"-Vd");
+				pszArgs.push_back(L"-Zpc");						// Enable debug information
+			}
+			else
+			{
+				pszArgs.push_back(L"-E");
+				pszArgs.push_back(request.EntryPoint.c_str());	// Marking entrypoint
+				pszArgs.push_back(L"-Zpc");						// Pack matrices in column-major order
+			}
+
 #ifdef _DEBUG
 
-		pszArgs.push_back(L"-Zi");							// Enable debug information
-		//pszArgs.push_back(L"-Zs");						// Enable debug information (slim format)
-		pszArgs.push_back(L"-Qembed_debug");
-		forceDisableOptimization = true;
+			pszArgs.push_back(L"-Zi");							// Enable debug information
+			//pszArgs.push_back(L"-Zs");						// Enable debug information (slim format)
+			pszArgs.push_back(L"-Qembed_debug");
+			disableOptimization = true;
 #endif
 
-		if (forceDisableOptimization)
-		{
-			pszArgs.push_back(L"-Od");							// Disable optimizations
-			pszArgs.push_back(L"-fspv-preserve-bindings");		// Preserving all unused bindings
-			pszArgs.push_back(L"-fspv-preserve-interface");		// Preserving all unused interface
+			if (disableOptimization)
+			{
+				pszArgs.push_back(L"-Od");							// Disable optimizations
+				pszArgs.push_back(L"-fspv-preserve-bindings");		// Preserving all unused bindings
+				pszArgs.push_back(L"-fspv-preserve-interface");		// Preserving all unused interface
 
-		}
+			}
 
+			// Handling defines
+			for (auto const& define : request.Defines)
+			{
+				pszArgs.push_back(L"-D");
+				pszArgs.push_back(define.c_str());
+			}
 
+			// Handle includes
+			for (auto const& include : request.IncludeDirectories)
+			{
+				pszArgs.push_back(L"-I");
+				pszArgs.push_back(include.c_str());
+			}
 
-		// Handling defines
-		for (auto const& define : defines)
-		{
-			pszArgs.push_back(L"-D");
-			pszArgs.push_back(define.c_str());
-		}
+			DxcBuffer Source;
+			Source.Ptr = source.data();
+			Source.Size = source.size();
+			Source.Encoding = DXC_CP_ACP; // Assume BOM says UTF8 or UTF16 or this is ANSI text.
+
+			//
+			// Compile it with specified arguments.
+			//
+			ComPtr<IDxcResult> pResults;
+			HRESULT compRes = context.Compiler->Compile(
+				&Source,							// Source buffer.
+				pszArgs.data(),						// Array of pointers to arguments.
+				(UINT)pszArgs.size(),				// Number of arguments.
+				context.IncludeHandler.Get(),		// User-provided interface to handle #include directives (optional).
+				IID_PPV_ARGS(&pResults)				// Compiler output status, buffer, and errors.
+			);
+
+			D_HR_CHECK(compRes);
+
+			// Fetching the hResult
+			HRESULT hrStatus;
+			pResults->GetStatus(&hrStatus);
+
+			// Note that d3dcompiler would return null if no errors or warnings are present.
+			// IDxcCompiler3::Compile will always return an error buffer, but its length
+			// will be zero if there are no warnings or errors.
+			ComPtr<IDxcBlobUtf8> pErrors = nullptr;
+			pResults->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&pErrors), nullptr);
+			if (pErrors != nullptr && pErrors->GetStringLength() != 0)
+				result.CompileLog = pErrors->GetStringPointer();
+			else
+				result.CompileLog = "";
 
-		// Handle includes
-		for (auto const& include : includes)
-		{
-			pszArgs.push_back(L"-I");
-			pszArgs.push_back(include.c_str());
+			if (!D_HR_SUCCEEDED(hrStatus))
+				return false;
+
+			ComPtr<IDxcBlob> pShader = nullptr;
+			pResults->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&pShader), nullptr);
+			CopyBlob(pShader.Get(), result.Bytecode);
+
+			ComPtr<IDxcBlob> pPDB = nullptr;
+			pResults->GetOutput(DXC_OUT_PDB, IID_PPV_ARGS(&pPDB), nullptr);
+			CopyBlob(pPDB.Get(), result.Pdb);
+			WritePdb(pdbName, result.Pdb);
+
+#ifdef SHADER_REFLECTION
+			ComPtr<IDxcBlob> pReflectionData;
+			pResults->GetOutput(DXC_OUT_REFLECTION, IID_PPV_ARGS(&pReflectionData), nullptr);
+			CopyBlob(pReflectionData.Get(), result.Reflection);
+#endif
+
+			return !result.Bytecode.empty();
 		}
 
-		//
-		// Open source file.  
-		//
-		ComPtr<IDxcBlobEncoding> pSource = nullptr;
-		if (shaderCode == nullptr)
-			pUtils->LoadFile(filename.c_str(), nullptr, pSource.ReleaseAndGetAddressOf());
-		else
-			pUtils->CreateBlobFromPinned(shaderCode, (UINT32)shaderCodeSize, DXC_CP_ACP, pSource.ReleaseAndGetAddressOf());
-		DxcBuffer Source;
-		Source.Ptr = pSource->GetBufferPointer();
-		Source.Size = pSource->GetBufferSize();
-		Source.Encoding = DXC_CP_ACP; // Assume BOM says UTF8 or UTF16 or this is ANSI text.
+	private:
+		std::string							mVersion;
+	};
 
+	static std::shared_ptr<DxcCompilerBackend> gDxcBackend;
+	static std::unique_ptr<Shaders::ShaderCache> gShaderCache;
 
-		//
-		// Compile it with specified arguments.
-		//
-		ComPtr<IDxcResult> pResults;
-		HRESULT compRes = pCompiler->Compile(
-			&Source,                    // Source buffer.
-			pszArgs.data(),             // Array of pointers to arguments.
-			(UINT)pszArgs.size(),       // Number of arguments.
-			pIncludeHandler.Get(),      // User-provided interface to handle #include directives (optional).
-			IID_PPV_ARGS(&pResults)     // Compiler output status, buffer, and errors.
-		);
+	void InitializeShaderCompiler(bool cacheEnabled, D_FILE::Path const& cacheDirectory, uint64_t cacheMaxSizeBytes)
+	{
+		gDxcBackend = std::make_shared<DxcCompilerBackend>();
+
+		if (!cacheEnabled)
+			return;
+
+		Shaders::ShaderCache::Config config;
+		config.Directory = cacheDirectory;
+		config.MaxSizeBytes = cacheMaxSizeBytes;
+		gShaderCache = std::make_unique<Shaders::ShaderCache>(config, gDxcBackend);
+	}
+
+	void ShutdownShaderCompiler()
+	{
+		gShaderCache.reset();
+		gDxcBackend.reset();
+	}
+
+	Shaders::ShaderCache* GetShaderCache()
+	{
+		return gShaderCache.get();
+	}
+
+	ComPtr<ID3DBlob> CompileShader(
+		std::wstring const& filename,
+		std::wstring const& entrypoint,
+		std::wstring const& target,
+		void const* shaderCode,
+		size_t shaderCodeSize,
+		D_CONTAINERS::DVector<std::wstring> const& defines,
+		D_CONTAINERS::DVector<std::wstring> const& includes,
+		ID3D12ShaderReflection** reflectionData,
+		ID3D12LibraryReflection** libraryReflectionData,
+		std::string& compileLog,
+		bool forceDisableOptimization)
+	{
+		D_ASSERT_M(gDxcBackend, "Shader compiler is not initialized");
 
-		D_HR_CHECK(compRes);
+		bool isShaderLibrary = target.starts_with(L"lib");
 
-		// Fetching the hResult
-		HRESULT hrStatus;
-		pResults->GetStatus(&hrStatus);
+		Shaders::ShaderCacheRequest request;
+		request.Path = filename;
+		request.EntryPoint = entrypoint;
+		request.Target = target;
+		request.Defines = defines;
+		request.IncludeDirectories = includes;
+		request.SourceCode = shaderCode;
+		request.SourceCodeSize = shaderCodeSize;
+		request.DisableOptimization = forceDisableOptimization;
+
+		Shaders::ShaderCacheBlobs blobs;
+		bool success;
+		bool cacheHit = false;
+
+		if (gShaderCache)
+			success = gShaderCache->GetOrCompile(request, blobs, &cacheHit);
+		else
+		{
+			std::string source;
+			if (shaderCode)
+				source.assign(reinterpret_cast<char const*>(shaderCode), shaderCodeSize);
+			else
+			{
+				std::ifstream file(filename, std::ios::binary);
+				std::stringstream ss;
+				ss << file.rdbuf();
+				source = ss.str();
+			}
+
+			success = gDxcBackend->Compile(request, source, blobs);
+		}
 
 		//
 		// Print errors if present.
 		//
-		ComPtr<IDxcBlobUtf8> pErrors = nullptr;
-		pResults->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&pErrors), nullptr);
-		// Note that d3dcompiler would return null if no errors or warnings are present.
-		// IDxcCompiler3::Compile will always return an error buffer, but its length
-		// will be zero if there are no warnings or errors.
-		if (pErrors != nullptr && pErrors->GetStringLength() != 0)
+		compileLog = blobs.CompileLog;
+		if (!compileLog.empty())
 		{
-			char* msg = (char*)pErrors->GetBufferPointer();
-			OutputDebugString(msg);
-			if (D_HR_SUCCEEDED(hrStatus))
-				D_LOG_WARN(msg);
+			OutputDebugString(compileLog.c_str());
+			if (success)
+				D_LOG_WARN(compileLog);
 			else
-				D_LOG_ERROR(msg);
-
-			compileLog = msg;
+				D_LOG_ERROR(compileLog);
 		}
-		else
-			compileLog = "";
 
 		// Quit if the compilation failed.
-		if (!D_HR_SUCCEEDED(hrStatus))
+		if (!success)
 		{
 			D_VERIFY(false);
 			return nullptr;
 		}
 
+		// PIX looks for the pdb next to the shader
+		if (cacheHit && !std::filesystem::exists(filename + L".pdb"))
+			WritePdb(filename + L".pdb", blobs.Pdb);
 
-
-		//
-		// Save shader binary.
-		//
-		ComPtr<IDxcBlob> pShader = nullptr;
-		ComPtr<IDxcBlobUtf16> pShaderName = nullptr;
-		pResults->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&pShader), &pShaderName);
-
-
-		//
-		// Save pdb.
-		//
-		ComPtr<IDxcBlob> pPDB = nullptr;
-		ComPtr<IDxcBlobUtf16> pPDBName = nullptr;
-		pResults->GetOutput(DXC_OUT_PDB, IID_PPV_ARGS(&pPDB), &pPDBName);
-		{
-			FILE* fp = NULL;
-
-			if (pPDBName)
-			{
-				std::wstring name = pPDBName->GetStringPointer();
-
-				// Note that if you don't specify -Fd, a pdb name will be automatically generated.
-				// Use this file name to save the pdb so that PIX can find it quickly.
-				_wfopen_s(&fp, pPDBName->GetStringPointer(), L"wb");
-				fwrite(pPDB->GetBufferPointer(), pPDB->GetBufferSize(), 1, fp);
-				fclose(fp);
-			}
-		}
+		auto& context = GetDxcThreadContext();
 
 		//
 		// Reflection Data
 		//
 
 #ifdef SHADER_REFLECTION
-
-
-		if ((isShaderLibrary && libraryReflectionData) || (!isShaderLibrary && reflectionData))
+		if (!blobs.Reflection.empty() && ((isShaderLibrary && libraryReflectionData) || (!isShaderLibrary && reflectionData)))
 		{
-			ComPtr<IDxcBlob> pReflectionData;
+			// Create reflection interface.
+			DxcBuffer ReflectionData;
+			ReflectionData.Encoding = DXC_CP_ACP;
+			ReflectionData.Ptr = blobs.Reflection.data();
+			ReflectionData.Size = blobs.Reflection.size();
 
-			pResults->GetOutput(DXC_OUT_REFLECTION, IID_PPV_ARGS(&pReflectionData), nullptr);
-			if (pReflectionData != nullptr)
+			if (isShaderLibrary)
 			{
-				// Optionally, save reflection blob for later here.
-
-				// Create reflection interface.
-				DxcBuffer ReflectionData;
-				ReflectionData.Encoding = DXC_CP_ACP;
-				ReflectionData.Ptr = pReflectionData->GetBufferPointer();
-				ReflectionData.Size = pReflectionData->GetBufferSize();
-
-				if (isShaderLibrary)
-				{
-					D_HR_CHECK(pUtils->CreateReflection(&ReflectionData, IID_PPV_ARGS(libraryReflectionData)));
-				}
-				else
-					D_HR_CHECK(pUtils->CreateReflection(&ReflectionData, IID_PPV_ARGS(reflectionData)));
+				D_HR_CHECK(context.Utils->CreateReflection(&ReflectionData, IID_PPV_ARGS(libraryReflectionData)));
 			}
+			else
+				D_HR_CHECK(context.Utils->CreateReflection(&ReflectionData, IID_PPV_ARGS(reflectionData)));
 		}
 #endif
 
+		// DXC blobs are binary compatible with ID3DBlob
+		ComPtr<IDxcBlobEncoding> pShader;
+		D_HR_CHECK(context.Utils->CreateBlob(blobs.Bytecode.data(), (UINT32)blobs.Bytecode.size(), DXC_CP_ACP, pShader.GetAddressOf()));
+
 		return ComPtr<ID3DBlob>(reinterpret_cast<ID3DBlob*>(pShader.Get()));
 	}
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Core/Containers/Vector.hpp>
+#include <Core/Filesystem/Path.hpp>
 
 #ifndef D_GRAPHICS_UTILS
 #define D_GRAPHICS_UTILS Darius::Graphics::Utils
@@ -11,8 +12,18 @@ namespace Darius::Graphics::Utils
     namespace Shaders
     {
         struct ShaderMacroContainer;
+        class ShaderCache;
     }
 
+    // Compilation results are kept in a content addressed cache in the cache directory if enabled
+    void                InitializeShaderCompiler(bool cacheEnabled, D_FILE::Path const& cacheDirectory, uint64_t cacheMaxSizeBytes);
+    void                ShutdownShaderCompiler();
+
+    // Null if the cache is disabled
+    Shaders::ShaderCache* GetShaderCache();
+
+    // Thread safe
+
     Microsoft::WRL::ComPtr<ID3DBlob> CompileShader(
         std::wstring const& filename,
         std::wstring const& entrypoint,
@@ -90,6 +90,7 @@ namespace Darius::Graphics::Utils::Shaders
 				.ShaderType = shaderType
 			};
 
+			std::lock_guard<std::mutex> LockGuard(mShaderCacheMutex);
 			auto cacheSearch = mShaderCache.find(cacheKey);
 			if (cacheSearch != mShaderCache.end())
 			{
@@ -129,6 +130,7 @@ namespace Darius::Graphics::Utils::Shaders
 
 			if (success)
 			{
+				std::lock_guard<std::mutex> LockGuard(mShaderCacheMutex);
 				mShaderCache[cacheKey] = shader;
 				return shader;
 			}
@@ -163,6 +165,8 @@ namespace Darius::Graphics::Utils::Shaders
 		D3D_SHADER_MODEL	mShaderModel;
 		std::wstring		mShaderModelStr;
 
+		// Shaders can be compiled from multiple threads
+		std::mutex			mShaderCacheMutex;
 		D_CONTAINERS::DUnorderedMap<ShaderCacheKey, std::shared_ptr<CompiledShader>, std::hash<ShaderCacheKey>> mShaderCache;
 
 		friend AsyncShaderCompileTask<VertexShader>;
@@ -196,7 +200,10 @@ namespace Darius::Graphics::Utils::Shaders
 				bool success = mFactory->CompileShaderInternal(mShader.get(), mFactory->GetCompiler(shaderType), mShaderCode ? mShaderCode->data() : nullptr, mShaderCode ? mShaderCode->size() : 0, shaderType);
 
 				if(success)
+				{
+					std::lock_guard<std::mutex> LockGuard(mFactory->mShaderCacheMutex);
 					mFactory->mShaderCache[mCacheKey] = mShader;
+				}
 			}
 
 			if (mCallback)
@@ -0,0 +1,460 @@
+#define BOOST_TEST_MODULE GraphicsTests
+#define BOOST_TEST_DYN_LINK
+
+#include <GraphicsUtils/Buffers/DDSMipLayout.hpp>
+#include <GraphicsUtils/Profiling/EventProfiler.hpp>
+#include <GraphicsUtils/Shader/ShaderCache.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <thread>
+
+using namespace D_CONTAINERS;
+using namespace D_GRAPHICS_BUFFERS;
+using namespace D_GRAPHICS_SHADERS;
+using namespace D_PROFILING;
+
+namespace
+{
+	// Echoes the source as bytecode and counts compilations
+	class StubCompilerBackend : public IShaderCompilerBackend
+	{
+	public:
+		virtual std::string GetVersion() const override { return Version; }
+
+		virtual bool Compile(ShaderCacheRequest const& request, std::string const& source, ShaderCacheBlobs& result) override
+		{
+			CompileCount++;
+			if (source.find("error") != std::string::npos)
+			{
+				result.CompileLog = "error";
+				return false;
+			}
+
+			result.Bytecode.resize(source.size());
+			std::memcpy(result.Bytecode.data(), source.data(), source.size());
+			result.Reflection.resize(16);
+			return true;
+		}
+
+		std::string			Version = "stub 1.0";
+		uint32_t			CompileCount = 0u;
+	};
+
+	struct ShaderCacheFixture
+	{
+		ShaderCacheFixture()
+		{
+			Directory = std::filesystem::temp_directory_path() / "DariusShaderCacheTests";
+			std::filesystem::remove_all(Directory);
+
+			Backend = std::make_shared<StubCompilerBackend>();
+
+			Files[L"Shaders/Main.hlsl"] = "#include \"Common.hlsli\"\nfloat4 main() : SV_Target { return Value; }\n";
+			Files[L"Shaders/Common.hlsli"] = "#include <Utils/Math.hlsli>\nstatic float4 Value = 1;\n";
+			Files[L"Shaders/Utils/Math.hlsli"] = "#include \"../Common.hlsli\"\n";
+		}
+
+		~ShaderCacheFixture()
+		{
+			std::filesystem::remove_all(Directory);
+		}
+
+		std::unique_ptr<ShaderCache> CreateCache(uint64_t maxSize = 1ull << 20)
+		{
+			ShaderCache::Config config;
+			config.Directory = Directory;
+			config.MaxSizeBytes = maxSize;
+			config.ReadFile = [this](D_FILE::Path const& path, std::string& content)
+				{
+					auto search = Files.find(path.lexically_normal().generic_wstring());
+					if (search == Files.end())
+						return false;
+					content = search->second;
+					return true;
+				};
+			return std::make_unique<ShaderCache>(config, Backend);
+		}
+
+		ShaderCacheRequest CreateRequest(std::wstring const& path = L"Shaders/Main.hlsl")
+		{
+			ShaderCacheRequest request;
+			request.Path = path;
+			request.EntryPoint = L"main";
+			request.Target = L"ps_6_6";
+			request.IncludeDirectories = { L"Shaders" };
+			return request;
+		}
+
+		D_FILE::Path								Directory;
+		std::shared_ptr<StubCompilerBackend>		Backend;
+		std::map<std::wstring, std::string>			Files;
+	};
+}
+
+BOOST_FIXTURE_TEST_SUITE(ShaderCacheTests, ShaderCacheFixture)
+
+BOOST_AUTO_TEST_CASE(KeyTracksIncludes)
+{
+	auto cache = CreateCache();
+	auto request = CreateRequest();
+
+	ShaderCache::Key key;
+	DVector<D_FILE::Path> dependencies;
+	BOOST_TEST(cache->ComputeKey(request, key, &dependencies));
+	BOOST_TEST(dependencies.size() == 2u);
+
+	ShaderCache::Key sameKey;
+	BOOST_TEST(cache->ComputeKey(request, sameKey));
+	BOOST_TEST(key == sameKey);
+
+	// Include content
+	Files[L"Shaders/Utils/Math.hlsli"] += "// changed\n";
+	ShaderCache::Key includeKey;
+	BOOST_TEST(cache->ComputeKey(request, includeKey));
+	BOOST_TEST(key != includeKey);
+
+	// Defines, entry point, target and compiler version
+	auto defineRequest = request;
+	defineRequest.Defines = { L"FOO=1" };
+	ShaderCache::Key defineKey;
+	BOOST_TEST(cache->ComputeKey(defineRequest, defineKey));
+	BOOST_TEST(includeKey != defineKey);
+
+	auto targetRequest = request;
+	targetRequest.Target = L"ps_6_5";
+	ShaderCache::Key targetKey;
+	BOOST_TEST(cache->ComputeKey(targetRequest, targetKey));
+	BOOST_TEST(includeKey != targetKey);
+
+	Backend->Version = "stub 2.0";
+	ShaderCache::Key versionKey;
+	BOOST_TEST(cache->ComputeKey(request, versionKey));
+	BOOST_TEST(includeKey != versionKey);
+
+	BOOST_TEST(!cache->ComputeKey(CreateRequest(L"Shaders/Missing.hlsl"), key));
+}
+
+BOOST_AUTO_TEST_CASE(HitsPersistAcrossInstances)
+{
+	auto request = CreateRequest();
+
+	{
+		auto cache = CreateCache();
+		ShaderCacheBlobs blobs;
+		bool hit = true;
+		BOOST_TEST(cache->GetOrCompile(request, blobs, &hit));
+		BOOST_TEST(!hit);
+		BOOST_TEST(blobs.Bytecode.size() == Files[L"Shaders/Main.hlsl"].size());
+
+		BOOST_TEST(cache->GetOrCompile(request, blobs, &hit));
+		BOOST_TEST(hit);
+		BOOST_TEST(Backend->CompileCount == 1u);
+	}
+
+	// Index is rebuilt from the cache directory
+	auto cache = CreateCache();
+	BOOST_TEST(cache->GetEntryCount() == 1u);
+
+	ShaderCacheBlobs blobs;
+	bool hit = false;
+	BOOST_TEST(cache->GetOrCompile(request, blobs, &hit));
+	BOOST_TEST(hit);
+	BOOST_TEST(blobs.Reflection.size() == 16u);
+	BOOST_TEST(Backend->CompileCount == 1u);
+
+	// Failed compilations are not cached
+	Files[L"Shaders/Broken.hlsl"] = "error";
+	BOOST_TEST(!cache->GetOrCompile(CreateRequest(L"Shaders/Broken.hlsl"), blobs));
+	BOOST_TEST(!cache->GetOrCompile(CreateRequest(L"Shaders/Broken.hlsl"), blobs));
+	BOOST_TEST(Backend->CompileCount == 3u);
+	BOOST_TEST(cache->GetEntryCount() == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(EvictsLeastRecentlyUsed)
+{
+	for (int i = 0; i < 3; i++)
+		Files[L"Shaders/S" + std::to_wstring(i) + L".hlsl"] = std::string(1000, 'a' + (char)i);
+
+	// Room for two entries
+	auto cache = CreateCache(2500u);
+	ShaderCacheBlobs blobs;
+	ShaderCache::Key key0, key1, key2;
+	cache->ComputeKey(CreateRequest(L"Shaders/S0.hlsl"), key0);
+	cache->ComputeKey(CreateRequest(L"Shaders/S1.hlsl"), key1);
+	cache->ComputeKey(CreateRequest(L"Shaders/S2.hlsl"), key2);
+
+	cache->GetOrCompile(CreateRequest(L"Shaders/S0.hlsl"), blobs);
+	cache->GetOrCompile(CreateRequest(L"Shaders/S1.hlsl"), blobs);
+
+	// Touching the first one so that the second one is the oldest
+	cache->GetOrCompile(CreateRequest(L"Shaders/S0.hlsl"), blobs);
+	cache->GetOrCompile(CreateRequest(L"Shaders/S2.hlsl"), blobs);
+
+	BOOST_TEST(cache->Contains(key0));
+	BOOST_TEST(!cache->Contains(key1));
+	BOOST_TEST(cache->Contains(key2));
+	BOOST_TEST(cache->GetStats().Evictions == 1u);
+	BOOST_TEST(cache->GetTotalSize() <= 2500u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+	// Header of a DDS file with the given four cc, followed by the DX10 header if the format is given
+	DVector<uint32_t> CreateDDSHeader(uint32_t width, uint32_t height, uint32_t mips, uint32_t fourCC, uint32_t dx10Format = 0u)
+	{
+		DVector<uint32_t> words(1 + 31, 0u);
+		words[0] = 0x20534444;		// Magic
+		words[1] = 124;				// Header size
+		words[2] = 0x1007 | 0x20000;	// Caps, height, width, pixel format and mip count
+		words[3] = height;
+		words[4] = width;
+		words[7] = mips;
+		words[19] = 32;				// Pixel format size
+		words[20] = 0x4;			// Four cc
+		words[21] = fourCC;
+
+		if (dx10Format)
+		{
+			words.push_back(dx10Format);
+			words.push_back(3);		// Texture 2D
+			words.push_back(0);
+			words.push_back(1);		// Array size
+			words.push_back(0);
+		}
+		return words;
+	}
+
+	constexpr uint32_t FourCC(char const* cc)
+	{
+		return (uint32_t)cc[0] | ((uint32_t)cc[1] << 8) | ((uint32_t)cc[2] << 16) | ((uint32_t)cc[3] << 24);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(DDSMipLayoutTests)
+
+BOOST_AUTO_TEST_CASE(BlockCompressedMipChain)
+{
+	// 256x128 BC1 with the full chain
+	auto header = CreateDDSHeader(256u, 128u, 9u, FourCC("DXT1"));
+	size_t headerSize = header.size() * sizeof(uint32_t);
+
+	DDSMipLayout layout;
+	BOOST_TEST(ParseDDSMipLayout(header.data(), headerSize, ~0ull, layout));
+	BOOST_TEST(layout.Format == DXGI_FORMAT_BC1_UNORM);
+	BOOST_TEST(layout.GetMipCount() == 9u);
+	BOOST_TEST(layout.IsStreamable());
+
+	BOOST_TEST(layout.Mips[0].Offset == headerSize);
+	BOOST_TEST(layout.Mips[0].RowPitch == 64u * 8u);
+	BOOST_TEST(layout.Mips[0].Size == 64u * 32u * 8u);
+	BOOST_TEST(layout.Mips[1].Offset == headerSize + layout.Mips[0].Size);
+
+	// Mips smaller than a block still take a whole block
+	BOOST_TEST(layout.Mips[8].Width == 1u);
+	BOOST_TEST(layout.Mips[8].Height == 1u);
+	BOOST_TEST(layout.Mips[8].Size == 8u);
+
+	uint64_t total = 0u;
+	for (auto const& mip : layout.Mips)
+		total += mip.Size;
+	BOOST_TEST(layout.GetRangeOffset(0u) == headerSize);
+	BOOST_TEST(layout.GetRangeSize(0u) == total);
+	BOOST_TEST(layout.GetRangeSize(8u) == 8u);
+
+	BOOST_TEST(layout.GetFirstMipWithin(256u) == 0u);
+	BOOST_TEST(layout.GetFirstMipWithin(64u) == 2u);
+	BOOST_TEST(layout.GetFirstMipWithin(0u) == 8u);
+
+	// Every mip has to be in the file
+	BOOST_TEST(ParseDDSMipLayout(header.data(), headerSize, headerSize + total, layout));
+	BOOST_TEST(!ParseDDSMipLayout(header.data(), headerSize, headerSize + total - 1u, layout));
+}
+
+BOOST_AUTO_TEST_CASE(DX10Header)
+{
+	auto header = CreateDDSHeader(64u, 64u, 7u, FourCC("DX10"), DXGI_FORMAT_R8G8B8A8_UNORM);
+	size_t headerSize = header.size() * sizeof(uint32_t);
+	BOOST_TEST(headerSize == DDSMipLayout::MaxHeaderSize);
+
+	DDSMipLayout layout;
+	BOOST_TEST(ParseDDSMipLayout(header.data(), headerSize, ~0ull, layout));
+	BOOST_TEST(layout.Format == DXGI_FORMAT_R8G8B8A8_UNORM);
+	BOOST_TEST(layout.Mips[0].Offset == headerSize);
+	BOOST_TEST(layout.Mips[0].RowPitch == 256u);
+	BOOST_TEST(layout.Mips[6].Size == 4u);
+
+	// The DX10 header has to be in the data
+	BOOST_TEST(!ParseDDSMipLayout(header.data(), headerSize - 4u, ~0ull, layout));
+}
+
+BOOST_AUTO_TEST_CASE(RejectsInvalidFiles)
+{
+	auto header = CreateDDSHeader(64u, 64u, 1u, FourCC("DXT5"));
+	size_t headerSize = header.size() * sizeof(uint32_t);
+
+	DDSMipLayout layout;
+	BOOST_TEST(ParseDDSMipLayout(header.data(), headerSize, ~0ull, layout));
+
+	// Single mip textures have nothing to stream
+	BOOST_TEST(!layout.IsStreamable());
+
+	BOOST_TEST(!ParseDDSMipLayout(header.data(), headerSize - 1u, ~0ull, layout));
+
+	auto badMagic = header;
+	badMagic[0] = 0u;
+	BOOST_TEST(!ParseDDSMipLayout(badMagic.data(), headerSize, ~0ull, layout));
+
+	auto badFormat = CreateDDSHeader(64u, 64u, 1u, FourCC("XXXX"));
+	BOOST_TEST(!ParseDDSMipLayout(badFormat.data(), headerSize, ~0ull, layout));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+	struct EventRecordingFixture
+	{
+		EventRecordingFixture()
+		{
+			DVector<CapturedEvent> leftovers;
+			DrainEvents(leftovers);
+			SetEventRecording(true);
+		}
+
+		~EventRecordingFixture()
+		{
+			SetEventRecording(false);
+		}
+	};
+}
+
+BOOST_FIXTURE_TEST_SUITE(EventProfilerTests, EventRecordingFixture)
+
+BOOST_AUTO_TEST_CASE(MultithreadedScopes)
+{
+	constexpr uint32_t threadCount = 8u;
+	constexpr uint32_t iterations = 20000u;
+
+	auto outer = InternScope(L"Outer");
+	auto inner = InternScope(L"Inner");
+	BOOST_TEST(outer != inner);
+	BOOST_TEST(InternScope(std::wstring(L"Outer")) == outer);
+
+	uint64_t droppedBefore = GetDroppedEventCount();
+
+	std::atomic_uint32_t running = threadCount;
+	DVector<std::thread> threads;
+	for (uint32_t t = 0u; t < threadCount; t++)
+	{
+		threads.emplace_back([&]()
+			{
+				for (uint32_t i = 0u; i < iterations; i++)
+				{
+					RecordBegin(outer);
+					RecordBegin(inner);
+					RecordEnd();
+					RecordEnd();
+				}
+				running--;
+			});
+	}
+
+	// Draining while the threads are recording
+	DVector<CapturedEvent> events;
+	while (running.load() > 0u)
+		DrainEvents(events);
+
+	for (auto& thread : threads)
+		thread.join();
+	DrainEvents(events);
+
+	// Every thread has balanced and ordered scopes
+	std::map<uint32_t, DVector<ScopeId>> stacks;
+	std::map<uint32_t, uint32_t> begins;
+	std::map<uint32_t, int64_t> lastTimestamps;
+	for (auto const& captured : events)
+	{
+		auto const& event = captured.Event;
+		auto& stack = stacks[captured.Thread];
+
+		BOOST_TEST_REQUIRE(event.Timestamp >= lastTimestamps[captured.Thread]);
+		lastTimestamps[captured.Thread] = event.Timestamp;
+
+		if (event.Type == ProfileEventType::Begin)
+		{
+			BOOST_TEST_REQUIRE((event.Scope == (stack.empty() ? outer : inner)));
+			stack.push_back(event.Scope);
+			begins[captured.Thread]++;
+		}
+		else if (event.Type == ProfileEventType::End)
+		{
+			BOOST_TEST_REQUIRE(!stack.empty());
+			stack.pop_back();
+		}
+	}
+
+	BOOST_TEST(stacks.size() == threadCount);
+	uint64_t recordedBegins = 0u;
+	for (auto const& [thread, stack] : stacks)
+	{
+		BOOST_TEST(stack.empty());
+		recordedBegins += begins[thread];
+	}
+
+	// Only whole scopes are lost, if a buffer filled up between the drains
+	uint64_t dropped = GetDroppedEventCount() - droppedBefore;
+	BOOST_TEST(recordedBegins + dropped == (uint64_t)threadCount * iterations * 2u);
+}
+
+BOOST_AUTO_TEST_CASE(UnmatchedScopesAreNotRecorded)
+{
+	auto scope = InternScope(L"Toggled");
+
+	// Begin while disabled must not produce an end
+	SetEventRecording(false);
+	RecordBegin(scope);
+	SetEventRecording(true);
+	RecordBegin(scope);
+	RecordEnd();
+	RecordEnd();
+
+	DVector<CapturedEvent> events;
+	DrainEvents(events);
+	BOOST_TEST(events.size() == 2u);
+	BOOST_TEST((events[0].Event.Type == ProfileEventType::Begin));
+	BOOST_TEST((events[1].Event.Type == ProfileEventType::End));
+}
+
+BOOST_AUTO_TEST_CASE(ChromeTraceExport)
+{
+	RecordFrame(7u);
+	RecordBegin(InternScope(L"Update \"World\""));
+	RecordBegin(InternScope(L"Physics"));
+	RecordEnd();
+	RecordEnd();
+
+	// Still open, left out of the trace
+	RecordBegin(InternScope(L"Open"));
+
+	DVector<CapturedEvent> events;
+	DrainEvents(events);
+	RecordEnd();
+
+	std::ostringstream trace;
+	WriteChromeTrace(events, trace);
+	auto json = trace.str();
+
+	BOOST_TEST(json.find("\"traceEvents\"") != std::string::npos);
+	BOOST_TEST(json.find("\"name\":\"Update \\\"World\\\"\",\"ph\":\"X\"") != std::string::npos);
+	BOOST_TEST(json.find("\"name\":\"Physics\",\"ph\":\"X\"") != std::string::npos);
+	BOOST_TEST(json.find("\"name\":\"Frame 7\",\"ph\":\"i\"") != std::string::npos);
+	BOOST_TEST(json.find("Open") == std::string::npos);
+	BOOST_TEST(json.find("thread_name") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
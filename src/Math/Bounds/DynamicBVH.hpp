@@ -7,9 +7,11 @@
 #include "Math/Camera/Frustum.hpp"
 
 #include <Core/Containers/List.hpp>
-#include <Core/Memory/Allocators/PagedAllocator.hpp>
+#include <Core/Memory/Allocators/SlabAllocator.hpp>
 #include <Core/MultiThreading/RWLock.hpp>
 
+#include <algorithm>
+
 #ifndef D_MATH_BOUNDS
 #define D_MATH_BOUNDS Darius::Math::Bounds
 #endif
@@ -45,6 +47,9 @@ namespace Darius::Math::Bounds
 		typedef std::function<bool(T const&, Aabb const&)> QueryResult;
 
 	public:
+		// Runs both functions and returns when both are done, on other threads if it likes
+		typedef std::function<void(std::function<void()> const&, std::function<void()> const&)> ForkJoinFunction;
+
 		struct ID
 		{
 			Node* node = nullptr;
@@ -79,6 +84,12 @@ namespace Darius::Math::Bounds
 				return edges.Sum() + edges.Mult();
 			}
 
+			INLINE float GetSurfaceArea() const
+			{
+				const Vector3 edges = GetLength();
+				return 2.f * (edges.GetX() * edges.GetY() + edges.GetY() * edges.GetZ() + edges.GetZ() * edges.GetX());
+			}
+
 			INLINE bool IsNotEqualTo(const Volume& b) const
 			{
 				return !Aabb.Equals(b.Aabb);
@@ -163,6 +174,9 @@ namespace Darius::Math::Bounds
 			};
 			Node* Child1;
 
+			// Equal to the tree's mark while an internal node waits for a batch refit
+			uint32_t RefitMark = 0;
+
 			INLINE Node*& GetChild(int index /*0 or 1*/)
 			{
 				if(index == 0)
@@ -218,18 +232,33 @@ namespace Darius::Math::Bounds
 			}
 		};
 
-		D_MEMORY::PagedAllocator<Node> mNodeAllocator;
+		D_MEMORY::SlabAllocator<Node> mNodeAllocator;
 		// Fields
 		Node* mBvhRoot = nullptr;
 		int mLkhd = -1;
 		int mTotalLeaves = 0;
 		uint32_t mOpath = 0;
 		uint32_t mIndex = 0;
+		uint32_t mRefitMark = 0;
+		float mBuiltSahCost = 0.f;
+
+		// Cost the batch updates compare the tree to, from the last rebuild or the first look at a tree built by insertion
+		float mReferenceSahCost = 0.f;
+		int mChangedSinceCostCheck = 0;
+
+		ForkJoinFunction mForkJoin;
 		D_CORE_THREADING::RWLock mRWLock;
 
 		enum
 		{
-			ALLOCA_STACK_SIZE = 128
+			ALLOCA_STACK_SIZE = 128,
+
+			// Subtrees smaller than these are built and refitted on the calling thread
+			PARALLEL_BUILD_LEAVES = 4096,
+			PARALLEL_REFIT_DEPTH = 4,
+
+			// The cost is looked at once this fraction of the leaves changed, as it visits the whole tree
+			COST_CHECK_FRACTION = 8
 		};
 
 		void DeleteNodeInternal(Node* node)
@@ -636,6 +665,199 @@ namespace Darius::Math::Bounds
 			return (volume);
 		}
 
+		// Leaves copied next to each other with their centers, for the rebuild to scan them quickly
+		struct BuildLeaf
+		{
+			Volume Box;
+			Vector3 Center;
+			Node* Leaf;
+		};
+
+		// Splits the leaves at the cheapest bin boundary by surface area heuristic, along the widest axis of their centers
+		Node* BuildBinnedSah(BuildLeaf* leaves, int count)
+		{
+			static constexpr int binCount = 16;
+
+			if(count == 1)
+				return leaves[0].Leaf;
+
+			Volume volume = leaves[0].Box;
+			Vector3 centerMin = leaves[0].Center;
+			Vector3 centerMax = centerMin;
+			for(int i = 1; i < count; ++i)
+			{
+				volume = volume.Merge(leaves[i].Box);
+				centerMin = D_MATH::Min(centerMin, leaves[i].Center);
+				centerMax = D_MATH::Max(centerMax, leaves[i].Center);
+			}
+
+			const Vector3 centerExtents = centerMax - centerMin;
+			int axis = 0;
+			if(centerExtents._GetFast(1) > centerExtents._GetFast(axis))
+				axis = 1;
+			if(centerExtents._GetFast(2) > centerExtents._GetFast(axis))
+				axis = 2;
+
+			const float axisMin = centerMin._GetFast(axis);
+			const float axisExtents = centerExtents._GetFast(axis);
+
+			int partition = count / 2;
+
+			if(count > 2 && axisExtents > 0.f)
+			{
+				const float scale = (float)binCount / axisExtents;
+				auto getBin = [&](BuildLeaf const& leaf)
+					{
+						return D_MATH::Min(binCount - 1, (int)((leaf.Center._GetFast(axis) - axisMin) * scale));
+					};
+
+				Volume binVolumes[binCount];
+				int binCounts[binCount] = {};
+				for(int i = 0; i < count; ++i)
+				{
+					const int bin = getBin(leaves[i]);
+					binVolumes[bin] = binCounts[bin]++ == 0 ? leaves[i].Box : binVolumes[bin].Merge(leaves[i].Box);
+				}
+
+				// Cost of the right side of each split, the split before bin i
+				float rightCosts[binCount] = {};
+				Volume rightVolume;
+				int rightCount = 0;
+				for(int i = binCount - 1; i > 0; --i)
+				{
+					if(binCounts[i] > 0)
+					{
+						rightVolume = rightCount == 0 ? binVolumes[i] : rightVolume.Merge(binVolumes[i]);
+						rightCount += binCounts[i];
+					}
+					rightCosts[i] = rightCount > 0 ? rightCount * rightVolume.GetSurfaceArea() : 0.f;
+				}
+
+				float bestCost = INFINITY;
+				int bestSplit = -1;
+				Volume leftVolume;
+				int leftCount = 0;
+				for(int i = 1; i < binCount; ++i)
+				{
+					if(binCounts[i - 1] > 0)
+					{
+						leftVolume = leftCount == 0 ? binVolumes[i - 1] : leftVolume.Merge(binVolumes[i - 1]);
+						leftCount += binCounts[i - 1];
+					}
+
+					if(leftCount == 0 || leftCount == count)
+						continue;
+
+					const float cost = leftCount * leftVolume.GetSurfaceArea() + rightCosts[i];
+					if(cost < bestCost)
+					{
+						bestCost = cost;
+						bestSplit = i;
+					}
+				}
+
+				if(bestSplit > 0)
+				{
+					partition = (int)(std::partition(leaves, leaves + count, [&](BuildLeaf const& leaf)
+						{
+							return getBin(leaf) < bestSplit;
+						}) - leaves);
+				}
+			}
+
+			// All centers in one place
+			if(partition == 0 || partition == count)
+				partition = count / 2;
+
+			Node* node = CreateNodeWithVolumeInternal(nullptr, volume, {});
+			if(mForkJoin && count >= PARALLEL_BUILD_LEAVES)
+			{
+				// The two sides own disjoint ranges of the leaves
+				mForkJoin([&]() { node->Child0 = BuildBinnedSah(leaves, partition); },
+					[&]() { node->Child1 = BuildBinnedSah(leaves + partition, count - partition); });
+			}
+			else
+			{
+				node->Child0 = BuildBinnedSah(leaves, partition);
+				node->Child1 = BuildBinnedSah(leaves + partition, count - partition);
+			}
+			node->Child0->Parent = node;
+			node->Child1->Parent = node;
+			return node;
+		}
+
+		void RebuildInternal()
+		{
+			if(!mBvhRoot)
+				return;
+
+			D_CONTAINERS::DVector<Node*> leaves;
+			leaves.reserve(mTotalLeaves);
+			FetchLeaves(mBvhRoot, leaves);
+
+			D_CONTAINERS::DVector<BuildLeaf> buildLeaves;
+			buildLeaves.reserve(leaves.size());
+			for(Node* leaf : leaves)
+				buildLeaves.push_back({ leaf->Volume, leaf->Volume.GetCenter(), leaf });
+
+			mBvhRoot = BuildBinnedSah(buildLeaves.data(), (int)buildLeaves.size());
+			mBvhRoot->Parent = nullptr;
+			mBuiltSahCost = ComputeSahCostInternal();
+			mReferenceSahCost = mBuiltSahCost;
+			mChangedSinceCostCheck = 0;
+		}
+
+		// Children are refitted before their parents, visiting only the marked nodes
+		void RefitMarked(Node* node, int depth = 0)
+		{
+			auto refitChild = [this, node, depth](int i)
+				{
+					Node* child = node->GetChild(i);
+					if(child->IsInternal() && child->RefitMark == mRefitMark)
+						RefitMarked(child, depth + 1);
+				};
+
+			// Subtrees are disjoint, the top levels of large trees are split among the threads
+			if(mForkJoin && depth < PARALLEL_REFIT_DEPTH && mTotalLeaves >= PARALLEL_BUILD_LEAVES)
+				mForkJoin([&]() { refitChild(0); }, [&]() { refitChild(1); });
+			else
+			{
+				refitChild(0);
+				refitChild(1);
+			}
+
+			node->Volume = node->Child0->Volume.Merge(node->Child1->Volume);
+		}
+
+		// Sum of the node areas relative to the root's, the expected node visits of a ray hitting the root
+		float ComputeSahCostInternal() const
+		{
+			if(!mBvhRoot)
+				return 0.f;
+
+			const float rootArea = mBvhRoot->Volume.GetSurfaceArea();
+			if(rootArea <= 0.f)
+				return 0.f;
+
+			float area = 0.f;
+			D_CONTAINERS::DVector<Node const*> stack;
+			stack.push_back(mBvhRoot);
+			while(!stack.empty())
+			{
+				Node const* node = stack.back();
+				stack.pop_back();
+
+				area += node->Volume.GetSurfaceArea();
+				if(node->IsInternal())
+				{
+					stack.push_back(node->Child0);
+					stack.push_back(node->Child1);
+				}
+			}
+
+			return area / rootArea;
+		}
+
 	public:
 		// Methods
 		void Clear()
@@ -648,6 +870,18 @@ namespace Darius::Math::Bounds
 			}
 			mLkhd = -1;
 			mOpath = 0;
+			mTotalLeaves = 0;
+			mBuiltSahCost = 0.f;
+			mReferenceSahCost = 0.f;
+			mChangedSinceCostCheck = 0;
+		}
+
+		// Lets the rebuilds and refits of large trees run on other threads, serial when empty
+		void SetForkJoin(ForkJoinFunction const& forkJoin)
+		{
+			D_CORE_THREADING::RWLockWrite lock(mRWLock);
+
+			mForkJoin = forkJoin;
 		}
 
 		bool IsEmpty() const
@@ -764,6 +998,87 @@ namespace Darius::Math::Bounds
 			return true;
 		}
 
+		struct LeafUpdate
+		{
+			ID Id;
+			Aabb Box;
+		};
+
+		// Resizes the leaves in place and refits each of their ancestors once, keeping the tree's
+		// topology. Once enough leaves changed, rebuilds the tree if refitting made its cost more than
+		// rebuildCostRatio times the reference cost. Returns the number of leaves changed.
+		int UpdateBatch(LeafUpdate const* updates, int count, float rebuildCostRatio = 1.5f)
+		{
+			D_CORE_THREADING::RWLockWrite lock(mRWLock);
+
+			// Marks of earlier batches are never equal to the new one, save for wrapping around
+			if(++mRefitMark == 0)
+				mRefitMark = 1;
+
+			int changed = 0;
+			for(int i = 0; i < count; ++i)
+			{
+				auto const& update = updates[i];
+				if(!update.Id.IsValid())
+					continue;
+
+				Node* leaf = update.Id.node;
+				if(leaf->Volume.Aabb.NearEquals(update.Box, 0.00001f))
+					continue;
+
+				leaf->Volume = Volume {update.Box};
+				++changed;
+
+				// Ancestors above a marked one are marked already
+				for(Node* node = leaf->Parent; node && node->RefitMark != mRefitMark; node = node->Parent)
+					node->RefitMark = mRefitMark;
+			}
+
+			if(changed == 0 || mBvhRoot->IsLeaf())
+				return changed;
+
+			// Refitting is much cheaper than a rebuild even when every leaf moved
+			RefitMarked(mBvhRoot);
+
+			mChangedSinceCostCheck += changed;
+			if(mChangedSinceCostCheck * COST_CHECK_FRACTION < mTotalLeaves)
+				return changed;
+
+			mChangedSinceCostCheck = 0;
+			const float cost = ComputeSahCostInternal();
+			if(mReferenceSahCost <= 0.f)
+				mReferenceSahCost = cost;
+			else if(cost > rebuildCostRatio * mReferenceSahCost)
+				RebuildInternal();
+
+			return changed;
+		}
+
+		// Full rebuild with binned surface area heuristic splits
+		void Rebuild()
+		{
+			D_CORE_THREADING::RWLockWrite lock(mRWLock);
+
+			RebuildInternal();
+		}
+
+		// Refits and incremental updates make the tree worse than a rebuild, which can be scheduled by
+		// comparing the current cost to the one right after the last rebuild
+		float GetSahCost() const
+		{
+			D_CORE_THREADING::RWLockRead lock(mRWLock);
+
+			return ComputeSahCostInternal();
+		}
+
+		// Zero before the first rebuild
+		float GetBuiltSahCost() const
+		{
+			D_CORE_THREADING::RWLockRead lock(mRWLock);
+
+			return mBuiltSahCost;
+		}
+
 		void Remove(ID const& id)
 		{
 			D_CORE_THREADING::RWLockWrite lock(mRWLock);
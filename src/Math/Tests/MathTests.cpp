@@ -3,12 +3,19 @@
 
 #include <Core/Serialization/TypeSerializer.hpp>
 #include <Math/Matrix4.hpp>
+#include <Math/Bounds/DynamicBVH.hpp>
 #include <Math/Camera/Camera.hpp>
 
 #include <rttr/registration.h>
 
 #include <boost/test/included/unit_test.hpp>
 
+#include <algorithm>
+#include <cfloat>
+#include <functional>
+#include <thread>
+#include <vector>
+
 using namespace D_MATH;
 using namespace D_MATH_CAMERA;
 
@@ -327,4 +334,208 @@ BOOST_AUTO_TEST_CASE(CameraSerialization)
 	BOOST_TEST(cam.GetRotation().Equals(dest.GetRotation()));
 }
 
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+	using BenchmarkBVH = D_MATH_BOUNDS::DynamicBVH<uint32_t>;
+
+	D_MATH_BOUNDS::Aabb GetBoxAt(Vector3 const& center)
+	{
+		return D_MATH_BOUNDS::Aabb(center - Vector3(1.f), center + Vector3(1.f));
+	}
+
+	// Whether an aabb query at the box finds the leaf with exactly that box
+	bool ContainsLeaf(BenchmarkBVH const& bvh, uint32_t data, D_MATH_BOUNDS::Aabb const& box)
+	{
+		bool found = false;
+		bvh.AabbQuery(box, [&](uint32_t const& leafData, D_MATH_BOUNDS::Aabb const& leafBox)
+			{
+				found = leafData == data && leafBox.NearEquals(box, 0.0001f);
+				return !found;
+			});
+		return found;
+	}
+
+	struct MovingLeaves
+	{
+		std::vector<BenchmarkBVH::ID>	Ids;
+		std::vector<Vector3>			Positions;
+
+		MovingLeaves(BenchmarkBVH& bvh, uint32_t count)
+		{
+			for (uint32_t i = 0u; i < count; i++)
+			{
+				auto position = Vector3((float)(i % 97u), (float)((i / 97u) % 89u), (float)(i / (97u * 89u))) * 4.f;
+				Positions.push_back(position);
+				Ids.push_back(bvh.Insert(GetBoxAt(position), i));
+			}
+		}
+
+		// Moves every step-th leaf
+		void Move(uint32_t step, float offset, std::vector<BenchmarkBVH::LeafUpdate>& updates)
+		{
+			updates.clear();
+			for (uint32_t i = 0u; i < Ids.size(); i += step)
+			{
+				Positions[i] += Vector3(offset, -offset, offset * 0.5f);
+				updates.push_back({ Ids[i], GetBoxAt(Positions[i]) });
+			}
+		}
+
+		// Sends every leaf to where another one was, which leaves a refitted tree in poor shape
+		void Scatter(std::vector<BenchmarkBVH::LeafUpdate>& updates)
+		{
+			auto previous = Positions;
+			updates.clear();
+			for (uint32_t i = 0u; i < Ids.size(); i++)
+			{
+				Positions[i] = previous[(i * 7919u + 1u) % previous.size()];
+				updates.push_back({ Ids[i], GetBoxAt(Positions[i]) });
+			}
+		}
+	};
+
+	// Runs the first function on a new thread
+	void ThreadForkJoin(std::function<void()> const& first, std::function<void()> const& second)
+	{
+		std::thread thread(first);
+		second();
+		thread.join();
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(DynamicBVHBatchUpdate)
+
+BOOST_AUTO_TEST_CASE(RefitKeepsLeavesFindable)
+{
+	BenchmarkBVH bvh;
+	MovingLeaves leaves(bvh, 2000u);
+	std::vector<BenchmarkBVH::LeafUpdate> updates;
+
+	leaves.Move(10u, 3.f, updates);
+	BOOST_TEST(bvh.UpdateBatch(updates.data(), (int)updates.size()) == (int)updates.size());
+
+	for (uint32_t i = 0u; i < leaves.Ids.size(); i++)
+		BOOST_TEST(ContainsLeaf(bvh, i, GetBoxAt(leaves.Positions[i])));
+
+	// Unchanged bounds are skipped
+	BOOST_TEST(bvh.UpdateBatch(updates.data(), (int)updates.size()) == 0);
+	BOOST_TEST(bvh.GetLeafCount() == 2000);
+}
+
+BOOST_AUTO_TEST_CASE(RebuildKeepsLeavesFindable)
+{
+	BenchmarkBVH bvh;
+	BenchmarkBVH refitted;
+	MovingLeaves leaves(bvh, 2000u);
+	MovingLeaves refittedLeaves(refitted, 2000u);
+	std::vector<BenchmarkBVH::LeafUpdate> updates;
+
+	BOOST_TEST(bvh.GetBuiltSahCost() == 0.f);
+	bvh.Rebuild();
+	refitted.Rebuild();
+	auto builtCost = bvh.GetBuiltSahCost();
+	BOOST_TEST(builtCost > 0.f);
+
+	// Moving every leaf the same way keeps the refitted tree as good
+	leaves.Move(1u, 7.f, updates);
+	BOOST_TEST(bvh.UpdateBatch(updates.data(), (int)updates.size()) == 2000);
+	BOOST_TEST(bvh.GetBuiltSahCost() == builtCost);
+
+	// Far over the cost ratio, as the tree never allowed to rebuild shows
+	leaves.Scatter(updates);
+	BOOST_TEST(bvh.UpdateBatch(updates.data(), (int)updates.size()) == 2000);
+	refittedLeaves.Scatter(updates);
+	refitted.UpdateBatch(updates.data(), (int)updates.size(), FLT_MAX);
+
+	for (uint32_t i = 0u; i < leaves.Ids.size(); i++)
+		BOOST_TEST(ContainsLeaf(bvh, i, GetBoxAt(leaves.Positions[i])));
+
+	BOOST_TEST(refitted.GetSahCost() > 1.5f * builtCost);
+	BOOST_TEST(bvh.GetSahCost() <= 1.5f * builtCost);
+	BOOST_TEST(bvh.GetSahCost() == bvh.GetBuiltSahCost());
+
+	// Removing after a rebuild still finds the right leaves
+	for (uint32_t i = 0u; i < leaves.Ids.size(); i += 2u)
+		bvh.Remove(leaves.Ids[i]);
+	BOOST_TEST(bvh.GetLeafCount() == 1000);
+	BOOST_TEST(!ContainsLeaf(bvh, 0u, GetBoxAt(leaves.Positions[0])));
+	BOOST_TEST(ContainsLeaf(bvh, 1u, GetBoxAt(leaves.Positions[1])));
+}
+
+BOOST_AUTO_TEST_CASE(BatchMatchesSingleUpdates)
+{
+	constexpr uint32_t leafCount = 2000u;
+
+	// Refitted or rebuilt, both trees hold the same leaves
+	for (uint32_t step : { 100u, 10u, 1u })
+	{
+		BenchmarkBVH single;
+		BenchmarkBVH batched;
+		MovingLeaves singleLeaves(single, leafCount);
+		MovingLeaves batchedLeaves(batched, leafCount);
+		std::vector<BenchmarkBVH::LeafUpdate> updates;
+
+		for (uint32_t frame = 0u; frame < 3u; frame++)
+		{
+			singleLeaves.Move(step, 0.5f, updates);
+			for (auto const& update : updates)
+				single.Update(update.Id, update.Box);
+
+			batchedLeaves.Move(step, 0.5f, updates);
+			batched.UpdateBatch(updates.data(), (int)updates.size());
+		}
+
+		BOOST_TEST(batched.GetLeafCount() == single.GetLeafCount());
+
+		// Both trees hold the same leaves with the same boxes
+		for (uint32_t i = 0u; i < leafCount; i += 7u)
+		{
+			auto probe = D_MATH_BOUNDS::Aabb(singleLeaves.Positions[i] - Vector3(6.f), singleLeaves.Positions[i] + Vector3(6.f));
+			std::vector<uint32_t> singleFound, batchedFound;
+			single.AabbQuery(probe, [&](uint32_t const& data, D_MATH_BOUNDS::Aabb const&) { singleFound.push_back(data); return true; });
+			batched.AabbQuery(probe, [&](uint32_t const& data, D_MATH_BOUNDS::Aabb const&) { batchedFound.push_back(data); return true; });
+
+			std::sort(singleFound.begin(), singleFound.end());
+			std::sort(batchedFound.begin(), batchedFound.end());
+			BOOST_TEST(singleFound == batchedFound);
+			BOOST_TEST(ContainsLeaf(batched, i, GetBoxAt(batchedLeaves.Positions[i])));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ParallelBuildMatchesSerial)
+{
+	constexpr uint32_t leafCount = 20000u;
+
+	BenchmarkBVH serial;
+	BenchmarkBVH parallel;
+	MovingLeaves serialLeaves(serial, leafCount);
+	MovingLeaves parallelLeaves(parallel, leafCount);
+	parallel.SetForkJoin(ThreadForkJoin);
+
+	serial.Rebuild();
+	parallel.Rebuild();
+	BOOST_TEST(parallel.GetSahCost() == serial.GetSahCost());
+
+	// Refitting in parallel too, then rebuilding from the scattered leaves
+	std::vector<BenchmarkBVH::LeafUpdate> updates;
+	serialLeaves.Move(3u, 2.f, updates);
+	serial.UpdateBatch(updates.data(), (int)updates.size());
+	parallelLeaves.Move(3u, 2.f, updates);
+	parallel.UpdateBatch(updates.data(), (int)updates.size());
+	BOOST_TEST(parallel.GetSahCost() == serial.GetSahCost());
+
+	serialLeaves.Scatter(updates);
+	serial.UpdateBatch(updates.data(), (int)updates.size());
+	parallelLeaves.Scatter(updates);
+	parallel.UpdateBatch(updates.data(), (int)updates.size());
+	BOOST_TEST(parallel.GetSahCost() == serial.GetSahCost());
+	BOOST_TEST(parallel.GetBuiltSahCost() == serial.GetBuiltSahCost());
+
+	for (uint32_t i = 0u; i < leafCount; i += 13u)
+		BOOST_TEST(ContainsLeaf(parallel, i, GetBoxAt(parallelLeaves.Positions[i])));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
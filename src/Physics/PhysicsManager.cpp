@@ -11,6 +11,7 @@
 
 #include <Core/Containers/Map.hpp>
 #include <Core/Containers/Vector.hpp>
+#include <Core/Memory/Memory.hpp>
 #include <Core/TimeManager/TimeManager.hpp>
 #include <Graphics/GraphicsUtils/Profiling/Profiling.hpp>
 #include <Job/Job.hpp>
@@ -41,7 +42,22 @@ namespace Darius::Physics
 	bool									dirtyOptions = false;
 	bool									gGpuAccelerated = false;
 
-	PxDefaultAllocator						gAllocator;
+	// Counts the PhysX memory under the physics tag. Memory manager allocations keep the 16 byte alignment PhysX needs.
+	class TrackedPxAllocator : public PxAllocatorCallback
+	{
+	public:
+		virtual void* allocate(size_t size, const char*, const char*, int) override
+		{
+			return DMemAllocTagged(size, D_MEMORY::MemoryTag::Physics);
+		}
+
+		virtual void deallocate(void* ptr) override
+		{
+			DMemFree(ptr);
+		}
+	};
+
+	TrackedPxAllocator						gAllocator;
 	PxDefaultErrorCallback					gErrorCallback;
 	PxTolerancesScale						gToleranceScale;
 	PxCookingParams* gCookingParams;
@@ -125,6 +141,8 @@ namespace Darius::Physics
 
 	void Initialize(D_SERIALIZATION::Json const& settings)
 	{
+		D_MEMORY_TAG_SCOPE(Physics);
+
 		D_ASSERT(!_init);
 		_init = true;
 
@@ -260,6 +278,8 @@ namespace Darius::Physics
 
 	void Update(bool running, float dt)
 	{
+		D_MEMORY_TAG_SCOPE(Physics);
+
 		D_PROFILING::ScopedTimer physicsProfiler(L"Physics Update");
 
 		gScene->Simulate(running, true, dt);
@@ -1,6 +1,8 @@
 #include "Renderer/pch.hpp"
 #include "MeshRendererComponent.hpp"
 
+#include "Renderer/Resources/TextureStreaming.hpp"
+
 #include <ResourceManager/ResourceManager.hpp>
 #include <Scene/Utils/DetailsDrawer.hpp>
 #include <Utils/DragDropPayload.hpp>
@@ -81,6 +83,14 @@ namespace Darius::Renderer
 		if (draws != (UINT)mMaterials.size())
 			OnMeshChanged();
 
+		// Texture streaming feedback from the views
+		float screenSize = -1.f;
+		if (riContext.Camera && !riContext.Shadow && D_RENDERER_STREAMING::IsEnabled())
+		{
+			auto aabb = GetAabb();
+			screenSize = D_RENDERER_STREAMING::GetScreenSize(*riContext.Camera, aabb.GetCenter(), aabb.GetExtents().Length());
+		}
+
 		for (UINT i = 0; i < draws; i++)
 		{
 			auto const& draw = mesh->mDraw[i];
@@ -93,6 +103,10 @@ namespace Darius::Renderer
 			if (!material.IsValid() || material->IsDirtyGPU())
 				continue;
 
+			if (screenSize >= 0.f)
+				for (uint32_t t = 0u; t < material->GetTextureCount(); t++)
+					if (auto texture = material->GetTexture(t))
+						texture->ReportScreenSize(screenSize);
 
 			result.PsoType = GetPsoIndex(i, material.Get());
 			result.DepthPsoIndex = mMaterialPsoData[i].DepthPsoIndex;
@@ -2,6 +2,7 @@
 #include "SkeletalMeshRendererComponent.hpp"
 
 #include "Renderer/RendererManager.hpp"
+#include "Renderer/Resources/TextureStreaming.hpp"
 
 #include <Core/TimeManager/TimeManager.hpp>
 #include <Debug/DebugDraw.hpp>
@@ -117,6 +118,14 @@ namespace Darius::Renderer
 		if (draws != (UINT)mMaterials.size())
 			OnMeshChanged();
 
+		// Texture streaming feedback from the views
+		float screenSize = -1.f;
+		if (riContext.Camera && !riContext.Shadow && D_RENDERER_STREAMING::IsEnabled())
+		{
+			auto aabb = GetAabb();
+			screenSize = D_RENDERER_STREAMING::GetScreenSize(*riContext.Camera, aabb.GetCenter(), aabb.GetExtents().Length());
+		}
+
 		for (UINT i = 0; i < draws; i++)
 		{
 			auto const& draw = mesh->mDraw[i];
@@ -129,6 +138,11 @@ namespace Darius::Renderer
 			if (!material.IsValid() || material->IsDirtyGPU())
 				continue;
 
+			if (screenSize >= 0.f)
+				for (uint32_t t = 0u; t < material->GetTextureCount(); t++)
+					if (auto texture = material->GetTexture(t))
+						texture->ReportScreenSize(screenSize);
+
 			result.PsoType = GetPsoIndex(i, material.Get());
 			result.DepthPsoIndex = mMaterialPsoData[i].DepthPsoIndex;
 			result.Material.MaterialCBV = material->GetConstantsGpuAddress();
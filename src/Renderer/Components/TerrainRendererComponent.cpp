@@ -5,6 +5,8 @@
 #include "Renderer/Resources/MaterialResource.hpp"
 #include "Renderer/VertexTypes.hpp"
 
+#include <Graphics/GraphicsCore.hpp>
+
 
 #ifdef _D_EDITOR
 #include <Libs/FontIcon/IconsFontAwesome6.h>
@@ -30,7 +32,9 @@ namespace Darius::Renderer
 		mMaterial(),
 		mGridMesh(),
 		mGridSize(TerrainGridSize::Cells8x8),
-		mTerrainData()
+		mTerrainData(),
+		mNodeConstantsCursor(0u),
+		mNodeConstantsFrame(~0u)
 	{
 	}
 
@@ -39,7 +43,9 @@ namespace Darius::Renderer
 		mMaterial(),
 		mGridMesh(),
 		mGridSize(TerrainGridSize::Cells8x8),
-		mTerrainData()
+		mTerrainData(),
+		mNodeConstantsCursor(0u),
+		mNodeConstantsFrame(~0u)
 	{
 	}
 
@@ -48,8 +54,12 @@ namespace Darius::Renderer
 		Super::Awake();
 
 		// Initializing Mesh Constants buffers
-		mMeshConstantsCPU.Create(L"Mesh Constant Upload Buffer", sizeof(MeshConstants), D_GRAPHICS_DEVICE::gNumFrameResources);
-		mMeshConstantsGPU.Create(L"Mesh Constant GPU Buffer", 1, sizeof(MeshConstants));
+		mMeshConstantsCPU.Create(L"Mesh Constant Upload Buffer", sizeof(TerrainNodeConstants), D_GRAPHICS_DEVICE::gNumFrameResources);
+		mMeshConstantsGPU.Create(L"Mesh Constant GPU Buffer", 1, sizeof(TerrainNodeConstants));
+
+		// Initializing LOD node constants buffers
+		mNodeConstants.Create(L"Terrain Node Constants Upload Buffer", sizeof(TerrainNodeConstants) * MaxSelectedNodesPerFrame, D_GRAPHICS_DEVICE::gNumFrameResources);
+		mSelectedNodes.reserve(MaxSelectedNodesPerFrame);
 
 		UpdateGridMesh();
 		SetDirty();
@@ -68,10 +78,17 @@ namespace Darius::Renderer
 		// Updating mesh constants
 		// Mapping upload buffer
 		auto instanceIndex = D_GRAPHICS_DEVICE::GetCurrentFrameResourceIndex();
-		MeshConstants* cb = reinterpret_cast<MeshConstants*>(mMeshConstantsCPU.MapInstance(instanceIndex));
+		TerrainNodeConstants* cb = reinterpret_cast<TerrainNodeConstants*>(mMeshConstantsCPU.MapInstance(instanceIndex));
 		Matrix4 world = GetTransform()->GetWorld();
+		*cb = TerrainNodeConstants();
 		cb->World = Matrix4(world);
 		cb->WorldIT = InverseTranspose(world.Get3x3());
+		if (mTerrainData.IsValid())
+		{
+			float width, depth;
+			mTerrainData->GetDimensions(width, depth);
+			cb->NodeOffsetScale.w = width;
+		}
 		mMeshConstantsCPU.Unmap();
 
 		// Uploading
@@ -90,13 +107,37 @@ namespace Darius::Renderer
 
 		UpdatePsoIndex();
 
+		RenderItem ri;
+		FillRenderItem(ri, riContext);
+
+		// Drawing LOD nodes of the quad tree for views with a camera
+		D3D12_GPU_VIRTUAL_ADDRESS nodeConstants = D3D12_GPU_VIRTUAL_ADDRESS_NULL;
+		UINT selectedCount = riContext.Camera ? SelectLodNodes(*riContext.Camera, nodeConstants) : 0u;
+
+		if (selectedCount == 0u)
+		{
+			ri.MeshHsCBV = GetConstantsAddress();
+			ri.MeshDsCBV = GetConstantsAddress();
+			appendFunction(ri);
+			return true;
+		}
+
+		for (UINT i = 0u; i < selectedCount; i++)
+		{
+			ri.MeshHsCBV = nodeConstants + i * sizeof(TerrainNodeConstants);
+			ri.MeshDsCBV = ri.MeshHsCBV;
+			appendFunction(ri);
+		}
+
+		return true;
+	}
+
+	void TerrainRendererComponent::FillRenderItem(RenderItem& ri, RenderItemContext const& riContext) const
+	{
 		static const uint16_t psoFlags = mMaterial->GetPsoFlags() | RenderItem::PointOnly | RenderItem::LineOnly;
 
-		RenderItem ri;
 		ri.Mesh = mGridMesh->GetMeshData();
 		ri.PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_4_CONTROL_POINT_PATCHLIST;
-		ri.MeshHsCBV = GetConstantsAddress();
-		ri.MeshDsCBV = GetConstantsAddress();
 		ri.ParamsDsCBV = mTerrainData->GetParamsConstantsAddress();
 		ri.PsoType = mMaterialPsoData.PsoIndex;
 		ri.DepthPsoIndex = mMaterialPsoData.DepthPsoIndex;
@@ -133,10 +174,90 @@ namespace Darius::Renderer
 			ri.StencilValue = GetStencilValue();
 			ri.CustomDepth = IsCustomDepthEnable();
 		}
+	}
 
-		appendFunction(ri);
+	UINT TerrainRendererComponent::SelectLodNodes(D_MATH_CAMERA::BaseCamera const& camera, _OUT_ D3D12_GPU_VIRTUAL_ADDRESS& firstNodeConstants)
+	{
+		auto const& quadTree = mTerrainData->GetQuadTree();
+		if (!quadTree.IsValid())
+			return 0u;
+
+		// Node constants of previous frames are still in flight, so each frame resource has its own region
+		// and views of the same frame are appended after each other
+		UINT frameIndex = D_GRAPHICS_DEVICE::GetCurrentFrameResourceIndex();
+		UINT frameCount = D_GRAPHICS::GetFrameCount();
+		if (mNodeConstantsFrame != frameCount)
+		{
+			mNodeConstantsFrame = frameCount;
+			mNodeConstantsCursor = 0u;
+		}
 
-		return true;
+		// Selection happens in terrain space
+		auto transform = GetTransform();
+		Matrix4 world = transform->GetWorld();
+		Matrix4 invWorld = Invert(world);
+		Vector3 cameraPosLocal = Vector3(invWorld * Vector4(camera.GetPosition(), 1.f));
+		auto localFrustum = invWorld * camera.GetWorldSpaceFrustum();
+
+		D_RENDERER_GEOMETRY::TerrainQuadTree::SelectionParams params;
+		params.CameraPosition = cameraPosLocal;
+		params.Frustum = &localFrustum;
+
+		mSelectedNodes.clear();
+		quadTree.Select(params, mSelectedNodes);
+
+		UINT available = MaxSelectedNodesPerFrame - mNodeConstantsCursor;
+		if (mSelectedNodes.empty() || mSelectedNodes.size() > available)
+			return 0u;
+
+		float width, depth;
+		mTerrainData->GetDimensions(width, depth);
+
+		Matrix3 worldIT = InverseTranspose(world.Get3x3());
+		float patchQuads = (float)(GetGridPatchVertexCount() - 1u);
+
+		auto nodesCB = reinterpret_cast<TerrainNodeConstants*>(mNodeConstants.MapInstance(frameIndex)) + mNodeConstantsCursor;
+		for (auto const& selected : mSelectedNodes)
+		{
+			auto const& node = quadTree.GetNode(selected.NodeIndex);
+			auto uvRect = quadTree.GetNodeUVRect(node);
+			auto center = quadTree.GetNodeAabb(node).GetCenter();
+
+			// Areas of finer nodes drawn in a coarser LOD get the density of that LOD
+			float tessellation = (float)(NodeTessellationFactor >> (selected.Lod - node.Level));
+
+			TerrainNodeConstants& cb = *nodesCB++;
+			cb.World = world;
+			cb.WorldIT = worldIT;
+			cb.UVOffsetScale = { uvRect.GetX(), uvRect.GetY(), uvRect.GetZ(), uvRect.GetW() };
+			cb.NodeOffsetScale = { center.GetX(), center.GetZ(), uvRect.GetZ(), width };
+			cb.MorphParams = { selected.MorphStart, selected.MorphEnd, patchQuads * tessellation, tessellation };
+			cb.CameraPosLocal = (DirectX::XMFLOAT3)cameraPosLocal;
+		}
+		mNodeConstants.Unmap();
+
+		firstNodeConstants = mNodeConstants.GetGpuVirtualAddress(frameIndex) + mNodeConstantsCursor * sizeof(TerrainNodeConstants);
+		mNodeConstantsCursor += (UINT)mSelectedNodes.size();
+
+		return (UINT)mSelectedNodes.size();
+	}
+
+	UINT TerrainRendererComponent::GetGridPatchVertexCount() const
+	{
+		switch (mGridSize)
+		{
+		case D_RENDERER::TerrainRendererComponent::TerrainGridSize::Cells2x2:
+			return 2u;
+		case D_RENDERER::TerrainRendererComponent::TerrainGridSize::Cells4x4:
+			return 4u;
+		case D_RENDERER::TerrainRendererComponent::TerrainGridSize::Cells8x8:
+			return 8u;
+		case D_RENDERER::TerrainRendererComponent::TerrainGridSize::Cells16x16:
+			return 16u;
+		default:
+			D_ASSERT_M(false, "Bad grid size");
+			return 2u;
+		}
 	}
 
 	void TerrainRendererComponent::UpdatePsoIndex()
@@ -253,6 +374,7 @@ namespace Darius::Renderer
 	{
 		mMeshConstantsCPU.Destroy();
 		mMeshConstantsGPU.Destroy();
+		mNodeConstants.Destroy();
 
 		Super::OnDestroy();
 	}
@@ -84,9 +84,19 @@ namespace Darius::Renderer
 			}
 		}
 
+		// Maximum number of quad tree nodes drawn per frame
+		static constexpr UINT				MaxSelectedNodesPerFrame = 512u;
+		// Tessellation factor of a patch in its own LOD
+		static constexpr UINT				NodeTessellationFactor = 8u;
+
 	protected:
 		void								UpdatePsoIndex();
 		void								UpdateGridMesh();
+		UINT								GetGridPatchVertexCount() const;
+
+		// Selects quad tree nodes for the view camera and writes their constants, returns selected count
+		UINT								SelectLodNodes(D_MATH_CAMERA::BaseCamera const& camera, _OUT_ D3D12_GPU_VIRTUAL_ADDRESS& firstNodeConstants);
+		void								FillRenderItem(D_RENDERER::RenderItem& ri, RenderItemContext const& riContext) const;
 
 		DField(Serialize)
 		D_RESOURCE::ResourceRef<MaterialResource> mMaterial;
@@ -103,6 +113,12 @@ namespace Darius::Renderer
 		D_GRAPHICS_BUFFERS::UploadBuffer		mMeshConstantsCPU;
 		D_GRAPHICS_BUFFERS::ByteAddressBuffer	mMeshConstantsGPU;
 
+		// Per frame constants of the selected LOD nodes, one instance per frame resource
+		D_GRAPHICS_BUFFERS::UploadBuffer		mNodeConstants;
+		UINT								mNodeConstantsCursor;
+		UINT								mNodeConstantsFrame;
+		D_CONTAINERS::DVector<D_RENDERER_GEOMETRY::TerrainQuadTree::SelectedNode> mSelectedNodes;
+
 
 		MaterialPsoData						mMaterialPsoData;
 		D_RESOURCE::ResourceRef<D_RENDERER::StaticMeshResource> mGridMesh;
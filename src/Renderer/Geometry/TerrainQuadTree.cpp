@@ -0,0 +1,241 @@
+#include "Renderer/pch.hpp"
+#include "TerrainQuadTree.hpp"
+
+#include <Math/Bounds/BoundingSphere.hpp>
+
+using namespace D_CONTAINERS;
+using namespace D_MATH;
+using namespace D_MATH_BOUNDS;
+
+namespace
+{
+	enum class FrustumTestResult
+	{
+		Outside,
+		Intersecting,
+		Inside
+	};
+
+	FrustumTestResult TestFrustum(D_MATH_CAMERA::Frustum const& frustum, Aabb const& aabb)
+	{
+		auto min = aabb.GetMin();
+		auto max = aabb.GetMax();
+
+		bool inside = true;
+		for (int i = 0; i < 6; i++)
+		{
+			auto const& plane = frustum.GetFrustumPlane((D_MATH_CAMERA::Frustum::PlaneID)i);
+			auto positiveMask = plane.GetNormal() > Vector3(kZero);
+
+			Vector3 farCorner = Select(min, max, positiveMask);
+			if (plane.DistanceFromPoint(farCorner) < 0.f)
+				return FrustumTestResult::Outside;
+
+			Vector3 nearCorner = Select(max, min, positiveMask);
+			if (plane.DistanceFromPoint(nearCorner) < 0.f)
+				inside = false;
+		}
+
+		return inside ? FrustumTestResult::Inside : FrustumTestResult::Intersecting;
+	}
+}
+
+namespace Darius::Renderer::Geometry
+{
+
+	void TerrainQuadTree::Clear()
+	{
+		mNodes.clear();
+		mLevelOffsets.clear();
+		mLodRanges.clear();
+		mLeavesPerSide = 0u;
+	}
+
+	void TerrainQuadTree::Build(float const* heights, uint32_t width, uint32_t height, Config const& config)
+	{
+		Clear();
+
+		D_ASSERT(heights);
+		D_ASSERT(width > 1 && height > 1);
+		D_ASSERT(config.LodLevelCount > 0 && config.LodLevelCount <= MaxLodLevelCount);
+
+		mConfig = config;
+		mLeavesPerSide = 1u << (config.LodLevelCount - 1);
+
+		// Reserving all levels, sum of 4^i
+		{
+			uint32_t nodeCount = 0u;
+			mLevelOffsets.resize(config.LodLevelCount);
+			for (uint32_t level = 0u; level < config.LodLevelCount; level++)
+			{
+				mLevelOffsets[level] = nodeCount;
+				uint32_t side = mLeavesPerSide >> level;
+				nodeCount += side * side;
+			}
+			mNodes.resize(nodeCount);
+		}
+
+		// Leaves take min max of the covered samples. Samples lie on the borders
+		// of the leaves, so neighbor leaves share their border samples.
+		float sampleStepX = (float)(width - 1) / mLeavesPerSide;
+		float sampleStepY = (float)(height - 1) / mLeavesPerSide;
+
+		for (uint32_t y = 0u; y < mLeavesPerSide; y++)
+		{
+			uint32_t rowBegin = (uint32_t)std::floor(y * sampleStepY);
+			uint32_t rowEnd = std::min((uint32_t)std::ceil((y + 1) * sampleStepY), height - 1);
+
+			for (uint32_t x = 0u; x < mLeavesPerSide; x++)
+			{
+				uint32_t colBegin = (uint32_t)std::floor(x * sampleStepX);
+				uint32_t colEnd = std::min((uint32_t)std::ceil((x + 1) * sampleStepX), width - 1);
+
+				float minHeight = FLT_MAX;
+				float maxHeight = -FLT_MAX;
+
+				for (uint32_t row = rowBegin; row <= rowEnd; row++)
+				{
+					float const* rowData = heights + (size_t)row * width;
+					for (uint32_t col = colBegin; col <= colEnd; col++)
+					{
+						float h = rowData[col];
+						minHeight = std::min(minHeight, h);
+						maxHeight = std::max(maxHeight, h);
+					}
+				}
+
+				Node& node = mNodes[GetNodeIndex(0, x, y)];
+				node.X = (uint16_t)x;
+				node.Y = (uint16_t)y;
+				node.Size = 1u;
+				node.Level = 0u;
+				node.MinHeight = minHeight;
+				node.MaxHeight = maxHeight;
+			}
+		}
+
+		// Parents take the bounds of their children
+		for (uint32_t level = 1u; level < config.LodLevelCount; level++)
+		{
+			uint32_t side = mLeavesPerSide >> level;
+			uint16_t size = (uint16_t)(1u << level);
+
+			for (uint32_t y = 0u; y < side; y++)
+			{
+				for (uint32_t x = 0u; x < side; x++)
+				{
+					Node const& c00 = mNodes[GetNodeIndex(level - 1, x * 2, y * 2)];
+					Node const& c10 = mNodes[GetNodeIndex(level - 1, x * 2 + 1, y * 2)];
+					Node const& c01 = mNodes[GetNodeIndex(level - 1, x * 2, y * 2 + 1)];
+					Node const& c11 = mNodes[GetNodeIndex(level - 1, x * 2 + 1, y * 2 + 1)];
+
+					Node& node = mNodes[GetNodeIndex(level, x, y)];
+					node.X = (uint16_t)(x * size);
+					node.Y = (uint16_t)(y * size);
+					node.Size = size;
+					node.Level = (uint8_t)level;
+					node.MinHeight = std::min(std::min(c00.MinHeight, c10.MinHeight), std::min(c01.MinHeight, c11.MinHeight));
+					node.MaxHeight = std::max(std::max(c00.MaxHeight, c10.MaxHeight), std::max(c01.MaxHeight, c11.MaxHeight));
+				}
+			}
+		}
+
+		// LOD ranges
+		mLodRanges.resize(config.LodLevelCount);
+		float range = config.FinestLodDistance;
+		for (uint32_t lod = 0u; lod < config.LodLevelCount; lod++)
+		{
+			mLodRanges[lod] = range;
+			range *= config.LodDistanceRatio;
+		}
+	}
+
+	Aabb TerrainQuadTree::GetNodeAabb(Node const& node) const
+	{
+		float leafWidth = mConfig.Width / mLeavesPerSide;
+		float leafDepth = mConfig.Depth / mLeavesPerSide;
+
+		// Grid x grows with u, and z decreases with v
+		float minX = -0.5f * mConfig.Width + node.X * leafWidth;
+		float maxX = minX + node.Size * leafWidth;
+		float maxZ = 0.5f * mConfig.Depth - node.Y * leafDepth;
+		float minZ = maxZ - node.Size * leafDepth;
+
+		return Aabb(Vector3(minX, node.MinHeight * mConfig.HeightScale, minZ), Vector3(maxX, node.MaxHeight * mConfig.HeightScale, maxZ));
+	}
+
+	Vector4 TerrainQuadTree::GetNodeUVRect(Node const& node) const
+	{
+		float invLeaves = 1.f / mLeavesPerSide;
+		return Vector4(node.X * invLeaves, node.Y * invLeaves, node.Size * invLeaves, node.Size * invLeaves);
+	}
+
+	uint32_t TerrainQuadTree::Select(SelectionParams const& params, DVector<SelectedNode>& result) const
+	{
+		if (!IsValid())
+			return 0u;
+
+		auto initialSize = result.size();
+
+		// Keeping the terrain drawn in its coarsest LOD when the camera is farther than all ranges
+		if (!SelectNode(GetRootIndex(), params, params.Frustum == nullptr, result))
+			AddSelection(GetRootIndex(), mConfig.LodLevelCount - 1, result);
+
+		return (uint32_t)(result.size() - initialSize);
+	}
+
+	bool TerrainQuadTree::SelectNode(uint32_t nodeIndex, SelectionParams const& params, bool fullyInFrustum, DVector<SelectedNode>& result) const
+	{
+		Node const& node = mNodes[nodeIndex];
+		auto aabb = GetNodeAabb(node);
+
+		if (!fullyInFrustum)
+		{
+			auto frustumResult = TestFrustum(*params.Frustum, aabb);
+
+			// Handled by being culled
+			if (frustumResult == FrustumTestResult::Outside)
+				return true;
+
+			fullyInFrustum = frustumResult == FrustumTestResult::Inside;
+		}
+
+		// Too far for this LOD, parent has to cover it
+		if (!aabb.Intersects(BoundingSphere(params.CameraPosition, mLodRanges[node.Level])))
+			return false;
+
+		// Finest level or children are out of their range, drawing the whole node
+		if (node.Level == 0u || !aabb.Intersects(BoundingSphere(params.CameraPosition, mLodRanges[node.Level - 1])))
+		{
+			AddSelection(nodeIndex, node.Level, result);
+			return true;
+		}
+
+		// Children which are out of their range are drawn in this node's LOD
+		uint32_t childLevel = node.Level - 1u;
+		uint32_t childX = (node.X >> childLevel);
+		uint32_t childY = (node.Y >> childLevel);
+
+		for (uint32_t i = 0u; i < 4u; i++)
+		{
+			uint32_t childIndex = GetNodeIndex(childLevel, childX + (i & 1u), childY + (i >> 1));
+
+			if (!SelectNode(childIndex, params, fullyInFrustum, result))
+				AddSelection(childIndex, node.Level, result);
+		}
+
+		return true;
+	}
+
+	void TerrainQuadTree::AddSelection(uint32_t nodeIndex, uint32_t lod, DVector<SelectedNode>& result) const
+	{
+		float rangeEnd = mLodRanges[lod];
+		float rangeBegin = lod > 0u ? mLodRanges[lod - 1] : 0.f;
+
+		SelectedNode& selected = result.emplace_back();
+		selected.NodeIndex = nodeIndex;
+		selected.Lod = (uint8_t)lod;
+		selected.MorphEnd = rangeEnd;
+		selected.MorphStart = rangeBegin + (rangeEnd - rangeBegin) * mConfig.MorphStartRatio;
+	}
+}
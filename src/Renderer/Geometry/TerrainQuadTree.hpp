@@ -0,0 +1,118 @@
+#pragma once
+
+#include <Core/Containers/Vector.hpp>
+#include <Math/Bounds/BoundingBox.hpp>
+#include <Math/Camera/Frustum.hpp>
+#include <Math/VectorMath.hpp>
+#include <Utils/Common.hpp>
+
+#ifndef D_RENDERER_GEOMETRY
+#define D_RENDERER_GEOMETRY Darius::Renderer::Geometry
+#endif
+
+namespace Darius::Renderer::Geometry
+{
+	// Continuous distance-dependent level of detail (CDLOD) quad tree of a terrain.
+	// The tree covers the whole terrain in UV space and keeps the min/max height of
+	// every node so that the selection can happen on CPU against the camera frustum
+	// and the LOD ranges each frame. Everything is in terrain local space.
+	class TerrainQuadTree
+	{
+	public:
+
+		struct Config
+		{
+			// Number of LOD levels, also the depth of the tree
+			uint32_t					LodLevelCount = 6u;
+
+			// Visibility distance of the finest LOD, each coarser LOD covers the previous one times LodDistanceRatio
+			float						FinestLodDistance = 15.f;
+			float						LodDistanceRatio = 2.f;
+
+			// Fraction of a LOD range where the morph to the next LOD starts
+			float						MorphStartRatio = 0.66f;
+
+			// Dimensions of the terrain in local space
+			float						Width = 100.f;
+			float						Depth = 100.f;
+			float						HeightScale = 1.f;
+		};
+
+		struct Node
+		{
+			// Position and size of the node in leaf units
+			uint16_t					X;
+			uint16_t					Y;
+			uint16_t					Size;
+			uint8_t						Level;	// 0 is the finest level
+
+			// Normalized heights of the height map samples covered by the node
+			float						MinHeight;
+			float						MaxHeight;
+		};
+
+		struct SelectedNode
+		{
+			uint32_t					NodeIndex;
+			uint8_t						Lod;
+
+			// Distances between which vertices morph into the next coarser LOD
+			float						MorphStart;
+			float						MorphEnd;
+		};
+
+		struct SelectionParams
+		{
+			D_MATH::Vector3				CameraPosition;
+			D_MATH_CAMERA::Frustum const* Frustum = nullptr; // Frustum culling is skipped if null
+		};
+
+	public:
+		TerrainQuadTree() = default;
+
+		// Builds the tree from a row-major normalized height map
+		void							Build(float const* heights, uint32_t width, uint32_t height, Config const& config);
+		void							Clear();
+
+		// Appends the nodes to be drawn with their LOD and morph ranges, returns number of appended nodes
+		uint32_t						Select(SelectionParams const& params, D_CONTAINERS::DVector<SelectedNode>& result) const;
+
+		D_MATH_BOUNDS::Aabb				GetNodeAabb(Node const& node) const;
+		D_MATH_BOUNDS::Aabb				GetNodeAabb(uint32_t nodeIndex) const { return GetNodeAabb(mNodes[nodeIndex]); }
+
+		// Returns node rect in UV space as (uMin, vMin, uSize, vSize)
+		D_MATH::Vector4					GetNodeUVRect(Node const& node) const;
+
+		INLINE Node const&				GetNode(uint32_t index) const { return mNodes[index]; }
+		INLINE uint32_t					GetNodeCount() const { return (uint32_t)mNodes.size(); }
+		INLINE uint32_t					GetRootIndex() const { return mNodes.empty() ? InvalidIndex : (uint32_t)mNodes.size() - 1; }
+		INLINE uint32_t					GetLeavesPerSide() const { return mLeavesPerSide; }
+		INLINE Config const&			GetConfig() const { return mConfig; }
+		INLINE bool						IsValid() const { return !mNodes.empty(); }
+
+		// Visibility range of a LOD level
+		INLINE float					GetLodRange(uint32_t lod) const { return mLodRanges[lod]; }
+
+		static constexpr uint32_t		InvalidIndex = ~0u;
+		static constexpr uint32_t		MaxLodLevelCount = 15u;
+
+	private:
+
+		INLINE uint32_t					GetNodeIndex(uint32_t level, uint32_t x, uint32_t y) const
+		{
+			return mLevelOffsets[level] + y * (mLeavesPerSide >> level) + x;
+		}
+
+		// Returns false if the node is out of its LOD range and has to be drawn by its parent
+		bool							SelectNode(uint32_t nodeIndex, SelectionParams const& params, bool fullyInFrustum, D_CONTAINERS::DVector<SelectedNode>& result) const;
+		void							AddSelection(uint32_t nodeIndex, uint32_t lod, D_CONTAINERS::DVector<SelectedNode>& result) const;
+
+		Config							mConfig;
+		uint32_t						mLeavesPerSide = 0u;
+
+		// Nodes are stored level by level starting from the leaves, the root is the last node
+		D_CONTAINERS::DVector<Node>		mNodes;
+		D_CONTAINERS::DVector<uint32_t>	mLevelOffsets;
+		D_CONTAINERS::DVector<float>	mLodRanges;
+	};
+}
@@ -4,6 +4,7 @@
 #include "Renderer/Rasterization/Renderer.hpp"
 #include "Renderer/RendererCommon.hpp"
 
+#include <Core/Memory/Allocators/FrameAllocator.hpp>
 #include <Debug/DebugDraw.hpp>
 #include <Graphics/GraphicsUtils/Profiling/Profiling.hpp>
 #include <Job/Job.hpp>
@@ -137,8 +138,15 @@ namespace Darius::Renderer::Rasterization::Light
 		if((UINT)mCascades.size() == 0)
 			mCascades.resize(1);
 
-		D_CONTAINERS::DVector<std::function<void()>> updateFuncs;
-		updateFuncs.reserve(D_WORLD::CountComponents<D_RENDERER::LightComponent>());
+		struct LightUpdate
+		{
+			LightData*					Light;
+			LightSourceType				Type;
+			UINT						Index;
+		};
+
+		D_FRAME_ALLOCATOR::DFrameVector<LightUpdate> lightUpdates;
+		lightUpdates.reserve(D_WORLD::CountComponents<D_RENDERER::LightComponent>());
 
 		D_WORLD::IterateComponents<D_RENDERER::LightComponent>([&](D_RENDERER::LightComponent& comp)
 			{
@@ -152,27 +160,32 @@ namespace Darius::Renderer::Rasterization::Light
 				lightData.Position = (DirectX::XMFLOAT3)trans->GetPosition();
 				lightData.Direction = (DirectX::XMFLOAT3)trans->GetRotation().GetForward();
 
-				updateFuncs.push_back([&, lightType, viewerCamera, light = &lightData, lightIndex]()
+				lightUpdates.push_back({ &lightData, lightType, lightIndex });
+			});
+
+		// Wait for processing all light sources
+		if(!lightUpdates.empty())
+			D_JOB::AddTaskSetAndWait((uint32_t)lightUpdates.size(), [&](D_JOB::TaskPartition range, D_JOB::ThreadNumber)
+				{
+					for(auto i = range.start; i < range.end; i++)
 					{
-						switch(lightType)
+						auto const& update = lightUpdates[i];
+						switch(update.Type)
 						{
 						case LightSourceType::DirectionalLight:
-							CalculateDirectionalShadowCamera(viewerCamera, *light, lightIndex);
+							CalculateDirectionalShadowCamera(viewerCamera, *update.Light, update.Index);
 							break;
 						case LightSourceType::PointLight:
-							CalculatePointShadowCamera(*light, lightIndex);
+							CalculatePointShadowCamera(*update.Light, update.Index);
 							break;
 						case LightSourceType::SpotLight:
-							CalculateSpotShadowCamera(*light, lightIndex);
+							CalculateSpotShadowCamera(*update.Light, update.Index);
 							break;
 						default:
 							D_ASSERT_M(false, "Source type is not implemented");
 						}
-					});
-			});
-
-		// Wait for processing all light sources
-		D_JOB::AddTaskSetAndWait(updateFuncs);
+					}
+				});
 
 		mLightConfigBufferData.CascadesCount = GetCascadesCount();
 	}
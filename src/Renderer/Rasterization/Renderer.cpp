@@ -12,6 +12,7 @@
 #include "Renderer/Resources/TextureResource.hpp"
 #include "Renderer/VertexTypes.hpp"
 
+#include <Core/Memory/Allocators/FrameAllocator.hpp>
 #include <Core/TimeManager/TimeManager.hpp>
 #include <Debug/DebugDraw.hpp>
 #include <Graphics/AntiAliasing/TemporalEffect.hpp>
@@ -166,23 +167,21 @@ namespace Darius::Renderer::Rasterization
 
 			D_CAMERA_MANAGER::Update();
 
-			DVector<std::function<void()>> updateFuncs;
+			// Pointers in frame memory rather than a function per component
+			D_FRAME_ALLOCATOR::DFrameVector<RendererComponent*> dirtyComps;
 
 			auto componentCount = 0u;
 			componentCount += D_WORLD::CountComponents<MeshRendererComponent>();
 			componentCount += D_WORLD::CountComponents<SkeletalMeshRendererComponent>();
 			componentCount += D_WORLD::CountComponents<BillboardRendererComponent>();
 			componentCount += D_WORLD::CountComponents<TerrainRendererComponent>();
-			updateFuncs.reserve(componentCount);
+			dirtyComps.reserve(componentCount);
 
 #define RENDERER_COMPONENT_UPDATE_ITER(T) \
 			D_WORLD::IterateComponents<T>([&](D_RENDERER::T& meshComp) \
 				{ \
 					if(meshComp.IsDirty() && meshComp.IsActive()) \
-						updateFuncs.push_back([&]() \
-							{ \
-									meshComp.Update(-1.f); \
-							}); \
+						dirtyComps.push_back(&meshComp); \
 				} \
 			) \
 
@@ -192,7 +191,12 @@ namespace Darius::Renderer::Rasterization
 			RENDERER_COMPONENT_UPDATE_ITER(TerrainRendererComponent);
 #undef RENDERER_COMPONENT_UPDATE_ITER
 
-			D_JOB::AddTaskSetAndWait(updateFuncs);
+			if(!dirtyComps.empty())
+				D_JOB::AddTaskSetAndWait((uint32_t)dirtyComps.size(), [&dirtyComps](D_JOB::TaskPartition range, D_JOB::ThreadNumber)
+					{
+						for(auto i = range.start; i < range.end; i++)
+							dirtyComps[i]->Update(-1.f);
+					});
 		}
 	}
 
@@ -201,11 +205,14 @@ namespace Darius::Renderer::Rasterization
 		auto frustum = cam.GetWorldSpaceFrustum();
 		auto camPos = cam.GetPosition();
 
+		RenderItemContext viewRiContext = riContext;
+		viewRiContext.Camera = &cam;
+
 #if _D_EDITOR
 		bool addEditorPicker = sorterContext.EditorPickerRenderSorter != nullptr;
 #endif
 
-		GetSceneBvh().FrustumQuery(frustum, [=, &sorterContext](D_ECS::UntypedCompRef const& compRef, D_MATH_BOUNDS::Aabb const& aabb)
+		GetSceneBvh().FrustumQuery(frustum, [=, &sorterContext, &viewRiContext](D_ECS::UntypedCompRef const& compRef, D_MATH_BOUNDS::Aabb const& aabb)
 			{
 				auto rendererComp = reinterpret_cast<RendererComponent*>(compRef.Get());
 
@@ -226,7 +233,7 @@ namespace Darius::Renderer::Rasterization
 				rendererComp->AddRenderItems([=, &sorterContext](RenderItem const& ri)
 					{
 						sorterContext.RenderSorter.AddMesh(ri, distance);
-					}, riContext);
+					}, viewRiContext);
 
 				return true;
 			});
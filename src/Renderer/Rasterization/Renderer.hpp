@@ -4,6 +4,7 @@
 #include "Renderer/Resources/TextureResource.hpp"
 
 #include <Core/Containers/Vector.hpp>
+#include <Core/Memory/Allocators/FrameAllocator.hpp>
 #include <Graphics/CommandContext.hpp>
 #include <Graphics/GraphicsUtils/Buffers/ColorBuffer.hpp>
 #include <Graphics/GraphicsUtils/Buffers/DepthBuffer.hpp>
@@ -166,8 +167,9 @@ namespace Darius::Renderer::Rasterization
 			D_RENDERER::RenderItem const renderItem;
 		};
 
-		D_CONTAINERS::DVector<SortObject> m_SortObjects;
-		D_CONTAINERS::DVector<uint64_t> m_SortKeys;
+		// Sorters live within a frame
+		D_FRAME_ALLOCATOR::DFrameVector<SortObject> m_SortObjects;
+		D_FRAME_ALLOCATOR::DFrameVector<uint64_t> m_SortKeys;
 		BatchType m_BatchType;
 		uint32_t m_PassCounts[kNumPasses];
 		DrawPass m_CurrentPass;
@@ -49,6 +49,9 @@ namespace Darius::Renderer
 		uint8_t				StencilOverride = false;
 #endif
 		bool				Shadow = false;
+
+		// View camera, used for view dependent LOD selection. Null for views without LOD selection
+		D_MATH_CAMERA::BaseCamera const* Camera = nullptr;
 	};
 
 	ALIGN_DECL_256 struct MeshConstants
@@ -58,6 +61,19 @@ namespace Darius::Renderer
 		float					Lod = 1.f;
 	};
 
+	// Mesh constants of a terrain draw, either the whole terrain or one of its LOD quad tree nodes
+	ALIGN_DECL_256 struct TerrainNodeConstants
+	{
+		D_MATH::Matrix4			World;
+		D_MATH::Matrix3			WorldIT;
+		DirectX::XMFLOAT4		UVOffsetScale = { 0.f, 0.f, 1.f, 1.f };
+		// xy: node center in terrain space, z: node scale relative to patch mesh, w: patch mesh size
+		DirectX::XMFLOAT4		NodeOffsetScale = { 0.f, 0.f, 1.f, 0.f };
+		// x: morph start distance, y: morph end distance, z: morph grid dimension, w: tessellation factor
+		DirectX::XMFLOAT4		MorphParams = { 0.f, 0.f, 0.f, 0.f };
+		DirectX::XMFLOAT3		CameraPosLocal = { 0.f, 0.f, 0.f };
+	};
+
 #if _D_EDITOR
 	ALIGN_DECL_16 struct PickerPsMeshConstants
 	{
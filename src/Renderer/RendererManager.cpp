@@ -18,9 +18,11 @@
 #include "Resources/StaticMeshResource.hpp"
 #include "Resources/TerrainResource.hpp"
 #include "Resources/TextureResource.hpp"
+#include "Resources/TextureStreaming.hpp"
 
 #include <Core/Containers/Map.hpp>
 #include <Core/Containers/Set.hpp>
+#include <Core/Memory/MemoryTracking.hpp>
 #include <Core/Uuid.hpp>
 #include <Graphics/GraphicsUtils/Profiling/Profiling.hpp>
 #include <Math/VectorMath.hpp>
@@ -61,6 +63,8 @@ namespace Darius::Renderer
 
 	void Initialize(D_SERIALIZATION::Json const& settings)
 	{
+		D_MEMORY_TAG_SCOPE(Renderer);
+
 		D_ASSERT(!_initialized);
 		_initialized = true;
 
@@ -76,6 +80,8 @@ namespace Darius::Renderer
 		ShaderResource::Register();
 		ShaderMaterialResource::Register();
 
+		D_RENDERER_STREAMING::Initialize(settings);
+
 		LoadDefaultResources();
 
 		ActiveRendererType = HardwareRayTracing ? RendererType::RayTracing : RendererType::Rasterization;
@@ -108,12 +114,16 @@ namespace Darius::Renderer
 		else
 			D_RENDERER_RT::Shutdown();
 
+		D_RENDERER_STREAMING::Shutdown();
+
 		TextureHeap.Destroy();
 		SamplerHeap.Destroy();
 	}
 
 	void Update()
 	{
+		D_MEMORY_TAG_SCOPE(Renderer);
+
 		auto& context = D_GRAPHICS::GraphicsContext::Begin(L"Update Renderer");
 
 		switch (ActiveRendererType)
@@ -133,6 +143,11 @@ namespace Darius::Renderer
 			SceneBVH.OptimizeIncremental(1);
 		}
 
+		{
+			D_PROFILING::ScopedTimer _prof(L"Texture Streaming", context);
+			D_RENDERER_STREAMING::Update();
+		}
+
 		context.Finish();
 	}
 
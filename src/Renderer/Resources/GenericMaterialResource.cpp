@@ -152,6 +152,8 @@ namespace Darius::Renderer
 		{
 			mTextures[textureIndex].ChangeConnection = std::make_shared<D_CORE::SignalScopedConnection>(texture->SubscribeOnChange([&, textureIndex](D_RESOURCE::Resource* res)
 				{
+					// Texture descriptors are copied to the table on upload
+					MakeGpuDirty();
 					OnTextureDataChanged(textureIndex);
 				}));
 
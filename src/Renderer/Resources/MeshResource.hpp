@@ -88,7 +88,15 @@ namespace Darius::Renderer
 		virtual bool					WriteResourceToFile(D_SERIALIZATION::Json&) const override;
 		virtual void					ReadResourceFromFile(D_SERIALIZATION::Json const&, bool& dirtyDisk) override;
 
-		INLINE virtual void				Unload() override { EvictFromGpu(); }
+		INLINE virtual void				Unload() override { mMesh.Destroy(); EvictFromGpu(); }
+
+		INLINE virtual uint64_t			GetResidentSize() const override
+		{
+			uint64_t size = mMesh.VertexDataGpu.GetBufferSize();
+			for (auto const& indexBuffer : mMesh.IndexDataGpu)
+				size += indexBuffer.GetBufferSize();
+			return size;
+		}
 		INLINE virtual bool				UploadToGpu() override { SetUploading(); return true; }
 
 		void							SetMaterialListSize(UINT size);
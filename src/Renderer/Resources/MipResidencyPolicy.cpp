@@ -0,0 +1,141 @@
+#include "Renderer/pch.hpp"
+#include "MipResidencyPolicy.hpp"
+
+#include <algorithm>
+
+using namespace D_CONTAINERS;
+
+namespace Darius::Renderer
+{
+	MipResidencyPolicy::MipResidencyPolicy(uint64_t budget, uint32_t keepFrames, uint32_t maxLoadsPerUpdate) :
+		mBudget(budget),
+		mKeepFrames(keepFrames),
+		mMaxLoadsPerUpdate(maxLoadsPerUpdate)
+	{ }
+
+	uint64_t MipResidencyPolicy::GetCommittedSize(DVector<Entry> const& entries)
+	{
+		uint64_t total = 0u;
+		for (auto const& entry : entries)
+			total += entry.GetSize(std::min(entry.ResidentMip, entry.TargetMip));
+		return total;
+	}
+
+	void MipResidencyPolicy::Evaluate(DVector<Entry> const& entries, uint64_t frame, DVector<Decision>& decisions) const
+	{
+		decisions.clear();
+
+		uint32_t count = (uint32_t)entries.size();
+		uint64_t total = GetCommittedSize(entries);
+
+		DVector<uint32_t> desired(count);
+		DVector<uint32_t> planned(count);
+
+		// Entries holding more mips than needed, and the ones needing more
+		DVector<uint32_t> shrinking;
+		DVector<uint32_t> growing;
+
+		for (uint32_t i = 0u; i < count; i++)
+		{
+			auto const& entry = entries[i];
+			planned[i] = entry.ResidentMip;
+
+			bool stale = frame > entry.LastUsedFrame + mKeepFrames;
+			desired[i] = stale ? entry.TailMip : std::min(entry.RequestedMip, entry.TailMip);
+
+			if (entry.IsLoading())
+				continue;
+
+			if (desired[i] > entry.ResidentMip)
+				shrinking.push_back(i);
+			else if (desired[i] < entry.ResidentMip)
+				growing.push_back(i);
+		}
+
+		auto olderFirst = [&](uint32_t a, uint32_t b)
+			{
+				return entries[a].LastUsedFrame < entries[b].LastUsedFrame || (entries[a].LastUsedFrame == entries[b].LastUsedFrame && a < b);
+			};
+
+		std::sort(shrinking.begin(), shrinking.end(), olderFirst);
+		std::sort(growing.begin(), growing.end(), [&](uint32_t a, uint32_t b) { return olderFirst(b, a); });
+
+		auto setPlanned = [&](uint32_t index, uint32_t mip)
+			{
+				auto const& entry = entries[index];
+				total = total - entry.GetSize(planned[index]) + entry.GetSize(mip);
+				planned[index] = mip;
+			};
+
+		// Mips are kept until the memory is needed
+		size_t nextShrinking = 0u;
+		while (total > mBudget && nextShrinking < shrinking.size())
+		{
+			auto index = shrinking[nextShrinking++];
+			setPlanned(index, desired[index]);
+		}
+
+		// Still over the budget, e.g. when it is lowered, so the least recently used textures
+		// lose the mips they need too, but never the tail
+		if (total > mBudget)
+		{
+			DVector<uint32_t> forced;
+			for (uint32_t i = 0u; i < count; i++)
+				if (!entries[i].IsLoading() && planned[i] < entries[i].TailMip)
+					forced.push_back(i);
+
+			std::sort(forced.begin(), forced.end(), olderFirst);
+
+			for (size_t i = 0u; i < forced.size() && total > mBudget; i++)
+			{
+				auto index = forced[i];
+				auto const& entry = entries[index];
+
+				// Keeping as many mips as the budget allows
+				uint32_t mip = planned[index] + 1u;
+				while (mip < entry.TailMip && total - entry.GetSize(planned[index]) + entry.GetSize(mip) > mBudget)
+					mip++;
+
+				setPlanned(index, mip);
+			}
+		}
+
+		// Most recently used textures are loaded first
+		uint32_t loads = 0u;
+		for (auto index : growing)
+		{
+			if (loads >= mMaxLoadsPerUpdate)
+				break;
+
+			auto const& entry = entries[index];
+
+			// Lost mips to stay within the budget
+			if (planned[index] > entry.ResidentMip)
+				continue;
+
+			// Making room from textures used before this one
+			while (total - entry.GetSize(planned[index]) + entry.GetSize(desired[index]) > mBudget &&
+				nextShrinking < shrinking.size() &&
+				entries[shrinking[nextShrinking]].LastUsedFrame < entry.LastUsedFrame)
+			{
+				auto evicted = shrinking[nextShrinking++];
+				setPlanned(evicted, desired[evicted]);
+			}
+
+			// Loading as many mips as fit
+			uint32_t mip = desired[index];
+			while (mip < planned[index] && total - entry.GetSize(planned[index]) + entry.GetSize(mip) > mBudget)
+				mip++;
+
+			if (mip >= planned[index])
+				continue;
+
+			setPlanned(index, mip);
+			loads++;
+		}
+
+		for (uint32_t i = 0u; i < count; i++)
+			if (planned[i] != entries[i].ResidentMip)
+				decisions.push_back({ i, planned[i] });
+	}
+}
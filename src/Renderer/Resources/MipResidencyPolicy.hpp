@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Core/Containers/Vector.hpp>
+#include <Utils/Common.hpp>
+
+#ifndef D_RENDERER
+#define D_RENDERER Darius::Renderer
+#endif // !D_RENDERER
+
+namespace Darius::Renderer
+{
+	// Decides which mips of the streamed textures should be resident so that their total size
+	// stays within a budget. Textures are always kept from their tail mip, and the least recently
+	// used ones give up their mips first.
+	class MipResidencyPolicy
+	{
+	public:
+		struct Entry
+		{
+			// Size of the texture when it is resident from each mip, decreasing
+			D_CONTAINERS::DVector<uint64_t>	SizeFromMip;
+
+			// Smallest mips which are always resident
+			uint32_t						TailMip = 0u;
+
+			uint32_t						ResidentMip = 0u;
+
+			// Mip which will be resident after the load in flight, same as the resident one if there is none
+			uint32_t						TargetMip = 0u;
+
+			// Most detailed mip the renderer asked for
+			uint32_t						RequestedMip = 0u;
+			uint64_t						LastUsedFrame = 0u;
+
+			INLINE uint64_t					GetSize(uint32_t mip) const { return SizeFromMip[mip]; }
+			INLINE bool						IsLoading() const { return TargetMip != ResidentMip; }
+		};
+
+		struct Decision
+		{
+			uint32_t						Entry;
+			uint32_t						TargetMip;
+		};
+
+	public:
+		MipResidencyPolicy(uint64_t budget, uint32_t keepFrames = 30u, uint32_t maxLoadsPerUpdate = 8u);
+
+		// Decisions are made only for the entries which are not loading. Loads of more detailed
+		// mips are limited per call while evictions are not.
+		void								Evaluate(D_CONTAINERS::DVector<Entry> const& entries, uint64_t frame, D_CONTAINERS::DVector<Decision>& decisions) const;
+
+		// Size including the loads in flight
+		static uint64_t						GetCommittedSize(D_CONTAINERS::DVector<Entry> const& entries);
+
+		INLINE uint64_t						GetBudget() const { return mBudget; }
+		INLINE void							SetBudget(uint64_t budget) { mBudget = budget; }
+
+	private:
+		uint64_t							mBudget;
+
+		// Frames after which a texture not used is only kept for its tail
+		uint32_t							mKeepFrames;
+		uint32_t							mMaxLoadsPerUpdate;
+	};
+}
@@ -103,6 +103,8 @@ namespace Darius::Renderer
 
 	bool TerrainResource::UploadToGpu()
 	{
+		BuildQuadTree();
+
 		auto renderType = D_RENDERER::GetActiveRendererType();
 
 		switch (renderType)
@@ -124,6 +126,81 @@ namespace Darius::Renderer
 		mMesh.mBoundSp = D_MATH_BOUNDS::BoundingSphere(D_MATH::Vector3::Zero, extents.Length());
 	}
 
+	void TerrainResource::BuildQuadTree()
+	{
+		D_PROFILING::ScopedTimer _prof(L"Building Terrain Quad Tree");
+
+		TerrainQuadTree::Config config;
+		config.Width = GRID_WIDTH;
+		config.Depth = GRID_DEPTH;
+		config.HeightScale = mHeightFactor;
+
+		// Reading height map data from its file since texture data only lives on gpu
+		DirectX::ScratchImage image;
+		DirectX::TexMetadata meta;
+		HRESULT hr = E_FAIL;
+
+		if (mHeightMap.IsValid() && !mHeightMap->IsDefault())
+		{
+			auto const& path = mHeightMap->GetPath();
+			auto ext = boost::algorithm::to_lower_copy(path.extension().string());
+			auto fileData = D_FILE::ReadFileSync(path.wstring());
+			bool hasData = fileData && !fileData->empty();
+
+			if (hasData && ext == ".dds")
+				hr = DirectX::LoadFromDDSMemory(fileData->data(), fileData->size(), DirectX::DDS_FLAGS_NONE, &meta, image);
+			else if (hasData && ext == ".png")
+				hr = DirectX::LoadFromWICMemory(fileData->data(), fileData->size(), DirectX::WIC_FLAGS_NONE, &meta, image);
+			else if (hasData && ext == ".tga")
+				hr = DirectX::LoadFromTGAMemory(fileData->data(), fileData->size(), DirectX::TGA_FLAGS_NONE, &meta, image);
+		}
+
+		DirectX::ScratchImage heights;
+		if (SUCCEEDED(hr))
+		{
+			DirectX::Image const* source = image.GetImage(0, 0, 0);
+
+			DirectX::ScratchImage decompressed;
+			if (DirectX::IsCompressed(meta.format))
+			{
+				hr = DirectX::Decompress(*source, DXGI_FORMAT_UNKNOWN, decompressed);
+				source = decompressed.GetImage(0, 0, 0);
+			}
+
+			if (SUCCEEDED(hr))
+			{
+				if (source->format == DXGI_FORMAT_R32_FLOAT)
+					hr = heights.InitializeFromImage(*source);
+				else
+					hr = DirectX::Convert(*source, DXGI_FORMAT_R32_FLOAT, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, heights);
+			}
+		}
+
+		if (FAILED(hr))
+		{
+			// Flat terrain for default or unreadable height maps
+			float flat[4] = { 0.f, 0.f, 0.f, 0.f };
+			mQuadTree.Build(flat, 2u, 2u, config);
+			return;
+		}
+
+		DirectX::Image const* heightsImage = heights.GetImage(0, 0, 0);
+
+		// Rows may be padded
+		if (heightsImage->rowPitch == heightsImage->width * sizeof(float))
+		{
+			mQuadTree.Build(reinterpret_cast<float const*>(heightsImage->pixels), (uint32_t)heightsImage->width, (uint32_t)heightsImage->height, config);
+		}
+		else
+		{
+			DVector<float> packed(heightsImage->width * heightsImage->height);
+			for (size_t row = 0; row < heightsImage->height; row++)
+				std::memcpy(&packed[row * heightsImage->width], heightsImage->pixels + row * heightsImage->rowPitch, heightsImage->width * sizeof(float));
+
+			mQuadTree.Build(packed.data(), (uint32_t)heightsImage->width, (uint32_t)heightsImage->height, config);
+		}
+	}
+
 	bool TerrainResource::InitRayTracing()
 	{
 		auto& context = D_GRAPHICS::ComputeContext::Begin(L"Initializing Ray Tracing Terrain Resource");
@@ -2,6 +2,7 @@
 
 #include "TextureResource.hpp"
 
+#include "Renderer/Geometry/TerrainQuadTree.hpp"
 #include "Renderer/Resources/StaticMeshResource.hpp"
 
 #include <Graphics/GraphicsUtils/Memory/DescriptorHeap.hpp>
@@ -43,6 +44,9 @@ namespace Darius::Renderer
 
 		INLINE D_RENDERER_GEOMETRY::Mesh const& GetMeshData() const { return mMesh; }
 
+		// CPU side LOD quad tree of the height map, built on upload
+		INLINE D_RENDERER_GEOMETRY::TerrainQuadTree const& GetQuadTree() const { return mQuadTree; }
+
 		INLINE virtual bool				AreDependenciesDirty() const override { return mHeightMap.IsValidAndGpuDirty(); }
 
 		void							GetDimensions(float& width, float& height);
@@ -56,6 +60,7 @@ namespace Darius::Renderer
 		virtual INLINE void				Unload() override { EvictFromGpu(); }
 
 		void							UpdateBoundsMath();
+		void							BuildQuadTree();
 	private:
 
 		TerrainResource(D_CORE::Uuid const& uuid, std::wstring const& path, std::wstring const& name, D_RESOURCE::DResourceId id, D_RESOURCE::Resource* parent, bool isDefault = false);
@@ -80,6 +85,9 @@ namespace Darius::Renderer
 
 		D_GRAPHICS_BUFFERS::Texture						mGeneratedNormalMap;
 
+		// LOD
+		D_RENDERER_GEOMETRY::TerrainQuadTree			mQuadTree;
+
 	};
 }
 
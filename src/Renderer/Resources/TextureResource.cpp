@@ -1,8 +1,12 @@
 #include "Renderer/pch.hpp"
 #include "TextureResource.hpp"
 
+#include "TextureStreaming.hpp"
+
 #include <Core/Serialization/TypeSerializer.hpp>
 #include <Graphics/CommandContext.hpp>
+#include <Graphics/GraphicsCore.hpp>
+#include <Graphics/GraphicsDeviceManager.hpp>
 #include <ResourceManager/ResourceManager.hpp>
 #include <Math/VectorMath.hpp>
 
@@ -316,8 +320,17 @@ namespace Darius::Renderer
 		auto ext = boost::algorithm::to_lower_copy(path.extension().string());
 		if (ext == ".dds")
 		{
-			auto fileData = D_FILE::ReadFileSync(path.wstring());
 			mCreatedManually = false;
+			if (D_RENDERER_STREAMING::IsEnabled() && UploadStreamedDDS(path.wstring()))
+				return true;
+
+			if (mStreamed)
+			{
+				D_RENDERER_STREAMING::Unregister(this);
+				mStreamed = false;
+			}
+
+			auto fileData = D_FILE::ReadFileSync(path.wstring());
 			return mTexture.CreateDDSFromMemory(fileData->data(), fileData->size(), IsSRGB());
 
 
@@ -343,11 +356,95 @@ namespace Darius::Renderer
 	}
 
 
+	bool TextureResource::UploadStreamedDDS(std::wstring const& path)
+	{
+		using namespace D_GRAPHICS_BUFFERS;
+
+		uint64_t fileSize = D_FILE::GetFileByteSize(path);
+		auto header = D_FILE::ReadFileRangeSync(path, 0u, std::min<uint64_t>(fileSize, DDSMipLayout::MaxHeaderSize));
+
+		DDSMipLayout layout;
+		if (header->empty() || !ParseDDSMipLayout(header->data(), header->size(), fileSize, layout) || !layout.IsStreamable())
+			return false;
+
+		// Small enough to be loaded whole
+		uint32_t tailMip = layout.GetFirstMipWithin(D_RENDERER_STREAMING::GetTailSize());
+		if (tailMip == 0u)
+			return false;
+
+		auto tail = D_FILE::ReadFileRangeSync(path, layout.GetRangeOffset(tailMip), layout.GetRangeSize(tailMip));
+		if (tail->empty())
+			return false;
+
+		mTexture.CreateDDSMipRange(layout, tailMip, tail->data(), IsSRGB());
+
+		mStreamed = true;
+		mStreamedSize = std::max(layout.Width, layout.Height);
+		mStreamingRequestedMip = UINT32_MAX;
+		D_RENDERER_STREAMING::Register(this, layout, tailMip);
+
+		return true;
+	}
+
+	void TextureResource::ReportScreenSize(float pixels)
+	{
+		if (!mStreamed)
+			return;
+
+		// Mip with about a texel per pixel
+		float ratio = (float)mStreamedSize / std::max(pixels, 1.f);
+		uint32_t mip = ratio <= 1.f ? 0u : (uint32_t)std::log2(ratio);
+
+		uint32_t current = mStreamingRequestedMip.load(std::memory_order_relaxed);
+		while (mip < current && !mStreamingRequestedMip.compare_exchange_weak(current, mip, std::memory_order_relaxed));
+
+		mStreamingLastUsedFrame.store(D_GRAPHICS::GetFrameCount(), std::memory_order_relaxed);
+	}
+
+	bool TextureResource::ConsumeStreamingFeedback(uint32_t& requestedMip, uint64_t& lastUsedFrame)
+	{
+		requestedMip = mStreamingRequestedMip.exchange(UINT32_MAX, std::memory_order_relaxed);
+		if (requestedMip == UINT32_MAX)
+			return false;
+
+		lastUsedFrame = mStreamingLastUsedFrame.load(std::memory_order_relaxed);
+		return true;
+	}
+
+	void TextureResource::ApplyStreamedMips(D_GRAPHICS_BUFFERS::DDSMipLayout const& layout, uint32_t firstMip, void const* data)
+	{
+		mTexture.CreateDDSMipRange(layout, firstMip, data, IsSRGB());
+
+		// Materials copy the descriptor again
+		SignalChange();
+	}
+
 	void TextureResource::Unload()
 	{
+		if (mStreamed)
+		{
+			D_RENDERER_STREAMING::Unregister(this);
+			mStreamed = false;
+		}
+
 		EvictFromGpu();
 	}
 
+	void TextureResource::EvictFromGpu()
+	{
+		mTexture.Destroy();
+	}
+
+	uint64_t TextureResource::GetResidentSize() const
+	{
+		auto resource = mTexture.GetResource();
+		if (!resource)
+			return 0u;
+
+		auto desc = resource->GetDesc();
+		return D_GRAPHICS_DEVICE::GetDevice()->GetResourceAllocationInfo(0, 1, &desc).SizeInBytes;
+	}
+
 	void TextureResource::SetUAddressing(D3D12_TEXTURE_ADDRESS_MODE value)
 	{
 		if (mUAddressing == value)
@@ -7,6 +7,8 @@
 #include <ResourceManager/Resource.hpp>
 #include <Utils/Common.hpp>
 
+#include <atomic>
+
 #include "TextureResource.generated.hpp"
 
 #ifndef D_RENDERER
@@ -69,6 +71,19 @@ namespace Darius::Renderer
 
 		INLINE virtual bool							AreDependenciesDirty() const override { return false; }
 
+		// Streaming
+		INLINE bool									IsStreamed() const { return mStreamed; }
+
+		// Feedback with the size of the texture on the screen in pixels. Thread safe.
+		void										ReportScreenSize(float pixels);
+
+		// Most detailed mip reported and the frame it was reported in since the last call.
+		// Returns false if there was no report.
+		bool										ConsumeStreamingFeedback(uint32_t& requestedMip, uint64_t& lastUsedFrame);
+
+		// Replaces the texture with the mips from the first mip read by the texture streamer
+		void										ApplyStreamedMips(D_GRAPHICS_BUFFERS::DDSMipLayout const& layout, uint32_t firstMip, void const* data);
+
 	protected:
 		TextureResource(D_CORE::Uuid const& uuid, std::wstring const& path, std::wstring const& name, D_RESOURCE::DResourceId id, D_RESOURCE::Resource* parent, bool isDefault = false) :
 			Resource(uuid, path, name, id, parent, isDefault),
@@ -81,7 +96,11 @@ namespace Darius::Renderer
 			mBorderColor(D_MATH::Color::Black),
 			mSamplerDesc(),
 			mDirtySampler(true),
-			mCreatedManually(true)
+			mCreatedManually(true),
+			mStreamed(false),
+			mStreamedSize(0u),
+			mStreamingRequestedMip(UINT32_MAX),
+			mStreamingLastUsedFrame(0u)
 		{}
 
 
@@ -91,6 +110,11 @@ namespace Darius::Renderer
 		virtual bool								UploadToGpu() override;
 
 		virtual void								Unload() override;
+		virtual void								EvictFromGpu() override;
+		virtual uint64_t							GetResidentSize() const override;
+
+		// Loads the tail mips only and registers the texture for streaming
+		bool										UploadStreamedDDS(std::wstring const& path);
 		
 		DField(Serialize)
 		TextureFilterType							mFilter;
@@ -123,6 +147,14 @@ namespace Darius::Renderer
 
 		D_GRAPHICS_UTILS::SamplerDesc				mSamplerDesc;
 
+		bool										mStreamed;
+
+		// Largest dimension of the most detailed mip in the file
+		uint32_t									mStreamedSize;
+
+		std::atomic_uint32_t						mStreamingRequestedMip;
+		std::atomic_uint64_t						mStreamingLastUsedFrame;
+
 	};
 }
 
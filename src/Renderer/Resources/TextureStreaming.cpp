@@ -0,0 +1,268 @@
+#include "Renderer/pch.hpp"
+#include "TextureStreaming.hpp"
+
+#include "MipResidencyPolicy.hpp"
+#include "TextureResource.hpp"
+
+#include <Core/Containers/ConcurrentQueue.hpp>
+#include <Core/Containers/Map.hpp>
+#include <Core/Filesystem/FileUtils.hpp>
+#include <Graphics/GraphicsCore.hpp>
+#include <Graphics/GraphicsDeviceManager.hpp>
+#include <Job/Job.hpp>
+#include <Utils/Assert.hpp>
+
+#include <mutex>
+#include <queue>
+
+using namespace D_CONTAINERS;
+using namespace D_GRAPHICS_BUFFERS;
+
+namespace Darius::Renderer::TextureStreaming
+{
+	struct StreamedTexture
+	{
+		TextureResource*				Texture;
+		std::wstring					Path;
+		DDSMipLayout					Layout;
+
+		// Distinguishes the loads started for a previous registration
+		uint64_t						Version;
+	};
+
+	struct CompletedLoad
+	{
+		TextureResource*				Texture;
+		uint64_t						Version;
+		uint32_t						FirstMip;
+		D_FILE::ByteArray				Data;
+	};
+
+	// Reads the mips from the first mip to the smallest one
+	class MipRangeLoadTask : public D_JOB::IPinnedTask
+	{
+	public:
+		virtual void Execute() override;
+
+		CompletedLoad					mLoad;
+		std::wstring					mPath;
+		uint64_t						mOffset = 0u;
+		uint64_t						mSize = 0u;
+	};
+
+	bool								_initialized = false;
+
+	// Settings
+	bool								Enabled;
+	uint32_t							BudgetMB;
+	uint32_t							TailSize;
+	uint32_t							KeepFrames;
+	uint32_t							MaxLoadsPerFrame;
+	float								ScreenHeight;
+
+	std::unique_ptr<MipResidencyPolicy>	Policy;
+
+	// Entries and textures are parallel
+	std::mutex							Mutex;
+	DVector<MipResidencyPolicy::Entry>	Entries;
+	DVector<StreamedTexture>			Textures;
+	DUnorderedMap<TextureResource*, uint32_t> TextureIndices;
+	uint64_t							NextVersion = 1u;
+
+	// Pushed by the file loading threads
+	ConcurrentQueue<CompletedLoad>		Completed;
+
+	// Replaced resources are kept alive until the frames using them are finished
+	std::queue<std::pair<uint64_t, Microsoft::WRL::ComPtr<ID3D12Resource>>> RetiredResources;
+
+	DVector<MipResidencyPolicy::Decision> Decisions;
+
+	void								ApplyCompletedLoads(uint64_t frame);
+
+	void Initialize(D_SERIALIZATION::Json const& settings)
+	{
+		D_ASSERT(!_initialized);
+		_initialized = true;
+
+		D_H_OPTIONS_LOAD_BASIC_DEFAULT("Renderer.TextureStreaming", Enabled, true);
+		D_H_OPTIONS_LOAD_BASIC_DEFAULT("Renderer.TextureStreamingBudgetMB", BudgetMB, 512u);
+		D_H_OPTIONS_LOAD_BASIC_DEFAULT("Renderer.TextureStreamingTailSize", TailSize, 128u);
+		D_H_OPTIONS_LOAD_BASIC_DEFAULT("Renderer.TextureStreamingKeepFrames", KeepFrames, 30u);
+		D_H_OPTIONS_LOAD_BASIC_DEFAULT("Renderer.TextureStreamingMaxLoadsPerFrame", MaxLoadsPerFrame, 8u);
+		D_H_OPTIONS_LOAD_BASIC_DEFAULT("Renderer.TextureStreamingScreenHeight", ScreenHeight, 1080.f);
+
+		Policy = std::make_unique<MipResidencyPolicy>((uint64_t)BudgetMB * 1024u * 1024u, KeepFrames, MaxLoadsPerFrame);
+	}
+
+	void Shutdown()
+	{
+		D_ASSERT(_initialized);
+
+		std::scoped_lock lock(Mutex);
+		Entries.clear();
+		Textures.clear();
+		TextureIndices.clear();
+
+		while (!RetiredResources.empty())
+			RetiredResources.pop();
+	}
+
+	bool IsEnabled()
+	{
+		return _initialized && Enabled;
+	}
+
+	uint32_t GetTailSize()
+	{
+		return TailSize;
+	}
+
+	void Register(TextureResource* texture, DDSMipLayout const& layout, uint32_t tailMip)
+	{
+		D_ASSERT(layout.IsStreamable());
+		D_ASSERT(tailMip < layout.GetMipCount());
+
+		MipResidencyPolicy::Entry entry;
+		entry.SizeFromMip.resize(layout.GetMipCount());
+		for (uint32_t i = 0u; i < layout.GetMipCount(); i++)
+			entry.SizeFromMip[i] = layout.GetRangeSize(i);
+		entry.TailMip = entry.ResidentMip = entry.TargetMip = entry.RequestedMip = tailMip;
+
+		std::scoped_lock lock(Mutex);
+
+		auto it = TextureIndices.find(texture);
+		uint32_t index;
+		if (it == TextureIndices.end())
+		{
+			index = (uint32_t)Entries.size();
+			Entries.push_back({});
+			Textures.push_back({});
+			TextureIndices[texture] = index;
+		}
+		else
+			index = it->second;
+
+		entry.LastUsedFrame = D_GRAPHICS::GetFrameCount();
+		Entries[index] = std::move(entry);
+		Textures[index] = { texture, texture->GetPath().wstring(), layout, NextVersion++ };
+	}
+
+	void Unregister(TextureResource* texture)
+	{
+		std::scoped_lock lock(Mutex);
+
+		auto it = TextureIndices.find(texture);
+		if (it == TextureIndices.end())
+			return;
+
+		// Swapping with the last one
+		uint32_t index = it->second;
+		uint32_t last = (uint32_t)Entries.size() - 1u;
+		TextureIndices.erase(it);
+		if (index != last)
+		{
+			Entries[index] = std::move(Entries[last]);
+			Textures[index] = std::move(Textures[last]);
+			TextureIndices[Textures[index].Texture] = index;
+		}
+		Entries.pop_back();
+		Textures.pop_back();
+	}
+
+	float GetScreenSize(D_MATH_CAMERA::BaseCamera const& camera, D_MATH::Vector3 const& center, float radius)
+	{
+		// Projected radius relative to half of the screen height
+		float distance = std::max((center - camera.GetPosition()).Length() - radius, 0.01f);
+		float projScale = camera.GetProjMatrix().GetY().GetY();
+
+		return radius * projScale / distance * ScreenHeight;
+	}
+
+	uint64_t GetCommittedSize()
+	{
+		std::scoped_lock lock(Mutex);
+		return MipResidencyPolicy::GetCommittedSize(Entries);
+	}
+
+	void Update()
+	{
+		if (!IsEnabled())
+			return;
+
+		uint64_t frame = D_GRAPHICS::GetFrameCount();
+
+		while (!RetiredResources.empty() && RetiredResources.front().first + D_GRAPHICS_DEVICE::gNumFrameResources < frame)
+			RetiredResources.pop();
+
+		std::scoped_lock lock(Mutex);
+
+		ApplyCompletedLoads(frame);
+
+		// Feedback of the frames since the last update
+		for (uint32_t i = 0u; i < (uint32_t)Entries.size(); i++)
+		{
+			auto& entry = Entries[i];
+
+			uint32_t requestedMip;
+			uint64_t lastUsedFrame;
+			if (Textures[i].Texture->ConsumeStreamingFeedback(requestedMip, lastUsedFrame))
+			{
+				entry.RequestedMip = std::min(requestedMip, entry.TailMip);
+				entry.LastUsedFrame = lastUsedFrame;
+			}
+		}
+
+		Policy->Evaluate(Entries, frame, Decisions);
+
+		for (auto const& decision : Decisions)
+		{
+			auto& entry = Entries[decision.Entry];
+			auto const& streamed = Textures[decision.Entry];
+			entry.TargetMip = decision.TargetMip;
+
+			auto task = new MipRangeLoadTask();
+			task->mLoad = { streamed.Texture, streamed.Version, decision.TargetMip, nullptr };
+			task->mPath = streamed.Path;
+			task->mOffset = streamed.Layout.GetRangeOffset(decision.TargetMip);
+			task->mSize = streamed.Layout.GetRangeSize(decision.TargetMip);
+			D_JOB::AddPinnedTask(task, D_JOB::ThreadType::FileIO);
+		}
+	}
+
+	void ApplyCompletedLoads(uint64_t frame)
+	{
+		CompletedLoad load;
+		while (Completed.TryPop(load))
+		{
+			auto it = TextureIndices.find(load.Texture);
+
+			// Unregistered or registered again while loading
+			if (it == TextureIndices.end() || Textures[it->second].Version != load.Version)
+				continue;
+
+			auto& entry = Entries[it->second];
+			auto const& streamed = Textures[it->second];
+
+			if (load.Data->empty())
+			{
+				// Will be decided on again
+				entry.TargetMip = entry.ResidentMip;
+				continue;
+			}
+
+			Microsoft::WRL::ComPtr<ID3D12Resource> previous = load.Texture->GetTextureData()->GetResource();
+			if (previous)
+				RetiredResources.push({ frame, previous });
+
+			load.Texture->ApplyStreamedMips(streamed.Layout, load.FirstMip, load.Data->data());
+			entry.ResidentMip = entry.TargetMip = load.FirstMip;
+		}
+	}
+
+	void MipRangeLoadTask::Execute()
+	{
+		mLoad.Data = D_FILE::ReadFileRangeSync(mPath, mOffset, mSize);
+
+		Completed.Push(std::move(mLoad));
+	}
+}
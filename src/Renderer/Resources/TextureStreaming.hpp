@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Core/Serialization/Json.hpp>
+#include <Graphics/GraphicsUtils/Buffers/DDSMipLayout.hpp>
+#include <Math/Camera/Camera.hpp>
+#include <Utils/Common.hpp>
+
+#ifndef D_RENDERER_STREAMING
+#define D_RENDERER_STREAMING Darius::Renderer::TextureStreaming
+#endif // !D_RENDERER_STREAMING
+
+namespace Darius::Renderer
+{
+	class TextureResource;
+}
+
+// Keeps the mips of the streamed DDS textures resident based on the feedback of the renderer
+// and within a memory budget. Textures start with their tail mips and the rest is read from
+// the file on the file IO thread.
+namespace Darius::Renderer::TextureStreaming
+{
+	void					Initialize(D_SERIALIZATION::Json const& settings);
+	void					Shutdown();
+
+	// Applies the finished loads and starts the new ones. Called on the main thread once a frame.
+	void					Update();
+
+	bool					IsEnabled();
+
+	// Mips not larger than this in any dimension are always resident
+	uint32_t				GetTailSize();
+
+	// Thread safe. Registering again resets the texture's residency.
+	void					Register(TextureResource* texture, D_GRAPHICS_BUFFERS::DDSMipLayout const& layout, uint32_t tailMip);
+	void					Unregister(TextureResource* texture);
+
+	// Size of a sphere on the screen of the camera in pixels, based on the reference screen height
+	float					GetScreenSize(D_MATH_CAMERA::BaseCamera const& camera, D_MATH::Vector3 const& center, float radius);
+
+	// Resident size of the streamed textures including the loads in flight
+	uint64_t				GetCommittedSize();
+}
@@ -0,0 +1,305 @@
+#define BOOST_TEST_MODULE RendererTests
+#define BOOST_TEST_DYN_LINK
+
+#include <Renderer/Geometry/TerrainQuadTree.hpp>
+#include <Renderer/Resources/MipResidencyPolicy.hpp>
+
+#include <boost/test/included/unit_test.hpp>
+
+using namespace D_CONTAINERS;
+using namespace D_MATH;
+using namespace D_RENDERER;
+using namespace D_RENDERER_GEOMETRY;
+
+namespace
+{
+	// Height grows along x so that every node has a distinct range
+	DVector<float> CreateRampHeightMap(uint32_t width, uint32_t height)
+	{
+		DVector<float> heights(width * height);
+		for (uint32_t y = 0u; y < height; y++)
+			for (uint32_t x = 0u; x < width; x++)
+				heights[y * width + x] = (float)x / (width - 1);
+		return heights;
+	}
+
+	// Area of the selected nodes in leaf units, checking no leaf is selected twice
+	bool CoversWithoutOverlap(TerrainQuadTree const& tree, DVector<TerrainQuadTree::SelectedNode> const& selection)
+	{
+		uint32_t side = tree.GetLeavesPerSide();
+		DVector<uint8_t> covered(side * side, 0u);
+
+		for (auto const& selected : selection)
+		{
+			auto const& node = tree.GetNode(selected.NodeIndex);
+			for (uint32_t y = node.Y; y < node.Y + node.Size; y++)
+				for (uint32_t x = node.X; x < node.X + node.Size; x++)
+					if (covered[y * side + x]++ != 0u)
+						return false;
+		}
+
+		for (auto c : covered)
+			if (c != 1u)
+				return false;
+		return true;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(TerrainQuadTreeTests)
+
+BOOST_AUTO_TEST_CASE(HeightBounds)
+{
+	auto heights = CreateRampHeightMap(65u, 65u);
+
+	TerrainQuadTree::Config config;
+	config.LodLevelCount = 4u;
+	config.HeightScale = 10.f;
+
+	TerrainQuadTree tree;
+	tree.Build(heights.data(), 65u, 65u, config);
+
+	BOOST_TEST(tree.GetLeavesPerSide() == 8u);
+	BOOST_TEST(tree.GetNodeCount() == 64u + 16u + 4u + 1u);
+
+	auto const& root = tree.GetNode(tree.GetRootIndex());
+	BOOST_TEST(root.Size == 8u);
+	BOOST_TEST(root.MinHeight == 0.f);
+	BOOST_TEST(root.MaxHeight == 1.f);
+
+	// Each leaf covers 8 samples plus the shared border sample
+	for (uint32_t i = 0u; i < 64u; i++)
+	{
+		auto const& leaf = tree.GetNode(i);
+		BOOST_TEST(leaf.Level == 0u);
+		BOOST_TEST(leaf.MinHeight == (float)(leaf.X * 8u) / 64.f);
+		BOOST_TEST(leaf.MaxHeight == (float)(leaf.X * 8u + 8u) / 64.f);
+	}
+
+	auto aabb = tree.GetNodeAabb(root);
+	BOOST_TEST(aabb.GetMin().GetY() == 0.f);
+	BOOST_TEST(aabb.GetMax().GetY() == 10.f);
+}
+
+BOOST_AUTO_TEST_CASE(SelectionCoversTerrain)
+{
+	auto heights = CreateRampHeightMap(129u, 129u);
+
+	TerrainQuadTree::Config config;
+	config.LodLevelCount = 5u;
+	config.FinestLodDistance = 10.f;
+
+	TerrainQuadTree tree;
+	tree.Build(heights.data(), 129u, 129u, config);
+
+	DVector<TerrainQuadTree::SelectedNode> selection;
+
+	// Camera on a corner, finest nodes near it and coarser ones away
+	TerrainQuadTree::SelectionParams params;
+	params.CameraPosition = Vector3(-50.f, 1.f, 50.f);
+	tree.Select(params, selection);
+
+	BOOST_TEST(CoversWithoutOverlap(tree, selection));
+
+	bool hasFinest = false;
+	bool hasCoarse = false;
+	for (auto const& selected : selection)
+	{
+		auto const& node = tree.GetNode(selected.NodeIndex);
+		BOOST_TEST(selected.Lod >= node.Level);
+		BOOST_TEST(selected.Lod <= node.Level + 1u);
+		BOOST_TEST(selected.MorphStart < selected.MorphEnd);
+		hasFinest |= selected.Lod == 0u;
+		hasCoarse |= selected.Lod > 1u;
+	}
+	BOOST_TEST(hasFinest);
+	BOOST_TEST(hasCoarse);
+}
+
+BOOST_AUTO_TEST_CASE(FarCameraSelectsRoot)
+{
+	auto heights = CreateRampHeightMap(33u, 33u);
+
+	TerrainQuadTree::Config config;
+	config.LodLevelCount = 3u;
+
+	TerrainQuadTree tree;
+	tree.Build(heights.data(), 33u, 33u, config);
+
+	DVector<TerrainQuadTree::SelectedNode> selection;
+
+	TerrainQuadTree::SelectionParams params;
+	params.CameraPosition = Vector3(0.f, 10000.f, 0.f);
+
+	BOOST_TEST(tree.Select(params, selection) == 1u);
+	BOOST_TEST(selection[0].NodeIndex == tree.GetRootIndex());
+	BOOST_TEST(selection[0].Lod == 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+	// Square 4 bytes per pixel texture with the full mip chain, resident from the tail
+	MipResidencyPolicy::Entry CreateMipEntry(uint32_t size, uint32_t tailSize = 64u)
+	{
+		MipResidencyPolicy::Entry entry;
+
+		DVector<uint64_t> mipSizes;
+		for (uint32_t s = size; s > 0u; s >>= 1)
+		{
+			mipSizes.push_back((uint64_t)s * s * 4u);
+			if (s > tailSize)
+				entry.TailMip++;
+		}
+
+		entry.SizeFromMip.resize(mipSizes.size());
+		uint64_t total = 0u;
+		for (size_t i = mipSizes.size(); i-- > 0u;)
+		{
+			total += mipSizes[i];
+			entry.SizeFromMip[i] = total;
+		}
+
+		entry.ResidentMip = entry.TargetMip = entry.RequestedMip = entry.TailMip;
+		return entry;
+	}
+
+	void ApplyDecisions(DVector<MipResidencyPolicy::Entry>& entries, DVector<MipResidencyPolicy::Decision> const& decisions)
+	{
+		for (auto const& decision : decisions)
+			entries[decision.Entry].ResidentMip = entries[decision.Entry].TargetMip = decision.TargetMip;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(MipResidencyPolicyTests)
+
+BOOST_AUTO_TEST_CASE(LoadsRecentlyUsedFirst)
+{
+	DVector<MipResidencyPolicy::Entry> entries = { CreateMipEntry(1024u), CreateMipEntry(1024u) };
+	uint64_t tails = entries[0].GetSize(entries[0].TailMip) * 2u;
+
+	// Room for one whole texture only
+	MipResidencyPolicy policy(tails + entries[0].GetSize(0u) - entries[0].GetSize(entries[0].TailMip));
+
+	entries[0].RequestedMip = 0u;
+	entries[0].LastUsedFrame = 9u;
+	entries[1].RequestedMip = 0u;
+	entries[1].LastUsedFrame = 10u;
+
+	DVector<MipResidencyPolicy::Decision> decisions;
+	policy.Evaluate(entries, 10u, decisions);
+	ApplyDecisions(entries, decisions);
+
+	BOOST_TEST(entries[1].ResidentMip == 0u);
+	BOOST_TEST(entries[0].ResidentMip == entries[0].TailMip);
+	BOOST_TEST(MipResidencyPolicy::GetCommittedSize(entries) <= policy.GetBudget());
+
+	// The other texture becomes the recent one and takes the memory
+	entries[0].LastUsedFrame = 11u;
+	entries[1].RequestedMip = entries[1].TailMip;
+	policy.Evaluate(entries, 11u, decisions);
+	ApplyDecisions(entries, decisions);
+
+	BOOST_TEST(entries[0].ResidentMip == 0u);
+	BOOST_TEST(entries[1].ResidentMip == entries[1].TailMip);
+	BOOST_TEST(MipResidencyPolicy::GetCommittedSize(entries) <= policy.GetBudget());
+}
+
+BOOST_AUTO_TEST_CASE(KeepsMipsUntilMemoryIsNeeded)
+{
+	DVector<MipResidencyPolicy::Entry> entries = { CreateMipEntry(512u), CreateMipEntry(512u) };
+	MipResidencyPolicy policy(entries[0].GetSize(0u) * 2u, 30u);
+
+	entries[0].ResidentMip = entries[0].TargetMip = 0u;
+	entries[0].RequestedMip = entries[0].TailMip;
+
+	// Not needed and stale, but there is enough memory
+	DVector<MipResidencyPolicy::Decision> decisions;
+	policy.Evaluate(entries, 100u, decisions);
+	BOOST_TEST(decisions.empty());
+
+	// Loads in flight are not decided on again
+	entries[1].RequestedMip = 0u;
+	entries[1].LastUsedFrame = 100u;
+	entries[1].TargetMip = 0u;
+	policy.Evaluate(entries, 100u, decisions);
+	BOOST_TEST(decisions.empty());
+
+	// Lowered budget drops the unneeded mips first
+	entries[1].ResidentMip = 0u;
+	policy.SetBudget(entries[0].GetSize(0u) + entries[0].GetSize(entries[0].TailMip));
+	policy.Evaluate(entries, 100u, decisions);
+	BOOST_TEST(decisions.size() == 1u);
+	BOOST_TEST(decisions[0].Entry == 0u);
+	BOOST_TEST(decisions[0].TargetMip == entries[0].TailMip);
+
+	// Needed mips are dropped too but never the tail
+	ApplyDecisions(entries, decisions);
+	policy.SetBudget(0u);
+	policy.Evaluate(entries, 100u, decisions);
+	ApplyDecisions(entries, decisions);
+	BOOST_TEST(entries[1].ResidentMip == entries[1].TailMip);
+	BOOST_TEST(entries[0].ResidentMip == entries[0].TailMip);
+}
+
+BOOST_AUTO_TEST_CASE(LimitsLoadsPerUpdate)
+{
+	DVector<MipResidencyPolicy::Entry> entries(20u, CreateMipEntry(256u));
+	for (auto& entry : entries)
+		entry.RequestedMip = 0u;
+
+	MipResidencyPolicy policy(~0ull, 30u, 8u);
+
+	DVector<MipResidencyPolicy::Decision> decisions;
+	policy.Evaluate(entries, 0u, decisions);
+	BOOST_TEST(decisions.size() == 8u);
+}
+
+// Camera moving over a set of textures, checking the budget is never exceeded
+// and the visible textures get their mips. Its timing is in the benchmarks.
+BOOST_AUTO_TEST_CASE(KeepsBudgetWhileCameraMoves)
+{
+	constexpr uint32_t textureCount = 200u;
+	constexpr uint32_t visibleCount = 16u;
+
+	DVector<MipResidencyPolicy::Entry> entries;
+	uint64_t tails = 0u;
+	for (uint32_t i = 0u; i < textureCount; i++)
+	{
+		entries.push_back(CreateMipEntry(i % 3 == 0 ? 2048u : 1024u));
+		tails += entries.back().GetSize(entries.back().TailMip);
+	}
+
+	// Room for the visible textures at their largest
+	MipResidencyPolicy policy(tails + visibleCount * entries[0].GetSize(0u), 30u, 4u);
+
+	DVector<MipResidencyPolicy::Decision> decisions;
+	for (uint64_t frame = 1u; frame <= 2000u; frame++)
+	{
+		// Window of visible textures moves every 50 frames
+		uint32_t first = (uint32_t)(frame / 50u) * 7u % textureCount;
+		for (uint32_t i = 0u; i < visibleCount; i++)
+		{
+			auto& entry = entries[(first + i) % textureCount];
+			entry.RequestedMip = i % 4u;
+			entry.LastUsedFrame = frame;
+		}
+
+		policy.Evaluate(entries, frame, decisions);
+		ApplyDecisions(entries, decisions);
+
+		BOOST_TEST_REQUIRE(MipResidencyPolicy::GetCommittedSize(entries) <= policy.GetBudget());
+
+		// Enough frames for the loads of the window to finish
+		if (frame % 50u == 49u)
+		{
+			for (uint32_t i = 0u; i < visibleCount; i++)
+			{
+				auto const& entry = entries[(first + i) % textureCount];
+				BOOST_TEST_REQUIRE(entry.ResidentMip <= entry.RequestedMip);
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
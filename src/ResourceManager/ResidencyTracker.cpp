@@ -0,0 +1,188 @@
+#include "pch.hpp"
+#include "ResidencyTracker.hpp"
+
+#include <Core/Containers/Vector.hpp>
+
+#include <mutex>
+
+using namespace D_CONTAINERS;
+
+namespace Darius::ResourceManager
+{
+	ResidencyTracker::ResidencyTracker(EvictFunc evict, BudgetFunc budget, uint32_t keepFrames) :
+		mEvict(evict),
+		mDefaultBudget(budget),
+		mKeepFrames(keepFrames)
+	{ }
+
+	ResidencyTracker::~ResidencyTracker()
+	{
+		// The entries outlive the tracker
+		for (auto& [_, list] : mTypes)
+		{
+			while (list.Head)
+				Unlink(list, *list.Head);
+		}
+	}
+
+	void ResidencyTracker::SetBudget(uint16_t type, uint64_t budget)
+	{
+		std::scoped_lock lock(mLock);
+		GetTypeList(type).Budget = budget;
+	}
+
+	uint64_t ResidencyTracker::GetBudget(uint16_t type) const
+	{
+		std::scoped_lock lock(mLock);
+
+		auto search = mTypes.find(type);
+		return search == mTypes.end() ? mDefaultBudget(type) : search->second.Budget;
+	}
+
+	void ResidencyTracker::MarkUnused(Entry& entry, uint16_t type, uint64_t size)
+	{
+		std::scoped_lock lock(mLock);
+
+		// Released again, so it moves to the recent end
+		if (entry.mListed)
+			Unlink(GetTypeList(entry.mType), entry);
+
+		entry.mType = type;
+		entry.mSize = size;
+		entry.mUnusedFrame = mFrame.load(std::memory_order_relaxed);
+		Link(GetTypeList(type), entry);
+	}
+
+	void ResidencyTracker::Remove(Entry& entry)
+	{
+		std::scoped_lock lock(mLock);
+
+		if (entry.mListed)
+			Unlink(GetTypeList(entry.mType), entry);
+	}
+
+	void ResidencyTracker::Update(uint64_t frame)
+	{
+		mFrame.store(frame, std::memory_order_relaxed);
+
+		mOverBudget.clear();
+
+		{
+			std::scoped_lock lock(mLock);
+
+			for (auto const& [type, list] : mTypes)
+			{
+				if (list.Totals.UnusedSize > list.Budget)
+					mOverBudget.push_back({ type, list.Totals.UnusedCount });
+			}
+		}
+
+		// Each listed object is tried at most once, busy ones go back to the list
+		for (auto [type, count] : mOverBudget)
+		{
+			while (count-- > 0u && EvictOne(type, frame)) { }
+		}
+	}
+
+	bool ResidencyTracker::EvictOne(uint16_t type, uint64_t frame)
+	{
+		Entry* entry;
+
+		{
+			std::scoped_lock lock(mLock);
+
+			auto& list = GetTypeList(type);
+			if (list.Totals.UnusedSize <= list.Budget || !list.Head)
+				return false;
+
+			// The rest of the list is released even more recently
+			entry = list.Head;
+			if (entry->mUnusedFrame + mKeepFrames > frame)
+				return false;
+
+			Unlink(list, *entry);
+		}
+
+		// Evicting without the lock, since releases may happen meanwhile
+		auto result = mEvict(*entry);
+
+		std::scoped_lock lock(mLock);
+
+		switch (result)
+		{
+		case EvictResult::Evicted:
+			// Released again while being evicted, but there is nothing left to evict
+			if (entry->mListed)
+				Unlink(GetTypeList(entry->mType), *entry);
+			GetTypeList(type).Totals.EvictedCount++;
+			break;
+
+		case EvictResult::Busy:
+			if (!entry->mListed)
+			{
+				entry->mUnusedFrame = frame;
+				Link(GetTypeList(type), *entry);
+			}
+			break;
+
+		case EvictResult::InUse:
+		default:
+			break;
+		}
+
+		return true;
+	}
+
+	ResidencyTracker::Stats ResidencyTracker::GetStats(uint16_t type) const
+	{
+		std::scoped_lock lock(mLock);
+
+		auto search = mTypes.find(type);
+		return search == mTypes.end() ? Stats() : search->second.Totals;
+	}
+
+	ResidencyTracker::TypeList& ResidencyTracker::GetTypeList(uint16_t type)
+	{
+		auto [search, inserted] = mTypes.try_emplace(type);
+		if (inserted)
+			search->second.Budget = mDefaultBudget(type);
+		return search->second;
+	}
+
+	void ResidencyTracker::Link(TypeList& list, Entry& entry)
+	{
+		D_ASSERT(!entry.mListed);
+
+		entry.mPrev = list.Tail;
+		entry.mNext = nullptr;
+		if (list.Tail)
+			list.Tail->mNext = &entry;
+		else
+			list.Head = &entry;
+		list.Tail = &entry;
+
+		entry.mListed = true;
+		list.Totals.UnusedSize += entry.mSize;
+		list.Totals.UnusedCount++;
+	}
+
+	void ResidencyTracker::Unlink(TypeList& list, Entry& entry)
+	{
+		D_ASSERT(entry.mListed);
+
+		if (entry.mPrev)
+			entry.mPrev->mNext = entry.mNext;
+		else
+			list.Head = entry.mNext;
+
+		if (entry.mNext)
+			entry.mNext->mPrev = entry.mPrev;
+		else
+			list.Tail = entry.mPrev;
+
+		entry.mPrev = entry.mNext = nullptr;
+		entry.mListed = false;
+		list.Totals.UnusedSize -= entry.mSize;
+		list.Totals.UnusedCount--;
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <Core/Containers/Map.hpp>
+#include <Core/Containers/Vector.hpp>
+#include <Core/MultiThreading/SpinLock.hpp>
+#include <Utils/Assert.hpp>
+#include <Utils/Common.hpp>
+
+#include <atomic>
+#include <functional>
+
+#ifndef D_RESOURCE
+#define D_RESOURCE Darius::ResourceManager
+#endif // !D_RESOURCE
+
+namespace Darius::ResourceManager
+{
+	// Keeps the loaded objects which nothing references anymore in a least recently released list per
+	// resource type, and evicts from the old end of the list while their total size is over the budget
+	// of their type. Objects referenced again are found lazily by the evict callback.
+	class ResidencyTracker
+	{
+	public:
+		// Embedded in the tracked objects, pointing back to them
+		class Entry
+		{
+		public:
+			INLINE Entry(void* owner) : mOwner(owner) { }
+
+			INLINE void*					GetOwner() const { return mOwner; }
+
+		private:
+			friend class ResidencyTracker;
+
+			void* const						mOwner;
+			Entry*							mPrev = nullptr;
+			Entry*							mNext = nullptr;
+			uint64_t						mSize = 0u;
+			uint64_t						mUnusedFrame = 0u;
+			uint16_t						mType = 0u;
+			bool							mListed = false;
+		};
+
+		enum class EvictResult
+		{
+			Evicted,
+
+			// Referenced again or not evictable at all, leaves the list until released again
+			InUse,
+
+			// Can't be evicted right now, goes back to the recent end of the list
+			Busy
+		};
+
+		using EvictFunc = std::function<EvictResult(Entry&)>;
+
+		// Budget of a type when it is first seen
+		using BudgetFunc = std::function<uint64_t(uint16_t type)>;
+
+		struct Stats
+		{
+			uint64_t						UnusedSize = 0u;
+			uint32_t						UnusedCount = 0u;
+			uint32_t						EvictedCount = 0u;
+		};
+
+	public:
+		// Unused objects are kept for at least keepFrames even when over the budget, since the frames in flight may still use them
+		ResidencyTracker(EvictFunc evict, BudgetFunc budget, uint32_t keepFrames);
+		~ResidencyTracker();
+
+		void								SetBudget(uint16_t type, uint64_t budget);
+		uint64_t							GetBudget(uint16_t type) const;
+
+		// The object is not referenced anymore, size is what evicting it would free
+		void								MarkUnused(Entry& entry, uint16_t type, uint64_t size);
+
+		// Stops tracking the object, for when it is unloaded or destroyed by other means
+		void								Remove(Entry& entry);
+
+		// Evicts the least recently released objects of the types over their budgets. Not to be called concurrently.
+		void								Update(uint64_t frame);
+
+		Stats								GetStats(uint16_t type) const;
+
+	private:
+		struct TypeList
+		{
+			// Least recently released first
+			Entry*							Head = nullptr;
+			Entry*							Tail = nullptr;
+			uint64_t						Budget = 0u;
+			Stats							Totals;
+		};
+
+		TypeList&							GetTypeList(uint16_t type);
+		void								Link(TypeList& list, Entry& entry);
+		void								Unlink(TypeList& list, Entry& entry);
+
+		// Returns false once the type is within its budget or nothing can be evicted this frame
+		bool								EvictOne(uint16_t type, uint64_t frame);
+
+		EvictFunc							mEvict;
+		BudgetFunc							mDefaultBudget;
+		uint32_t							mKeepFrames;
+		std::atomic_uint64_t				mFrame = 0u;
+
+		D_CONTAINERS::DUnorderedMap<uint16_t, TypeList> mTypes;
+		D_CORE_THREADING::SpinLock			mLock;
+
+		// Types and their unused counts, collected by Update
+		D_CONTAINERS::DVector<std::pair<uint16_t, uint32_t>> mOverBudget;
+	};
+}
@@ -61,11 +61,6 @@ namespace Darius::ResourceManager
 		return ResourceGpuUpdateResult::Success;
 	}
 
-	void Resource::AddTypeContainer(ResourceType type)
-	{
-		D_RESOURCE::GetManager()->mResourceMap[type];
-	}
-
 	void Resource::SignalChange()
 	{
 		OnChange();
@@ -84,8 +79,10 @@ namespace Darius::ResourceManager
 
 	bool Resource::Release()
 	{
-		//Unload();
-		//mLoaded.store(false);
+		// Nothing references it anymore, so it may be unloaded once its type is over budget
+		auto manager = D_RESOURCE::GetManager();
+		if (manager && IsLoaded() && !IsDefault())
+			manager->MarkUnused(this);
 		return true;
 	}
 }
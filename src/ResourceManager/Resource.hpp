@@ -1,5 +1,7 @@
 #pragma once
 
+#include "ResidencyTracker.hpp"
+
 #include <Core/StringId.hpp>
 #include <Core/Memory/Memory.hpp>
 #include <Core/Containers/Map.hpp>
@@ -28,7 +30,8 @@
 #define D_RESOURCE Darius::ResourceManager
 #endif // !D_RESOURCE
 
-#define D_T_RESOURCE_ID UINT16
+// Index and generation of the resource slot in the resource manager handle table
+#define D_T_RESOURCE_ID uint32_t
 
 #define D_CH_RESOURCE_ABSTRACT_BODY(T) \
 public:\
@@ -61,7 +64,6 @@ public: \
 		T::NameId = std::make_unique<D_CORE::StringId>(D_CORE::StringId(ResT)); \
 		D_ASSERT_M(!D_RESOURCE::Resource::GetResourceTypeFromName(*NameId), "Resource " #T " is already registered."); \
 		auto resType = D_RESOURCE::Resource::RegisterResourceTypeName<T, T::T##Factory>(*NameId); \
-		D_RESOURCE::Resource::AddTypeContainer(resType); \
 		RegisterConstructionValidation(resType, CanConstructFrom); \
 		\
 		std::string supportedExtensions[] = { __VA_ARGS__ }; \
@@ -331,6 +333,8 @@ namespace Darius::ResourceManager
 		INLINE DResourceId			GetId() const { return mId; }
 		INLINE D_CORE::Uuid const&	GetUuid() const { return mUuid; }
 		INLINE bool					IsDefault() const { return mDefault; }
+		// Unloaded for being over the residency budget, reloaded once requested again
+		INLINE bool					IsEvicted() const { return mEvicted.load(); }
 		INLINE std::wstring const&	GetName() const { return mName; }
 
 		INLINE void					SetName(std::wstring const& name) { mName = name; }
@@ -374,6 +378,11 @@ namespace Darius::ResourceManager
 		// For saving / loading / manipulation purposes
 		std::atomic_bool			mLocked;
 
+		std::atomic_bool			mEvicted;
+		// Set while being unloaded for the residency budget
+		std::atomic_bool			mEvicting;
+		ResidencyTracker::Entry		mResidency;
+
 
 	public:
 		ResourceGpuUpdateResult		UpdateGPU();
@@ -435,6 +444,9 @@ namespace Darius::ResourceManager
 			mDirtyGPU(GPUDirtyState::Dirty),
 			mUuid(uuid),
 			mLocked(false),
+			mEvicted(false),
+			mEvicting(false),
+			mResidency(this),
 			mParent(parent)
 		{ }
 
@@ -453,6 +465,9 @@ namespace Darius::ResourceManager
 		virtual void				EvictFromGpu() { }
 		virtual void				Unload() = 0;
 
+		// Memory freed by unloading, counted against the residency budget of the type
+		virtual uint64_t			GetResidentSize() const { return 0u; }
+
 		// Don't trigger change signal inside this. It'll break the whole thing!
 		virtual void				OnChange() { }
 		void						SignalChange();
@@ -460,7 +475,6 @@ namespace Darius::ResourceManager
 
 		D_CH_SIGNAL(Change, void(Resource*));
 
-		static void					AddTypeContainer(ResourceType type);
 
 		static SubResourceConstructionData CanConstructFrom(ResourceType type, D_FILE::Path const& path);
 
@@ -5,6 +5,7 @@
 #include <Core/Serialization/Json.hpp>
 #include <Core/Containers/ConcurrentQueue.hpp>
 #include <Core/Exceptions/Exception.hpp>
+#include <Core/Memory/MemoryTracking.hpp>
 #include <Job/Job.hpp>
 #include <Utils/Common.hpp>
 #include <Utils/Log.hpp>
@@ -27,6 +28,8 @@ namespace Darius::ResourceManager
 	{
 		virtual void Execute() override
 		{
+			D_MEMORY_TAG_SCOPE(Resource);
+
 			if(!mPendingToLoad)
 			{
 				if(mCallback)
@@ -233,6 +236,7 @@ namespace Darius::ResourceManager
 			resource->SetLocked(true);
 			resource->mDirtyDisk = false;
 			resource->mLoaded = true;
+			resource->mEvicted = false;
 			resource->SetLocked(false);
 			return *resource;
 		}
@@ -289,8 +293,8 @@ namespace Darius::ResourceManager
 		// If already exists
 		auto manager = D_RESOURCE::GetManager();
 
-		DVector<ResourceHandle>const* existingResources;
-		if(manager->TryGetHandleFromPath(path, &existingResources))
+		DVector<ResourceHandle> existingResources;
+		if(manager->TryGetHandleFromPath(path, existingResources))
 		{
 			foundMeta = true;
 			alreadyExists = true;
@@ -316,7 +320,7 @@ namespace Darius::ResourceManager
 		meta = jMeta;
 
 		if(alreadyExists)
-			return *existingResources;
+			return existingResources;
 
 		return CreateResourceObject(meta, manager, path.parent_path());
 	}
@@ -376,6 +380,7 @@ namespace Darius::ResourceManager
 					resName = "__";
 				resource->ReadResourceFromFile(properties.contains(resName) ? properties[resName] : Json(), dirtyDisk);
 				resource->mLoaded = true;
+				resource->mEvicted = false;
 			}
 
 			resource->SetLocked(false);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Resource.hpp"
+
+#include <Core/Uuid.hpp>
+#include <Core/Containers/Map.hpp>
+#include <Core/Containers/Vector.hpp>
+#include <Core/Filesystem/Path.hpp>
+#include <Core/MultiThreading/RWLock.hpp>
+
+#include <algorithm>
+
+#ifndef D_RESOURCE
+#define D_RESOURCE Darius::ResourceManager
+#endif // !D_RESOURCE
+
+namespace Darius::ResourceManager
+{
+	// Finds resource handles by UUID and by file path. Written once per resource creation and read
+	// by every deserialization, so lookups share a lock and only additions take it exclusively.
+	class ResourceLookup
+	{
+	public:
+
+		void Add(D_CORE::Uuid const& uuid, std::wstring const& path, ResourceHandle handle)
+		{
+			D_CORE_THREADING::RWLockWrite lock(mLock);
+
+			mUuidMap.insert({ uuid, handle });
+
+			auto& pathHandles = mPathMap[path];
+			if (std::find(pathHandles.begin(), pathHandles.end(), handle) == pathHandles.end())
+				pathHandles.push_back(handle);
+		}
+
+		// Empty handle if not found
+		ResourceHandle Find(D_CORE::Uuid const& uuid) const
+		{
+			D_CORE_THREADING::RWLockRead lock(mLock);
+
+			auto search = mUuidMap.find(uuid);
+			if (search == mUuidMap.end())
+				return EmptyResourceHandle;
+			return search->second;
+		}
+
+		bool TryFind(std::wstring const& path, _OUT_ D_CONTAINERS::DVector<ResourceHandle>& result) const
+		{
+			D_CORE_THREADING::RWLockRead lock(mLock);
+
+			auto search = mPathMap.find(path);
+			if (search == mPathMap.end())
+				return false;
+
+			result = search->second;
+			return true;
+		}
+
+		void GetAllPaths(D_CONTAINERS::DVector<D_FILE::Path>& paths) const
+		{
+			D_CORE_THREADING::RWLockRead lock(mLock);
+
+			paths.reserve(paths.size() + mPathMap.size());
+			for (auto const& [path, _] : mPathMap)
+				paths.push_back(D_FILE::Path(path));
+		}
+
+	private:
+		D_CORE_THREADING::RWLock												mLock;
+		D_CONTAINERS::DUnorderedMap<D_CORE::Uuid, ResourceHandle, D_CORE::UuidHasher>	mUuidMap;
+		D_CONTAINERS::DUnorderedMap<std::wstring, D_CONTAINERS::DVector<ResourceHandle>>	mPathMap;
+	};
+}
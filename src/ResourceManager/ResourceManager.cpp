@@ -6,10 +6,13 @@
 #include <Core/Filesystem/Path.hpp>
 #include <Core/Filesystem/FileUtils.hpp>
 #include <Core/Containers/Map.hpp>
+#include <Core/Memory/MemoryTracking.hpp>
 #include <Core/Exceptions/Exception.hpp>
 #include <Job/Job.hpp>
 #include <Utils/Assert.hpp>
 
+#include <thread>
+
 using namespace D_CONTAINERS;
 using namespace D_CORE;
 using namespace D_FILE;
@@ -20,11 +23,34 @@ namespace Darius::ResourceManager
 
 	std::unique_ptr<DResourceManager>				_ResourceManager;
 
+	// Options
+	uint32_t										ResidencyDefaultBudgetMB;
+	uint32_t										ResidencyKeepFrames;
+	DUnorderedMap<std::string, uint32_t>			ResidencyBudgetsMB;
+
 	void Initialize(D_SERIALIZATION::Json const& settings)
 	{
+		D_MEMORY_TAG_SCOPE(Resource);
+
 		D_ASSERT(_ResourceManager == nullptr);
 
-		_ResourceManager = std::make_unique<DResourceManager>();
+		D_H_OPTIONS_LOAD_BASIC_DEFAULT("ResourceManager.ResidencyDefaultBudgetMB", ResidencyDefaultBudgetMB, 256u);
+		D_H_OPTIONS_LOAD_BASIC_DEFAULT("ResourceManager.ResidencyKeepFrames", ResidencyKeepFrames, 30u);
+
+		// Budgets of specific types by type name, like "Texture"
+		if(settings.contains("ResourceManager.ResidencyBudgetsMB"))
+			for(auto const& [name, budget] : settings["ResourceManager.ResidencyBudgetsMB"].items())
+				ResidencyBudgetsMB[name] = budget.get<uint32_t>();
+
+		// Types are registered after initialization, so budgets are found by name once a type is first seen
+		auto budget = [](ResourceType type) -> uint64_t
+			{
+				auto search = ResidencyBudgetsMB.find(Resource::GetResourceName(type).string());
+				uint64_t budgetMB = search == ResidencyBudgetsMB.end() ? ResidencyDefaultBudgetMB : search->second;
+				return budgetMB * 1024u * 1024u;
+			};
+
+		_ResourceManager = std::make_unique<DResourceManager>(budget, ResidencyKeepFrames);
 
 	}
 
@@ -52,6 +78,11 @@ namespace Darius::ResourceManager
 		if (!resource)
 			return nullptr;
 
+		if(!syncLoad)
+			_ResourceManager->ReloadIfEvicted(resource);
+		else
+			_ResourceManager->WaitForEviction(resource);
+
 		// Load resource if not loaded yet
 		if(syncLoad && !resource->IsLoaded())
 			D_RESOURCE_LOADER::LoadResourceSync(resource);
@@ -67,6 +98,11 @@ namespace Darius::ResourceManager
 	{
 		auto resource = _ResourceManager->GetRawResource(handle);
 
+		if(!syncLoad)
+			_ResourceManager->ReloadIfEvicted(resource);
+		else
+			_ResourceManager->WaitForEviction(resource);
+
 		// Load resource if not loaded yet
 		if(syncLoad && !resource->IsLoaded())
 			D_RESOURCE_LOADER::LoadResourceSync(resource);
@@ -78,6 +114,12 @@ namespace Darius::ResourceManager
 		return resource;
 	}
 
+	void ReloadIfEvicted(Resource* resource)
+	{
+		if(_ResourceManager)
+			_ResourceManager->ReloadIfEvicted(resource);
+	}
+
 	void GetRawResourceAsync(ResourceHandle handle, ResourceLoadedResourceCalllback callback)
 	{
 		auto resource = _ResourceManager->GetRawResource(handle);
@@ -115,6 +157,8 @@ namespace Darius::ResourceManager
 
 	void UpdateGPUResources()
 	{
+		D_MEMORY_TAG_SCOPE(Resource);
+
 		_ResourceManager->UpdateGPUResources();
 	}
 
@@ -150,24 +194,24 @@ namespace Darius::ResourceManager
 #endif // _D_EDITOR
 
 
-	DResourceManager::DResourceManager() :
-		mDefaultResourcesSet()
+	DResourceManager::DResourceManager(ResidencyTracker::BudgetFunc budget, uint32_t residencyKeepFrames) :
+		mDefaultResourcesSet(),
+		mResidency([this](ResidencyTracker::Entry& entry) { return EvictResource(static_cast<Resource*>(entry.GetOwner())); }, budget, residencyKeepFrames)
 	{ }
 
 	DResourceManager::~DResourceManager()
 	{
 		mDefaultResourcesSet.clear();
 
-		for(auto& typeClass : mResourceMap)
-			for(auto& resourcePair : typeClass.second)
-				resourcePair.second->Destroy();
+		mHandles.ForEach([](Resource* resource)
+			{
+				resource->Destroy();
+			});
 	}
 
 	Resource* DResourceManager::GetRawResource(D_CORE::Uuid const& uuid)
 	{
-		if(mUuidMap.find(uuid) == mUuidMap.end())
-			return nullptr;
-		return mUuidMap[uuid];
+		return GetRawResourceSafe(mLookup.Find(uuid));
 	}
 
 	Resource* DResourceManager::GetRawResource(ResourceHandle handle)
@@ -175,12 +219,10 @@ namespace Darius::ResourceManager
 		if(handle.Type == 0)
 			return nullptr;
 
-		if(!D_VERIFY(mResourceMap.find(handle.Type) != mResourceMap.end()))
+		auto resource = mHandles.Resolve(handle.Id);
+		if(!D_VERIFY(resource && resource->GetType() == handle.Type))
 			return nullptr;
-		auto& typeClass = mResourceMap[handle.Type];
-		if(!D_VERIFY(typeClass.contains(handle.Id)))
-			return nullptr;
-		return typeClass[handle.Id].get();
+		return resource;
 	}
 
 	Resource* DResourceManager::GetRawResourceSafe(ResourceHandle handle)
@@ -188,23 +230,21 @@ namespace Darius::ResourceManager
 		if(handle.Type == 0)
 			return nullptr;
 
-		if(mResourceMap.find(handle.Type) == mResourceMap.end())
+		auto resource = mHandles.Resolve(handle.Id);
+		if(!resource || resource->GetType() != handle.Type)
 			return nullptr;
-		auto& typeClass = mResourceMap[handle.Type];
-		if(!typeClass.contains(handle.Id))
-			return nullptr;
-		return typeClass[handle.Id].get();
+		return resource;
 	}
 
 #ifdef _D_EDITOR
 	DVector<ResourcePreview> DResourceManager::GetResourcePreviews(ResourceType type)
 	{
 		DVector<ResourcePreview> res;
-		res.reserve(mResourceMap.at(type).size());
-		for(auto& resource : mResourceMap.at(type))
-		{
-			res.push_back(*resource.second);
-		}
+		mHandles.ForEach([&res, type](Resource* resource)
+			{
+				if(resource->GetType() == type)
+					res.push_back(*resource);
+			});
 
 		std::sort(res.begin(), res.end(), [](ResourcePreview const& a, ResourcePreview const& b)
 			{
@@ -234,7 +274,27 @@ namespace Darius::ResourceManager
 		if(!factory)
 			return EmptyResourceHandle;
 
-		auto res = factory->Create(uuid, path, name, GetNewId(), parent, isDefault);
+		auto id = mHandles.Allocate();
+		if(id == decltype(mHandles)::InvalidHandle)
+			return EmptyResourceHandle;
+
+		std::shared_ptr<Resource> res;
+		try
+		{
+			res = factory->Create(uuid, path, name, id, parent, isDefault);
+		}
+		catch(...)
+		{
+			// Otherwise the slot would never be reused
+			mHandles.Remove(id);
+			throw;
+		}
+
+		if(!res)
+		{
+			mHandles.Remove(id);
+			return EmptyResourceHandle;
+		}
 
 		if(isDefault)
 			mDefaultResourcesSet.push_back(res.get());
@@ -256,12 +316,12 @@ namespace Darius::ResourceManager
 		dirtyResources.clear();
 		stillDirtyResources.clear();
 
+		// Unloading the unreferenced resources of the types over budget before uploading others
+		mResidency.Update(++mFrame);
+
 		// Iterating over all resources
-		for(auto& resType : mResourceMap)
-		{
-			for(auto& res : resType.second)
+		mHandles.ForEach([](Resource* resource)
 			{
-				auto resource = res.second;
 				if(resource->IsLoaded() && resource->GetGpuState() == Resource::GPUDirtyState::Dirty && !resource->IsLocked())
 				{
 					switch(resource->UpdateGPU())
@@ -269,12 +329,12 @@ namespace Darius::ResourceManager
 						// It is successfully cleaned
 					case ResourceGpuUpdateResult::Success:
 						if(resource->GetGpuState() == Resource::GPUDirtyState::Dirty)
-							dirtyResources.push_back(resource.get());
+							dirtyResources.push_back(resource);
 						break;
 
 						// It will be cleaned in the next round
 					case ResourceGpuUpdateResult::DirtyDependency:
-						stillDirtyResources.push_back(resource.get());
+						stillDirtyResources.push_back(resource);
 						break;
 
 					case ResourceGpuUpdateResult::AlreadyClean:
@@ -282,8 +342,7 @@ namespace Darius::ResourceManager
 						break;
 					}
 				}
-			}
-		}
+			});
 
 		// Make gpu state of the clean ones, clean
 		for(auto resource : dirtyResources)
@@ -329,63 +388,98 @@ namespace Darius::ResourceManager
 
 	void DResourceManager::UpdateMaps(std::shared_ptr<Resource> resource)
 	{
+		// Taking ownership
+		{
+			std::scoped_lock lock(mResourcesMutex);
+			mResources.push_back(resource);
+		}
 
-		// Update resource map
-		mResourceMap.at(resource->GetType()).try_emplace(resource->GetId(), resource);
+		// The resource is reachable by its id from here on
+		mHandles.Assign(resource->GetId(), resource.get());
+
+		// Update uuid and path lookups
+		mLookup.Add(resource->GetUuid(), resource->GetPath().lexically_normal().wstring(), *resource);
+	}
+
+	ResidencyTracker::EvictResult DResourceManager::EvictResource(Resource* resource)
+	{
+		// Referenced again since released, already unloaded, or has unsaved changes
+		if(resource->GetReferenceCount() != 0u || !resource->IsLoaded() || resource->IsDirtyDisk())
+			return ResidencyTracker::EvictResult::InUse;
 
-		// Update uuid map
-		mUuidMap.insert({resource->GetUuid(), resource.get()});
+		// Could not be loaded again
+		if(!D_H_ENSURE_FILE(resource->GetPath()))
+			return ResidencyTracker::EvictResult::InUse;
 
-		// Update path map
+		if(resource->IsLocked() || resource->GetGpuState() == Resource::GPUDirtyState::Uploading)
+			return ResidencyTracker::EvictResult::Busy;
 
-		auto path = resource->GetPath().lexically_normal().wstring();
+		// Marked before checking the references again. A reference taken meanwhile either
+		// shows up here, or sees the mark and waits to reload it in ReloadIfEvicted
+		if(resource->mEvicting.exchange(true))
+			return ResidencyTracker::EvictResult::Busy;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
 
-		auto& pathHandles = mPathMap[path];
-		bool found = false;
-		ResourceHandle newHandle = *resource;
-		for(auto const& handle : pathHandles)
+		if(resource->GetReferenceCount() != 0u || resource->IsLocked())
 		{
-			if(handle.Id == newHandle.Id && handle.Type == newHandle.Type)
-			{
-				found = true;
-				break;
-			}
+			resource->mEvicting.store(false);
+			return ResidencyTracker::EvictResult::InUse;
 		}
-		if(!found)
-			pathHandles.push_back(newHandle);
+
+		resource->SetLocked(true);
+
+		resource->Unload();
+		resource->mLoaded = false;
+		resource->mEvicted = true;
+		resource->MakeGpuDirty();
+
+		resource->SetLocked(false);
+		resource->mEvicting.store(false);
+
+		return ResidencyTracker::EvictResult::Evicted;
+	}
+
+	void DResourceManager::WaitForEviction(Resource* resource) const
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		while(resource->mEvicting.load())
+			std::this_thread::yield();
+	}
+
+	void DResourceManager::ReloadIfEvicted(Resource* resource)
+	{
+		if(!resource)
+			return;
+
+		WaitForEviction(resource);
+
+		if(resource->mEvicted.exchange(false))
+			ResourceLoader::LoadResourceAsync(resource, nullptr, true);
 	}
 
 	void DResourceManager::SaveAllResources()
 	{
-		for(auto& resType : mResourceMap)
-		{
-			for(auto& res : resType.second)
+		mHandles.ForEach([](Resource* resource)
 			{
-				auto resource = res.second;
 				if(resource->IsDirtyDisk())
-					D_RESOURCE_LOADER::SaveResource(resource.get());
-			}
-		}
+					D_RESOURCE_LOADER::SaveResource(resource);
+			});
 	}
 
 #ifdef _D_EDITOR
 	void DResourceManager::GetAllResources(DVector<Resource*>& resources) const
 	{
-		for(auto& resType : mResourceMap)
-		{
-			for(auto& res : resType.second)
+		resources.reserve(resources.size() + mHandles.GetSize());
+		mHandles.ForEach([&resources](Resource* resource)
 			{
-				resources.push_back(res.second.get());
-			}
-		}
+				resources.push_back(resource);
+			});
 	}
 
 	void DResourceManager::GetAllResourcePaths(DVector<Path>& paths) const
 	{
-		for(auto const& path : mPathMap)
-		{
-			paths.push_back(Path(path.first));
-		}
+		mLookup.GetAllPaths(paths);
 	}
 #endif // _D_EDITOR
 }
\ No newline at end of file
@@ -2,9 +2,11 @@
 
 #include "Resource.hpp"
 #include "ResourceLoader.hpp"
+#include "ResourceLookup.hpp"
 #include "ResourceRef.hpp"
 
 #include <Core/Uuid.hpp>
+#include <Core/Containers/HandleTable.hpp>
 #include <Core/Containers/Vector.hpp>
 #include <COre/Containers/Map.hpp>
 #include <Core/Exceptions/Exception.hpp>
@@ -13,6 +15,7 @@
 
 #include <concurrent_unordered_map.h>
 
+#include <mutex>
 #include <optional>
 
 #ifndef D_RESOURCE
@@ -130,9 +133,13 @@ namespace Darius::ResourceManager
 	class DResourceManager : NonCopyable
 	{
 	public:
-		DResourceManager();
+		// Budgets limit the size of the loaded resources of each type which nothing references
+		DResourceManager(ResidencyTracker::BudgetFunc budget, uint32_t residencyKeepFrames);
 		~DResourceManager();
 
+		INLINE void					SetResidencyBudget(ResourceType type, uint64_t budget) { mResidency.SetBudget(type, budget); }
+		INLINE ResidencyTracker::Stats GetResidencyStats(ResourceType type) const { return mResidency.GetStats(type); }
+
 		// Save resouce
 		void						SaveAllResources();
 
@@ -198,24 +205,36 @@ namespace Darius::ResourceManager
 
 		void						UpdateMaps(std::shared_ptr<Resource> resuorce);
 
-		INLINE DResourceId			GetNewId() { return ++mLastId; }
-		INLINE D_CONTAINERS::DVector<ResourceHandle> const& GetHandleFromPath(std::wstring const& path) const { if (mPathMap.find(path) == mPathMap.end()) throw std::exception("Path Not Found"); return mPathMap.at(path); }
-		INLINE bool					TryGetHandleFromPath(std::wstring const& path, _OUT_ D_CONTAINERS::DVector<ResourceHandle>const** result) const
+		INLINE void					MarkUnused(Resource* resource) { mResidency.MarkUnused(resource->mResidency, resource->GetType(), resource->GetResidentSize()); }
+		ResidencyTracker::EvictResult	EvictResource(Resource* resource);
+
+		// Evicted resources come back through the async loader once requested again
+		void						ReloadIfEvicted(Resource* resource);
+		// Returns once an eviction already passed the reference check is over
+		void						WaitForEviction(Resource* resource) const;
+
+		INLINE D_CONTAINERS::DVector<ResourceHandle> GetHandleFromPath(std::wstring const& path) const
 		{
-			if (mPathMap.find(path) == mPathMap.end())
-			{
-				result = nullptr;
-				return false;
-			}
-			*result = &mPathMap.at(path);
-			return true;
+			D_CONTAINERS::DVector<ResourceHandle> result;
+			if (!mLookup.TryFind(path, result))
+				throw std::exception("Path Not Found");
+			return result;
 		}
+		INLINE bool					TryGetHandleFromPath(std::wstring const& path, _OUT_ D_CONTAINERS::DVector<ResourceHandle>& result) const { return mLookup.TryFind(path, result); }
 
-		D_CONTAINERS::DConcurrentUnorderedMap<ResourceType, D_CONTAINERS::DUnorderedMap<DResourceId, std::shared_ptr<Resource>>>	mResourceMap;
-		D_CONTAINERS::DConcurrentUnorderedMap<D_CORE::Uuid, Resource*, D_CORE::UuidHasher>			mUuidMap;
-		D_CONTAINERS::DConcurrentUnorderedMap<std::wstring, D_CONTAINERS::DVector<ResourceHandle>>	mPathMap;
+		// Resolves resource ids without locking, stale ids resolve to nothing
+		D_CONTAINERS::HandleTable<Resource>		mHandles;
+
+		// Owns the resources, only locked when adding
+		std::mutex								mResourcesMutex;
+		D_CONTAINERS::DVector<std::shared_ptr<Resource>>	mResources;
+
+		ResourceLookup							mLookup;
 		D_CONTAINERS::DConcurrentVector<ResourceRef<Resource>> mDefaultResourcesSet;
-		DResourceId								mLastId = 0;
+
+		// Destroyed before the resources it lists
+		ResidencyTracker						mResidency;
+		uint64_t								mFrame = 0u;
 	};
 
 }
\ No newline at end of file
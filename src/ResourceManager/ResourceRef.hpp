@@ -21,7 +21,8 @@ namespace Darius::ResourceManager
 		template<class OTHER>
 		ResourceRef(D_CORE::Ref<OTHER> const& other) : D_CORE::Ref<T>(other) { };
 
-		ResourceRef(T* ptr) : D_CORE::Ref<T>(ptr) { }
+		// The first reference of an evicted resource has it reloaded
+		ResourceRef(T* ptr) : D_CORE::Ref<T>(ptr) { if (ptr) ReloadIfEvicted(ptr); }
 
 		ResourceRef() : D_CORE::Ref<T>() { };
 
@@ -30,6 +31,8 @@ namespace Darius::ResourceManager
 		INLINE bool IsValidAndGpuDirty() const { return D_CORE::Ref<T>::IsValid() && D_CORE::Ref<T>::Get()->IsDirtyGPU(); }
 	};
 
+	void ReloadIfEvicted(Resource* resource);
+
 	template<class T>
 	D_RESOURCE::ResourceRef<T> GetResourceSync(D_CORE::Uuid const& uuid, bool load = false);
 	Resource* GetRawResourceSync(D_CORE::Uuid const& uuid, bool syncLoad);
@@ -0,0 +1,203 @@
+#define BOOST_TEST_MODULE ResourceManagerTests
+#define BOOST_TEST_DYN_LINK
+
+#include <ResourceManager/ResidencyTracker.hpp>
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <deque>
+
+using namespace D_CONTAINERS;
+using namespace D_RESOURCE;
+
+namespace
+{
+	constexpr uint16_t TextureType = 1u;
+	constexpr uint16_t MeshType = 2u;
+
+	// Stands in for a resource, evicted unless referenced or busy
+	struct FakeResource
+	{
+		FakeResource(uint16_t type, uint64_t size) :
+			Residency(this),
+			Type(type),
+			Size(size)
+		{ }
+
+		ResidencyTracker::Entry	Residency;
+		uint16_t				Type;
+		uint64_t				Size;
+		bool					Loaded = true;
+		bool					Referenced = false;
+		bool					Busy = false;
+		uint32_t				EvictionOrder = 0u;
+	};
+
+	class FakeResources
+	{
+	public:
+		FakeResources(uint64_t budget, uint32_t keepFrames = 0u) :
+			Tracker([this](ResidencyTracker::Entry& entry) { return Evict(*static_cast<FakeResource*>(entry.GetOwner())); }, [budget](uint16_t) { return budget; }, keepFrames)
+		{ }
+
+		FakeResource& Add(uint16_t type, uint64_t size)
+		{
+			return Resources.emplace_back(type, size);
+		}
+
+		// The last reference is gone
+		void Release(FakeResource& resource)
+		{
+			resource.Referenced = false;
+			Tracker.MarkUnused(resource.Residency, resource.Type, resource.Size);
+		}
+
+		std::deque<FakeResource>	Resources;
+		ResidencyTracker			Tracker;
+		uint32_t					Evictions = 0u;
+
+	private:
+		ResidencyTracker::EvictResult Evict(FakeResource& resource)
+		{
+			if (resource.Referenced || !resource.Loaded)
+				return ResidencyTracker::EvictResult::InUse;
+			if (resource.Busy)
+				return ResidencyTracker::EvictResult::Busy;
+
+			resource.Loaded = false;
+			resource.EvictionOrder = ++Evictions;
+			return ResidencyTracker::EvictResult::Evicted;
+		}
+	};
+}
+
+BOOST_AUTO_TEST_SUITE(ResidencyTrackerTests)
+
+BOOST_AUTO_TEST_CASE(EvictsLeastRecentlyReleasedOverBudget)
+{
+	FakeResources fakes(100u);
+	auto& first = fakes.Add(TextureType, 40u);
+	auto& second = fakes.Add(TextureType, 40u);
+	auto& third = fakes.Add(TextureType, 40u);
+
+	fakes.Release(first);
+	fakes.Release(second);
+	fakes.Tracker.Update(1u);
+	BOOST_TEST(fakes.Evictions == 0u);
+
+	fakes.Release(third);
+	fakes.Tracker.Update(2u);
+
+	BOOST_TEST(fakes.Evictions == 1u);
+	BOOST_TEST(!first.Loaded);
+	BOOST_TEST(second.Loaded);
+	BOOST_TEST(third.Loaded);
+
+	auto stats = fakes.Tracker.GetStats(TextureType);
+	BOOST_TEST(stats.UnusedSize == 80u);
+	BOOST_TEST(stats.UnusedCount == 2u);
+	BOOST_TEST(stats.EvictedCount == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(ReleasedAgainMovesToRecentEnd)
+{
+	FakeResources fakes(50u);
+	auto& first = fakes.Add(TextureType, 40u);
+	auto& second = fakes.Add(TextureType, 40u);
+
+	fakes.Release(first);
+	fakes.Release(second);
+
+	// Used and released again, so now the second one is the oldest
+	first.Referenced = true;
+	fakes.Release(first);
+	fakes.Tracker.Update(1u);
+
+	BOOST_TEST(first.Loaded);
+	BOOST_TEST(!second.Loaded);
+}
+
+BOOST_AUTO_TEST_CASE(SkipsReferencedAgainAndRetriesBusy)
+{
+	FakeResources fakes(0u);
+	auto& referenced = fakes.Add(TextureType, 10u);
+	auto& busy = fakes.Add(TextureType, 10u);
+	auto& unused = fakes.Add(TextureType, 10u);
+
+	fakes.Release(referenced);
+	fakes.Release(busy);
+	fakes.Release(unused);
+	referenced.Referenced = true;
+	busy.Busy = true;
+
+	fakes.Tracker.Update(1u);
+	BOOST_TEST(referenced.Loaded);
+	BOOST_TEST(busy.Loaded);
+	BOOST_TEST(!unused.Loaded);
+
+	// Referenced one left the list, the busy one is kept listed
+	BOOST_TEST(fakes.Tracker.GetStats(TextureType).UnusedCount == 1u);
+
+	busy.Busy = false;
+	fakes.Tracker.Update(2u);
+	BOOST_TEST(!busy.Loaded);
+	BOOST_TEST(referenced.Loaded);
+}
+
+BOOST_AUTO_TEST_CASE(KeepsRecentlyReleasedForFramesInFlight)
+{
+	FakeResources fakes(0u, 3u);
+	auto& resource = fakes.Add(TextureType, 10u);
+
+	fakes.Tracker.Update(10u);
+	fakes.Release(resource);
+
+	fakes.Tracker.Update(12u);
+	BOOST_TEST(resource.Loaded);
+
+	fakes.Tracker.Update(13u);
+	BOOST_TEST(!resource.Loaded);
+}
+
+BOOST_AUTO_TEST_CASE(BudgetsArePerType)
+{
+	FakeResources fakes(100u);
+	fakes.Tracker.SetBudget(MeshType, 1000u);
+	BOOST_TEST(fakes.Tracker.GetBudget(TextureType) == 100u);
+	BOOST_TEST(fakes.Tracker.GetBudget(MeshType) == 1000u);
+
+	for (uint32_t i = 0u; i < 10u; i++)
+	{
+		fakes.Release(fakes.Add(TextureType, 50u));
+		fakes.Release(fakes.Add(MeshType, 50u));
+	}
+
+	fakes.Tracker.Update(1u);
+
+	BOOST_TEST(fakes.Tracker.GetStats(TextureType).UnusedSize == 100u);
+	BOOST_TEST(fakes.Tracker.GetStats(TextureType).EvictedCount == 8u);
+	BOOST_TEST(fakes.Tracker.GetStats(MeshType).UnusedSize == 500u);
+	BOOST_TEST(fakes.Tracker.GetStats(MeshType).EvictedCount == 0u);
+
+	for (auto const& resource : fakes.Resources)
+	{
+		// Oldest ones evicted first
+		if (!resource.Loaded)
+			BOOST_TEST(resource.EvictionOrder <= 8u);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(RemovedAreNotEvicted)
+{
+	FakeResources fakes(0u);
+	auto& resource = fakes.Add(TextureType, 10u);
+
+	fakes.Release(resource);
+	fakes.Tracker.Remove(resource.Residency);
+	fakes.Tracker.Update(1u);
+
+	BOOST_TEST(resource.Loaded);
+	BOOST_TEST(fakes.Tracker.GetStats(TextureType).UnusedCount == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -13,23 +13,13 @@ static void ComponentUpdater(float dt, D_ECS::ECSRegistry& reg); \
 static void ComponentLateUpdater(float dt, D_ECS::ECSRegistry& reg)
 
 #define D_H_BEHAVIOUR_COMP_DEF(type) D_H_COMP_DEF(type) \
-void type::ComponentUpdater(float dt, D_ECS::ECSRegistry& reg) \
+void type::ComponentUpdater(float dt, D_ECS::ECSRegistry&) \
 { \
-	reg.each([&](type& comp) \
-		{ \
-			if(comp.IsStarted() && comp.IsActive()) \
-				comp.Update(dt); \
-		} \
-	); \
+	D_WORLD::UpdateBehaviours<type>(dt, false); \
 } \
-void type::ComponentLateUpdater(float dt, D_ECS::ECSRegistry& reg) \
+void type::ComponentLateUpdater(float dt, D_ECS::ECSRegistry&) \
 { \
-	reg.each([&](type& comp) \
-		{ \
-			if(comp.IsStarted() && comp.IsActive()) \
-				comp.LateUpdate(dt); \
-		} \
-	); \
+	D_WORLD::UpdateBehaviours<type>(dt, true); \
 }
 
 namespace Darius::Scene::ECS::Components
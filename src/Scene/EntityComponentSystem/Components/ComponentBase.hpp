@@ -47,7 +47,7 @@ T(D_CORE::Uuid const& uuid); \
 using Super = parent; \
 using ThisClass = T; \
 static constexpr INLINE std::string ClassName() { return D_NAMEOF(T); } \
-static INLINE D_ECS::ComponentEntry GetComponentEntryStatic() { return D_WORLD::GetComponentEntity(T::GetComponentNameStatic()); } \
+static INLINE D_ECS::ComponentEntry GetComponentEntryStatic() { return D_WORLD::GetComponentTypeInfo<T>().Entry; } \
 virtual INLINE std::string GetDisplayName() const override { return T::DisplayName; } \
 virtual INLINE D_CORE::StringId GetComponentName() const override { return T::GetComponentNameStatic(); } \
 static INLINE D_CORE::StringId GetComponentNameStatic() { return *CompName; } \
@@ -331,6 +331,7 @@ namespace Darius::Scene::ECS::Components
 		virtual INLINE void         Awake() { }
 		virtual INLINE void         OnDestroy() { }
 		virtual INLINE void         OnPreDestroy() { }
+		// Scene dumps call it on the main thread once all the objects are serialized
 		virtual INLINE void         OnSerialized() const { }
 		virtual INLINE void         OnPreDeserialize() { }
 		virtual INLINE void         OnDeserialized() { }
@@ -392,6 +393,15 @@ namespace Darius::Scene::ECS::Components
 		static void                 ComponentUpdater(float, D_ECS::ECSRegistry&) { }
 		static void                 ComponentLateUpdater(float, D_ECS::ECSRegistry&) { }
 
+		// Behaviours only touching themselves in their updates may hide this with true to be updated on the workers.
+		// Reading world transforms doesn't qualify, as GetWorld fills the world caches of the parents, nor does deleting.
+		static constexpr bool       ParallelUpdates = false;
+
+		// Components whose deserialization only touches themselves may hide this with true to be deserialized
+		// on the workers when loading scene dumps, getting OnDeserialized after all the others. The serialized
+		// properties must then be plain data writes, with setters reading neither the world nor the game object.
+		static constexpr bool       ParallelDeserialization = false;
+
 		static void                 StaticDestructor()
 		{ }
 
@@ -443,6 +453,9 @@ namespace Darius::Scene::ECS::Components
 	{
 		if(CanChange())
 			mDirty = true;
+
+		if(mGameObject && !mGameObject->IsInScene())
+			mGameObject->InvalidatePrefab();
 	}
 
 	INLINE bool ComponentBase::CanChange() const
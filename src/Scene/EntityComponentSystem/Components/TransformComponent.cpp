@@ -18,6 +18,8 @@ namespace Darius::Math
 		mTransformMath(Vector3::Zero, Quaternion::Identity, Vector3::One),
 		mWorldMatrix(kZero),
 		mWorldDirty(true),
+		mWorldChangeQueued(false),
+		mCleanQueued(false),
 		mWorldChanged()
 	{
 		SetDirty();
@@ -28,6 +30,8 @@ namespace Darius::Math
 		mTransformMath(Vector3::Zero, Quaternion::Identity, Vector3::One),
 		mWorldMatrix(kZero),
 		mWorldDirty(true),
+		mWorldChangeQueued(false),
+		mCleanQueued(false),
 		mWorldChanged()
 	{
 		SetDirty();
@@ -51,7 +55,7 @@ namespace Darius::Math
 			mTransformMath = Transform(localWorld);
 
 		}
-		mWorldChanged(this, mTransformMath);
+		QueueWorldChanged();
 	}
 
 	Matrix4 const& TransformComponent::GetWorld()
@@ -81,7 +85,7 @@ namespace Darius::Math
 		mTransformMath = Transform(mat);
 		mWorldDirty = true;
 		SetDirty();
-		mWorldChanged(this, mTransformMath);
+		QueueWorldChanged();
 	}
 
 #ifdef _D_EDITOR
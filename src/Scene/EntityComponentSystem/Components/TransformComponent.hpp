@@ -3,6 +3,7 @@
 #include "ComponentBase.hpp"
 
 #include <Core/Signal.hpp>
+#include <Core/MultiThreading/SafeNumeric.hpp>
 #include <Math/Transform.hpp>
 
 #include "TransformComponent.generated.hpp"
@@ -59,17 +60,45 @@ namespace Darius::Math
 		INLINE virtual bool					IsDirty() const override { auto parent = GetGameObject()->GetParent(); return parent ? ComponentBase::IsDirty() || parent->GetTransform()->IsDirty() : ComponentBase::IsDirty(); }
 
 	public:
+		// Fired once per frame when the scene flushes the transform changes, not on each setter call
 		TransformChangeSignalType			mWorldChanged;
 
 	private:
+		friend class D_SCENE::SceneManager;
+
 		bool								IsWorldDirty() const;
+		void								QueueWorldChanged();
+		void								QueueClean();
 
 		D_MATH::Transform					mTransformMath;
 		D_MATH::Matrix4						mWorldMatrix;
 
 		bool								mWorldDirty;
+
+		// Set by the setters on any thread, only the first one queues the entity
+		D_CORE_THREADING::SafeFlag			mWorldChangeQueued;
+		D_CORE_THREADING::SafeFlag			mCleanQueued;
 	};
 
+	INLINE void TransformComponent::QueueWorldChanged()
+	{
+		// Every change dirtying the transform comes through here
+		QueueClean();
+
+		if (mWorldChangeQueued.IsSet() || mWorldChangeQueued.TestAndSet())
+			return;
+
+		D_WORLD::QueueTransformChange(GetGameObject()->GetEntity());
+	}
+
+	INLINE void TransformComponent::QueueClean()
+	{
+		if (mCleanQueued.IsSet() || mCleanQueued.TestAndSet())
+			return;
+
+		D_WORLD::QueueTransformClean(GetGameObject()->GetEntity());
+	}
+
 	INLINE bool TransformComponent::IsWorldDirty() const
 	{
 		if (mWorldDirty)
@@ -89,7 +118,7 @@ namespace Darius::Math
 		mTransformMath.Translation = value;
 		mWorldDirty = true;
 		SetDirty();
-		mWorldChanged(this, mTransformMath);
+		QueueWorldChanged();
 	}
 
 	INLINE void TransformComponent::SetLocalRotation(Quaternion const& val)
@@ -99,7 +128,7 @@ namespace Darius::Math
 		mTransformMath.Rotation = val;
 		mWorldDirty = true;
 		SetDirty();
-		mWorldChanged(this, mTransformMath);
+		QueueWorldChanged();
 	}
 
 	INLINE void TransformComponent::SetLocalScale(Vector3 const& val)
@@ -109,7 +138,7 @@ namespace Darius::Math
 		mTransformMath.Scale = val;
 		mWorldDirty = true;
 		SetDirty();
-		mWorldChanged(this, mTransformMath);
+		QueueWorldChanged();
 	}
 
 	INLINE void TransformComponent::SetPosition(Vector3 const& val)
@@ -41,6 +41,12 @@ namespace Darius::Scene
 		mStarted(false),
 		mDeleted(false),
 		mParent(nullptr),
+		mFirstChild(nullptr),
+		mLastChild(nullptr),
+		mPrevSibling(nullptr),
+		mNextSibling(nullptr),
+		mChildCount(0u),
+		mDepth(0u),
 		mAwake(false),
 		mPrefab(Uuid()),
 		mInScene(inScene)
@@ -368,6 +374,7 @@ namespace Darius::Scene
 			return;
 
 		comp->mGameObject = this;
+		InvalidatePrefab();
 
 		if(mAwake)
 		{
@@ -390,6 +397,7 @@ namespace Darius::Scene
 	{
 		comp->OnDestroy();
 		comp->mDestroyed = true;
+		InvalidatePrefab();
 
 		OnComponentRemove(this, comp);
 		OnComponentSetChange(this);
@@ -492,8 +500,17 @@ namespace Darius::Scene
 
 	void GameObject::SetParent(GameObject* newParent, AttachmentType attachmentType)
 	{
-		if(!D_VERIFY(CanAttachTo(newParent)))
+		// Can come from the editor dropping an object on its descendant, refused before any link is touched
+		if(!CanAttachTo(newParent))
+		{
 			D_LOG_WARN("Circular pattern in hierarchy");
+			return;
+		}
+
+		// Both the prefab it leaves and the one it joins change
+		InvalidatePrefab();
+		if(newParent)
+			newParent->InvalidatePrefab();
 
 		if(!newParent || !newParent->IsValid()) // Unparent
 		{
@@ -506,11 +523,11 @@ namespace Darius::Scene
 			{
 				auto trans = GetTransform();
 				auto world = trans->GetWorld();
-				mParent = nullptr;
+				AttachToParent(nullptr);
 				trans->SetWorld(world);
 			}
 			else
-				mParent = nullptr;
+				AttachToParent(nullptr);
 
 			return;
 		}
@@ -522,12 +539,66 @@ namespace Darius::Scene
 		{
 			auto trans = GetTransform();
 			auto world = trans->GetWorld();
-			mParent = newParent;
+			AttachToParent(newParent);
 			trans->SetWorld(world);
 		}
 		else
-			mParent = newParent;
+			AttachToParent(newParent);
+
+	}
+
+	void GameObject::UnlinkFromParent()
+	{
+		if(!mParent)
+			return;
+
+		// Not among the children anymore
+		if(!mPrevSibling && mParent->mFirstChild != this)
+			return;
+
+		if(mPrevSibling)
+			mPrevSibling->mNextSibling = mNextSibling;
+		else
+			mParent->mFirstChild = mNextSibling;
+
+		if(mNextSibling)
+			mNextSibling->mPrevSibling = mPrevSibling;
+		else
+			mParent->mLastChild = mPrevSibling;
+
+		mPrevSibling = nullptr;
+		mNextSibling = nullptr;
+		mParent->mChildCount--;
+	}
+
+	void GameObject::AttachToParent(GameObject* parent)
+	{
+		UnlinkFromParent();
+
+		mParent = parent;
+
+		UINT depth = 0u;
+		if(parent)
+		{
+			mPrevSibling = parent->mLastChild;
+			if(mPrevSibling)
+				mPrevSibling->mNextSibling = this;
+			else
+				parent->mFirstChild = this;
+			parent->mLastChild = this;
+			parent->mChildCount++;
 
+			depth = parent->mDepth + 1u;
+		}
+
+		if(depth == mDepth)
+			return;
+
+		// Shifting the depth of the whole subtree along
+		int shift = (int)depth - (int)mDepth;
+		mDepth = depth;
+		for(auto desc : GetDescendants())
+			desc->mDepth = (UINT)((int)desc->mDepth + shift);
 	}
 
 	void GameObject::VisitAncestors(std::function<void(GameObject*)> callback) const
@@ -548,40 +619,45 @@ namespace Darius::Scene
 
 	void GameObject::VisitChildren(std::function<void(GameObject*)> callback) const
 	{
-		auto childrenList = DVector<GameObject*>();
-
-		mEntity.children([&](D_ECS::Entity childEnt)
-			{
-				childrenList.push_back(D_WORLD::GetGameObject(childEnt));
-			});
-
-		for(auto child : childrenList)
+		// Next is taken first, so the callback may move or delete the visited child
+		for(auto child = mFirstChild; child;)
+		{
+			auto next = child->mNextSibling;
 			callback(child);
+			child = next;
+		}
 	}
 
-	// TODO: All descendants should be loaded on a list and then iterated, otherwise a descendant may change the hierarchy and invalidates the traversal.
+	// The callback must not change the hierarchy of the subtree
 	void GameObject::VisitDescendants(std::function<void(GameObject*)> callback) const
 	{
-		VisitChildren([&](GameObject* child)
-			{
-				callback(child);
-				child->VisitDescendants(callback);
-			});
+		for(auto desc = mFirstChild; desc;)
+		{
+			auto next = desc->GetNextInSubtree(this);
+			callback(desc);
+			desc = next;
+		}
 	}
 
-	UINT GameObject::CountChildren()
+	GameObject* GameObject::GetNextInSubtree(GameObject const* root) const
 	{
-		int result = 0;
-		VisitChildren([&](GameObject*)
-			{
-				result++;
-			});
-		return result;
+		if(mFirstChild)
+			return mFirstChild;
+
+		// Going up until an ancestor below root has a next sibling
+		for(auto current = this; current && current != root; current = current->mParent)
+		{
+			if(current->mNextSibling)
+				return current->mNextSibling;
+		}
+
+		return nullptr;
 	}
 
 	void GameObject::SetActive(bool active)
 	{
 		this->mActive = active;
+		InvalidatePrefab();
 
 		if(active)
 			VisitComponents([&](auto comp)
@@ -603,6 +679,12 @@ namespace Darius::Scene
 
 	}
 
+	void GameObject::InvalidatePrefab() const
+	{
+		if(!mInScene)
+			D_WORLD::InvalidatePrefabTemplate(this);
+	}
+
 	void GameObject::RegisterComponent(StringId const& name, D_CONTAINERS::DVector<std::string>& displayName)
 	{
 		if(!D_WORLD::IsIdValid(D_WORLD::GetComponentEntity(name)))
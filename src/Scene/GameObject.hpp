@@ -40,8 +40,8 @@ namespace Darius::Math
 
 namespace Darius::Core::Memory
 {
-	template<class T, bool ThreadSafe>
-	class PagedAllocator;
+	template<class T, uint32_t BatchSize>
+	class SlabAllocator;
 }
 
 namespace Darius::Scene
@@ -77,6 +77,8 @@ namespace Darius::Scene
 		void								SetParent(GameObject* newParent, AttachmentType attachmentType);
 
 		void								SetActive(bool active);
+
+		// False once deleted, so that an object waiting to be removed gets no more updates
 		bool								IsActive() const;
 		INLINE bool							IsSelfActive() const { return mActive && !mDeleted; }
 
@@ -91,7 +93,64 @@ namespace Darius::Scene
 		void								VisitAncestors(std::function<void(GameObject*)> callback) const;
 		void								VisitChildren(std::function<void(GameObject*)> callback) const;
 		void								VisitDescendants(std::function<void(GameObject*)> callback) const;
-		UINT								CountChildren();
+		INLINE UINT							CountChildren() const { return mChildCount; }
+
+		// Hierarchy links, kept up to date by SetParent and deletion
+		INLINE GameObject*					GetFirstChild() const { return mFirstChild; }
+		INLINE GameObject*					GetLastChild() const { return mLastChild; }
+		INLINE GameObject*					GetPrevSibling() const { return mPrevSibling; }
+		INLINE GameObject*					GetNextSibling() const { return mNextSibling; }
+
+		// Number of ancestors
+		INLINE UINT							GetDepth() const { return mDepth; }
+
+		// Walks the children by their sibling links without allocating
+		class ChildIterator
+		{
+		public:
+			INLINE ChildIterator(GameObject* current) : mCurrent(current) { }
+
+			INLINE GameObject*				operator*() const { return mCurrent; }
+			INLINE ChildIterator&			operator++() { mCurrent = mCurrent->mNextSibling; return *this; }
+			INLINE bool						operator==(ChildIterator const& other) const { return mCurrent == other.mCurrent; }
+			INLINE bool						operator!=(ChildIterator const& other) const { return mCurrent != other.mCurrent; }
+
+		private:
+			GameObject*						mCurrent;
+		};
+
+		// Walks the whole subtree below an object in preorder without allocating
+		class DescendantIterator
+		{
+		public:
+			INLINE DescendantIterator(GameObject const* root, GameObject* current) : mRoot(root), mCurrent(current) { }
+
+			INLINE GameObject*				operator*() const { return mCurrent; }
+			INLINE DescendantIterator&		operator++() { mCurrent = mCurrent->GetNextInSubtree(mRoot); return *this; }
+			INLINE bool						operator==(DescendantIterator const& other) const { return mCurrent == other.mCurrent; }
+			INLINE bool						operator!=(DescendantIterator const& other) const { return mCurrent != other.mCurrent; }
+
+		private:
+			GameObject const*				mRoot;
+			GameObject*						mCurrent;
+		};
+
+		template<typename ITERATOR>
+		struct Range
+		{
+			ITERATOR						Begin;
+			ITERATOR						End;
+
+			INLINE ITERATOR					begin() const { return Begin; }
+			INLINE ITERATOR					end() const { return End; }
+		};
+
+		// The hierarchy must not be changed while iterating these
+		INLINE Range<ChildIterator>			GetChildren() const { return { ChildIterator(mFirstChild), ChildIterator(nullptr) }; }
+		INLINE Range<DescendantIterator>	GetDescendants() const { return { DescendantIterator(this, mFirstChild), DescendantIterator(this, nullptr) }; }
+
+		// Next object after this one in a preorder walk of the subtree of root, null once past it
+		GameObject*							GetNextInSubtree(GameObject const* root) const;
 		INLINE bool							IsValid() const { return !mDeleted && mEntity.is_valid(); }
 
 		// Copyable Interface
@@ -189,10 +248,10 @@ namespace Darius::Scene
 		INLINE GameObject*					GetParent() const { return mParent; }
 		bool								CanAttachTo(GameObject const* go) const;
 		
-		INLINE void							SetNameId(D_CORE::StringId const& name) { mName = name; }
+		INLINE void							SetNameId(D_CORE::StringId const& name) { mName = name; InvalidatePrefab(); }
 		// Call SetNameId instead
 		INLINE void							SetName(std::string str) { SetNameId(D_CORE::StringId(str.c_str())); }
-		INLINE void							SetType(Type type) { mType = type; }
+		INLINE void							SetType(Type type) { mType = type; InvalidatePrefab(); }
 
 #ifdef _D_EDITOR
 		bool								DrawDetails(float params[]);
@@ -231,7 +290,8 @@ namespace Darius::Scene
 	private:
 		friend class D_SCENE::SceneManager;
 		friend class Darius::Scene::ECS::Components::ComponentBase;
-		friend class Darius::Core::Memory::PagedAllocator<GameObject, true>;
+		template<class T, uint32_t BatchSize>
+		friend class Darius::Core::Memory::SlabAllocator;
 
 		template<class T>
 		friend class D_CORE::Ref;
@@ -241,9 +301,18 @@ namespace Darius::Scene
 		void								PreEntityEdit();
 		void								PostEntityEdit();
 
+		// Moves the object to the end of the children of parent, or out of any when null
+		void								AttachToParent(GameObject* parent);
+
+		// Leaves the children of the parent, keeping the parent pointer
+		void								UnlinkFromParent();
+
 		void								AddComponentRoutine(Darius::Scene::ECS::Components::ComponentBase*);
 		void								RemoveComponentRoutine(Darius::Scene::ECS::Components::ComponentBase*);
 
+		// Objects out of the scene are prefabs, whose compiled templates are outdated by any change
+		void								InvalidatePrefab() const;
+
 #ifdef _D_EDITOR
 		void								DrawComponentNameContext(D_CONTAINERS::DMap<std::string, GameObject::ComponentAddressNode> const& componentNameTree);
 #endif // _D_EDITOR
@@ -263,6 +332,13 @@ namespace Darius::Scene
 		DField()
 		GameObject* mParent;
 
+		GameObject*				mFirstChild;
+		GameObject*				mLastChild;
+		GameObject*				mPrevSibling;
+		GameObject*				mNextSibling;
+		UINT					mChildCount;
+		UINT					mDepth;
+
 		DField(Serialize)
 		const D_CORE::Uuid		mUuid;
 
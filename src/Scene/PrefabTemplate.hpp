@@ -0,0 +1,77 @@
+#pragma once
+
+#include "EntityComponentSystem/Entity.hpp"
+
+#include <Core/Uuid.hpp>
+#include <Core/Containers/Vector.hpp>
+#include <Core/Serialization/Json.hpp>
+#include <Utils/Common.hpp>
+
+#ifndef D_SCENE
+#define D_SCENE Darius::Scene
+#endif // !D_SCENE
+
+namespace Darius::Scene
+{
+	// A game object hierarchy compiled once for instantiating many copies of it. The objects and
+	// components are kept serialized along with their resolved component types, and the values
+	// referencing objects of the hierarchy are found up front, so each copy only writes its new
+	// uuids into those values and deserializes, without dumping the source object again. The
+	// template is not changed by instantiating it, the uuids are written into a copy of the data.
+	class PrefabTemplate
+	{
+	public:
+		PrefabTemplate() = default;
+		PrefabTemplate(PrefabTemplate const&) = delete;
+		PrefabTemplate& operator=(PrefabTemplate const&) = delete;
+
+		INLINE bool							IsValid() const { return !mNodes.empty(); }
+		INLINE UINT							GetObjectCount() const { return (UINT)mNodes.size(); }
+		INLINE D_CORE::Uuid const&			GetSource() const { return mSource; }
+		INLINE bool							IsMaintainingContext() const { return mMaintainContext; }
+
+	private:
+		friend class SceneManager;
+
+		static constexpr UINT				InvalidIndex = ~0u;
+
+		struct ComponentTemplate
+		{
+			D_ECS::ComponentEntry			Entry;
+			D_ECS::ECSId					Id;
+
+			// Index of the component's uuid among the new uuids of a copy
+			UINT							Target;
+			D_SERIALIZATION::Json			Data;
+		};
+
+		struct Node
+		{
+			// Parents come before their children
+			UINT							Parent = InvalidIndex;
+			D_SERIALIZATION::Json			Data;
+
+			// In the order the components of a dumped object are loaded
+			D_CONTAINERS::DVector<ComponentTemplate> Components;
+		};
+
+		// A value in the serialized data to be replaced by a new uuid for each copy, in the
+		// data of the node itself or of one of its components
+		struct ReferenceSlot
+		{
+			UINT							Node;
+			UINT							Component;
+			D_SERIALIZATION::Json::json_pointer Value;
+			UINT							Target;
+		};
+
+		// Root first, the index of a node is also the index of its object's new uuid
+		D_CONTAINERS::DVector<Node>			mNodes;
+		D_CONTAINERS::DVector<ReferenceSlot> mReferenceSlots;
+		UINT								mTargetCount = 0u;
+
+		D_CORE::Uuid						mSource;
+		bool								mSourceInScene = false;
+		bool								mMaintainContext = true;
+	};
+}
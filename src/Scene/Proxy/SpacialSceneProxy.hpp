@@ -3,9 +3,12 @@
 #include "SceneProxy.hpp"
 
 #include <Core/Signal.hpp>
+#include <Job/Job.hpp>
 #include <Math/Bounds/BoundingBox.hpp>
 #include <Math/Bounds/DynamicBVH.hpp>
 
+#include <span>
+
 #include "SpacialSceneProxy.generated.hpp"
 
 #ifndef D_SCENE
@@ -25,18 +28,50 @@ namespace Darius::Scene
 	public:
 		SpacialSceneProxy(SceneManager* scene) :
 			SceneProxy<Object>(scene)
-		{ }
+		{
+			mTransformsChangedConnection = SceneManager::OnTransformsChanged.connect([this](std::span<GameObject* const> changed)
+				{
+					OnTransformsChanged(changed);
+				});
+
+			// Large rebuilds and refits are split among the workers
+			mBVH.SetForkJoin([](std::function<void()> const& first, std::function<void()> const& second)
+				{
+					D_JOB::AddTaskSetAndWait(D_CONTAINERS::DVector<std::function<void()>> { first, second });
+				});
+		}
+
+		virtual ~SpacialSceneProxy()
+		{
+			mTransformsChangedConnection.disconnect();
+		}
 
 		virtual void						Update(float /*dt*/)
 		{
 			mBVH.OptimizeIncremental(1);
 		}
 
+		// Receives all the transforms changed in a frame at once and refits the bvh for them together
+		virtual void						OnTransformsChanged(std::span<GameObject* const> changed)
+		{
+			mLeafUpdates.clear();
+			for(auto go : changed)
+			{
+				if(auto proxy = this->LookupGameObject(go))
+					mLeafUpdates.push_back({ proxy->GetBvhNodeId(), proxy->GetAabb() });
+			}
+
+			if(!mLeafUpdates.empty())
+				mBVH.UpdateBatch(mLeafUpdates.data(), (int)mLeafUpdates.size());
+		}
+
 		INLINE D_MATH_BOUNDS::DynamicBVH<Object*>& GetBVH() { return mBVH; }
 		INLINE D_MATH_BOUNDS::DynamicBVH<Object*> const& GetBVH() const { return mBVH; }
 
 	private:
 		D_MATH_BOUNDS::DynamicBVH<Object*> mBVH;
+		D_CONTAINERS::DVector<typename D_MATH_BOUNDS::DynamicBVH<Object*>::LeafUpdate> mLeafUpdates;
+		D_CORE::SignalConnection			mTransformsChangedConnection;
 	};
 
 	template <typename Object>
@@ -47,7 +82,6 @@ namespace Darius::Scene
 			SceneProxyObjectBase<Object>(go, scene)
 		{
 			D_ASSERT(dynamic_cast<SpacialSceneProxy<Object>*>(scene));
-			mTransformChangeSignal = go->GetTransform()->mWorldChanged.ConnectGenericObject(this, &SpacialSceneProxyObject::OnWorldTransformChanged);
 		}
 
 		virtual void Initialize() override
@@ -59,12 +93,6 @@ namespace Darius::Scene
 		virtual ~SpacialSceneProxyObject()
 		{
 			GetSpacialScene()->GetBVH().Remove(mBvhNodeId);
-			mTransformChangeSignal.disconnect();
-		}
-
-		virtual void						OnWorldTransformChanged(D_MATH::TransformComponent* target, D_MATH::Transform const& newTrans)
-		{
-			GetSpacialScene()->GetBVH().Update(mBvhNodeId, GetAabb());
 		}
 
 		virtual D_MATH_BOUNDS::Aabb			GetAabb() const { return D_MATH_BOUNDS::Aabb(); };
@@ -74,11 +102,11 @@ namespace Darius::Scene
 			GetSpacialScene()->GetBVH().Update(mBvhNodeId, GetAabb());
 		}
 
+		INLINE D_MATH_BOUNDS::DynamicBVH<Object*>::ID GetBvhNodeId() const { return mBvhNodeId; }
 		INLINE SpacialSceneProxy<Object>*	GetSpacialScene() const { return static_cast<SpacialSceneProxy<Object>*>(this->GetScene()); }
 
 	private:
 		
-		D_CORE::SignalConnection			mTransformChangeSignal;
 		D_MATH_BOUNDS::DynamicBVH<Object*>::ID mBvhNodeId;
 	};
 }
@@ -101,7 +101,10 @@ namespace Darius::Scene
 		valueChanged |= mPrefabGameObject->DrawDetails(params);
 
 		if (valueChanged)
+		{
+			D_WORLD::InvalidatePrefabTemplate(mPrefabGameObject);
 			MakeDiskDirty();
+		}
 
 		return valueChanged;
 	}
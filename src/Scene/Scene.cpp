@@ -2,18 +2,23 @@
 #include "Scene.hpp"
 
 #include "GameObject.hpp"
+#include "PrefabTemplate.hpp"
 
 #include "EntityComponentSystem/Components/ComponentBase.hpp"
 #include "EntityComponentSystem/Components/BehaviourComponent.hpp"
 #include "EntityComponentSystem/Components/TransformComponent.hpp"
 #include "Resources/PrefabResource.hpp"
+#include "Streaming/SceneStreamer.hpp"
+#include "Utils/DeferredDeletions.hpp"
 
 #include <Core/Containers/Set.hpp>
 #include <Core/Filesystem/FileUtils.hpp>
 #include <Core/Memory/Memory.hpp>
-#include <Core/Memory/Allocators/PagedAllocator.hpp>
+#include <Core/Memory/Allocators/SlabAllocator.hpp>
+#include <Core/MultiThreading/SpinLock.hpp>
 #include <Core/Serialization/Json.hpp>
 #include <Core/Serialization/TypeSerializer.hpp>
+#include <Core/TimeManager/SystemTime.hpp>
 #include <Core/Uuid.hpp>
 #include <Graphics/GraphicsDeviceManager.hpp>
 #include <Graphics/GraphicsCore.hpp>
@@ -22,6 +27,8 @@
 
 #include <flecs.h>
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 
 using namespace D_CONTAINERS;
@@ -40,11 +47,54 @@ namespace Darius::Scene
 	DVector<std::function<void(float, D_ECS::ECSRegistry&)>>			BehaviourLateUpdaterFunctions;
 	DUnorderedMap<D_ECS::ComponentEntry, rttr::type, std::hash<flecs::id_t>> ComponentEntityReflectionTypeMapping;
 
+	// Open addressed by the precomputed hashes of the component names, probing linearly
+	struct ComponentTypeNameSlot
+	{
+		StringIdHashType												Hash = 0u;
+		UINT															TypeIndex = SceneManager::InvalidComponentTypeIndex;
+	};
+	DVector<ComponentTypeNameSlot>										ComponentTypeNames;
+
+	void InsertComponentTypeName(StringIdHashType hash, UINT typeIndex)
+	{
+		auto mask = ComponentTypeNames.size() - 1;
+		auto slot = (size_t)hash & mask;
+		while(ComponentTypeNames[slot].TypeIndex != SceneManager::InvalidComponentTypeIndex)
+			slot = (slot + 1) & mask;
+		ComponentTypeNames[slot] = { hash, typeIndex };
+	}
+
+
+	DeferredDeletions<GameObject>										ToBeDeleted;
+
+	// Deleted objects wait for the frame resource in use by the GPU to come back around.
+	// Without a device there are no frames in flight, so they go with the next removal.
+	INLINE UINT GetRemovalFrameIndex()
+	{
+		return D_GRAPHICS::IsInitialized() ? D_GRAPHICS_DEVICE::GetCurrentFrameResourceIndex() : 0u;
+	}
+
+	INLINE UINT GetDeletionFrameIndex()
+	{
+		return D_GRAPHICS::IsInitialized() ? D_GRAPHICS_DEVICE::GetCurrentFrameResourceIndex() + D_GRAPHICS_DEVICE::gNumFrameResources - 1 : 0u;
+	}
 
-	DVector<DVector<GameObject*>>										ToBeDeleted;
 	DVector<GameObject*>												ToBeStarted;
 	DSet<GameObject*>													DeletedObjects;
 
+	// Entities whose transforms changed since the last flush, each once
+	DVector<D_ECS::EntityId>											TransformChanges;
+	DVector<D_ECS::EntityId>											FlushingTransformChanges;
+	DVector<GameObject*>												ChangedTransformObjects;
+	D_CORE_THREADING::SpinLock											TransformChangesLock;
+
+	// Transforms that may have been set dirty since the last frame initialization
+	DVector<D_ECS::EntityId>											DirtyTransforms;
+	DVector<D_ECS::EntityId>											CleaningTransforms;
+
+	// Compiled templates of the objects out of the scene, by their uuids
+	DUnorderedMap<Uuid, std::shared_ptr<PrefabTemplate>, UuidHasher>	PrefabTemplates;
+
 	std::string															SceneName;
 	D_FILE::Path														ScenePath;
 
@@ -56,9 +106,11 @@ namespace Darius::Scene
 	D_ECS::Entity SceneManager::Root = D_ECS::Entity();
 	D_ECS::ECSRegistry SceneManager::World = D_ECS::ECSRegistry();
 	DUnorderedMap<D_CORE::StringId, D_ECS::ComponentEntry> SceneManager::ComponentEntryCache;
+	DVector<ComponentTypeInfo> SceneManager::ComponentTypes;
 
 	D_CORE::Signal<void()> SceneManager::OnSceneCleared;
-	D_MEMORY::PagedAllocator<GameObject, true>							GoAllocator;
+	D_CORE::Signal<void(std::span<GameObject* const>)> SceneManager::OnTransformsChanged;
+	D_MEMORY::SlabAllocator<GameObject>									GoAllocator(D_MEMORY::SlabAllocator<GameObject>::DEFAULT_SLAB_SIZE, D_MEMORY::MemoryTag::Scene);
 
 	void SceneManager::Initialize()
 	{
@@ -77,7 +129,7 @@ namespace Darius::Scene
 
 		PrefabResource::Register();
 
-		ToBeDeleted.resize(D_GRAPHICS_DEVICE::gNumFrameResources);
+		ToBeDeleted.Resize(D_GRAPHICS_DEVICE::gNumFrameResources);
 
 		Root = World.entity("Root");
 
@@ -90,6 +142,10 @@ namespace Darius::Scene
 	{
 		D_ASSERT(GOs);
 
+		PrefabTemplates.clear();
+		TransformChanges.clear();
+		DirtyTransforms.clear();
+		ToBeDeleted.Clear();
 		GoAllocator.Reset();
 		GOs.reset();
 		UuidMap.reset();
@@ -107,10 +163,82 @@ namespace Darius::Scene
 
 	void SceneManager::FrameInitialization()
 	{
-		World.each([&](D_MATH::TransformComponent& trans)
-			{
-				trans.SetClean();
-			});
+		if(!EntityMap)
+			return;
+
+		{
+			std::scoped_lock lock(TransformChangesLock);
+			std::swap(DirtyTransforms, CleaningTransforms);
+		}
+
+		for(auto entity : CleaningTransforms)
+		{
+			// Deleted meanwhile
+			auto search = EntityMap->find(entity);
+			if(search == EntityMap->end())
+				continue;
+
+			auto trans = search->second->GetTransform();
+			if(!trans)
+				continue;
+
+			trans->mCleanQueued.Clear();
+			trans->SetClean();
+		}
+		CleaningTransforms.clear();
+	}
+
+	void SceneManager::QueueTransformClean(D_ECS::EntityId entity)
+	{
+		std::scoped_lock lock(TransformChangesLock);
+		DirtyTransforms.push_back(entity);
+	}
+
+	void SceneManager::QueueTransformChange(D_ECS::EntityId entity)
+	{
+		std::scoped_lock lock(TransformChangesLock);
+		TransformChanges.push_back(entity);
+	}
+
+	void SceneManager::FlushTransformChanges()
+	{
+		if(!EntityMap)
+			return;
+
+		// Changes made by the subscribers are queued for the next flush
+		{
+			std::scoped_lock lock(TransformChangesLock);
+			std::swap(TransformChanges, FlushingTransformChanges);
+		}
+
+		ChangedTransformObjects.clear();
+		for(auto entity : FlushingTransformChanges)
+		{
+			// Deleted meanwhile
+			auto search = EntityMap->find(entity);
+			if(search == EntityMap->end())
+				continue;
+
+			auto go = search->second;
+			auto trans = go->GetTransform();
+			if(!trans)
+				continue;
+
+			trans->mWorldChangeQueued.Clear();
+			ChangedTransformObjects.push_back(go);
+		}
+		FlushingTransformChanges.clear();
+
+		if(ChangedTransformObjects.empty())
+			return;
+
+		for(auto go : ChangedTransformObjects)
+		{
+			auto trans = go->GetTransform();
+			trans->mWorldChanged(trans, trans->GetTransformData());
+		}
+
+		OnTransformsChanged(std::span<GameObject* const>(ChangedTransformObjects));
 	}
 
 	void SceneManager::Update(float deltaTime)
@@ -120,6 +248,7 @@ namespace Darius::Scene
 
 		World.progress(deltaTime);
 
+		// Once a frame, as each call retires a frame resource and spends a deletion budget
 		RemoveDeleted();
 
 		// Start to-be-started objects
@@ -127,7 +256,7 @@ namespace Darius::Scene
 			go->Start();
 		ToBeStarted.clear();
 
-		// Update each component
+		// Update each behaviour type, in the order they were registered
 		for(auto& updater : BehaviourUpdaterFunctions)
 			updater(deltaTime, World);
 
@@ -135,8 +264,6 @@ namespace Darius::Scene
 
 	void SceneManager::LateUpdate(float deltaTime)
 	{
-		RemoveDeleted();
-
 		for(auto& updater : BehaviourLateUpdaterFunctions)
 			updater(deltaTime, World);
 	}
@@ -178,20 +305,53 @@ namespace Darius::Scene
 		UuidMap->emplace(uuid, go);
 		EntityMap->emplace(entity, go);
 
+		go->GetTransform()->QueueClean();
+
 		return go;
 	}
 
 	GameObject* SceneManager::InstantiateGameObject(GameObject* go, bool maintainContext)
 	{
-		Json refGoJson;
-		GameObject* result;
-		DumpGameObject(go, refGoJson, maintainContext);
-		LoadGameObject(refGoJson, &result, true);
+		DVector<GameObject*> result;
+		InstantiateGameObjects(go, 1u, result, maintainContext);
+		return result.front();
+	}
+
+	void SceneManager::InstantiateGameObjects(GameObject* go, UINT count, _OUT_ DVector<GameObject*>& result, bool maintainContext)
+	{
+		D_ASSERT(go);
+
+		// Objects in the scene may change at any time, so they are compiled for this call only
+		if(go->IsInScene())
+		{
+			PrefabTemplate prefab;
+			CompilePrefabTemplate(go, prefab, maintainContext);
+			InstantiatePrefabTemplate(prefab, count, result);
+			return;
+		}
+
+		auto& cached = PrefabTemplates[go->GetUuid()];
+		if(!cached || cached->IsMaintainingContext() != maintainContext)
+		{
+			cached = std::make_shared<PrefabTemplate>();
+			CompilePrefabTemplate(go, *cached, maintainContext);
+		}
+
+		// Held for the call, as the new copies may change the prefab and drop it from the cache
+		auto prefab = cached;
+		InstantiatePrefabTemplate(*prefab, count, result);
+	}
+
+	void SceneManager::InvalidatePrefabTemplate(GameObject const* go)
+	{
+		if(!go || PrefabTemplates.empty())
+			return;
 
-		if(!go->IsInScene())
-			result->mPrefab = go->GetUuid();
+		// Cached by the root of the prefab, which any object under it changes
+		while(go->GetParent())
+			go = go->GetParent();
 
-		return result;
+		PrefabTemplates.erase(go->GetUuid());
 	}
 
 	GameObject* SceneManager::CreateGameObject(bool addToScene)
@@ -212,22 +372,81 @@ namespace Darius::Scene
 		return go;
 	}
 
+	void SceneManager::CreateGameObjects(UINT count, _OUT_ DVector<GameObject*>& result, bool addToScene)
+	{
+		if(count == 0u)
+			return;
+
+		// The entities come with their transforms and in place under the root, so that constructing
+		// the objects moves none of them to another table
+		ecs_bulk_desc_t desc = {};
+		desc.count = (int32_t)count;
+		desc.ids[0] = World.id<D_MATH::TransformComponent>();
+		if(addToScene)
+			desc.ids[1] = ecs_pair(flecs::ChildOf, Root.id());
+
+		// Copied right away, flecs may reuse the returned storage
+		auto created = ecs_bulk_init(World, &desc);
+		DVector<D_ECS::EntityId> entities(created, created + count);
+
+		UuidMap->reserve(UuidMap->size() + count);
+		EntityMap->reserve(EntityMap->size() + count);
+		if(addToScene)
+			GOs->reserve(GOs->size() + count);
+
+		result.reserve(result.size() + count);
+		for(auto entity : entities)
+		{
+			auto uuid = GenerateUuid();
+			auto go = GoAllocator.Alloc(uuid, D_ECS::Entity(World, entity), addToScene);
+
+			if(addToScene)
+				GOs->insert(go);
+
+			UuidMap->emplace(uuid, go);
+			EntityMap->emplace(entity, go);
+			go->GetTransform()->QueueClean();
+
+			if(Started)
+				go->Awake();
+			if(Running)
+				go->Start();
+
+			result.push_back(go);
+		}
+	}
+
 	void SceneManager::DeleteGameObject(GameObject* go)
+	{
+		MarkDeleted(go, ToBeDeleted.GetBucket(GetDeletionFrameIndex()));
+	}
+
+	void SceneManager::DeleteGameObjects(std::span<GameObject* const> gos)
+	{
+		auto& toBeDeleted = ToBeDeleted.GetBucket(GetDeletionFrameIndex());
+		toBeDeleted.reserve(toBeDeleted.size() + gos.size());
+
+		for(auto go : gos)
+			MarkDeleted(go, toBeDeleted);
+	}
+
+	void SceneManager::MarkDeleted(GameObject* go, DVector<GameObject*>& toBeDeleted)
 	{
 		if(go->mDeleted || !go->mEntity.is_valid())
 			return;
 
-		if(!go->mDeleted)
-			go->OnPreDestroy();
+		go->OnPreDestroy();
 
 		go->VisitChildren([&](GameObject* child)
 			{
-				DeleteGameObject(child);
+				MarkDeleted(child, toBeDeleted);
 			});
 
+		// The parent keeps its pointer for the destruction callbacks, but no longer lists the object
+		go->UnlinkFromParent();
+
 		go->mDeleted = true;
-		UINT index = (D_GRAPHICS_DEVICE::GetCurrentFrameResourceIndex() + D_GRAPHICS_DEVICE::gNumFrameResources - 1) % D_GRAPHICS_DEVICE::gNumFrameResources;
-		ToBeDeleted[index].push_back(go);
+		toBeDeleted.push_back(go);
 	}
 
 	void SceneManager::DeleteGameObjectImmediately(GameObject* go)
@@ -238,13 +457,62 @@ namespace Darius::Scene
 		World.progress();
 	}
 
-	void SceneManager::DeleteGameObjectData(GameObject* go)
+	void SceneManager::DeleteGameObjectData(DVector<GameObject*>& toBeDeleted)
 	{
-		go->OnDestroy();
-		UuidMap->erase(go->GetUuid());
-		EntityMap->erase(go->mEntity);
-		go->mEntity.destruct();
-		DeletedObjects.insert(go);
+		if(toBeDeleted.empty())
+			return;
+
+		// Objects deleted by the callbacks meanwhile go to the emptied list
+		DVector<GameObject*> gos;
+		std::swap(gos, toBeDeleted);
+
+		// All destroyed before any entity is, so the callbacks still find the rest of the objects
+		for(auto go : gos)
+		{
+			if(!go->IsInScene())
+				InvalidatePrefabTemplate(go);
+
+			go->OnDestroy();
+			UuidMap->erase(go->GetUuid());
+			EntityMap->erase(go->mEntity);
+			GOs->erase(go);
+		}
+
+		// Deepest first, so no entity is a parent anymore when destructed and flecs has no
+		// children to clean up after it. The children of each parent are next to each other.
+		DVector<std::pair<GameObject*, D_ECS::EntityId>> byParent;
+		byParent.reserve(gos.size());
+		for(auto go : gos)
+			byParent.push_back({ go, go->mEntity.parent().id() });
+
+		std::sort(byParent.begin(), byParent.end(), [](auto const& a, auto const& b)
+			{
+				if(a.first->GetDepth() != b.first->GetDepth())
+					return a.first->GetDepth() > b.first->GetDepth();
+				if(a.second != b.second)
+					return a.second < b.second;
+				return ecs_get_table(World, a.first->mEntity) < ecs_get_table(World, b.first->mEntity);
+			});
+
+		for(size_t begin = 0u; begin < byParent.size();)
+		{
+			auto parent = byParent[begin].second;
+			auto end = begin + 1u;
+			while(end < byParent.size() && byParent[end].second == parent)
+				end++;
+
+			// All the children of the parent go, flecs deletes their tables as a whole
+			auto childOf = ecs_pair(flecs::ChildOf, parent);
+			if(parent != 0u && (size_t)ecs_count_id(World, childOf) == end - begin)
+				ecs_delete_with(World, childOf);
+			else
+				for(auto i = begin; i < end; i++)
+					byParent[i].first->mEntity.destruct();
+
+			for(auto i = begin; i < end; i++)
+				DeletedObjects.insert(byParent[i].first);
+			begin = end;
+		}
 	}
 
 	void SceneManager::RemoveDeletedPointers()
@@ -307,39 +575,74 @@ namespace Darius::Scene
 
 	void SceneManager::DumpScene(Json& sceneJson)
 	{
-		// Serializing objects and hierarchy
-		DVector<GameObject const*> rawGos;
-		for(GameObject const* go : *GOs)
-		{
-			rawGos.push_back(go);
+		// Sorted by uuid, so that saving the same scene gives the same file
+		DVector<GameObject const*> rawGos(GOs->begin(), GOs->end());
+		std::sort(rawGos.begin(), rawGos.end(), [](GameObject const* a, GameObject const* b)
+			{
+				return a->GetUuid() < b->GetUuid();
+			});
 
+		DumpObjects(rawGos, sceneJson);
+	}
 
-			// Serialize hierarchy
-			Json& goContext = sceneJson["Hierarchy"][ToString(go->GetUuid())];
-			go->VisitChildren([&](GameObject const* child)
+	void SceneManager::DumpObjects(std::span<GameObject const* const> objects, _OUT_ Json& dump, bool parallel)
+	{
+		struct ObjectFragment
+		{
+			std::string					Uuid;
+			Json						Object;
+			Json						Children;
+			Json						Components;
+		};
+
+		DVector<ObjectFragment> fragments(objects.size());
+		auto serializeRange = [&](UINT begin, UINT end)
+			{
+				for(UINT i = begin; i < end; i++)
 				{
-					goContext.push_back(ToString(child->GetUuid()));
+					auto go = objects[i];
+					auto& fragment = fragments[i];
+
+					fragment.Uuid = ToString(go->GetUuid());
+					D_SERIALIZATION::Serialize(go, fragment.Object);
+
+					for(auto child : go->GetChildren())
+						fragment.Children.push_back(ToString(child->GetUuid()));
+
+					go->VisitComponents([&](D_ECS_COMP::ComponentBase const* comp)
+						{
+							D_SERIALIZATION::Json componentJson;
+							D_SERIALIZATION::Serialize(comp, componentJson);
+							D_CORE::to_json(componentJson["Uuid"], comp->mUuid);
+							fragment.Components[comp->GetComponentName().string()] = std::move(componentJson);
+						});
+				}
+			};
 
-				});
-		}
+		// Objects share nothing while serialized, and only read the scene
+		if(!parallel)
+			serializeRange(0u, (UINT)objects.size());
+		else if(!fragments.empty())
+			D_JOB::AddTaskSetAndWait((UINT)objects.size(), [&](D_JOB::TaskPartition range, D_JOB::ThreadNumber)
+				{
+					serializeRange(range.start, range.end);
+				}, 64u);
 
-		D_SERIALIZATION::SerializeSequentialContainer(rawGos, sceneJson["Objects"]);
+		// Merged in order, so the output is the same as serializing them one by one
+		auto& objectsJson = dump["Objects"] = Json::array();
+		auto& hierarchyJson = dump["Hierarchy"] = Json::object();
+		auto& componentsJson = dump["ObjectComponent"] = Json::object();
 
-		// Serializing components
-		for(GameObject const* go : *GOs)
+		for(auto& fragment : fragments)
 		{
-			D_SERIALIZATION::Json objectComps;
-			go->VisitComponents([&](D_ECS_COMP::ComponentBase const* comp)
-				{
-					auto compName = comp->GetComponentName().string();
-					D_SERIALIZATION::Json componentJson;
-					D_SERIALIZATION::Serialize(comp, componentJson);
-					comp->OnSerialized();
-					D_CORE::to_json(componentJson["Uuid"], comp->mUuid);
-					objectComps[compName] = componentJson;
-				});
-			sceneJson["ObjectComponent"][ToString(go->GetUuid())] = objectComps;
+			objectsJson.push_back(std::move(fragment.Object));
+			hierarchyJson[fragment.Uuid] = std::move(fragment.Children);
+			componentsJson[std::move(fragment.Uuid)] = std::move(fragment.Components);
 		}
+
+		// Back on this thread once merged, in the order of the objects and their components
+		for(auto go : objects)
+			go->VisitComponents([](D_ECS_COMP::ComponentBase const* comp) { comp->OnSerialized(); });
 	}
 
 	void SceneManager::LoadSceneDump(Json const& sceneJson)
@@ -374,6 +677,22 @@ namespace Darius::Scene
 				}
 			}
 
+		// Component types deserialized on the workers once all the components are added
+		DSet<D_ECS::EntityId> parallelTypes;
+		for(auto const& typeInfo : ComponentTypes)
+		{
+			if(typeInfo.ParallelDeserialization)
+				parallelTypes.insert(typeInfo.Entry.id());
+		}
+
+		struct DeferredComponent
+		{
+			D_ECS::Entity				Entity;
+			D_ECS::ECSId				Id;
+			Json const*					Data;
+		};
+		DVector<DeferredComponent> deferred;
+
 		// Loading Components
 		if(sceneJson.contains("ObjectComponent"))
 			for(auto const& [objUuidStr, objCompsJ] : sceneJson["ObjectComponent"].items())
@@ -399,16 +718,189 @@ namespace Darius::Scene
 					gameObject->AddComponentRoutine(comp);
 
 					comp->OnPreDeserialize();
+
+					if(parallelTypes.contains(compR.id()))
+					{
+						deferred.push_back({ gameObject->mEntity, compId, &compJ });
+						continue;
+					}
+
 					D_SERIALIZATION::Deserialize(comp, compJ);
 					comp->OnDeserialized();
 				}
 			}
 
+		// No entity changes from here on, so the components stay where they are while the workers write them
+		auto getDeferred = [](DeferredComponent const& component)
+			{
+				return reinterpret_cast<D_ECS_COMP::ComponentBase*>(const_cast<void*>(component.Entity.get(component.Id)));
+			};
+
+		if(!deferred.empty())
+			D_JOB::AddTaskSetAndWait((UINT)deferred.size(), [&](D_JOB::TaskPartition range, D_JOB::ThreadNumber)
+				{
+					for(UINT i = range.start; i < range.end; i++)
+						D_SERIALIZATION::Deserialize(getDeferred(deferred[i]), *deferred[i].Data);
+				}, 256u);
+
+		for(auto const& component : deferred)
+			getDeferred(component)->OnDeserialized();
+
 		World.progress();
 
 		StartScene();
 	}
 
+	void SceneManager::DumpGameObjects(std::span<GameObject* const> roots, _OUT_ Json& dump, bool parallel)
+	{
+		DVector<GameObject const*> objects;
+		for(auto root : roots)
+		{
+			objects.push_back(root);
+			for(auto desc : root->GetDescendants())
+				objects.push_back(desc);
+		}
+
+		DumpObjects(objects, dump, parallel);
+	}
+
+	bool SceneManager::IntegrateStagedDump(StagedSceneDump& dump, double deadlineMs, bool holdComponents)
+	{
+		D_ASSERT(dump.IsStaged());
+
+		using Phase = StagedSceneDump::Phase;
+
+		auto objectCount = (UINT)dump.mObjects.size();
+
+		// At least one step is taken each call, so that a tiny budget still makes progress
+		while(dump.mPhase != Phase::Done)
+		{
+			switch(dump.mPhase)
+			{
+			case Phase::Objects:
+			{
+				if(dump.mNext == 0u)
+				{
+					dump.mCreated.resize(objectCount);
+					UuidMap->reserve(UuidMap->size() + objectCount);
+					EntityMap->reserve(EntityMap->size() + objectCount);
+					GOs->reserve(GOs->size() + objectCount);
+				}
+
+				if(dump.mNext == objectCount)
+				{
+					dump.mPhase = Phase::Hierarchy;
+					dump.mNext = 0u;
+					continue;
+				}
+
+				auto const& staged = dump.mObjects[dump.mNext];
+
+				if(auto existing = GetGameObject(staged.Uuid))
+				{
+					// A previous copy is deleted but not removed yet
+					if(existing->IsDeleted())
+						return false;
+
+					// A live object has its uuid, e.g. one saved in two chunks, and is left as it is
+					D_LOG_WARN("Skipped a staged object, an object with uuid " << D_CORE::ToString(staged.Uuid) << " already exists");
+					dump.mCreated[dump.mNext++] = nullptr;
+					break;
+				}
+
+				auto obj = AddGameObject(staged.Uuid, true);
+				D_SERIALIZATION::Deserialize(obj, *staged.Data);
+				dump.mCreated[dump.mNext++] = obj;
+				break;
+			}
+
+			case Phase::Hierarchy:
+			{
+				if(dump.mNext == objectCount)
+				{
+					dump.mPhase = Phase::Components;
+					dump.mNext = 0u;
+					continue;
+				}
+
+				// Children of a skipped object stay at the top level
+				auto parent = dump.mCreated[dump.mNext];
+				for(auto child : dump.mObjects[dump.mNext].Children)
+					if(parent && dump.mCreated[child])
+						dump.mCreated[child]->SetParent(parent, GameObject::AttachmentType::KeepLocal);
+				dump.mNext++;
+				break;
+			}
+
+			case Phase::Components:
+			{
+				if(holdComponents)
+					return false;
+
+				if(dump.mNext == objectCount)
+				{
+					dump.mPhase = Phase::Awake;
+					dump.mNext = 0u;
+					continue;
+				}
+
+				auto gameObject = dump.mCreated[dump.mNext];
+				if(!gameObject)
+				{
+					dump.mNext++;
+					break;
+				}
+
+				for(auto const& staged : dump.mObjects[dump.mNext].Components)
+				{
+					auto compEntry = GetComponentEntity(StringId(staged.Name.c_str()));
+					auto compId = World.id(compEntry);
+
+					gameObject->mEntity.add(compEntry);
+					auto compP = const_cast<void*>(gameObject->mEntity.get(compId));
+					D_ASSERT(compP);
+
+					auto comp = reinterpret_cast<D_ECS_COMP::ComponentBase*>(compP);
+
+					D_CORE::UuidFromJson(comp->mUuid, (*staged.Data)["Uuid"]);
+					gameObject->AddComponentRoutine(comp);
+
+					comp->OnPreDeserialize();
+					D_SERIALIZATION::Deserialize(comp, *staged.Data);
+					comp->OnDeserialized();
+				}
+				dump.mNext++;
+				break;
+			}
+
+			case Phase::Awake:
+			{
+				for(auto go : dump.mCreated)
+				{
+					if(!go)
+						continue;
+
+					go->Awake();
+					ToBeStarted.push_back(go);
+				}
+
+				dump.mPhase = Phase::Done;
+				dump.mNext = 0u;
+				continue;
+			}
+
+			default:
+				D_ASSERT_NOENTRY();
+				return true;
+			}
+
+			if(D_TIME::SystemTime::GetCurrentMillisecond() >= deadlineMs)
+				return dump.mPhase == Phase::Done;
+		}
+
+		return true;
+	}
+
 	void SceneManager::SetDeferEnable(bool value)
 	{
 		if(value)
@@ -569,6 +1061,213 @@ namespace Darius::Scene
 #undef NEW_UUID
 	}
 
+	void SceneManager::CompilePrefabTemplate(GameObject const* go, _OUT_ PrefabTemplate& result, bool maintainContext)
+	{
+		D_ASSERT(go);
+
+		result.mNodes.clear();
+		result.mReferenceSlots.clear();
+		result.mTargetCount = 0u;
+		result.mSource = go->GetUuid();
+		result.mSourceInScene = go->IsInScene();
+		result.mMaintainContext = maintainContext;
+
+		DVector<GameObject const*> objects;
+		objects.push_back(go);
+		go->VisitDescendants([&objects](auto go)
+			{
+				objects.push_back(go);
+			});
+
+		// Objects and components are rereferenced to placeholders, which are replaced by new uuids on each instantiation
+		DUnorderedMap<Uuid, Uuid, UuidHasher> placeholderMap;
+		DUnorderedMap<std::string, UINT> placeholders;
+		auto addTarget = [&](Uuid const& uuid)
+			{
+				auto placeholder = D_CORE::GenerateUuid();
+				placeholderMap[uuid] = placeholder;
+				placeholders[ToString(placeholder)] = result.mTargetCount;
+				return result.mTargetCount++;
+			};
+
+		DUnorderedMap<GameObject const*, UINT> objectIndices;
+		for(UINT i = 0; i < objects.size(); i++)
+		{
+			objectIndices[objects[i]] = i;
+			addTarget(objects[i]->GetUuid());
+		}
+
+		// All the targets are known before serializing anything, so any object or component can be referenced
+		DVector<DVector<D_ECS_COMP::ComponentBase const*>> objectComponents(objects.size());
+		DVector<DVector<UINT>> componentTargets(objects.size());
+		for(UINT i = 0; i < objects.size(); i++)
+		{
+			auto& components = objectComponents[i];
+			objects[i]->VisitComponents([&components](D_ECS_COMP::ComponentBase const* comp)
+				{
+					components.push_back(comp);
+				});
+
+			// Dumps load components sorted by name
+			std::sort(components.begin(), components.end(), [](auto a, auto b)
+				{
+					return a->GetComponentName().string() < b->GetComponentName().string();
+				});
+
+			for(auto comp : components)
+				componentTargets[i].push_back(addTarget(comp->mUuid));
+		}
+
+		Serialization::SerializationContext serializationContext = {
+			.Rereference = true,
+			.MaintainExternalReferences = maintainContext,
+			.ReferenceMap = placeholderMap};
+
+		result.mNodes.resize(objects.size());
+		for(UINT i = 0; i < objects.size(); i++)
+		{
+			auto obj = objects[i];
+			auto& node = result.mNodes[i];
+
+			node.Parent = i == 0 ? PrefabTemplate::InvalidIndex : objectIndices.at(obj->GetParent());
+
+			D_SERIALIZATION::Serialize(obj, node.Data, serializationContext);
+			D_CORE::UuidToJson(placeholderMap.at(obj->GetUuid()), node.Data["Uuid"]);
+
+			auto const& components = objectComponents[i];
+			node.Components.resize(components.size());
+			for(UINT j = 0; j < components.size(); j++)
+			{
+				auto comp = components[j];
+				auto& compTemplate = node.Components[j];
+
+				compTemplate.Entry = comp->GetComponentEntry();
+				compTemplate.Id = World.id(compTemplate.Entry);
+				compTemplate.Target = componentTargets[i][j];
+
+				D_SERIALIZATION::Serialize(comp, compTemplate.Data, serializationContext);
+				comp->OnSerialized();
+				D_CORE::UuidToJson(placeholderMap.at(comp->mUuid), compTemplate.Data["Uuid"]);
+			}
+		}
+
+		// Finding the placeholder values, by their paths in the data of their node or component
+		UINT nodeIndex = 0u;
+		UINT componentIndex = PrefabTemplate::InvalidIndex;
+		std::function<void(Json const&, Json::json_pointer const&)> collectSlots = [&](Json const& json, Json::json_pointer const& pointer)
+			{
+				if(json.is_string())
+				{
+					auto search = placeholders.find(json.get_ref<std::string const&>());
+					if(search != placeholders.end())
+						result.mReferenceSlots.push_back({ nodeIndex, componentIndex, pointer, search->second });
+				}
+				else if(json.is_object())
+				{
+					for(auto const& [key, child] : json.items())
+						collectSlots(child, pointer / key);
+				}
+				else if(json.is_array())
+				{
+					for(size_t k = 0; k < json.size(); k++)
+						collectSlots(json[k], pointer / k);
+				}
+			};
+
+		for(nodeIndex = 0u; nodeIndex < result.mNodes.size(); nodeIndex++)
+		{
+			auto const& node = result.mNodes[nodeIndex];
+
+			componentIndex = PrefabTemplate::InvalidIndex;
+			collectSlots(node.Data, Json::json_pointer());
+
+			for(componentIndex = 0u; componentIndex < node.Components.size(); componentIndex++)
+				collectSlots(node.Components[componentIndex].Data, Json::json_pointer());
+		}
+	}
+
+	void SceneManager::InstantiatePrefabTemplate(PrefabTemplate const& prefab, UINT count, _OUT_ DVector<GameObject*>& result)
+	{
+		D_ASSERT(prefab.IsValid());
+
+		auto objectCount = prefab.GetObjectCount();
+
+		result.reserve(result.size() + count);
+		UuidMap->reserve(UuidMap->size() + (size_t)objectCount * count);
+		EntityMap->reserve(EntityMap->size() + (size_t)objectCount * count);
+		ToBeStarted.reserve(ToBeStarted.size() + (size_t)objectCount * count);
+
+		DVector<Uuid> uuids(prefab.mTargetCount);
+		DVector<GameObject*> objects(objectCount);
+
+		// Each call patches its own copy of the data, so the copies it creates can instantiate the
+		// same template again, e.g. when awaking, without seeing the uuids of this call
+		DVector<PrefabTemplate::Node> nodes = prefab.mNodes;
+		DVector<Json*> slotValues;
+		slotValues.reserve(prefab.mReferenceSlots.size());
+		for(auto const& slot : prefab.mReferenceSlots)
+		{
+			auto& node = nodes[slot.Node];
+			auto& data = slot.Component == PrefabTemplate::InvalidIndex ? node.Data : node.Components[slot.Component].Data;
+			slotValues.push_back(&data.at(slot.Value));
+		}
+
+		for(UINT copy = 0; copy < count; copy++)
+		{
+			for(auto& uuid : uuids)
+				uuid = D_CORE::GenerateUuid();
+
+			// Writing this copy's uuids in place of the previous copy's
+			for(UINT i = 0; i < slotValues.size(); i++)
+				D_CORE::UuidToJson(uuids[prefab.mReferenceSlots[i].Target], *slotValues[i]);
+
+			// Creating game object instances
+			for(UINT i = 0; i < objectCount; i++)
+			{
+				auto obj = AddGameObject(uuids[i], true);
+				D_SERIALIZATION::Deserialize(obj, nodes[i].Data);
+				objects[i] = obj;
+			}
+
+			// Loading hierarchy
+			for(UINT i = 1; i < objectCount; i++)
+				objects[i]->SetParent(objects[prefab.mNodes[i].Parent], GameObject::AttachmentType::KeepLocal);
+
+			// Loading components
+			for(UINT i = 0; i < objectCount; i++)
+			{
+				auto gameObject = objects[i];
+
+				for(auto const& compTemplate : nodes[i].Components)
+				{
+					gameObject->mEntity.add(compTemplate.Entry);
+					auto compP = const_cast<void*>(gameObject->mEntity.get(compTemplate.Id));
+					D_ASSERT(compP);
+
+					auto comp = reinterpret_cast<D_ECS_COMP::ComponentBase*>(compP);
+
+					comp->mUuid = uuids[compTemplate.Target];
+					gameObject->AddComponentRoutine(comp);
+
+					D_SERIALIZATION::Deserialize(comp, compTemplate.Data);
+					comp->OnDeserialized();
+				}
+			}
+
+			for(auto obj : objects)
+			{
+				obj->Awake();
+				ToBeStarted.push_back(obj);
+			}
+
+			auto root = objects.front();
+			if(!prefab.mSourceInScene)
+				root->mPrefab = prefab.mSource;
+
+			result.push_back(root);
+		}
+	}
+
 	void SceneManager::Unload()
 	{
 		ClearScene();
@@ -579,10 +1278,12 @@ namespace Darius::Scene
 
 	void SceneManager::ClearScene(std::function<void()> preClean)
 	{
+		DVector<GameObject*> topLevel;
 		Root.children([&](D_ECS::Entity ent)
 			{
-				DeleteGameObject((*EntityMap)[ent]);
+				topLevel.push_back((*EntityMap)[ent]);
 			});
+		DeleteGameObjects(topLevel);
 
 		if(preClean)
 			preClean();
@@ -614,31 +1315,23 @@ namespace Darius::Scene
 	{
 		if(flush)
 		{
-			D_GRAPHICS::GetCommandManager()->IdleGPU();
-			for(auto& instance : ToBeDeleted)
-			{
-				for(auto go : instance)
-				{
-					DeleteGameObjectData(go);
-					GOs->erase(go);
-				}
-				instance.clear();
-			}
+			if(D_GRAPHICS::IsInitialized())
+				D_GRAPHICS::GetCommandManager()->IdleGPU();
+			ToBeDeleted.Flush(DeleteGameObjectData);
 		}
 		else
 		{
-			auto currentResourceIndex = D_GRAPHICS_DEVICE::GetCurrentFrameResourceIndex();
-			for(auto go : ToBeDeleted[currentResourceIndex])
-			{
-				DeleteGameObjectData(go);
-				GOs->erase(go);
-			}
-
-			ToBeDeleted[currentResourceIndex].clear();
+			ToBeDeleted.Retire(GetRemovalFrameIndex());
+			ToBeDeleted.RemoveRetired(DeleteGameObjectData);
 		}
 		RemoveDeletedPointers();
 	}
 
+	void SceneManager::SetDeletionBudget(double milliseconds, UINT maxObjects)
+	{
+		ToBeDeleted.SetBudget(milliseconds, maxObjects);
+	}
+
 	D_FILE::Path SceneManager::GetPath()
 	{
 		return ScenePath;
@@ -687,6 +1380,23 @@ namespace Darius::Scene
 		BehaviourLateUpdaterFunctions.push_back(updater);
 	}
 
+	void SceneManager::UpdateBehavioursInParallel(UINT count, std::function<void(UINT begin, UINT end)> const& updateRange)
+	{
+		// Small tables are not worth waking the workers for
+		constexpr UINT minRange = 256u;
+
+		if(count <= minRange)
+		{
+			updateRange(0u, count);
+			return;
+		}
+
+		D_JOB::AddTaskSetAndWait(count, [&updateRange](D_JOB::TaskPartition range, D_JOB::ThreadNumber)
+			{
+				updateRange(range.start, range.end);
+			}, minRange);
+	}
+
 	bool SceneManager::IsRunning()
 	{
 		return Running;
@@ -705,9 +1415,49 @@ namespace Darius::Scene
 		return result->second;
 	}
 
-	void SceneManager::RegisterComponentType(D_ECS::ComponentEntry componentId, rttr::type type)
+	UINT SceneManager::FindComponentTypeIndex(D_CORE::StringId const& compName)
+	{
+		if(ComponentTypeNames.empty())
+			return InvalidComponentTypeIndex;
+
+		auto hash = compName.hash_code();
+		auto mask = ComponentTypeNames.size() - 1;
+		for(auto slot = (size_t)hash & mask;; slot = (slot + 1) & mask)
+		{
+			auto const& entry = ComponentTypeNames[slot];
+			if(entry.TypeIndex == InvalidComponentTypeIndex)
+				return InvalidComponentTypeIndex;
+
+			// Names sharing a hash are told apart by their strings
+			if(entry.Hash == hash && std::strcmp(ComponentTypes[entry.TypeIndex].Name.string(), compName.string()) == 0)
+				return entry.TypeIndex;
+		}
+	}
+
+	UINT SceneManager::RegisterComponentType(D_ECS::ComponentEntry componentId, D_CORE::StringId const& name, rttr::type type, size_t size, bool parallelDeserialization)
 	{
 		ComponentEntityReflectionTypeMapping.emplace(componentId, type);
+
+		D_ASSERT_M(FindComponentTypeIndex(name) == InvalidComponentTypeIndex, "A component type is already registered by this name.");
+#if _DEBUG
+		for(auto const& typeInfo : ComponentTypes)
+			D_ASSERT_M(typeInfo.Name.hash_code() != name.hash_code(), "Two component type names share a hash.");
+#endif // _DEBUG
+
+		auto typeIndex = (UINT)ComponentTypes.size();
+		ComponentTypes.push_back({ componentId, name, type, size, parallelDeserialization });
+
+		// Kept at most half full, so that the probes stay short
+		if(ComponentTypes.size() * 2 > ComponentTypeNames.size())
+		{
+			ComponentTypeNames.assign(std::max<size_t>(64u, ComponentTypeNames.size() * 2), ComponentTypeNameSlot());
+			for(UINT index = 0u; index < typeIndex; index++)
+				InsertComponentTypeName(ComponentTypes[index].Name.hash_code(), index);
+		}
+
+		InsertComponentTypeName(name.hash_code(), typeIndex);
+
+		return typeIndex;
 	}
 
 }
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include <rttr/type.h>
 
 #include <functional>
+#include <span>
 
 #ifndef D_WORLD
 #define D_WORLD Darius::Scene::SceneManager
@@ -27,6 +28,18 @@ namespace Darius::Scene
 {
 
 	class GameObject;
+	class PrefabTemplate;
+	class StagedSceneDump;
+
+	// A registered component type, found by the dense index it is given at registration
+	struct ComponentTypeInfo
+	{
+		D_ECS::ComponentEntry			Entry;
+		D_CORE::StringId				Name;
+		rttr::type						Type = rttr::type::get<rttr::detail::invalid_type>();
+		size_t							Size = 0u;
+		bool							ParallelDeserialization = false;
+	};
 
 	class SceneManager
 	{
@@ -36,20 +49,41 @@ namespace Darius::Scene
 
 		static GameObject*		CreateGameObject(bool addToScene = true);
 		static GameObject*		CreateGameObject(D_CORE::Uuid uuid, bool addToScene = true);
+		// Creates the entities in bulk and reserves room in the lookups once for all of them
+		static void				CreateGameObjects(UINT count, _OUT_ D_CONTAINERS::DVector<GameObject*>& result, bool addToScene = true);
 		static GameObject*		InstantiateGameObject(GameObject* go, bool maintainContext = true);
+		static void				InstantiateGameObjects(GameObject* go, UINT count, _OUT_ D_CONTAINERS::DVector<GameObject*>& result, bool maintainContext = true);
 		static void				DeleteGameObject(GameObject* go);
+		static void				DeleteGameObjects(std::span<GameObject* const> gos);
 		// Use of this method is strongly discouraged
 		static void				DeleteGameObjectImmediately(GameObject* go);
+
+		// Deleted objects are removed a batch at a time once the GPU frames using them retire, spending
+		// at most about this much at each Update. No limit on the count with zero objects.
+		static void				SetDeletionBudget(double milliseconds, UINT maxObjects = 0u);
 		static void				GetGameObjects(D_CONTAINERS::DVector<GameObject*>& container);
 		static GameObject*		GetGameObject(D_CORE::Uuid const& uuid);
 		static GameObject*		GetGameObject(D_ECS::Entity entity);
 
 		static void				DumpGameObject(GameObject const* go, _OUT_ D_SERIALIZATION::Json& json, bool maintainContext = false);
 		static void				LoadGameObject(D_SERIALIZATION::Json const& json, _OUT_ GameObject** go, bool addToScene = true);
+
+		// Instantiating a compiled template is the same as loading a dump of its source, without dumping each time
+		static void				CompilePrefabTemplate(GameObject const* go, _OUT_ PrefabTemplate& result, bool maintainContext = true);
+		static void				InstantiatePrefabTemplate(PrefabTemplate const& prefab, UINT count, _OUT_ D_CONTAINERS::DVector<GameObject*>& result);
+
+		// Templates of the objects out of the scene are cached, to be invalidated when they change
+		static void				InvalidatePrefabTemplate(GameObject const* go);
 		static bool				BeginStaging();
 		static void				EndStaging();
 
 		static void				FrameInitialization();
+
+		// Delivers the transforms changed since the last flush, each once, to their own signals and to OnTransformsChanged
+		static void				FlushTransformChanges();
+		static void				QueueTransformChange(D_ECS::EntityId entity);
+		// Only the queued transforms are set clean by FrameInitialization
+		static void				QueueTransformClean(D_ECS::EntityId entity);
 		static void				Update(float deltaTime);
 		static void				LateUpdate(float deltaTime);
 
@@ -94,6 +128,11 @@ namespace Darius::Scene
 
 		static INLINE D_ECS::ComponentEntry GetComponentEntity(D_CORE::StringId const& compName)
 		{
+			auto typeIndex = FindComponentTypeIndex(compName);
+			if(typeIndex != InvalidComponentTypeIndex)
+				return ComponentTypes[typeIndex].Entry;
+
+			// Not registered through a static constructor, looked up by its flecs name
 			auto search = ComponentEntryCache.find(compName);
 
 			// Add to cache if not present
@@ -108,12 +147,35 @@ namespace Darius::Scene
 			return search->second;
 		}
 
+		static constexpr UINT	InvalidComponentTypeIndex = ~0u;
+
+		// InvalidComponentTypeIndex until the type is registered. Indices follow the registration order.
+		template<class COMP>
+		static INLINE UINT		GetComponentTypeIndex() { return ComponentTypeIndex<COMP>; }
+
+		// InvalidComponentTypeIndex if no component type is registered by the name
+		static UINT				FindComponentTypeIndex(D_CORE::StringId const& compName);
+
+		static INLINE UINT		GetComponentTypeCount() { return (UINT)ComponentTypes.size(); }
+
+		static INLINE ComponentTypeInfo const& GetComponentTypeInfo(UINT typeIndex)
+		{
+			D_ASSERT(typeIndex < ComponentTypes.size());
+			return ComponentTypes[typeIndex];
+		}
+
+		template<class COMP>
+		static INLINE ComponentTypeInfo const& GetComponentTypeInfo()
+		{
+			return GetComponentTypeInfo(ComponentTypeIndex<COMP>);
+		}
+
 		template<class COMP, class PARENT>
 		static INLINE D_ECS::EntityId RegisterComponent()
 		{
 			auto comp = World.component<COMP>(COMP::ClassName().c_str());
 			auto parentComp = World.component<PARENT>();
-			RegisterComponentType(comp, rttr::type::get<COMP>());
+			RegisterComponentType<COMP>(comp);
 			D_ASSERT(World.is_valid(parentComp));
 			comp.is_a(parentComp);
 			return comp;
@@ -122,8 +184,44 @@ namespace Darius::Scene
 		template<class COMP>
 		static INLINE D_ECS::EntityId RegisterComponent()
 		{
-			return World.component<COMP>(COMP::ClassName().c_str());
+			auto comp = World.component<COMP>(COMP::ClassName().c_str());
+			RegisterComponentType<COMP>(comp);
+			return comp;
+		}
 
+		// Calls Update, or LateUpdate, of the started and active components of the type. The query
+		// is cached, so the matched tables are not looked up again each frame and the components
+		// are visited in their contiguous table columns. Types declaring ParallelUpdates have each
+		// table split among the workers, and must not touch other objects or change entities in them.
+		template<class COMP>
+		static void				UpdateBehaviours(float deltaTime, bool late)
+		{
+			static auto query = World.query_builder<COMP>()
+				.term_at(1).self().inout(flecs::InOut)
+				.build();
+
+			query.iter([&](flecs::iter& it, COMP* comps)
+				{
+					auto updateRange = [comps, deltaTime, late](UINT begin, UINT end)
+						{
+							for(UINT i = begin; i < end; i++)
+							{
+								auto& comp = comps[i];
+								if(!comp.IsStarted() || !comp.IsActive())
+									continue;
+
+								if(late)
+									comp.LateUpdate(deltaTime);
+								else
+									comp.Update(deltaTime);
+							}
+						};
+
+					if constexpr(COMP::ParallelUpdates)
+						UpdateBehavioursInParallel((UINT)it.count(), updateRange);
+					else
+						updateRange(0u, (UINT)it.count());
+				});
 		}
 
 		// Don't call!
@@ -139,21 +237,45 @@ namespace Darius::Scene
 		static void				DumpScene(D_SERIALIZATION::Json& sceneDump);
 		static void				LoadSceneDump(D_SERIALIZATION::Json const& sceneDump);
 
+		// Dumps the hierarchies under the roots keeping their uuids, in the layout of the scene dumps.
+		// Without parallel, the objects are serialized on the calling thread, e.g. when it is a worker.
+		static void				DumpGameObjects(std::span<GameObject* const> roots, _OUT_ D_SERIALIZATION::Json& dump, bool parallel = true);
+
+		// Adds the staged objects to the scene until all are added or the deadline passes, and returns
+		// whether all are. With holdComponents, it stops once the objects are created and in their hierarchy.
+		static bool				IntegrateStagedDump(StagedSceneDump& dump, double deadlineMs, bool holdComponents = false);
+
 		// Events
 		static D_CORE::Signal<void()>	OnSceneCleared;
+		static D_CORE::Signal<void(std::span<GameObject* const>)> OnTransformsChanged;
 
 	private:
-		static void				DeleteGameObjectData(GameObject* go);
+		static void				DeleteGameObjectData(D_CONTAINERS::DVector<GameObject*>& toBeDeleted);
+		static void				MarkDeleted(GameObject* go, D_CONTAINERS::DVector<GameObject*>& toBeDeleted);
 		static void				RemoveDeletedPointers();
+		// Serializes the objects on the workers, each into its own fragments, and merges them in the given order
+		static void				DumpObjects(std::span<GameObject const* const> objects, _OUT_ D_SERIALIZATION::Json& dump, bool parallel = true);
 		static void				StartScene();
 		static void				RemoveDeleted(bool flush = false);
-		static void				RegisterComponentType(D_ECS::ComponentEntry componentId, rttr::type type);
+		static UINT				RegisterComponentType(D_ECS::ComponentEntry componentId, D_CORE::StringId const& name, rttr::type type, size_t size, bool parallelDeserialization);
+
+		template<class COMP>
+		static INLINE void		RegisterComponentType(D_ECS::ComponentEntry componentId)
+		{
+			if(ComponentTypeIndex<COMP> == InvalidComponentTypeIndex)
+				ComponentTypeIndex<COMP> = RegisterComponentType(componentId, D_CORE::StringId(COMP::ClassName().c_str()), rttr::type::get<COMP>(), sizeof(COMP), COMP::ParallelDeserialization);
+		}
+		static void				UpdateBehavioursInParallel(UINT count, std::function<void(UINT begin, UINT end)> const& updateRange);
 
 		static GameObject*		AddGameObject(D_CORE::Uuid const& uuid, bool addToScene = true);
 
 		static D_ECS::Entity	Root;
 		static D_ECS::ECSRegistry World;
 		static D_CONTAINERS::DUnorderedMap<D_CORE::StringId, D_ECS::ComponentEntry> ComponentEntryCache;
+		static D_CONTAINERS::DVector<ComponentTypeInfo> ComponentTypes;
+
+		template<class COMP>
+		static inline UINT		ComponentTypeIndex = InvalidComponentTypeIndex;
 
 		friend class GameObject;
 	};
@@ -0,0 +1,489 @@
+#include "Scene/pch.hpp"
+#include "SceneStreamer.hpp"
+
+#include "Scene/GameObject.hpp"
+#include "Scene/EntityComponentSystem/Components/TransformComponent.hpp"
+
+#include <Core/Containers/Map.hpp>
+#include <Core/Containers/Set.hpp>
+#include <Core/Filesystem/FileUtils.hpp>
+#include <Core/TimeManager/SystemTime.hpp>
+#include <Job/Job.hpp>
+#include <Utils/Assert.hpp>
+
+#include <cmath>
+#include <exception>
+#include <functional>
+#include <limits>
+
+using namespace D_CONTAINERS;
+using namespace D_CORE;
+using namespace D_FILE;
+using namespace D_MATH;
+using namespace D_SERIALIZATION;
+
+namespace Darius::Scene
+{
+	bool StagedSceneDump::Stage(Path const& path)
+	{
+		D_ASSERT(!mStaged);
+
+		try
+		{
+			if(!D_FILE::ReadJsonFile(path, mData))
+				return false;
+		}
+		catch(std::exception const& e)
+		{
+			D_LOG_ERROR("Could not parse scene chunk " << path.string() << ": " << e.what());
+			return false;
+		}
+
+		Json const& data = mData;
+		if(!data.contains("Objects"))
+			return false;
+
+		auto const& objects = data.at("Objects");
+		mObjects.resize(objects.size());
+
+		DUnorderedMap<Uuid, UINT, UuidHasher> indices;
+		for(UINT i = 0u; i < mObjects.size(); i++)
+		{
+			auto& staged = mObjects[i];
+			staged.Data = &objects[i];
+			D_CORE::UuidFromJson(staged.Uuid, objects[i].at("Uuid"));
+			indices[staged.Uuid] = i;
+		}
+
+		DVector<bool> hasParent(mObjects.size(), false);
+		if(data.contains("Hierarchy"))
+			for(auto const& [parentUuid, children] : data.at("Hierarchy").items())
+			{
+				auto parent = indices.find(FromString(parentUuid));
+				if(parent == indices.end())
+					continue;
+
+				for(auto const& childJson : children)
+				{
+					Uuid childUuid;
+					D_CORE::UuidFromJson(childUuid, childJson);
+
+					auto child = indices.find(childUuid);
+					if(child == indices.end())
+						continue;
+
+					mObjects[parent->second].Children.push_back(child->second);
+					hasParent[child->second] = true;
+				}
+			}
+
+		// Components are added in the order of their names, as when loading scene dumps
+		if(data.contains("ObjectComponent"))
+			for(auto const& [objectUuid, components] : data.at("ObjectComponent").items())
+			{
+				auto object = indices.find(FromString(objectUuid));
+				if(object == indices.end())
+					continue;
+
+				auto& stagedComponents = mObjects[object->second].Components;
+				for(auto const& [compName, compJson] : components.items())
+					stagedComponents.push_back({ compName, &compJson });
+			}
+
+		for(UINT i = 0u; i < mObjects.size(); i++)
+		{
+			if(!hasParent[i])
+				mRoots.push_back(mObjects[i].Uuid);
+		}
+
+		mStaged = true;
+		return true;
+	}
+
+	bool SceneStreamer::SaveStreamedScene(Path const& manifestPath, float cellSize)
+	{
+		D_ASSERT(cellSize > 0.f);
+
+		struct SavedCell
+		{
+			int							X;
+			int							Z;
+			DVector<GameObject*>		Roots;
+			Vector3						Min;
+			Vector3						Max;
+		};
+
+		DVector<GameObject*> gos;
+		D_WORLD::GetGameObjects(gos);
+
+		// Whole hierarchies go to the cell of their top level object
+		DMap<std::pair<int, int>, UINT> cellIndices;
+		DVector<SavedCell> cells;
+		for(auto go : gos)
+		{
+			if(go->GetParent())
+				continue;
+
+			auto position = go->GetTransform()->GetPosition();
+			auto key = std::make_pair((int)std::floor(position.GetX() / cellSize), (int)std::floor(position.GetZ() / cellSize));
+
+			auto search = cellIndices.find(key);
+			if(search == cellIndices.end())
+			{
+				search = cellIndices.emplace(key, (UINT)cells.size()).first;
+				cells.push_back({ key.first, key.second, {}, position, position });
+			}
+
+			auto& cell = cells[search->second];
+			cell.Roots.push_back(go);
+
+			// Bounds cover the positions of the whole hierarchy
+			for(auto desc : go->GetDescendants())
+			{
+				auto descPosition = desc->GetTransform()->GetPosition();
+				cell.Min = D_MATH::Min(cell.Min, descPosition);
+				cell.Max = D_MATH::Max(cell.Max, descPosition);
+			}
+			cell.Min = D_MATH::Min(cell.Min, position);
+			cell.Max = D_MATH::Max(cell.Max, position);
+		}
+
+		// Cells owning each object and component, by their uuid strings
+		DVector<Json> dumps(cells.size());
+		DUnorderedMap<std::string, UINT> owners;
+		for(UINT i = 0u; i < cells.size(); i++)
+		{
+			D_WORLD::DumpGameObjects(cells[i].Roots, dumps[i]);
+
+			for(auto const& objectJson : dumps[i]["Objects"])
+				owners[objectJson.at("Uuid").get<std::string>()] = i;
+
+			for(auto const& [_, components] : dumps[i]["ObjectComponent"].items())
+				for(auto const& [__, compJson] : components.items())
+					owners[compJson.at("Uuid").get<std::string>()] = i;
+		}
+
+		auto stem = manifestPath.stem().string();
+		auto directory = manifestPath.parent_path();
+
+		Json manifest;
+		manifest["Type"] = "StreamedScene";
+		manifest["CellSize"] = cellSize;
+		manifest["Cells"] = Json::array();
+
+		for(UINT i = 0u; i < cells.size(); i++)
+		{
+			auto const& cell = cells[i];
+
+			// References are saved as uuid strings, any string owned by another cell is one
+			DSet<UINT> references;
+			std::function<void(Json const&)> findReferences = [&](Json const& json)
+				{
+					if(json.is_string())
+					{
+						auto search = owners.find(json.get_ref<std::string const&>());
+						if(search != owners.end() && search->second != i)
+							references.insert(search->second);
+					}
+					else if(json.is_structured())
+					{
+						for(auto const& child : json)
+							findReferences(child);
+					}
+				};
+			findReferences(dumps[i]["ObjectComponent"]);
+
+			auto fileName = stem + ".cell_" + std::to_string(cell.X) + "_" + std::to_string(cell.Z) + ".json";
+			if(!D_FILE::WriteJsonFile(directory / fileName, dumps[i]))
+				return false;
+
+			Json cellJson;
+			cellJson["X"] = cell.X;
+			cellJson["Z"] = cell.Z;
+			cellJson["File"] = fileName;
+			cellJson["Min"] = { cell.Min.GetX(), cell.Min.GetY(), cell.Min.GetZ() };
+			cellJson["Max"] = { cell.Max.GetX(), cell.Max.GetY(), cell.Max.GetZ() };
+			cellJson["References"] = DVector<UINT>(references.begin(), references.end());
+			manifest["Cells"].push_back(cellJson);
+		}
+
+		return D_FILE::WriteJsonFile(manifestPath, manifest);
+	}
+
+	void SceneStreamer::LoadTask::ExecuteRange(D_JOB::TaskPartition, D_JOB::ThreadNumber)
+	{
+		Succeeded = Dump->Stage(Path);
+	}
+
+	SceneStreamer::SceneStreamer(Settings const& settings) :
+		mSettings(settings)
+	{
+		D_ASSERT(mSettings.UnloadRadius >= mSettings.LoadRadius);
+	}
+
+	SceneStreamer::~SceneStreamer()
+	{
+		Close();
+	}
+
+	bool SceneStreamer::Open(Path const& manifestPath)
+	{
+		Close();
+
+		Json manifest;
+		try
+		{
+			if(!D_FILE::ReadJsonFile(manifestPath, manifest))
+				return false;
+		}
+		catch(std::exception const& e)
+		{
+			D_LOG_ERROR("Could not parse streamed scene manifest " << manifestPath.string() << ": " << e.what());
+			return false;
+		}
+
+		if(!manifest.contains("Type") || manifest["Type"] != "StreamedScene")
+			return false;
+
+		auto directory = manifestPath.parent_path();
+		auto const& cellsJson = manifest["Cells"];
+
+		mCells.resize(cellsJson.size());
+		for(UINT i = 0u; i < mCells.size(); i++)
+		{
+			auto const& cellJson = cellsJson[i];
+			auto& cell = mCells[i];
+
+			cell.X = cellJson.at("X").get<int>();
+			cell.Z = cellJson.at("Z").get<int>();
+			cell.File = directory / cellJson.at("File").get<std::string>();
+
+			auto const& min = cellJson.at("Min");
+			auto const& max = cellJson.at("Max");
+			cell.Min = Vector3(min[0].get<float>(), min[1].get<float>(), min[2].get<float>());
+			cell.Max = Vector3(max[0].get<float>(), max[1].get<float>(), max[2].get<float>());
+
+			for(auto const& reference : cellJson.at("References"))
+			{
+				auto index = reference.get<UINT>();
+				if(D_VERIFY(index < cellsJson.size()))
+					cell.References.push_back(index);
+			}
+		}
+
+		return true;
+	}
+
+	void SceneStreamer::Close()
+	{
+		for(auto& cell : mCells)
+		{
+			// Tasks can't be cancelled, their dumps are kept until they finish
+			if(cell.Task)
+				D_JOB::WaitForTask(cell.Task.get());
+
+			if(cell.State == CellState::Integrating || cell.State == CellState::Loaded)
+				Unload(cell);
+		}
+
+		mCells.clear();
+		mLoadsInFlight = 0u;
+		mLoadedCount = 0u;
+	}
+
+	UINT SceneStreamer::AddSource(Vector3 const& position)
+	{
+		for(UINT i = 0u; i < mSources.size(); i++)
+		{
+			if(mSourceUsed[i])
+				continue;
+
+			mSources[i] = position;
+			mSourceUsed[i] = true;
+			return i;
+		}
+
+		mSources.push_back(position);
+		mSourceUsed.push_back(true);
+		return (UINT)mSources.size() - 1;
+	}
+
+	void SceneStreamer::SetSourcePosition(UINT source, Vector3 const& position)
+	{
+		D_ASSERT(source < mSources.size() && mSourceUsed[source]);
+		mSources[source] = position;
+	}
+
+	void SceneStreamer::RemoveSource(UINT source)
+	{
+		D_ASSERT(source < mSources.size());
+		mSourceUsed[source] = false;
+	}
+
+	bool SceneStreamer::IsCellLoaded(int x, int z) const
+	{
+		for(auto const& cell : mCells)
+		{
+			if(cell.X == x && cell.Z == z)
+				return cell.State == CellState::Loaded;
+		}
+		return false;
+	}
+
+	float SceneStreamer::GetSourceDistance(Cell const& cell) const
+	{
+		float result = std::numeric_limits<float>::max();
+		for(UINT i = 0u; i < mSources.size(); i++)
+		{
+			if(!mSourceUsed[i])
+				continue;
+
+			auto const& source = mSources[i];
+			float dx = std::max(std::max((float)cell.Min.GetX() - (float)source.GetX(), 0.f), (float)source.GetX() - (float)cell.Max.GetX());
+			float dz = std::max(std::max((float)cell.Min.GetZ() - (float)source.GetZ(), 0.f), (float)source.GetZ() - (float)cell.Max.GetZ());
+			result = std::min(result, std::sqrt(dx * dx + dz * dz));
+		}
+		return result;
+	}
+
+	void SceneStreamer::UpdateRequiredCells()
+	{
+		// Close cells, and the loaded ones not far enough yet
+		DVector<UINT> pending;
+		for(UINT i = 0u; i < mCells.size(); i++)
+		{
+			auto& cell = mCells[i];
+			auto distance = GetSourceDistance(cell);
+			bool isIn = cell.State == CellState::Unloaded ? distance <= mSettings.LoadRadius : distance <= mSettings.UnloadRadius;
+
+			cell.Required = false;
+			if(isIn)
+				pending.push_back(i);
+		}
+
+		// Along with all the cells they reference
+		while(!pending.empty())
+		{
+			auto& cell = mCells[pending.back()];
+			pending.pop_back();
+
+			if(cell.Required)
+				continue;
+
+			cell.Required = true;
+			for(auto reference : cell.References)
+			{
+				if(!mCells[reference].Required)
+					pending.push_back(reference);
+			}
+		}
+	}
+
+	void SceneStreamer::Unload(Cell& cell)
+	{
+		DVector<GameObject*> created;
+		if(cell.Dump && cell.Dump->IsStaged())
+		{
+			// Only the objects the dump created, not the live ones it skipped for having their uuids.
+			// Looked up again, as they may have been deleted by others meanwhile. Objects whose
+			// ancestors are deleted along are skipped by the deletion.
+			auto const& dump = *cell.Dump;
+			for(UINT i = 0u; i < dump.mCreated.size(); i++)
+			{
+				auto go = D_WORLD::GetGameObject(dump.mObjects[i].Uuid);
+				if(go && go == dump.mCreated[i] && !go->IsDeleted())
+					created.push_back(go);
+			}
+		}
+		D_WORLD::DeleteGameObjects(created);
+
+		if(cell.State == CellState::Loaded)
+			mLoadedCount--;
+
+		cell.State = CellState::Unloaded;
+		cell.Dump.reset();
+		cell.Task.reset();
+	}
+
+	void SceneStreamer::Update()
+	{
+		UpdateRequiredCells();
+
+		for(auto& cell : mCells)
+		{
+			switch(cell.State)
+			{
+			case CellState::Unloaded:
+				if(!cell.Required || mLoadsInFlight >= mSettings.MaxLoadsInFlight)
+					break;
+
+				cell.Dump = std::make_unique<StagedSceneDump>();
+				cell.Task = std::make_unique<LoadTask>();
+				cell.Task->Path = cell.File;
+				cell.Task->Dump = cell.Dump.get();
+				cell.State = CellState::Loading;
+				mLoadsInFlight++;
+				D_JOB::AddTaskSet(cell.Task.get());
+				break;
+
+			case CellState::Loading:
+				if(!cell.Task->GetIsComplete())
+					break;
+
+				mLoadsInFlight--;
+				if(!cell.Task->Succeeded)
+				{
+					D_LOG_ERROR("Could not load scene chunk " << cell.File.string());
+					cell.Required = false;
+				}
+
+				if(!cell.Required || !cell.Task->Succeeded)
+				{
+					cell.State = CellState::Unloaded;
+					cell.Dump.reset();
+					cell.Task.reset();
+					break;
+				}
+
+				cell.Task.reset();
+				cell.State = CellState::Integrating;
+				break;
+
+			// Integrating cells are finished before being unloaded, so that their objects are all known
+			case CellState::Integrating:
+				break;
+
+			case CellState::Loaded:
+				if(!cell.Required)
+					Unload(cell);
+				break;
+			}
+		}
+
+		// Integrating within the budget. Components are held until the cells they reference have their objects created.
+		auto deadline = D_TIME::SystemTime::GetCurrentMillisecond() + mSettings.IntegrationBudgetMs;
+		for(auto& cell : mCells)
+		{
+			if(cell.State != CellState::Integrating)
+				continue;
+
+			bool referencesCreated = true;
+			for(auto reference : cell.References)
+			{
+				auto const& referenced = mCells[reference];
+				if(!referenced.Dump || !referenced.Dump->IsStaged() || !referenced.Dump->HasCreatedObjects())
+					referencesCreated = false;
+			}
+
+			if(D_WORLD::IntegrateStagedDump(*cell.Dump, deadline, !referencesCreated))
+			{
+				cell.State = CellState::Loaded;
+				mLoadedCount++;
+			}
+
+			// A held cell goes on to the ones it waits for, or with the budget spent they would never be reached
+			if(referencesCreated && D_TIME::SystemTime::GetCurrentMillisecond() >= deadline)
+				break;
+		}
+	}
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "Scene/Scene.hpp"
+
+#include <Core/Uuid.hpp>
+#include <Core/Containers/Vector.hpp>
+#include <Core/Filesystem/Path.hpp>
+#include <Core/Serialization/Json.hpp>
+#include <Job/JobCommon.hpp>
+#include <Math/VectorMath.hpp>
+#include <Utils/Common.hpp>
+
+#include <memory>
+
+#ifndef D_SCENE
+#define D_SCENE Darius::Scene
+#endif // !D_SCENE
+
+namespace Darius::Scene
+{
+	class GameObject;
+
+	// A dump of objects read and parsed off the main thread, to be added to the scene a few objects
+	// at a time by SceneManager::IntegrateStagedDump
+	class StagedSceneDump
+	{
+	public:
+		StagedSceneDump() = default;
+		StagedSceneDump(StagedSceneDump const&) = delete;
+		StagedSceneDump& operator=(StagedSceneDump const&) = delete;
+
+		// Safe to call on the workers, touches nothing in the scene
+		bool								Stage(D_FILE::Path const& path);
+
+		INLINE bool							IsStaged() const { return mStaged; }
+		INLINE bool							IsIntegrated() const { return mPhase == Phase::Done; }
+
+		// Whether all its objects exist in the scene, so others may reference them
+		INLINE bool							HasCreatedObjects() const { return mPhase > Phase::Objects; }
+
+		// The objects without a parent in the dump
+		INLINE D_CONTAINERS::DVector<D_CORE::Uuid> const& GetRoots() const { return mRoots; }
+
+	private:
+		friend class SceneManager;
+		friend class SceneStreamer;
+
+		enum class Phase
+		{
+			Objects,
+			Hierarchy,
+			Components,
+			Awake,
+			Done
+		};
+
+		struct StagedComponent
+		{
+			std::string						Name;
+			D_SERIALIZATION::Json const*	Data;
+		};
+
+		struct StagedObject
+		{
+			D_CORE::Uuid					Uuid;
+			D_SERIALIZATION::Json const*	Data = nullptr;
+			D_CONTAINERS::DVector<UINT>		Children;
+			D_CONTAINERS::DVector<StagedComponent> Components;
+		};
+
+		// Staged objects point into it, so it is not changed after staging
+		D_SERIALIZATION::Json				mData;
+		D_CONTAINERS::DVector<StagedObject>	mObjects;
+		D_CONTAINERS::DVector<D_CORE::Uuid>	mRoots;
+		bool								mStaged = false;
+
+		// Integration progress
+		D_CONTAINERS::DVector<GameObject*>	mCreated;
+		Phase								mPhase = Phase::Objects;
+		UINT								mNext = 0u;
+	};
+
+	// Streams a scene saved by SaveStreamedScene in cells around the streaming sources. Chunks are
+	// read and parsed on the workers, and added to the scene within a time budget each frame. A cell
+	// is only loaded along with the cells it references, so the references between them resolve.
+	class SceneStreamer
+	{
+	public:
+		struct Settings
+		{
+			// Cells closer than this to a source are loaded
+			float							LoadRadius = 100.f;
+
+			// Loaded cells are kept until all sources are farther than this
+			float							UnloadRadius = 150.f;
+
+			// Time spent adding staged objects to the scene each update
+			double							IntegrationBudgetMs = 2.0;
+
+			UINT							MaxLoadsInFlight = 4u;
+		};
+
+		// Splits the scene among square cells on the XZ plane by the positions of the top level
+		// objects, and saves each cell with the hierarchies under them next to the manifest
+		static bool							SaveStreamedScene(D_FILE::Path const& manifestPath, float cellSize);
+
+		SceneStreamer(Settings const& settings);
+		~SceneStreamer();
+
+		SceneStreamer(SceneStreamer const&) = delete;
+		SceneStreamer& operator=(SceneStreamer const&) = delete;
+
+		bool								Open(D_FILE::Path const& manifestPath);
+
+		// Unloads all the cells and waits for the loads in flight
+		void								Close();
+
+		UINT								AddSource(D_MATH::Vector3 const& position);
+		void								SetSourcePosition(UINT source, D_MATH::Vector3 const& position);
+		void								RemoveSource(UINT source);
+
+		// To be called once a frame on the main thread
+		void								Update();
+
+		INLINE UINT							GetCellCount() const { return (UINT)mCells.size(); }
+		INLINE UINT							GetLoadedCellCount() const { return mLoadedCount; }
+		bool								IsCellLoaded(int x, int z) const;
+
+	private:
+		enum class CellState
+		{
+			Unloaded,
+			Loading,
+			Integrating,
+			Loaded
+		};
+
+		class LoadTask : public D_JOB::ITaskSet
+		{
+		public:
+			virtual void ExecuteRange(D_JOB::TaskPartition range, D_JOB::ThreadNumber threadNumber) override;
+
+			D_FILE::Path					Path;
+			StagedSceneDump*				Dump = nullptr;
+			bool							Succeeded = false;
+		};
+
+		struct Cell
+		{
+			int								X;
+			int								Z;
+			D_MATH::Vector3					Min;
+			D_MATH::Vector3					Max;
+			D_FILE::Path					File;
+
+			// Cells holding the objects this one references
+			D_CONTAINERS::DVector<UINT>		References;
+
+			CellState						State = CellState::Unloaded;
+			bool							Required = false;
+			std::unique_ptr<StagedSceneDump> Dump;
+			std::unique_ptr<LoadTask>		Task;
+		};
+
+		// Distance on the XZ plane from the closest source to the contents of the cell
+		float								GetSourceDistance(Cell const& cell) const;
+		void								UpdateRequiredCells();
+		void								Unload(Cell& cell);
+
+		Settings							mSettings;
+		D_CONTAINERS::DVector<Cell>			mCells;
+		D_CONTAINERS::DVector<D_MATH::Vector3> mSources;
+		D_CONTAINERS::DVector<bool>			mSourceUsed;
+		UINT								mLoadsInFlight = 0u;
+		UINT								mLoadedCount = 0u;
+	};
+}
@@ -0,0 +1,1135 @@
+#define BOOST_TEST_MODULE SceneTests
+#define BOOST_TEST_DYN_LINK
+
+#include <EntityComponentSystem/Components/BehaviourComponent.hpp>
+#include <EntityComponentSystem/Components/TransformComponent.hpp>
+#include <GameObject.hpp>
+#include <PrefabTemplate.hpp>
+#include <Scene.hpp>
+#include <Streaming/SceneStreamer.hpp>
+#include <Utils/DeferredDeletions.hpp>
+#include <Core/Containers/Set.hpp>
+#include <Core/Filesystem/FileUtils.hpp>
+#include <Core/Serialization/TypeSerializer.hpp>
+#include <Core/TimeManager/SystemTime.hpp>
+#include <Job/Job.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <thread>
+
+using namespace D_CONTAINERS;
+using namespace D_SCENE;
+
+namespace
+{
+	// Advances a state depending on nothing but itself, the way parallel behaviours must
+	INLINE uint64_t StepState(uint64_t state, float deltaTime)
+	{
+		return state * 6364136223846793005ull + 1442695040888963407ull + (uint64_t)(deltaTime * 1000.f);
+	}
+
+	class SerialStepper : public D_ECS_COMP::BehaviourComponent
+	{
+		D_H_BEHAVIOUR_COMP_BODY(SerialStepper, D_ECS_COMP::BehaviourComponent, "Tests/SerialStepper", false, false);
+
+	public:
+		virtual void Update(float deltaTime) override
+		{
+			State = StepState(State, deltaTime);
+			Visit = ++VisitCount;
+		}
+
+		uint64_t			State = 0u;
+		uint64_t			Visit = 0u;
+
+		static inline uint64_t VisitCount = 0u;
+	};
+
+	class ParallelStepper : public D_ECS_COMP::BehaviourComponent
+	{
+		D_H_BEHAVIOUR_COMP_BODY(ParallelStepper, D_ECS_COMP::BehaviourComponent, "Tests/ParallelStepper", false, false);
+
+	public:
+		static constexpr bool ParallelUpdates = true;
+
+		virtual void Update(float deltaTime) override
+		{
+			State = StepState(State, deltaTime);
+			Updates++;
+		}
+
+		uint64_t			State = 0u;
+		UINT				Updates = 0u;
+	};
+
+	// Instantiates a template again while a copy of it is loading, as components may do
+	class NestedSpawner : public D_ECS_COMP::BehaviourComponent
+	{
+		D_H_BEHAVIOUR_COMP_BODY(NestedSpawner, D_ECS_COMP::BehaviourComponent, "Tests/NestedSpawner", false, false);
+
+	public:
+		virtual void OnDeserialized() override
+		{
+			if (!Template || Spawning)
+				return;
+
+			Spawning = true;
+			D_WORLD::InstantiatePrefabTemplate(*Template, 1u, Spawned);
+			Spawning = false;
+		}
+
+		static inline PrefabTemplate const* Template = nullptr;
+		static inline bool			Spawning = false;
+		static inline DVector<GameObject*> Spawned;
+	};
+
+	D_H_BEHAVIOUR_COMP_DEF(SerialStepper);
+	D_H_COMP_DEFAULT_CONSTRUCTOR_DEF_PAR(SerialStepper, D_ECS_COMP::BehaviourComponent);
+	D_H_BEHAVIOUR_COMP_DEF(ParallelStepper);
+	D_H_COMP_DEFAULT_CONSTRUCTOR_DEF_PAR(ParallelStepper, D_ECS_COMP::BehaviourComponent);
+	D_H_BEHAVIOUR_COMP_DEF(NestedSpawner);
+	D_H_COMP_DEFAULT_CONSTRUCTOR_DEF_PAR(NestedSpawner, D_ECS_COMP::BehaviourComponent);
+
+	template<class COMP>
+	void CheckComponentTypeIndex()
+	{
+		auto index = D_WORLD::GetComponentTypeIndex<COMP>();
+		BOOST_TEST_REQUIRE(index < D_WORLD::GetComponentTypeCount());
+
+		auto const& info = D_WORLD::GetComponentTypeInfo(index);
+		BOOST_TEST(info.Name == D_CORE::StringId(COMP::ClassName().c_str()));
+		BOOST_TEST((info.Type == rttr::type::get<COMP>()));
+		BOOST_TEST(info.Size == sizeof(COMP));
+		BOOST_TEST(info.Entry == D_WORLD::GetTypeId<COMP>());
+		BOOST_TEST(D_WORLD::FindComponentTypeIndex(info.Name) == index);
+		BOOST_TEST(D_WORLD::GetComponentEntity(info.Name) == info.Entry);
+	}
+
+	// The scene is shared by the tests, each working on its own objects
+	struct SceneFixture
+	{
+		SceneFixture()
+		{
+			D_TIME::SystemTime::Initialize();
+			D_JOB::Initialize(D_SERIALIZATION::Json());
+			D_WORLD::Initialize();
+		}
+
+		~SceneFixture()
+		{
+			D_WORLD::Shutdown();
+			D_JOB::Shutdown();
+		}
+	};
+
+	// Roots with full trees of the given depth under them, at distinct positions
+	DVector<GameObject*> CreateHierarchies(UINT rootCount, UINT depth, UINT childCount)
+	{
+		DVector<GameObject*> roots;
+		DVector<GameObject*> level;
+		UINT index = 0u;
+
+		for (UINT i = 0u; i < rootCount; i++)
+		{
+			auto root = D_WORLD::CreateGameObject();
+			root->GetTransform()->SetLocalPosition(D_MATH::Vector3((float)index++, 0.f, 0.f));
+			roots.push_back(root);
+			level.push_back(root);
+		}
+
+		for (UINT d = 0u; d < depth; d++)
+		{
+			DVector<GameObject*> next;
+			for (auto parent : level)
+			{
+				for (UINT c = 0u; c < childCount; c++)
+				{
+					auto child = D_WORLD::CreateGameObject();
+					child->SetParent(parent, GameObject::AttachmentType::KeepLocal);
+					child->GetTransform()->SetLocalPosition(D_MATH::Vector3(0.f, (float)index++, (float)d));
+					next.push_back(child);
+				}
+			}
+			level = std::move(next);
+		}
+
+		return roots;
+	}
+
+	// Checks the links of the object against flecs, which keeps the hierarchy on its own
+	void CheckHierarchyLinks(GameObject* go)
+	{
+		auto parent = go->GetParent();
+		BOOST_TEST((go->GetEntity().parent() == (parent ? parent->GetEntity() : D_WORLD::GetRoot())));
+
+		UINT depth = 0u;
+		for (auto ancestor = parent; ancestor; ancestor = ancestor->GetParent())
+			depth++;
+		BOOST_TEST(go->GetDepth() == depth);
+
+		DSet<D_ECS::EntityId> linked;
+		GameObject* prev = nullptr;
+		for (auto child = go->GetFirstChild(); child; child = child->GetNextSibling())
+		{
+			BOOST_TEST(child->GetParent() == go);
+			BOOST_TEST(child->GetPrevSibling() == prev);
+			linked.insert(child->GetEntity().id());
+			prev = child;
+		}
+		BOOST_TEST(go->GetLastChild() == prev);
+		BOOST_TEST(go->CountChildren() == linked.size());
+
+		DSet<D_ECS::EntityId> children;
+		go->GetEntity().children([&](D_ECS::Entity child) { children.insert(child.id()); });
+		BOOST_TEST((linked == children));
+	}
+
+	// Replaces the uuids with their order of appearance, so copies of a hierarchy dump the same
+	D_SERIALIZATION::Json ReplaceUuids(D_SERIALIZATION::Json const& json, DUnorderedMap<std::string, std::string> const& names)
+	{
+		if (json.is_string())
+		{
+			auto search = names.find(json.get<std::string>());
+			return search == names.end() ? json : D_SERIALIZATION::Json(search->second);
+		}
+
+		if (json.is_array())
+		{
+			auto result = D_SERIALIZATION::Json::array();
+			for (auto const& element : json)
+				result.push_back(ReplaceUuids(element, names));
+			return result;
+		}
+
+		if (json.is_object())
+		{
+			auto result = D_SERIALIZATION::Json::object();
+			for (auto const& [key, value] : json.items())
+			{
+				auto search = names.find(key);
+				result[search == names.end() ? key : search->second] = ReplaceUuids(value, names);
+			}
+			return result;
+		}
+
+		return json;
+	}
+
+	D_SERIALIZATION::Json DumpWithoutUuids(GameObject* root)
+	{
+		D_SERIALIZATION::Json dump;
+		GameObject* roots[] = { root };
+		D_WORLD::DumpGameObjects(roots, dump);
+
+		DUnorderedMap<std::string, std::string> names;
+		for (auto const& objectJson : dump["Objects"])
+		{
+			auto uuid = objectJson.at("Uuid").get<std::string>();
+			names.emplace(uuid, "Object" + std::to_string(names.size()));
+
+			for (auto const& [_, compJson] : dump["ObjectComponent"][uuid].items())
+				names.emplace(compJson.at("Uuid").get<std::string>(), "Component" + std::to_string(names.size()));
+		}
+
+		return ReplaceUuids(dump, names);
+	}
+
+	// Dumps the hierarchies the way it was done before the dumps were split among the workers,
+	// one object after the other on this thread
+	D_SERIALIZATION::Json DumpOneByOne(std::span<GameObject* const> roots)
+	{
+		DVector<GameObject const*> objects;
+		for (auto root : roots)
+		{
+			objects.push_back(root);
+			for (auto desc : root->GetDescendants())
+				objects.push_back(desc);
+		}
+
+		D_SERIALIZATION::Json dump;
+		dump["Objects"] = D_SERIALIZATION::Json::array();
+		dump["Hierarchy"] = D_SERIALIZATION::Json::object();
+		dump["ObjectComponent"] = D_SERIALIZATION::Json::object();
+
+		for (GameObject const* go : objects)
+		{
+			D_SERIALIZATION::Json& goContext = dump["Hierarchy"][D_CORE::ToString(go->GetUuid())];
+			for (auto child : go->GetChildren())
+				goContext.push_back(D_CORE::ToString(child->GetUuid()));
+
+			D_SERIALIZATION::Json objectComps;
+			go->VisitComponents([&](D_ECS_COMP::ComponentBase const* comp)
+				{
+					D_SERIALIZATION::Json componentJson;
+					D_SERIALIZATION::Serialize(comp, componentJson);
+					D_CORE::to_json(componentJson["Uuid"], comp->GetUuid());
+					objectComps[comp->GetComponentName().string()] = componentJson;
+				});
+			dump["ObjectComponent"][D_CORE::ToString(go->GetUuid())] = objectComps;
+		}
+
+		D_SERIALIZATION::SerializeSequentialContainer(objects, dump["Objects"]);
+		return dump;
+	}
+
+	// The objects saved in a cell of a streamed scene
+	DVector<D_CORE::Uuid> ReadCellObjects(D_FILE::Path const& path)
+	{
+		D_SERIALIZATION::Json dump;
+		BOOST_TEST_REQUIRE(D_FILE::ReadJsonFile(path, dump));
+
+		DVector<D_CORE::Uuid> result;
+		for (auto const& objectJson : dump["Objects"])
+		{
+			D_CORE::Uuid uuid;
+			D_CORE::UuidFromJson(uuid, objectJson.at("Uuid"));
+			result.push_back(uuid);
+		}
+		return result;
+	}
+
+	UINT CountExisting(DVector<D_CORE::Uuid> const& uuids)
+	{
+		return (UINT)std::count_if(uuids.begin(), uuids.end(), [](auto const& uuid) { return D_WORLD::GetGameObject(uuid) != nullptr; });
+	}
+
+	struct WorldChangeCounter
+	{
+		void OnWorldChanged(D_MATH::TransformComponent*, D_MATH::Transform const&)
+		{
+			Count++;
+		}
+
+		UINT				Count = 0u;
+	};
+
+	struct Deletable
+	{
+		UINT				Id = 0u;
+		bool				Destroyed = false;
+	};
+
+	// Destroys the batches and keeps the order and size of each
+	struct DestroyedBatches
+	{
+		void operator()(DVector<Deletable*>& batch)
+		{
+			BatchSizes.push_back((UINT)batch.size());
+			for (auto object : batch)
+			{
+				object->Destroyed = true;
+				Order.push_back(object->Id);
+			}
+		}
+
+		DVector<UINT>		BatchSizes;
+		DVector<UINT>		Order;
+	};
+}
+
+BOOST_GLOBAL_FIXTURE(SceneFixture);
+
+BOOST_AUTO_TEST_SUITE(DeferredDeletionTests)
+
+BOOST_AUTO_TEST_CASE(KeptUntilFrameResourceRetires)
+{
+	constexpr UINT frameCount = 3u;
+	D_TIME::SystemTime::Initialize();
+
+	DeferredDeletions<Deletable> deletions(frameCount);
+	DestroyedBatches destroyed;
+	auto destroy = [&](DVector<Deletable*>& batch) { destroyed(batch); };
+
+	Deletable objects[2];
+	objects[0].Id = 0u;
+	objects[1].Id = 1u;
+
+	for (UINT frame = 0u; frame < 2u * frameCount; frame++)
+	{
+		// The start of the frame, as in SceneManager::Update
+		deletions.Retire(frame % frameCount);
+		deletions.RemoveRetired(destroy);
+
+		// Not destroyed before the frame resource in use when deleted comes back around
+		BOOST_TEST(objects[0].Destroyed == (frame >= frameCount - 1u));
+		BOOST_TEST(objects[1].Destroyed == (frame >= frameCount));
+
+		// Deleted into the bucket of the previous frame resource, as in SceneManager::DeleteGameObject
+		if (frame < 2u)
+			deletions.GetBucket(frame + frameCount - 1u).push_back(&objects[frame]);
+	}
+
+	BOOST_TEST(deletions.IsEmpty());
+	BOOST_TEST((destroyed.Order == DVector<UINT>{ 0u, 1u }));
+}
+
+BOOST_AUTO_TEST_CASE(BudgetLimitsDestroysPerCall)
+{
+	constexpr UINT objectCount = 1000u;
+	constexpr UINT budgetCount = 300u;
+	constexpr UINT batchSize = 128u;
+	D_TIME::SystemTime::Initialize();
+
+	DeferredDeletions<Deletable> deletions(1u, batchSize);
+	deletions.SetBudget(1000., budgetCount);
+	DestroyedBatches destroyed;
+	auto destroy = [&](DVector<Deletable*>& batch) { destroyed(batch); };
+
+	DVector<Deletable> objects(objectCount);
+	for (UINT i = 0u; i < objectCount; i++)
+	{
+		objects[i].Id = i;
+		deletions.GetBucket(0u).push_back(&objects[i]);
+	}
+	deletions.Retire(0u);
+
+	UINT calls = 0u;
+	while (deletions.GetRetiredCount() > 0u)
+	{
+		auto before = destroyed.Order.size();
+		auto removed = deletions.RemoveRetired(destroy);
+		calls++;
+
+		BOOST_TEST(removed <= budgetCount);
+		BOOST_TEST(destroyed.Order.size() - before == removed);
+		BOOST_TEST(deletions.GetRetiredCount() == objectCount - destroyed.Order.size());
+	}
+
+	BOOST_TEST(calls == (objectCount + budgetCount - 1u) / budgetCount);
+	BOOST_TEST(std::all_of(destroyed.BatchSizes.begin(), destroyed.BatchSizes.end(), [](UINT size) { return size <= batchSize; }));
+
+	// Destroyed in the order they were queued
+	for (UINT i = 0u; i < objectCount; i++)
+		BOOST_TEST(destroyed.Order[i] == i);
+}
+
+BOOST_AUTO_TEST_CASE(FlushDestroysEverythingRetiredFirst)
+{
+	D_TIME::SystemTime::Initialize();
+
+	DeferredDeletions<Deletable> deletions(2u);
+	deletions.SetBudget(1000., 1u);
+	DestroyedBatches destroyed;
+	auto destroy = [&](DVector<Deletable*>& batch) { destroyed(batch); };
+
+	Deletable objects[4];
+	for (UINT i = 0u; i < 4u; i++)
+		objects[i].Id = i;
+
+	deletions.GetBucket(0u).push_back(&objects[0]);
+	deletions.GetBucket(0u).push_back(&objects[1]);
+	deletions.Retire(0u);
+	deletions.RemoveRetired(destroy);
+	deletions.GetBucket(1u).push_back(&objects[2]);
+	deletions.GetBucket(0u).push_back(&objects[3]);
+
+	deletions.Flush(destroy);
+
+	BOOST_TEST(deletions.IsEmpty());
+	BOOST_TEST((destroyed.Order == DVector<UINT>{ 0u, 1u, 3u, 2u }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(SceneDumpTests)
+
+BOOST_AUTO_TEST_CASE(ParallelDumpMatchesSerial)
+{
+	auto roots = CreateHierarchies(40u, 3u, 3u);
+
+	D_SERIALIZATION::Json parallelDump;
+	D_SERIALIZATION::Json serialDump;
+	D_WORLD::DumpGameObjects(roots, parallelDump);
+	D_WORLD::DumpGameObjects(roots, serialDump, false);
+
+	BOOST_TEST(parallelDump["Objects"].size() == 40u * (1u + 3u + 9u + 27u));
+	BOOST_TEST(parallelDump.dump() == serialDump.dump());
+
+	// Same bytes as serializing the objects one by one
+	BOOST_TEST(parallelDump.dump() == DumpOneByOne(roots).dump());
+
+	// Dumping again gives the same bytes
+	D_SERIALIZATION::Json again;
+	D_WORLD::DumpGameObjects(roots, again);
+	BOOST_TEST(again.dump() == parallelDump.dump());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(TransformChangeTests)
+
+BOOST_AUTO_TEST_CASE(ConcurrentSettersLoseNoChanges)
+{
+	constexpr UINT objectCount = 4096u;
+	constexpr UINT rounds = 8u;
+
+	DVector<GameObject*> gos;
+	D_WORLD::CreateGameObjects(objectCount, gos);
+	D_WORLD::FlushTransformChanges();
+
+	DUnorderedMap<GameObject*, UINT> delivered;
+	D_CORE::SignalScopedConnection connection = D_WORLD::OnTransformsChanged.connect([&](std::span<GameObject* const> changed)
+		{
+			for (auto go : changed)
+				delivered[go]++;
+		});
+
+	for (UINT round = 0u; round < rounds; round++)
+	{
+		delivered.clear();
+
+		// Each object set a few times from its own task, while the others queue theirs
+		D_JOB::AddTaskSetAndWait(objectCount, [&](D_JOB::TaskPartition range, D_JOB::ThreadNumber)
+			{
+				for (UINT i = range.start; i < range.end; i++)
+					for (UINT j = 0u; j < 3u; j++)
+						gos[i]->GetTransform()->SetLocalPosition(D_MATH::Vector3((float)round, (float)i, (float)j));
+			}, 16u);
+
+		D_WORLD::FlushTransformChanges();
+
+		BOOST_TEST(delivered.size() == objectCount);
+		BOOST_TEST(std::all_of(delivered.begin(), delivered.end(), [](auto const& pair) { return pair.second == 1u; }));
+	}
+
+	// Nothing changed since the last flush
+	delivered.clear();
+	D_WORLD::FlushTransformChanges();
+	BOOST_TEST(delivered.empty());
+}
+
+BOOST_AUTO_TEST_CASE(WorldChangedFiresOncePerFlush)
+{
+	auto go = D_WORLD::CreateGameObject();
+	auto trans = go->GetTransform();
+	D_WORLD::FlushTransformChanges();
+
+	WorldChangeCounter counter;
+	auto connection = trans->mWorldChanged.ConnectGenericObject(&counter, &WorldChangeCounter::OnWorldChanged);
+
+	for (UINT i = 0u; i < 10u; i++)
+		trans->SetLocalPosition(D_MATH::Vector3((float)i, 0.f, 0.f));
+	trans->SetLocalScale(D_MATH::Vector3(2.f, 2.f, 2.f));
+	BOOST_TEST(counter.Count == 0u);
+
+	D_WORLD::FlushTransformChanges();
+	BOOST_TEST(counter.Count == 1u);
+
+	D_WORLD::FlushTransformChanges();
+	BOOST_TEST(counter.Count == 1u);
+
+	// Queued again once the flush is done
+	trans->SetLocalPosition(D_MATH::Vector3(1.f, 1.f, 1.f));
+	D_WORLD::FlushTransformChanges();
+	BOOST_TEST(counter.Count == 2u);
+
+	connection.disconnect();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(HierarchyTests)
+
+BOOST_AUTO_TEST_CASE(RandomReparentingKeepsLinks)
+{
+	constexpr UINT objectCount = 256u;
+	constexpr UINT steps = 4000u;
+
+	DVector<GameObject*> gos;
+	D_WORLD::CreateGameObjects(objectCount, gos);
+
+	std::mt19937 random(45u);
+	std::uniform_int_distribution<UINT> pick(0u, objectCount - 1u);
+
+	for (UINT step = 0u; step < steps; step++)
+	{
+		auto go = gos[pick(random)];
+
+		// Back to the root now and then, otherwise under any object not below it
+		GameObject* parent = nullptr;
+		if (random() % 8u != 0u)
+		{
+			parent = gos[pick(random)];
+			if (!go->CanAttachTo(parent))
+				continue;
+		}
+
+		go->SetParent(parent, step % 2u ? GameObject::AttachmentType::KeepLocal : GameObject::AttachmentType::KeepWorld);
+
+		if (step % 500u == 0u)
+			for (auto checked : gos)
+				CheckHierarchyLinks(checked);
+	}
+
+	for (auto go : gos)
+		CheckHierarchyLinks(go);
+
+	// Descendants reached through the links are the ones flecs has under the object
+	for (auto go : gos)
+	{
+		UINT count = 0u;
+		for (auto desc : go->GetDescendants())
+		{
+			BOOST_TEST(desc->GetDepth() > go->GetDepth());
+			count++;
+		}
+
+		UINT flecsCount = 0u;
+		std::function<void(D_ECS::Entity)> countChildren = [&](D_ECS::Entity entity)
+			{
+				entity.children([&](D_ECS::Entity child)
+					{
+						flecsCount++;
+						countChildren(child);
+					});
+			};
+		countChildren(go->GetEntity());
+		BOOST_TEST(count == flecsCount);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(AttachingUnderDescendantIsRefused)
+{
+	auto root = CreateHierarchies(1u, 3u, 2u)[0];
+	auto child = root->GetFirstChild();
+	auto grandChild = child->GetLastChild();
+	auto leaf = grandChild->GetFirstChild();
+
+	BOOST_TEST(!child->CanAttachTo(leaf));
+	child->SetParent(leaf, GameObject::AttachmentType::KeepLocal);
+	root->SetParent(grandChild, GameObject::AttachmentType::KeepWorld);
+	child->SetParent(child, GameObject::AttachmentType::KeepLocal);
+
+	// Nothing moved
+	BOOST_TEST(!root->GetParent());
+	BOOST_TEST(child->GetParent() == root);
+	BOOST_TEST(leaf->GetParent() == grandChild);
+	BOOST_TEST(leaf->GetDepth() == 3u);
+
+	UINT count = 0u;
+	CheckHierarchyLinks(root);
+	for (auto desc : root->GetDescendants())
+	{
+		CheckHierarchyLinks(desc);
+		count++;
+	}
+	BOOST_TEST(count == 2u + 4u + 8u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(PrefabTemplateTests)
+
+BOOST_AUTO_TEST_CASE(TemplateCopiesMatchJsonCopies)
+{
+	auto source = CreateHierarchies(1u, 3u, 3u).front();
+
+	// The way copies were made before the templates
+	D_SERIALIZATION::Json sourceJson;
+	D_WORLD::DumpGameObject(source, sourceJson);
+	GameObject* jsonCopy = nullptr;
+	D_WORLD::LoadGameObject(sourceJson, &jsonCopy);
+	BOOST_TEST_REQUIRE(jsonCopy);
+
+	PrefabTemplate prefab;
+	D_WORLD::CompilePrefabTemplate(source, prefab, false);
+	BOOST_TEST(prefab.GetObjectCount() == 1u + 3u + 9u + 27u);
+
+	DVector<GameObject*> templateCopies;
+	D_WORLD::InstantiatePrefabTemplate(prefab, 4u, templateCopies);
+	BOOST_TEST_REQUIRE(templateCopies.size() == 4u);
+
+	auto expected = DumpWithoutUuids(jsonCopy);
+	BOOST_TEST(expected["Objects"].size() == prefab.GetObjectCount());
+
+	DSet<D_CORE::Uuid, D_CORE::UuidHasher> uuids;
+	for (auto copy : templateCopies)
+	{
+		BOOST_TEST(DumpWithoutUuids(copy).dump() == expected.dump());
+
+		// Each copy gets its own objects
+		uuids.insert(copy->GetUuid());
+		for (auto desc : copy->GetDescendants())
+			uuids.insert(desc->GetUuid());
+	}
+	BOOST_TEST(uuids.size() == 4u * prefab.GetObjectCount());
+}
+
+BOOST_AUTO_TEST_CASE(InstantiatingFromWithinACopyKeepsBothIntact)
+{
+	NestedSpawner::StaticConstructor();
+
+	auto source = CreateHierarchies(1u, 2u, 3u).front();
+	(*source->GetChildren().begin())->AddComponent<NestedSpawner>();
+
+	PrefabTemplate prefab;
+	D_WORLD::CompilePrefabTemplate(source, prefab, false);
+	auto expected = DumpWithoutUuids(source);
+
+	// Each outer copy loads a nested one halfway through its components
+	NestedSpawner::Template = &prefab;
+	NestedSpawner::Spawned.clear();
+	DVector<GameObject*> copies;
+	D_WORLD::InstantiatePrefabTemplate(prefab, 3u, copies);
+	NestedSpawner::Template = nullptr;
+
+	BOOST_TEST_REQUIRE(NestedSpawner::Spawned.size() == 3u);
+	copies.insert(copies.end(), NestedSpawner::Spawned.begin(), NestedSpawner::Spawned.end());
+
+	DSet<D_CORE::Uuid, D_CORE::UuidHasher> uuids;
+	auto addUuids = [&](GameObject* go)
+		{
+			BOOST_TEST(D_WORLD::GetGameObject(go->GetUuid()) == go);
+			uuids.insert(go->GetUuid());
+			go->VisitComponents([&](D_ECS_COMP::ComponentBase* comp) { uuids.insert(comp->GetUuid()); });
+		};
+
+	UINT componentCount = 0u;
+	auto countComponents = [&](GameObject* go) { go->VisitComponents([&](D_ECS_COMP::ComponentBase*) { componentCount++; }); };
+	countComponents(source);
+	source->VisitDescendants(countComponents);
+
+	for (auto copy : copies)
+	{
+		BOOST_TEST(DumpWithoutUuids(copy).dump() == expected.dump());
+
+		addUuids(copy);
+		for (auto desc : copy->GetDescendants())
+			addUuids(desc);
+	}
+	BOOST_TEST(uuids.size() == copies.size() * (prefab.GetObjectCount() + componentCount));
+}
+
+BOOST_AUTO_TEST_CASE(ChangingThePrefabRecompilesItsTemplate)
+{
+	auto source = CreateHierarchies(1u, 2u, 2u).front();
+
+	D_SERIALIZATION::Json sourceJson;
+	D_WORLD::DumpGameObject(source, sourceJson);
+	GameObject* prefab = nullptr;
+	D_WORLD::LoadGameObject(sourceJson, &prefab, false);
+	BOOST_TEST_REQUIRE(prefab);
+	BOOST_TEST_REQUIRE(!prefab->IsInScene());
+
+	DVector<GameObject*> before;
+	D_WORLD::InstantiateGameObjects(prefab, 2u, before, false);
+	BOOST_TEST_REQUIRE(before.size() == 2u);
+
+	// Changed deep in the prefab, both on the object and on one of its components
+	auto leaf = *(*prefab->GetChildren().begin())->GetChildren().begin();
+	leaf->SetName("ChangedLeaf");
+	leaf->GetTransform()->SetLocalPosition(D_MATH::Vector3(7.f, 8.f, 9.f));
+
+	DVector<GameObject*> after;
+	D_WORLD::InstantiateGameObjects(prefab, 2u, after, false);
+	BOOST_TEST_REQUIRE(after.size() == 2u);
+
+	for (auto copy : after)
+	{
+		auto copyLeaf = *(*copy->GetChildren().begin())->GetChildren().begin();
+		BOOST_TEST(copyLeaf->GetName() == "ChangedLeaf");
+		BOOST_TEST(copyLeaf->GetTransform()->GetLocalPosition().GetX() == 7.f);
+	}
+
+	// The earlier copies keep what the prefab was
+	for (auto copy : before)
+		BOOST_TEST((*(*copy->GetChildren().begin())->GetChildren().begin())->GetName() != "ChangedLeaf");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(BehaviourUpdateTests)
+
+BOOST_AUTO_TEST_CASE(ParallelUpdatesMatchSerial)
+{
+	constexpr UINT objectCount = 3000u;
+	constexpr UINT frames = 8u;
+
+	SerialStepper::StaticConstructor();
+	ParallelStepper::StaticConstructor();
+
+	DVector<GameObject*> gos;
+	D_WORLD::CreateGameObjects(objectCount, gos);
+	for (UINT i = 0u; i < objectCount; i++)
+	{
+		gos[i]->AddComponent<SerialStepper>();
+		gos[i]->AddComponent<ParallelStepper>();
+		gos[i]->GetComponent<SerialStepper>()->State = i + 1u;
+		gos[i]->GetComponent<ParallelStepper>()->State = i + 1u;
+		gos[i]->Start();
+	}
+
+	DVector<uint64_t> firstOrder;
+	for (UINT frame = 0u; frame < frames; frame++)
+	{
+		float deltaTime = 0.01f * (float)(frame + 1u);
+		auto visitsBefore = SerialStepper::VisitCount;
+
+		D_WORLD::UpdateBehaviours<SerialStepper>(deltaTime, false);
+		D_WORLD::UpdateBehaviours<ParallelStepper>(deltaTime, false);
+
+		// The serial ones are visited in the same order each frame
+		DVector<uint64_t> order;
+		for (auto go : gos)
+			order.push_back(go->GetComponent<SerialStepper>()->Visit - visitsBefore);
+		if (frame == 0u)
+			firstOrder = order;
+		else
+			BOOST_TEST((order == firstOrder));
+	}
+
+	for (auto go : gos)
+	{
+		auto parallel = go->GetComponent<ParallelStepper>();
+		BOOST_TEST(parallel->Updates == frames);
+		BOOST_TEST(parallel->State == go->GetComponent<SerialStepper>()->State);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(DeletedBehavioursStopUpdating)
+{
+	constexpr UINT rootCount = 32u;
+
+	ParallelStepper::StaticConstructor();
+
+	// Roots with a child each, every other root deleted with its child
+	auto roots = CreateHierarchies(rootCount, 1u, 1u);
+	DVector<GameObject*> deleted;
+	DVector<D_CORE::Uuid> deletedUuids;
+	DVector<ParallelStepper*> liveSteppers;
+	for (UINT i = 0u; i < rootCount; i++)
+	{
+		for (auto go : { roots[i], roots[i]->GetFirstChild() })
+		{
+			auto stepper = go->AddComponent<ParallelStepper>();
+			go->Start();
+			if (i % 2u)
+				liveSteppers.push_back(stepper);
+			else
+				deletedUuids.push_back(go->GetUuid());
+		}
+
+		if (i % 2u == 0u)
+			deleted.push_back(roots[i]);
+	}
+
+	D_WORLD::UpdateBehaviours<ParallelStepper>(0.01f, false);
+	D_WORLD::DeleteGameObjects(deleted);
+
+	// Removing one object an update keeps most of them pending for many frames
+	D_WORLD::SetDeletionBudget(1000., 1u);
+	UINT pending = 0u;
+	for (UINT frame = 0u; frame < 4u; frame++)
+	{
+		D_WORLD::UpdateBehaviours<ParallelStepper>(0.01f, false);
+		D_WORLD::UpdateBehaviours<ParallelStepper>(0.01f, true);
+
+		// Only the objects not removed yet are still found
+		pending = 0u;
+		for (auto const& uuid : deletedUuids)
+		{
+			if (auto go = D_WORLD::GetGameObject(uuid))
+			{
+				BOOST_TEST(go->IsDeleted());
+				BOOST_TEST(!go->IsActive());
+				BOOST_TEST(go->GetComponent<ParallelStepper>()->Updates == 1u);
+				pending++;
+			}
+		}
+		for (auto stepper : liveSteppers)
+			BOOST_TEST(stepper->Updates == frame + 2u);
+
+		D_WORLD::Update(0.f);
+	}
+	BOOST_TEST(pending > 0u);
+	BOOST_TEST(pending < deletedUuids.size());
+
+	D_WORLD::SetDeletionBudget(1.);
+	D_WORLD::Update(0.f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(ComponentTypeIndexTests)
+
+BOOST_AUTO_TEST_CASE(DenseIndicesAgreeWithLookups)
+{
+	// Whichever of these registers first, the lookups must agree with the indices they got
+	ParallelStepper::StaticConstructor();
+	SerialStepper::StaticConstructor();
+
+	CheckComponentTypeIndex<D_ECS_COMP::ComponentBase>();
+	CheckComponentTypeIndex<D_ECS_COMP::BehaviourComponent>();
+	CheckComponentTypeIndex<D_MATH::TransformComponent>();
+	CheckComponentTypeIndex<SerialStepper>();
+	CheckComponentTypeIndex<ParallelStepper>();
+
+	// Every index up to the count is taken by its own type, found by its own name
+	DSet<D_ECS::EntityId> entries;
+	DSet<D_CORE::StringIdHashType> hashes;
+	for (UINT index = 0u; index < D_WORLD::GetComponentTypeCount(); index++)
+	{
+		auto const& info = D_WORLD::GetComponentTypeInfo(index);
+		BOOST_TEST(D_WORLD::FindComponentTypeIndex(info.Name) == index);
+		BOOST_TEST((D_WORLD::GetComponentReflectionTypeByComponentEntity(info.Entry) == info.Type));
+		entries.insert((D_ECS::EntityId)info.Entry);
+		hashes.insert(info.Name.hash_code());
+	}
+	BOOST_TEST(entries.size() == D_WORLD::GetComponentTypeCount());
+	BOOST_TEST(hashes.size() == D_WORLD::GetComponentTypeCount());
+	BOOST_TEST(D_WORLD::FindComponentTypeIndex(D_CORE::StringId("NotAComponent")) == D_WORLD::InvalidComponentTypeIndex);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(BulkCreationTests)
+
+BOOST_AUTO_TEST_CASE(BulkCreateAndDeleteStress)
+{
+	constexpr UINT rounds = 6u;
+	constexpr UINT batch = 5000u;
+
+	std::mt19937 random(47u);
+	D_WORLD::SetDeletionBudget(1000.);
+
+	DVector<GameObject*> alive;
+	DVector<D_CORE::Uuid> deletedUuids;
+	for (UINT round = 0u; round < rounds; round++)
+	{
+		// A batch at once, part of it then moved under the earlier objects
+		DVector<GameObject*> created;
+		D_WORLD::CreateGameObjects(batch, created);
+		BOOST_TEST_REQUIRE(created.size() == batch);
+
+		for (auto go : created)
+		{
+			BOOST_TEST(D_WORLD::GetGameObject(go->GetUuid()) == go);
+			BOOST_TEST(D_WORLD::GetGameObject(go->GetEntity()) == go);
+			BOOST_TEST(go->GetTransform() != nullptr);
+			BOOST_TEST((go->GetEntity().parent() == D_WORLD::GetRoot()));
+
+			if (!alive.empty() && random() % 4u == 0u)
+				go->SetParent(alive[random() % alive.size()], GameObject::AttachmentType::KeepLocal);
+		}
+		alive.insert(alive.end(), created.begin(), created.end());
+
+		// Deletes a third of the roots, taking their subtrees with them
+		DVector<GameObject*> toDelete;
+		for (auto go : alive)
+			if (!go->GetParent() && random() % 3u == 0u)
+				toDelete.push_back(go);
+
+		DSet<GameObject*> deleted;
+		for (auto go : toDelete)
+		{
+			deleted.insert(go);
+			for (auto desc : go->GetDescendants())
+				deleted.insert(desc);
+		}
+		for (auto go : deleted)
+			deletedUuids.push_back(go->GetUuid());
+
+		D_WORLD::DeleteGameObjects(toDelete);
+		D_WORLD::Update(0.f);
+
+		std::erase_if(alive, [&](GameObject* go) { return deleted.contains(go); });
+
+		for (auto const& uuid : deletedUuids)
+			BOOST_TEST(D_WORLD::GetGameObject(uuid) == nullptr);
+
+		for (auto go : alive)
+		{
+			BOOST_TEST(D_WORLD::GetGameObject(go->GetUuid()) == go);
+			CheckHierarchyLinks(go);
+		}
+	}
+
+	D_WORLD::SetDeletionBudget(1.);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(SceneStreamingTests)
+
+BOOST_AUTO_TEST_CASE(ReferencedCellsResolveWithinBudget)
+{
+	// Saving takes the whole scene
+	D_WORLD::ClearScene();
+
+	constexpr UINT cellCount = 3u;
+	DUnorderedMap<D_CORE::Uuid, float, D_CORE::UuidHasher> rootX;
+	for (UINT i = 0u; i < cellCount; i++)
+	{
+		auto root = CreateHierarchies(1u, 2u, 3u)[0];
+		root->GetTransform()->SetLocalPosition(D_MATH::Vector3(1000.f * i + 5.f, 0.f, 5.f));
+		rootX[root->GetUuid()] = 1000.f * i + 5.f;
+	}
+
+	auto directory = std::filesystem::temp_directory_path() / "DariusSceneStreamingTests";
+	std::filesystem::create_directories(directory);
+	auto manifestPath = directory / "Streamed.json";
+	BOOST_TEST_REQUIRE(SceneStreamer::SaveStreamedScene(manifestPath, 100.f));
+
+	// No component here references other objects, so the first cell is made to reference the second in the manifest
+	D_SERIALIZATION::Json manifest;
+	BOOST_TEST_REQUIRE(D_FILE::ReadJsonFile(manifestPath, manifest));
+	auto& cellsJson = manifest["Cells"];
+	BOOST_TEST_REQUIRE(cellsJson.size() == cellCount);
+	BOOST_TEST(cellsJson[0]["References"].empty());
+	cellsJson[0]["References"] = DVector<UINT>{ 1u };
+	BOOST_TEST_REQUIRE(D_FILE::WriteJsonFile(manifestPath, manifest));
+
+	DVector<DVector<D_CORE::Uuid>> cellObjects;
+	for (auto const& cellJson : cellsJson)
+		cellObjects.push_back(ReadCellObjects(directory / cellJson["File"].get<std::string>()));
+
+	auto cellX = [&](UINT i) { return cellsJson[i]["X"].get<int>(); };
+	auto cellZ = [&](UINT i) { return cellsJson[i]["Z"].get<int>(); };
+
+	D_WORLD::ClearScene();
+	for (auto const& objects : cellObjects)
+		BOOST_TEST(CountExisting(objects) == 0u);
+
+	// The budget is always spent after a step, so each cell takes one step an update
+	SceneStreamer::Settings settings;
+	settings.LoadRadius = 10.f;
+	settings.UnloadRadius = 20.f;
+	settings.IntegrationBudgetMs = 1e-6;
+
+	SceneStreamer streamer(settings);
+	BOOST_TEST_REQUIRE(streamer.Open(manifestPath));
+	BOOST_TEST(streamer.GetCellCount() == cellCount);
+
+	// Only the first cell is close, the cells are a thousand units apart
+	auto const& min = cellsJson[0]["Min"];
+	auto source = streamer.AddSource(D_MATH::Vector3(min[0].get<float>(), 0.f, min[2].get<float>()));
+
+	DVector<UINT> created(cellCount, 0u);
+	bool loadedBeforeReferenced = false;
+	bool overBudget = false;
+	for (UINT i = 0u; i < 100000u && streamer.GetLoadedCellCount() < 2u; i++)
+	{
+		streamer.Update();
+
+		for (UINT c = 0u; c < cellCount; c++)
+		{
+			auto count = CountExisting(cellObjects[c]);
+			overBudget |= count > created[c] + 1u;
+			created[c] = count;
+		}
+
+		if (streamer.IsCellLoaded(cellX(0), cellZ(0)) && created[1] < cellObjects[1].size())
+			loadedBeforeReferenced = true;
+
+		// Waiting for the workers to stage the cells
+		std::this_thread::yield();
+	}
+
+	BOOST_TEST(streamer.GetLoadedCellCount() == 2u);
+	BOOST_TEST(streamer.IsCellLoaded(cellX(0), cellZ(0)));
+	BOOST_TEST(streamer.IsCellLoaded(cellX(1), cellZ(1)));
+	BOOST_TEST(!streamer.IsCellLoaded(cellX(2), cellZ(2)));
+	BOOST_TEST(!loadedBeforeReferenced);
+	BOOST_TEST(!overBudget);
+	BOOST_TEST(created[0] == cellObjects[0].size());
+	BOOST_TEST(created[1] == cellObjects[1].size());
+	BOOST_TEST(created[2] == 0u);
+
+	// Loaded back where they were saved
+	for (UINT c = 0u; c < 2u; c++)
+	{
+		for (auto const& uuid : cellObjects[c])
+		{
+			auto go = D_WORLD::GetGameObject(uuid);
+			BOOST_TEST_REQUIRE(go);
+			CheckHierarchyLinks(go);
+
+			if (!go->GetParent())
+				BOOST_TEST(go->GetTransform()->GetPosition().GetX() == rootX.at(uuid));
+		}
+	}
+
+	// Out of the unload radius of everything
+	streamer.SetSourcePosition(source, D_MATH::Vector3(100000.f, 0.f, 100000.f));
+	streamer.Update();
+	BOOST_TEST(streamer.GetLoadedCellCount() == 0u);
+
+	D_WORLD::Update(0.f);
+	for (auto const& objects : cellObjects)
+		BOOST_TEST(CountExisting(objects) == 0u);
+
+	streamer.Close();
+	std::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(LiveDuplicatesAreSkipped)
+{
+	auto root = CreateHierarchies(1u, 2u, 2u)[0];
+	root->GetTransform()->SetLocalPosition(D_MATH::Vector3(3.f, 4.f, 5.f));
+
+	DVector<GameObject*> originals = { root };
+	for (auto desc : root->GetDescendants())
+		originals.push_back(desc);
+
+	auto directory = std::filesystem::temp_directory_path() / "DariusSceneStreamingTests";
+	std::filesystem::create_directories(directory);
+	auto path = directory / "Duplicates.json";
+
+	D_SERIALIZATION::Json dumpJson;
+	GameObject* roots[] = { root };
+	D_WORLD::DumpGameObjects(roots, dumpJson);
+	BOOST_TEST_REQUIRE(D_FILE::WriteJsonFile(path, dumpJson));
+
+	auto integrate = [&]()
+		{
+			StagedSceneDump dump;
+			BOOST_TEST_REQUIRE(dump.Stage(path));
+
+			// Not stalling, each call takes a step at least
+			for (UINT i = 0u; i < 100u; i++)
+				if (D_WORLD::IntegrateStagedDump(dump, D_TIME::SystemTime::GetCurrentMillisecond() + 1000.))
+					return true;
+			return false;
+		};
+
+	auto countObjects = []()
+		{
+			DVector<GameObject*> gos;
+			D_WORLD::GetGameObjects(gos);
+			return gos.size();
+		};
+
+	// The live objects keep their uuids and nothing is added next to them
+	auto objectCount = countObjects();
+	BOOST_TEST(integrate());
+	BOOST_TEST(countObjects() == objectCount);
+	for (auto go : originals)
+		BOOST_TEST(D_WORLD::GetGameObject(go->GetUuid()) == go);
+	BOOST_TEST(root->CountChildren() == 2u);
+
+	// Deleted ones are waited for until removed, then replaced
+	D_WORLD::DeleteGameObjects(roots);
+	{
+		StagedSceneDump dump;
+		BOOST_TEST_REQUIRE(dump.Stage(path));
+		BOOST_TEST(!D_WORLD::IntegrateStagedDump(dump, D_TIME::SystemTime::GetCurrentMillisecond() + 1000.));
+	}
+
+	auto rootUuid = root->GetUuid();
+	D_WORLD::Update(0.f);
+	BOOST_TEST(integrate());
+
+	auto loaded = D_WORLD::GetGameObject(rootUuid);
+	BOOST_TEST_REQUIRE(loaded);
+	BOOST_TEST(!loaded->IsDeleted());
+	BOOST_TEST(loaded->GetTransform()->GetLocalPosition().GetY() == 4.f);
+	BOOST_TEST(countObjects() == objectCount);
+
+	std::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <Core/Containers/Vector.hpp>
+#include <Core/TimeManager/SystemTime.hpp>
+#include <Utils/Assert.hpp>
+#include <Utils/Common.hpp>
+
+#include <algorithm>
+#include <functional>
+
+#ifndef D_SCENE
+#define D_SCENE Darius::Scene
+#endif // !D_SCENE
+
+namespace Darius::Scene
+{
+	// Objects deleted during a frame are kept in the bucket of its frame resource until the resource
+	// comes back around and the GPU is done with them. From then on they are removed a batch at a time,
+	// spending at most the budget on each call, in the order they were queued.
+	template<class T>
+	class DeferredDeletions
+	{
+	public:
+		using DeleteBatchFunc = std::function<void(D_CONTAINERS::DVector<T*>& batch)>;
+
+		DeferredDeletions(UINT frameCount = 1u, UINT batchSize = 256u) :
+			mBuckets(frameCount),
+			mBatchSize(batchSize)
+		{
+			D_ASSERT(frameCount > 0u && batchSize > 0u);
+		}
+
+		INLINE void							Resize(UINT frameCount) { D_ASSERT(IsEmpty()); mBuckets.resize(frameCount); }
+		INLINE UINT							GetFrameCount() const { return (UINT)mBuckets.size(); }
+
+		// No limit on the count with zero objects
+		INLINE void							SetBudget(double milliseconds, UINT maxObjects = 0u) { D_ASSERT(milliseconds > 0.); mBudgetMs = milliseconds; mBudgetCount = maxObjects; }
+
+		INLINE D_CONTAINERS::DVector<T*>&	GetBucket(UINT frameIndex) { return mBuckets[frameIndex % mBuckets.size()]; }
+
+		INLINE size_t						GetRetiredCount() const { return mRetired.size() - mRetiredHead; }
+
+		INLINE bool							IsEmpty() const
+		{
+			return GetRetiredCount() == 0u && std::all_of(mBuckets.begin(), mBuckets.end(), [](auto const& bucket) { return bucket.empty(); });
+		}
+
+		// The frame resource came back around, so the GPU no longer uses the objects of its bucket
+		void								Retire(UINT frameIndex)
+		{
+			auto& bucket = GetBucket(frameIndex);
+			mRetired.insert(mRetired.end(), bucket.begin(), bucket.end());
+			bucket.clear();
+		}
+
+		// Removes the retired objects within the budget and returns how many were removed
+		UINT								RemoveRetired(DeleteBatchFunc const& deleteBatch)
+		{
+			auto deadline = D_TIME::SystemTime::GetCurrentMillisecond() + mBudgetMs;
+			UINT removed = 0u;
+
+			// Children are queued before their parents, so each batch leaves no parent destructed before its children
+			while(mRetiredHead < mRetired.size())
+			{
+				auto count = std::min((size_t)mBatchSize, mRetired.size() - mRetiredHead);
+				if(mBudgetCount > 0u)
+					count = std::min(count, (size_t)(mBudgetCount - removed));
+
+				auto begin = mRetired.begin() + mRetiredHead;
+				D_CONTAINERS::DVector<T*> batch(begin, begin + count);
+				mRetiredHead += count;
+				removed += (UINT)count;
+
+				deleteBatch(batch);
+
+				if((mBudgetCount > 0u && removed >= mBudgetCount) || D_TIME::SystemTime::GetCurrentMillisecond() >= deadline)
+					break;
+			}
+
+			if(mRetiredHead == mRetired.size())
+			{
+				mRetired.clear();
+				mRetiredHead = 0u;
+			}
+			// Not to grow while deletions keep coming
+			else if(mRetiredHead > mRetired.size() / 2)
+			{
+				mRetired.erase(mRetired.begin(), mRetired.begin() + mRetiredHead);
+				mRetiredHead = 0u;
+			}
+
+			return removed;
+		}
+
+		// Removes everything at once, the retired ones first as they were deleted before the rest
+		void								Flush(DeleteBatchFunc const& deleteBatch)
+		{
+			D_CONTAINERS::DVector<T*> all(mRetired.begin() + mRetiredHead, mRetired.end());
+			mRetired.clear();
+			mRetiredHead = 0u;
+
+			for(auto& bucket : mBuckets)
+			{
+				all.insert(all.end(), bucket.begin(), bucket.end());
+				bucket.clear();
+			}
+
+			deleteBatch(all);
+		}
+
+		void								Clear()
+		{
+			for(auto& bucket : mBuckets)
+				bucket.clear();
+			mRetired.clear();
+			mRetiredHead = 0u;
+		}
+
+	private:
+		D_CONTAINERS::DVector<D_CONTAINERS::DVector<T*>> mBuckets;
+
+		// Retired objects from the head on are still to be removed
+		D_CONTAINERS::DVector<T*>			mRetired;
+		size_t								mRetiredHead = 0u;
+
+		UINT								mBatchSize;
+		double								mBudgetMs = 1.0;
+		UINT								mBudgetCount = 0u;
+	};
+}
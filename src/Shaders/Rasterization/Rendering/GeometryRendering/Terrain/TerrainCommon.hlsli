@@ -47,3 +47,13 @@ struct DomainOut
     float2 UV : TEXCOORD0;
 };
 
+// Terrain draw constants, either for the whole terrain or one of its LOD quad tree nodes
+cbuffer cbPerObject : register(b0)
+{
+    float4x4 gWorld;
+    float3x3 gWorldIT;
+    float4 gUVOffsetScale;      // xy: uv offset, zw: uv scale
+    float4 gNodeOffsetScale;    // xy: node center in terrain space, z: node scale, w: patch mesh size
+    float4 gMorphParams;        // x: morph start, y: morph end, z: morph grid dimension, w: tessellation factor
+    float3 gCameraPosLocal;
+};
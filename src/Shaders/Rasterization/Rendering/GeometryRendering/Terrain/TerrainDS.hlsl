@@ -1,11 +1,5 @@
 #include "TerrainCommon.hlsli"
 
-cbuffer cbPerObject : register(b0)
-{
-    float4x4 gWorld;
-    float3x3 gWorldIT;
-};
-
 cbuffer cbMaterial : register(b2)
 {
     float  gDisplacementAmount;
@@ -29,8 +23,25 @@ DomainOut main(PatchTess patchTess,
 {
     DomainOut dout;
     
+    float2 patchUV = ResolveParam(UV);
+    float3 posL = ResolveParam(Pos);
+    
+    // CDLOD, morphing node vertices into the grid of the next coarser LOD as they get farther
+    if (gMorphParams.y > 0.f)
+    {
+        float3 terrainPos = float3(gNodeOffsetScale.x + posL.x * gNodeOffsetScale.z, 0.f, gNodeOffsetScale.y + posL.z * gNodeOffsetScale.z);
+        terrainPos.y = getHeight(gUVOffsetScale.xy + patchUV * gUVOffsetScale.zw, linearClamp) * gDisplacementAmount;
+        
+        float morphK = saturate((distance(terrainPos, gCameraPosLocal) - gMorphParams.x) / (gMorphParams.y - gMorphParams.x));
+        float2 morphOffset = frac(patchUV * gMorphParams.z * 0.5f) * 2.f / gMorphParams.z * morphK;
+        
+        // Grid x grows with u and z decreases with v
+        patchUV -= morphOffset;
+        posL.xz += float2(-morphOffset.x, morphOffset.y) * gNodeOffsetScale.w;
+    }
+    
     // UV
-    dout.UV = ResolveParam(UV);
+    dout.UV = gUVOffsetScale.xy + patchUV * gUVOffsetScale.zw;
 
     
     // Normal
@@ -53,8 +64,10 @@ DomainOut main(PatchTess patchTess,
     // World Pos    
     float displacementNorm = getHeight(dout.UV, linearWrap);
     float3 displacement = float3(0.f, displacementNorm * gDisplacementAmount, 0.f);
-    float3 posL = ResolveParam(Pos);
     posL += displacement;
+    
+    // Node space to terrain space
+    posL.xz = gNodeOffsetScale.xy + posL.xz * gNodeOffsetScale.z;
     dout.WorldPos = mul(gWorld, float4(posL, 1.f)).xyz;
     dout.Pos = mul(gViewProj, float4(dout.WorldPos, 1.f));
 
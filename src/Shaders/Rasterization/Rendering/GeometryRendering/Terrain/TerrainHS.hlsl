@@ -1,28 +1,32 @@
 #include "TerrainCommon.hlsli"
 
-cbuffer cbPerObject : register(b0)
-{
-    float4x4 gWorld;
-    float3x3 gWorldIT;
-};
-
 PatchTess ConstantHS(InputPatch<VertexOut, 4> patch,
                         uint patchId : SV_PrimitiveID)
 {
     PatchTess pt;
-    float3 centerL = 0.25f * (patch[0].Pos + patch[1].Pos + patch[2].Pos + patch[3].Pos);
-    float3 centerW = mul(gWorld, float4(centerL, 1.f)).xyz;
+    float tess;
+    
+    // LOD nodes have a fixed density, the distance is handled by the quad tree selection
+    if (gMorphParams.w > 0.f)
+    {
+        tess = gMorphParams.w;
+    }
+    else
+    {
+        float3 centerL = 0.25f * (patch[0].Pos + patch[1].Pos + patch[2].Pos + patch[3].Pos);
+        float3 centerW = mul(gWorld, float4(centerL, 1.f)).xyz;
 
-    float d = distance(centerW, gCameraPosW);
+        float d = distance(centerW, gCameraPosW);
     
-    // Tessellate the patch based on distance from the eye such that
-	// the tessellation is 0 if d >= d1 and 64 if d <= d0.  The interval
-	// [d0, d1] defines the range we tessellate in.
+        // Tessellate the patch based on distance from the eye such that
+	    // the tessellation is 0 if d >= d1 and 64 if d <= d0.  The interval
+	    // [d0, d1] defines the range we tessellate in.
 	
-    const float d0 = 600.0f;
-    const float d1 = 1000.0f;
-    float tess = 64 * saturate((d1 - d) / (d1 - d0));
-    tess = clamp(tess, 1.f, 64.f);
+        const float d0 = 600.0f;
+        const float d1 = 1000.0f;
+        tess = 64 * saturate((d1 - d) / (d1 - d0));
+        tess = clamp(tess, 1.f, 64.f);
+    }
     
     // Uniform tessellation
     pt.EdgeTess[0] = tess;
@@ -1,52 +1,23 @@
 #pragma once
 
-#ifdef _DEBUG
+#include "Logger.hpp"
+
 #include <iostream>
 #include <format>
-#define D_LOG_IMPL(msg, lvl)
-#define D_LOG_TRACE_IMPL(...) std::cout << "TRACE:\t" << __VA_ARGS__ << std::endl
-#define D_LOG_DEBUG_IMPL(...) std::cout << "DEBUG:\t" << __VA_ARGS__ << std::endl
-#define D_LOG_INFO_IMPL(...) std::cout << "INFO:\t" << __VA_ARGS__ << std::endl
-#define D_LOG_WARN_IMPL(...) std::cerr << "WARN:\t" << __VA_ARGS__ << std::endl
-#define D_LOG_ERROR_IMPL(...) std::cerr << "ERROR:\t" << __VA_ARGS__ << std::endl
-#define D_LOG_FATAL_IMPL(...) std::cerr << "FATAL:\t" << __VA_ARGS__ <<  std::endl
-#define D_LOG_TRACE_FMT_IMPL(fmt, ...) std::cout << std::format(fmt, __VA_ARGS__) << std::endl
-#define D_LOG_DEBUG_FMT_IMPL(fmt, ...) std::cout << std::format(fmt, __VA_ARGS__) << std::endl
-#define D_LOG_INFO_FMT_IMPL(fmt, ...) std::cout << std::format(fmt, __VA_ARGS__) << std::endl
-#define D_LOG_WARN_FMT_IMPL(fmt, ...) std::cerr << std::format(fmt, __VA_ARGS__) << std::endl
-#define D_LOG_ERROR_FMT_IMPL(fmt, ...) std::cerr << std::format(fmt, __VA_ARGS__) << std::endl
-#define D_LOG_FATAL_FMT_IMPL(fmt, ...) std::cerr << std::format(fmt, __VA_ARGS__) << std::endl
-#else
-#define D_LOG_IMPL(msg, lvl) do{}while(0)
-#define D_LOG_TRACE_IMPL(...) do{}while(0)
-#define D_LOG_DEBUG_IMPL(...) do{}while(0)
-#define D_LOG_INFO_IMPL(...) do{}while(0)
-#define D_LOG_WARN_IMPL(...) do{}while(0)
-#define D_LOG_ERROR_IMPL(...) do{}while(0)
-#define D_LOG_FATAL_IMPL(...) do{}while(0)
-#define D_LOG_TRACE_FMT_IMPL(...) do{}while(0)
-#define D_LOG_DEBUG_FMT_IMPL(...) do{}while(0)
-#define D_LOG_INFO_FMT_IMPL(...) do{}while(0)
-#define D_LOG_WARN_FMT_IMPL(...) do{}while(0)
-#define D_LOG_ERROR_FMT_IMPL(...) do{}while(0)
-#define D_LOG_FATAL_FMT_IMPL(...) do{}while(0)
-
-#endif // _DEBUG
-
 
-#define D_LOG(msg, lvl) D_LOG_IMPL(msg, lvl)
-#define D_LOG_TRACE(...) D_LOG_TRACE_IMPL(__VA_ARGS__)
-#define D_LOG_DEBUG(...) D_LOG_DEBUG_IMPL(__VA_ARGS__)
-#define D_LOG_INFO(...) D_LOG_INFO_IMPL(__VA_ARGS__)
-#define D_LOG_WARN(...) D_LOG_WARN_IMPL(__VA_ARGS__)
-#define D_LOG_ERROR(...) D_LOG_ERROR_IMPL(__VA_ARGS__)
-#define D_LOG_FATAL(...) D_LOG_FATAL_IMPL(__VA_ARGS__)
-#define D_LOG_TRACE_FMT(fmt, ...) D_LOG_TRACE_FMT_IMPL(fmt, __VA_ARGS__)
-#define D_LOG_DEBUG_FMT(fmt, ...) D_LOG_DEBUG_FMT_IMPL(fmt, __VA_ARGS__)
-#define D_LOG_INFO_FMT(fmt, ...) D_LOG_INFO_FMT_IMPL(fmt, __VA_ARGS__)
-#define D_LOG_WARN_FMT(fmt, ...) D_LOG_WARN_FMT_IMPL(fmt, __VA_ARGS__)
-#define D_LOG_ERROR_FMT(fmt, ...) D_LOG_ERROR_FMT_IMPL(fmt, __VA_ARGS__)
-#define D_LOG_FATAL_FMT(fmt, ...) D_LOG_FATAL_FMT_IMPL(fmt, __VA_ARGS__)
+#define D_LOG(msg, lvl) D_LOG_CATEGORY(lvl, nullptr, msg)
+#define D_LOG_TRACE(...) D_LOG_CATEGORY(D_LOGGER::LogLevel::Trace, nullptr, __VA_ARGS__)
+#define D_LOG_DEBUG(...) D_LOG_CATEGORY(D_LOGGER::LogLevel::Debug, nullptr, __VA_ARGS__)
+#define D_LOG_INFO(...) D_LOG_CATEGORY(D_LOGGER::LogLevel::Info, nullptr, __VA_ARGS__)
+#define D_LOG_WARN(...) D_LOG_CATEGORY(D_LOGGER::LogLevel::Warn, nullptr, __VA_ARGS__)
+#define D_LOG_ERROR(...) D_LOG_CATEGORY(D_LOGGER::LogLevel::Error, nullptr, __VA_ARGS__)
+#define D_LOG_FATAL(...) D_LOG_CATEGORY(D_LOGGER::LogLevel::Fatal, nullptr, __VA_ARGS__)
+#define D_LOG_TRACE_FMT(fmt, ...) D_LOG_CATEGORY_FMT(D_LOGGER::LogLevel::Trace, nullptr, fmt, __VA_ARGS__)
+#define D_LOG_DEBUG_FMT(fmt, ...) D_LOG_CATEGORY_FMT(D_LOGGER::LogLevel::Debug, nullptr, fmt, __VA_ARGS__)
+#define D_LOG_INFO_FMT(fmt, ...) D_LOG_CATEGORY_FMT(D_LOGGER::LogLevel::Info, nullptr, fmt, __VA_ARGS__)
+#define D_LOG_WARN_FMT(fmt, ...) D_LOG_CATEGORY_FMT(D_LOGGER::LogLevel::Warn, nullptr, fmt, __VA_ARGS__)
+#define D_LOG_ERROR_FMT(fmt, ...) D_LOG_CATEGORY_FMT(D_LOGGER::LogLevel::Error, nullptr, fmt, __VA_ARGS__)
+#define D_LOG_FATAL_FMT(fmt, ...) D_LOG_CATEGORY_FMT(D_LOGGER::LogLevel::Fatal, nullptr, fmt, __VA_ARGS__)
 
 #ifndef _DEBUG
 
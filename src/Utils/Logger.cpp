@@ -0,0 +1,532 @@
+#include "Logger.hpp"
+
+#include "Assert.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+	using namespace D_LOGGER;
+
+	// Fixed size slot, so the queue takes a bounded amount of memory and logging does not allocate
+	struct LogSlot
+	{
+		static constexpr uint32_t		MaxMessageLength = 1024u - 64u;
+
+		std::atomic_uint64_t			Sequence = 0u;
+		std::chrono::system_clock::time_point Time;
+		char const*						Category = nullptr;
+		uint32_t						Thread = 0u;
+		uint16_t						Length = 0u;
+		LogLevel						Level = LogLevel::Info;
+		char							Message[MaxMessageLength];
+	};
+
+	// Bounded multi producer, single consumer queue. A slot's sequence tells whether it is free
+	// for the enqueue position or written for the dequeue position.
+	class LogQueue
+	{
+	public:
+		static constexpr uint64_t		Capacity = 1u << 11;
+
+		LogQueue() :
+			mSlots(new LogSlot[Capacity])
+		{
+			for (uint64_t i = 0u; i < Capacity; i++)
+				mSlots[i].Sequence.store(i, std::memory_order_relaxed);
+		}
+
+		bool Push(LogLevel level, char const* category, uint32_t thread, std::string_view message)
+		{
+			uint64_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+			LogSlot* slot;
+			while (true)
+			{
+				slot = &mSlots[pos & (Capacity - 1u)];
+				int64_t diff = (int64_t)slot->Sequence.load(std::memory_order_acquire) - (int64_t)pos;
+
+				if (diff == 0)
+				{
+					if (mEnqueuePos.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed))
+						break;
+				}
+				else if (diff < 0)
+					return false;
+				else
+					pos = mEnqueuePos.load(std::memory_order_relaxed);
+			}
+
+			auto length = std::min(message.size(), (size_t)LogSlot::MaxMessageLength);
+			std::memcpy(slot->Message, message.data(), length);
+			slot->Length = (uint16_t)length;
+			slot->Time = std::chrono::system_clock::now();
+			slot->Category = category;
+			slot->Thread = thread;
+			slot->Level = level;
+
+			slot->Sequence.store(pos + 1u, std::memory_order_release);
+			return true;
+		}
+
+		// Only called from the consumer
+		LogSlot* Front()
+		{
+			auto slot = &mSlots[mDequeuePos & (Capacity - 1u)];
+			if (slot->Sequence.load(std::memory_order_acquire) != mDequeuePos + 1u)
+				return nullptr;
+			return slot;
+		}
+
+		void Pop()
+		{
+			mSlots[mDequeuePos & (Capacity - 1u)].Sequence.store(mDequeuePos + Capacity, std::memory_order_release);
+			mDequeuePos++;
+			mDequeued.store(mDequeuePos, std::memory_order_release);
+		}
+
+		INLINE uint64_t GetEnqueuePos() const { return mEnqueuePos.load(std::memory_order_acquire); }
+		INLINE uint64_t GetDequeuePos() const { return mDequeued.load(std::memory_order_acquire); }
+		INLINE uint64_t GetSize() const { return GetEnqueuePos() - GetDequeuePos(); }
+
+	private:
+		std::unique_ptr<LogSlot[]>		mSlots;
+
+		alignas(64) std::atomic_uint64_t mEnqueuePos = 0u;
+		alignas(64) uint64_t			mDequeuePos = 0u;
+		std::atomic_uint64_t			mDequeued = 0u;
+	};
+
+	struct LoggerState
+	{
+		// Not shut down, e.g. exiting after a fatal error
+		~LoggerState()
+		{
+			if (!Writer.joinable())
+				return;
+
+			{
+				std::scoped_lock lock(WakeMutex);
+				Stopping = true;
+			}
+			WakeWriter.notify_one();
+			Writer.join();
+		}
+
+		LogQueue						Queue;
+
+		std::mutex						SinksMutex;
+		std::vector<std::shared_ptr<LogSink>> Sinks = { std::make_shared<ConsoleLogSink>() };
+
+		std::thread						Writer;
+		bool							Running = false;
+		bool							Stopping = false;
+
+		// Wakes the writer, and the threads waiting for the entries to be written
+		std::mutex						WakeMutex;
+		std::condition_variable			WakeWriter;
+		std::condition_variable			Written;
+		bool							FlushRequested = false;
+
+		std::atomic_bool				Threaded = false;
+		std::atomic_uint64_t			Dropped = 0u;
+	};
+
+#ifdef _DEBUG
+	std::atomic<LogLevel>				Level = LogLevel::Trace;
+#else
+	std::atomic<LogLevel>				Level = LogLevel::Info;
+#endif
+
+	std::atomic_uint32_t				NextThread = 0u;
+	thread_local uint32_t				LocalThread = UINT32_MAX;
+
+	// Constructed on first use, since logging can happen during static initialization
+	LoggerState& GetState()
+	{
+		static LoggerState state;
+		return state;
+	}
+
+	uint32_t GetThreadIndex()
+	{
+		if (LocalThread == UINT32_MAX)
+			LocalThread = NextThread.fetch_add(1u, std::memory_order_relaxed);
+		return LocalThread;
+	}
+
+	void WriteToSinks(LoggerState& state, LogEntry const& entry)
+	{
+		for (auto const& sink : state.Sinks)
+			sink->Write(entry);
+	}
+
+	void FlushSinks(LoggerState& state)
+	{
+		for (auto const& sink : state.Sinks)
+			sink->Flush();
+	}
+
+	void WriterLoop()
+	{
+		auto& state = GetState();
+
+		while (true)
+		{
+			bool flush = false;
+			bool stop = false;
+			{
+				std::unique_lock lock(state.WakeMutex);
+
+				// Polling in short intervals so that the log calls do not have to wake the writer
+				state.WakeWriter.wait_for(lock, std::chrono::milliseconds(10), [&]() { return state.Queue.GetSize() > 0u || state.Stopping || state.FlushRequested; });
+
+				flush = state.FlushRequested;
+				stop = state.Stopping;
+				state.FlushRequested = false;
+			}
+
+			{
+				std::scoped_lock lock(state.SinksMutex);
+
+				while (auto slot = state.Queue.Front())
+				{
+					LogEntry entry = { slot->Time, slot->Level, slot->Thread, slot->Category, std::string_view(slot->Message, slot->Length) };
+					WriteToSinks(state, entry);
+					state.Queue.Pop();
+				}
+
+				if (flush || stop)
+					FlushSinks(state);
+			}
+
+			{
+				std::scoped_lock lock(state.WakeMutex);
+				state.Written.notify_all();
+			}
+
+			// Entries logged while stopping are written synchronously
+			if (stop)
+				break;
+		}
+	}
+}
+
+namespace Darius::Utils::Logger
+{
+	void Initialize()
+	{
+		auto& state = GetState();
+		D_ASSERT(!state.Running);
+
+		state.Running = true;
+		state.Stopping = false;
+		state.Writer = std::thread(WriterLoop);
+		state.Threaded.store(true, std::memory_order_release);
+	}
+
+	void Shutdown()
+	{
+		auto& state = GetState();
+		D_ASSERT(state.Running);
+
+		{
+			std::scoped_lock lock(state.WakeMutex);
+			state.Stopping = true;
+		}
+		state.WakeWriter.notify_one();
+		state.Writer.join();
+
+		state.Threaded.store(false, std::memory_order_release);
+		state.Running = false;
+
+		// Entries enqueued after the writer's last pass
+		std::scoped_lock lock(state.SinksMutex);
+		while (auto slot = state.Queue.Front())
+		{
+			LogEntry entry = { slot->Time, slot->Level, slot->Thread, slot->Category, std::string_view(slot->Message, slot->Length) };
+			WriteToSinks(state, entry);
+			state.Queue.Pop();
+		}
+		FlushSinks(state);
+	}
+
+	void AddSink(std::shared_ptr<LogSink> const& sink)
+	{
+		auto& state = GetState();
+		std::scoped_lock lock(state.SinksMutex);
+		state.Sinks.push_back(sink);
+	}
+
+	void RemoveSink(std::shared_ptr<LogSink> const& sink)
+	{
+		auto& state = GetState();
+		std::scoped_lock lock(state.SinksMutex);
+		std::erase(state.Sinks, sink);
+	}
+
+	void ClearSinks()
+	{
+		auto& state = GetState();
+		std::scoped_lock lock(state.SinksMutex);
+		state.Sinks.clear();
+	}
+
+	void SetLevel(LogLevel level)
+	{
+		Level.store(level, std::memory_order_relaxed);
+	}
+
+	LogLevel GetLevel()
+	{
+		return Level.load(std::memory_order_relaxed);
+	}
+
+	bool IsEnabled(LogLevel level)
+	{
+		return level >= Level.load(std::memory_order_relaxed);
+	}
+
+	void Log(LogLevel level, char const* category, std::string_view message)
+	{
+		auto& state = GetState();
+		auto thread = GetThreadIndex();
+
+		if (!state.Threaded.load(std::memory_order_acquire))
+		{
+			std::scoped_lock lock(state.SinksMutex);
+
+			WriteToSinks(state, { std::chrono::system_clock::now(), level, thread, category, message });
+			if (level >= LogLevel::Error)
+				FlushSinks(state);
+			return;
+		}
+
+		if (!state.Queue.Push(level, category, thread, message))
+		{
+			state.Dropped.fetch_add(1u, std::memory_order_relaxed);
+			return;
+		}
+
+		// Errors may come right before a crash
+		if (level >= LogLevel::Error)
+			Flush();
+		else if (state.Queue.GetSize() > LogQueue::Capacity / 2u)
+			state.WakeWriter.notify_one();
+	}
+
+	void Flush()
+	{
+		auto& state = GetState();
+		if (!state.Threaded.load(std::memory_order_acquire))
+		{
+			std::scoped_lock lock(state.SinksMutex);
+			FlushSinks(state);
+			return;
+		}
+
+		uint64_t target = state.Queue.GetEnqueuePos();
+
+		std::unique_lock lock(state.WakeMutex);
+		state.FlushRequested = true;
+		state.WakeWriter.notify_one();
+
+		// Checked again in case the writer stops while waiting
+		while (state.Queue.GetDequeuePos() < target && state.Threaded.load(std::memory_order_acquire))
+			state.Written.wait_for(lock, std::chrono::milliseconds(10));
+	}
+
+	uint64_t GetDroppedCount()
+	{
+		return GetState().Dropped.load(std::memory_order_relaxed);
+	}
+
+	char const* GetLevelName(LogLevel level)
+	{
+		switch (level)
+		{
+		case LogLevel::Trace: return "TRACE";
+		case LogLevel::Debug: return "DEBUG";
+		case LogLevel::Info: return "INFO";
+		case LogLevel::Warn: return "WARN";
+		case LogLevel::Error: return "ERROR";
+		case LogLevel::Fatal: return "FATAL";
+		default: return "UNKNOWN";
+		}
+	}
+
+	void FormatEntry(LogEntry const& entry, std::string& out)
+	{
+		auto time = std::chrono::floor<std::chrono::milliseconds>(entry.Time);
+		std::chrono::hh_mm_ss timeOfDay(time - std::chrono::floor<std::chrono::days>(time));
+
+		char prefix[64];
+		int length = std::snprintf(prefix, sizeof(prefix), "[%02d:%02d:%02d.%03d] [%s] ",
+			(int)timeOfDay.hours().count(), (int)timeOfDay.minutes().count(), (int)timeOfDay.seconds().count(), (int)timeOfDay.subseconds().count(),
+			GetLevelName(entry.Level));
+
+		out.append(prefix, std::max(length, 0));
+		if (entry.Category)
+		{
+			out.push_back('[');
+			out.append(entry.Category);
+			out.append("] ");
+		}
+		out.append(entry.Message);
+	}
+
+	std::ostringstream& GetThreadStream()
+	{
+		thread_local std::ostringstream stream;
+		return stream;
+	}
+
+	void LogThreadStream(LogLevel level, char const* category)
+	{
+		auto& stream = GetThreadStream();
+		Log(level, category, stream.view());
+		stream.str(std::string());
+	}
+
+	std::string& GetThreadFormatBuffer()
+	{
+		thread_local std::string buffer;
+		return buffer;
+	}
+
+	///////////////////////////////////////////////////
+	/////////////////// Console Sink //////////////////
+	///////////////////////////////////////////////////
+
+	void ConsoleLogSink::Write(LogEntry const& entry)
+	{
+		thread_local std::string line;
+		line.clear();
+		FormatEntry(entry, line);
+		line.push_back('\n');
+
+		auto& out = entry.Level >= LogLevel::Warn ? std::cerr : std::cout;
+		out.write(line.data(), line.size());
+	}
+
+	void ConsoleLogSink::Flush()
+	{
+		std::cout.flush();
+		std::cerr.flush();
+	}
+
+	///////////////////////////////////////////////////
+	///////////////// Rotating File Sink //////////////
+	///////////////////////////////////////////////////
+
+	RotatingFileLogSink::RotatingFileLogSink(std::filesystem::path const& path, uint64_t maxFileSize, uint32_t maxFiles) :
+		mPath(path),
+		mMaxFileSize(maxFileSize),
+		mMaxFiles(maxFiles)
+	{
+		std::error_code ec;
+		if (path.has_parent_path())
+			std::filesystem::create_directories(path.parent_path(), ec);
+
+		// Every run starts with a new file
+		Rotate();
+	}
+
+	std::filesystem::path RotatingFileLogSink::GetRotatedPath(uint32_t index) const
+	{
+		auto path = mPath;
+		path.replace_extension(std::to_string(index) + mPath.extension().string());
+		return path;
+	}
+
+	void RotatingFileLogSink::Rotate()
+	{
+		if (mFile.is_open())
+			mFile.close();
+
+		std::error_code ec;
+		if (mMaxFiles > 0u)
+		{
+			std::filesystem::remove(GetRotatedPath(mMaxFiles), ec);
+			for (uint32_t i = mMaxFiles; i > 1u; i--)
+				std::filesystem::rename(GetRotatedPath(i - 1u), GetRotatedPath(i), ec);
+			std::filesystem::rename(mPath, GetRotatedPath(1u), ec);
+		}
+
+		mFile.open(mPath, std::ios::out | std::ios::trunc | std::ios::binary);
+		mFileSize = 0u;
+	}
+
+	void RotatingFileLogSink::Write(LogEntry const& entry)
+	{
+		if (!mFile)
+			return;
+
+		thread_local std::string line;
+		line.clear();
+		FormatEntry(entry, line);
+		line.push_back('\n');
+
+		if (mFileSize > 0u && mFileSize + line.size() > mMaxFileSize)
+			Rotate();
+
+		mFile.write(line.data(), line.size());
+		mFileSize += line.size();
+	}
+
+	void RotatingFileLogSink::Flush()
+	{
+		mFile.flush();
+	}
+
+	///////////////////////////////////////////////////
+	////////////////// Memory Sink ////////////////////
+	///////////////////////////////////////////////////
+
+	MemoryLogSink::MemoryLogSink(uint32_t capacity) :
+		mCapacity(std::max(capacity, 1u))
+	{
+		mEntries.reserve(mCapacity);
+	}
+
+	void MemoryLogSink::Write(LogEntry const& entry)
+	{
+		Entry stored = { entry.Time, entry.Level, entry.Thread, entry.Category ? entry.Category : "", std::string(entry.Message) };
+
+		std::scoped_lock lock(mMutex);
+
+		// Overwriting the oldest entry when full
+		if (mEntries.size() < mCapacity)
+			mEntries.push_back(std::move(stored));
+		else
+		{
+			mEntries[mNext] = std::move(stored);
+			mNext = (mNext + 1u) % mCapacity;
+		}
+
+		mVersion.fetch_add(1u, std::memory_order_relaxed);
+	}
+
+	void MemoryLogSink::GetEntries(std::vector<Entry>& entries) const
+	{
+		std::scoped_lock lock(mMutex);
+
+		entries.clear();
+		entries.reserve(mEntries.size());
+		entries.insert(entries.end(), mEntries.begin() + mNext, mEntries.end());
+		entries.insert(entries.end(), mEntries.begin(), mEntries.begin() + mNext);
+	}
+
+	void MemoryLogSink::Clear()
+	{
+		std::scoped_lock lock(mMutex);
+
+		mEntries.clear();
+		mNext = 0u;
+		mVersion.fetch_add(1u, std::memory_order_relaxed);
+	}
+}
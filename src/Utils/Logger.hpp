@@ -0,0 +1,177 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef D_LOGGER
+#define D_LOGGER Darius::Utils::Logger
+#endif // !D_LOGGER
+
+// Log calls format the message on the calling thread and enqueue it into a bounded lock-free
+// queue. A background thread writes the entries to the sinks. Entries are dropped when the
+// queue is full, and messages longer than a queue slot are truncated.
+namespace Darius::Utils::Logger
+{
+	enum class LogLevel : uint8_t
+	{
+		Trace,
+		Debug,
+		Info,
+		Warn,
+		Error,
+		Fatal
+	};
+
+	struct LogEntry
+	{
+		std::chrono::system_clock::time_point Time;
+		LogLevel						Level;
+		uint32_t						Thread;
+
+		// Null for the uncategorized entries
+		char const*						Category;
+		std::string_view				Message;
+	};
+
+	// Sinks are only called from one thread at a time
+	class LogSink
+	{
+	public:
+		virtual ~LogSink() = default;
+
+		virtual void					Write(LogEntry const& entry) = 0;
+		virtual void					Flush() {}
+	};
+
+	class ConsoleLogSink : public LogSink
+	{
+	public:
+		virtual void					Write(LogEntry const& entry) override;
+		virtual void					Flush() override;
+	};
+
+	// Starts a new file when the current one is full, keeping the given number of older files
+	// as name.1.ext, name.2.ext and so on
+	class RotatingFileLogSink : public LogSink
+	{
+	public:
+		RotatingFileLogSink(std::filesystem::path const& path, uint64_t maxFileSize, uint32_t maxFiles);
+
+		virtual void					Write(LogEntry const& entry) override;
+		virtual void					Flush() override;
+
+	private:
+		void							Rotate();
+		std::filesystem::path			GetRotatedPath(uint32_t index) const;
+
+		std::filesystem::path			mPath;
+		uint64_t						mMaxFileSize;
+		uint32_t						mMaxFiles;
+
+		std::ofstream					mFile;
+		uint64_t						mFileSize = 0u;
+	};
+
+	// Keeps the latest entries in memory for displaying in the editor
+	class MemoryLogSink : public LogSink
+	{
+	public:
+		struct Entry
+		{
+			std::chrono::system_clock::time_point Time;
+			LogLevel					Level;
+			uint32_t					Thread;
+			std::string					Category;
+			std::string					Message;
+		};
+
+		MemoryLogSink(uint32_t capacity);
+
+		virtual void					Write(LogEntry const& entry) override;
+
+		// Thread safe, from the oldest to the latest entry
+		void							GetEntries(std::vector<Entry>& entries) const;
+		void							Clear();
+
+		// Changes whenever the entries change
+		INLINE uint64_t					GetVersion() const { return mVersion.load(std::memory_order_relaxed); }
+
+	private:
+		mutable std::mutex				mMutex;
+		std::vector<Entry>				mEntries;
+		uint32_t						mCapacity;
+		uint32_t						mNext = 0u;
+		std::atomic_uint64_t			mVersion = 0u;
+	};
+
+	// Starts the writer thread. Until then and after shutdown, entries are written on the logging thread.
+	void								Initialize();
+	void								Shutdown();
+
+	void								AddSink(std::shared_ptr<LogSink> const& sink);
+	void								RemoveSink(std::shared_ptr<LogSink> const& sink);
+
+	// Also removes the console sink that is there by default
+	void								ClearSinks();
+
+	void								SetLevel(LogLevel level);
+	LogLevel							GetLevel();
+	bool								IsEnabled(LogLevel level);
+
+	void								Log(LogLevel level, char const* category, std::string_view message);
+
+	// Waits until the entries logged so far are written and the sinks are flushed
+	void								Flush();
+
+	// Entries lost because the queue was full
+	uint64_t							GetDroppedCount();
+
+	char const*							GetLevelName(LogLevel level);
+
+	// Formats "[UTC time] [level] [category] message" without a line break
+	void								FormatEntry(LogEntry const& entry, std::string& out);
+
+	// Reused stream of the calling thread for the stream style log macros
+	std::ostringstream&					GetThreadStream();
+	void								LogThreadStream(LogLevel level, char const* category);
+
+	// Formats into a buffer of the calling thread, so nothing is allocated for short messages
+	std::string&						GetThreadFormatBuffer();
+
+	template<typename ...Args>
+	void LogFormat(LogLevel level, char const* category, std::format_string<Args...> fmt, Args&&... args)
+	{
+		auto& buffer = GetThreadFormatBuffer();
+		buffer.clear();
+		std::format_to(std::back_inserter(buffer), fmt, std::forward<Args>(args)...);
+		Log(level, category, buffer);
+	}
+}
+
+#define D_LOG_CATEGORY(lvl, category, ...) \
+	do \
+	{ \
+		if (D_LOGGER::IsEnabled(lvl)) \
+		{ \
+			D_LOGGER::GetThreadStream() << __VA_ARGS__; \
+			D_LOGGER::LogThreadStream(lvl, category); \
+		} \
+	} while(0)
+
+#define D_LOG_CATEGORY_FMT(lvl, category, fmt, ...) \
+	do \
+	{ \
+		if (D_LOGGER::IsEnabled(lvl)) \
+			D_LOGGER::LogFormat(lvl, category, fmt, __VA_ARGS__); \
+	} while(0)
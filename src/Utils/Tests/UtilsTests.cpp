@@ -0,0 +1,157 @@
+#define BOOST_TEST_MODULE UtilsTests
+#define BOOST_TEST_DYN_LINK
+
+#include <Utils/Log.hpp>
+#include <boost/test/included/unit_test.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <thread>
+
+using namespace D_LOGGER;
+
+namespace
+{
+	// Checks that the entries of each thread arrive in order
+	class CountingSink : public LogSink
+	{
+	public:
+		virtual void Write(LogEntry const& entry) override
+		{
+			Count++;
+
+			auto index = std::stoul(std::string(entry.Message.substr(entry.Message.find(' ') + 1)));
+			auto& last = LastIndices[entry.Thread];
+			if (last != 0u && index <= last)
+				OutOfOrder++;
+			last = index;
+		}
+
+		uint64_t						Count = 0u;
+		uint64_t						OutOfOrder = 0u;
+		std::map<uint32_t, unsigned long> LastIndices;
+	};
+
+	struct LoggerFixture
+	{
+		LoggerFixture()
+		{
+			ClearSinks();
+			SetLevel(LogLevel::Trace);
+			Initialize();
+		}
+
+		~LoggerFixture()
+		{
+			Shutdown();
+			ClearSinks();
+		}
+	};
+
+	void LogFromThreads(uint32_t threadCount, uint32_t count)
+	{
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0u; t < threadCount; t++)
+		{
+			threads.emplace_back([count]()
+				{
+					for (uint32_t i = 1u; i <= count; i++)
+						D_LOG_CATEGORY(LogLevel::Info, "Test", "Entry " << i);
+				});
+		}
+
+		for (auto& thread : threads)
+			thread.join();
+	}
+}
+
+BOOST_FIXTURE_TEST_SUITE(LoggerTests, LoggerFixture)
+
+BOOST_AUTO_TEST_CASE(WritesEntriesFromManyThreads)
+{
+	constexpr uint32_t threadCount = 8u;
+	constexpr uint32_t count = 5000u;
+
+	auto sink = std::make_shared<CountingSink>();
+	AddSink(sink);
+
+	auto droppedBefore = GetDroppedCount();
+	LogFromThreads(threadCount, count);
+	Flush();
+
+	BOOST_TEST(sink->Count + GetDroppedCount() - droppedBefore == (uint64_t)threadCount * count);
+	BOOST_TEST(sink->OutOfOrder == 0u);
+	BOOST_TEST(sink->LastIndices.size() <= threadCount);
+}
+
+BOOST_AUTO_TEST_CASE(FiltersByLevel)
+{
+	auto sink = std::make_shared<MemoryLogSink>(16u);
+	AddSink(sink);
+
+	bool evaluated = false;
+	auto evaluate = [&]() { evaluated = true; return 1; };
+
+	SetLevel(LogLevel::Warn);
+	D_LOG_INFO("Filtered " << evaluate());
+	D_LOG_WARN_FMT("Kept {}", 2);
+	D_LOG_CATEGORY(LogLevel::Error, "Renderer", "Error " << 3);
+	Flush();
+
+	// Filtered entries are not formatted
+	BOOST_TEST(!evaluated);
+
+	std::vector<MemoryLogSink::Entry> entries;
+	sink->GetEntries(entries);
+	BOOST_TEST_REQUIRE(entries.size() == 2u);
+	BOOST_TEST(entries[0].Message == "Kept 2");
+	BOOST_TEST(entries[0].Category == "");
+	BOOST_TEST((entries[1].Level == LogLevel::Error));
+	BOOST_TEST(entries[1].Category == "Renderer");
+}
+
+BOOST_AUTO_TEST_CASE(MemorySinkKeepsLatestEntries)
+{
+	MemoryLogSink sink(3u);
+
+	for (int i = 0; i < 5; i++)
+	{
+		auto message = std::to_string(i);
+		sink.Write({ std::chrono::system_clock::now(), LogLevel::Info, 0u, nullptr, message });
+	}
+
+	std::vector<MemoryLogSink::Entry> entries;
+	sink.GetEntries(entries);
+	BOOST_TEST_REQUIRE(entries.size() == 3u);
+	BOOST_TEST(entries[0].Message == "2");
+	BOOST_TEST(entries[2].Message == "4");
+
+	auto version = sink.GetVersion();
+	sink.Clear();
+	sink.GetEntries(entries);
+	BOOST_TEST(entries.empty());
+	BOOST_TEST(sink.GetVersion() != version);
+}
+
+BOOST_AUTO_TEST_CASE(RotatingFileSinkKeepsMaxFiles)
+{
+	auto dir = std::filesystem::temp_directory_path() / "DariusLoggerTests";
+	std::filesystem::remove_all(dir);
+
+	{
+		RotatingFileLogSink sink(dir / "Log.txt", 200u, 2u);
+		for (int i = 0; i < 50; i++)
+			sink.Write({ std::chrono::system_clock::now(), LogLevel::Info, 0u, "Test", "Some message to fill the files" });
+		sink.Flush();
+	}
+
+	BOOST_TEST(std::filesystem::file_size(dir / "Log.txt") <= 200u);
+	BOOST_TEST(std::filesystem::exists(dir / "Log.1.txt"));
+	BOOST_TEST(std::filesystem::exists(dir / "Log.2.txt"));
+	BOOST_TEST(!std::filesystem::exists(dir / "Log.3.txt"));
+
+	std::filesystem::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()